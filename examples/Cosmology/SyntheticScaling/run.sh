@@ -0,0 +1,53 @@
+#!/bin/bash
+
+# Strong or weak scaling test of SWIFT on initial conditions generated in
+# memory, so no input file is needed.
+#
+# Usage: ./run.sh [strong|weak] [max. nr of ranks] [threads per rank] [steps]
+#
+# The number of ranks is doubled from 1 to the maximum. In the strong scaling
+# test the problem size stays fixed at 2 x 64^3 particles, in the weak scaling
+# one it grows with the number of ranks. Each run is done in its own
+# directory, where SWIFT appends where the time of the steps went to
+# phase_times.jsonl. The results are summarised at the end.
+#
+# Set MPIRUN to change the MPI launcher (e.g. MPIRUN="srun").
+
+mode=${1:-strong}
+max_ranks=${2:-8}
+threads=${3:-4}
+steps=${4:-32}
+MPIRUN=${MPIRUN:-mpirun}
+
+if [ "$mode" != "strong" ] && [ "$mode" != "weak" ]
+then
+    echo "Unknown scaling test '$mode', must be 'strong' or 'weak'."
+    exit 1
+fi
+
+# Nr of particles per dimension with one rank
+base=64
+
+ranks=1
+while [ $ranks -le $max_ranks ]
+do
+    # Keep the number of particles per rank fixed for the weak scaling test
+    n=$base
+    if [ "$mode" = "weak" ]
+    then
+    n=$(python3 -c "print(round($base * $ranks ** (1. / 3.)))")
+    fi
+
+    # One Mpc per particle, to keep the resolution fixed
+    dir=${mode}_${ranks}
+    mkdir -p $dir
+    echo "Running on $ranks ranks with 2 x $n^3 particles in $dir..."
+    (cd $dir && $MPIRUN -np $ranks ../../../../swift_mpi --cosmology --hydro \
+    --self-gravity --threads=$threads --steps=$steps \
+    -P SyntheticICs:particles_per_dim:$n -P SyntheticICs:box_size:$n \
+    -P Gravity:mesh_side_length:$n ../synthetic_scaling.yml > output.log 2>&1)
+
+    ranks=$((ranks * 2))
+done
+
+python3 summarise.py ${mode}_*/phase_times.jsonl
@@ -0,0 +1,76 @@
+#!/usr/bin/env python3
+#
+# Usage:
+#  python3 summarise.py phase_times_file1.jsonl phase_times_file2.jsonl ...
+#
+# Description:
+# Prints the time per step, the parallel efficiency and where the time of the
+# steps went for a series of runs, as written by SWIFT to phase_times.jsonl.
+# Only the last run of each file is used. The efficiency is relative to the
+# run with the fewest ranks, assuming a strong scaling test if all the runs
+# have the same number of particles and a weak scaling one otherwise.
+
+import sys
+import json
+
+phases = ["rebuild", "tasks", "mpi_wait", "io", "other"]
+
+runs = []
+for file_name in sys.argv[1:]:
+    with open(file_name) as f:
+        lines = [line for line in f if line.strip()]
+    if lines:
+        runs.append(json.loads(lines[-1]))
+
+if not runs:
+    print("No runs found.")
+    sys.exit(1)
+
+runs.sort(key=lambda r: r["nr_nodes"] * r["nr_threads"])
+ref = runs[0]
+ref_cores = ref["nr_nodes"] * ref["nr_threads"]
+strong = all(r["total_nr_gparts"] == ref["total_nr_gparts"] for r in runs)
+
+print(
+    "%s scaling test, times per step in %s"
+    % ("Strong" if strong else "Weak", ref["time_unit"])
+)
+print(
+    "%6s %8s %14s %12s %10s"
+    % ("Ranks", "Threads", "Particles", "Time", "Efficiency")
+    + "".join(" %9s" % p for p in phases)
+    + " %12s" % "Imbalance"
+)
+
+for r in runs:
+    cores = r["nr_nodes"] * r["nr_threads"]
+    time = r["total"]["mean"] / r["steps"]
+    ref_time = ref["total"]["mean"] / ref["steps"]
+    if strong:
+        efficiency = ref_time * ref_cores / (time * cores)
+    else:
+        work = r["total_nr_gparts"] / cores
+        ref_work = ref["total_nr_gparts"] / ref_cores
+        efficiency = (ref_time / ref_work) / (time / work)
+
+    # Fraction of the time in each phase, and how unequal the task times are
+    total = r["total"]["mean"]
+    fractions = [
+        100.0 * r[p]["mean"] / total if total > 0 else 0.0 for p in phases
+    ]
+    imbalance = (
+        r["tasks"]["max"] / r["tasks"]["mean"] if r["tasks"]["mean"] > 0 else 1.0
+    )
+
+    print(
+        "%6d %8d %14d %12.3f %9.1f%%"
+        % (
+            r["nr_nodes"],
+            r["nr_threads"],
+            r["total_nr_gparts"],
+            time,
+            100.0 * efficiency,
+        )
+        + "".join(" %8.1f%%" % f for f in fractions)
+        + " %12.3f" % imbalance
+    )
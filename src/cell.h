@@ -27,6 +27,7 @@
 #include <config.h>
 
 /* Includes. */
+#include <float.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <string.h>
@@ -41,6 +42,8 @@
 #include "cell_stars.h"
 #include "ghost_stats.h"
 #include "kernel_hydro.h"
+#include "lock.h"
+#include "minmax.h"
 #include "multipole_struct.h"
 #include "part.h"
 #include "periodic.h"
@@ -98,6 +101,21 @@ struct cell_split_pair {
 };
 extern struct cell_split_pair cell_split_pairs[13];
 
+/**
+ * @brief Entry of the time-bin index of a leaf cell.
+ *
+ * The entries of a leaf are sorted by increasing time-bin, such that the
+ * particles active at any step are the first entries of the index.
+ */
+struct cell_bin_index_entry {
+
+  /*! Offset of the particle in the cell's particle array. */
+  int offset;
+
+  /*! Time-bin of the particle when the index was built. */
+  timebin_t time_bin;
+};
+
 /**
  * @brief Packed cell for information correct at rebuild time.
  *
@@ -533,6 +551,9 @@ void cell_pack_bpart_swallow(const struct cell *c,
                              struct black_holes_bpart_data *data);
 void cell_unpack_bpart_swallow(struct cell *c,
                                const struct black_holes_bpart_data *data);
+size_t cell_bh_swallow_buffer_size(const struct cell *c);
+void cell_pack_bh_swallow(const struct cell *c, void *buff);
+void cell_unpack_bh_swallow(struct cell *c, const void *buff);
 int cell_pack_tags(const struct cell *c, int *tags);
 int cell_unpack_tags(const int *tags, struct cell *c);
 int cell_pack_end_step(const struct cell *c, struct pcell_step *pcell);
@@ -541,6 +562,11 @@ void cell_pack_timebin(const struct cell *const c, timebin_t *const t);
 void cell_unpack_timebin(struct cell *const c, timebin_t *const t);
 int cell_pack_multipoles(struct cell *c, struct gravity_tensors *m);
 int cell_unpack_multipoles(struct cell *c, struct gravity_tensors *m);
+void cell_pack_gparts_compact(const struct cell *c,
+                              struct gpart_compact *pgparts);
+void cell_unpack_gparts_compact(struct cell *c,
+                                const struct gpart_compact *pgparts,
+                                integertime_t ti_current);
 int cell_pack_sf_counts(struct cell *c, struct pcell_sf *pcell);
 int cell_unpack_sf_counts(struct cell *c, struct pcell_sf *pcell);
 int cell_get_tree_size(struct cell *c);
@@ -554,6 +580,8 @@ void cell_unlink_foreign_particles(struct cell *c);
 int cell_count_parts_for_tasks(const struct cell *c);
 int cell_count_gparts_for_tasks(const struct cell *c);
 void cell_clean_links(struct cell *c, void *data);
+void cell_build_bin_index_parts(struct cell *c, const struct space *s);
+void cell_build_bin_index_gparts(struct cell *c, const struct space *s);
 void cell_make_multipoles(struct cell *c, integertime_t ti_current,
                           const struct gravity_props *const grav_props);
 void cell_check_multipole(struct cell *c,
@@ -626,6 +654,7 @@ void cell_activate_drift_sink(struct cell *c, struct scheduler *s);
 void cell_activate_drift_bpart(struct cell *c, struct scheduler *s);
 void cell_activate_sync_part(struct cell *c, struct scheduler *s);
 void cell_activate_rt_sorts(struct cell *c, int sid, struct scheduler *s);
+void cell_set_skip_rt_sort_flag_up(struct cell *c);
 void cell_activate_hydro_sorts(struct cell *c, int sid, struct scheduler *s);
 void cell_activate_stars_sorts(struct cell *c, int sid, struct scheduler *s);
 void cell_activate_limiter(struct cell *c, struct scheduler *s);
@@ -751,6 +780,81 @@ __attribute__((always_inline)) INLINE static double cell_min_dist2_same_size(
 
 /* Inlined functions (for speed). */
 
+/**
+ * @brief Number of entries of a time-bin index on a time-bin up to
+ * max_active_bin.
+ *
+ * @param index The (sorted) time-bin index.
+ * @param count The number of entries in the index.
+ * @param max_active_bin The largest active time-bin.
+ */
+__attribute__((always_inline)) INLINE static int cell_bin_index_count_active(
+    const struct cell_bin_index_entry *index, const int count,
+    const timebin_t max_active_bin) {
+
+  /* Find the first entry beyond the active bins */
+  int lo = 0, hi = count;
+  while (lo < hi) {
+    const int mid = (lo + hi) / 2;
+    if (index[mid].time_bin <= max_active_bin)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+/**
+ * @brief Get the #part of a leaf cell that may be active on a time-bin up to
+ * max_active_bin from its time-bin index.
+ *
+ * The particles listed can have been inhibited since the index was built, so
+ * the callers must still check their activity.
+ *
+ * @param c The leaf #cell.
+ * @param epoch The current space::bin_index_epoch.
+ * @param max_active_bin The largest active time-bin.
+ * @param index (return) The index entries to loop over.
+ *
+ * @return The number of entries to loop over or -1 if the cell has no
+ * valid index and all its particles must be scanned.
+ */
+__attribute__((always_inline)) INLINE static int
+cell_get_active_bin_index_parts(const struct cell *c, const int epoch,
+                                const timebin_t max_active_bin,
+                                const struct cell_bin_index_entry **index) {
+
+  if (epoch == 0 || c->hydro.bin_index_epoch != epoch) return -1;
+
+  *index = c->hydro.bin_index;
+  return cell_bin_index_count_active(c->hydro.bin_index,
+                                     c->hydro.bin_index_count, max_active_bin);
+}
+
+/**
+ * @brief Get the dark matter #gpart of a leaf cell that may be active on a
+ * time-bin up to max_active_bin from its time-bin index.
+ *
+ * @param c The leaf #cell.
+ * @param epoch The current space::bin_index_epoch.
+ * @param max_active_bin The largest active time-bin.
+ * @param index (return) The index entries to loop over.
+ *
+ * @return The number of entries to loop over or -1 if the cell has no
+ * valid index and all its particles must be scanned.
+ */
+__attribute__((always_inline)) INLINE static int
+cell_get_active_bin_index_gparts(const struct cell *c, const int epoch,
+                                 const timebin_t max_active_bin,
+                                 const struct cell_bin_index_entry **index) {
+
+  if (epoch == 0 || c->grav.bin_index_epoch != epoch) return -1;
+
+  *index = c->grav.bin_index;
+  return cell_bin_index_count_active(c->grav.bin_index,
+                                     c->grav.bin_index_count, max_active_bin);
+}
+
 /**
  * @brief Can a sub-pair hydro task recurse to a lower level based
  * on the status of the particles in the cell.
@@ -781,6 +885,152 @@ cell_can_recurse_in_self_hydro_task(const struct cell *c) {
   return c->split && (kernel_gamma * c->hydro.h_max_old < 0.5f * c->dmin);
 }
 
+/**
+ * @brief Reset a bounding box to the empty box.
+ *
+ * @param box_min The lower corner of the box.
+ * @param box_max The upper corner of the box.
+ */
+__attribute__((always_inline)) INLINE static void cell_bbox_init(
+    double box_min[3], double box_max[3]) {
+
+  for (int k = 0; k < 3; k++) {
+    box_min[k] = DBL_MAX;
+    box_max[k] = -DBL_MAX;
+  }
+}
+
+/**
+ * @brief Grow a bounding box to contain a position.
+ *
+ * @param box_min The lower corner of the box.
+ * @param box_max The upper corner of the box.
+ * @param x The position.
+ */
+__attribute__((always_inline)) INLINE static void cell_bbox_add(
+    double box_min[3], double box_max[3], const double x[3]) {
+
+  for (int k = 0; k < 3; k++) {
+    box_min[k] = min(box_min[k], x[k]);
+    box_max[k] = max(box_max[k], x[k]);
+  }
+}
+
+/**
+ * @brief Grow a bounding box to contain another box.
+ *
+ * @param box_min The lower corner of the box.
+ * @param box_max The upper corner of the box.
+ * @param other_min The lower corner of the box to add.
+ * @param other_max The upper corner of the box to add.
+ */
+__attribute__((always_inline)) INLINE static void cell_bbox_merge(
+    double box_min[3], double box_max[3], const double other_min[3],
+    const double other_max[3]) {
+
+  for (int k = 0; k < 3; k++) {
+    box_min[k] = min(box_min[k], other_min[k]);
+    box_max[k] = max(box_max[k], other_max[k]);
+  }
+}
+
+/**
+ * @brief Store the bounding boxes of the #part of a #cell.
+ *
+ * @param c The #cell.
+ * @param bbox_min The lower corner of the box of all the particles.
+ * @param bbox_max The upper corner of the box of all the particles.
+ * @param active_bbox_min The lower corner of the box of the active particles.
+ * @param active_bbox_max The upper corner of the box of the active particles.
+ * @param ti_current The time at which the boxes were computed.
+ */
+__attribute__((always_inline)) INLINE static void cell_hydro_set_bbox(
+    struct cell *c, const double bbox_min[3], const double bbox_max[3],
+    const double active_bbox_min[3], const double active_bbox_max[3],
+    const integertime_t ti_current) {
+
+  for (int k = 0; k < 3; k++) {
+    c->hydro.bbox_min[k] = bbox_min[k];
+    c->hydro.bbox_max[k] = bbox_max[k];
+    c->hydro.active_bbox_min[k] = active_bbox_min[k];
+    c->hydro.active_bbox_max[k] = active_bbox_max[k];
+  }
+  c->hydro.ti_bbox = ti_current;
+}
+
+/**
+ * @brief Are two bounding boxes closer than a given distance?
+ *
+ * @param a_min The lower corner of the first box.
+ * @param a_max The upper corner of the first box.
+ * @param shift The periodic shift to apply to the first box.
+ * @param b_min The lower corner of the second box.
+ * @param b_max The upper corner of the second box.
+ * @param range The distance.
+ */
+__attribute__((always_inline)) INLINE static int cell_bbox_within_range(
+    const double a_min[3], const double a_max[3], const double shift[3],
+    const double b_min[3], const double b_max[3], const double range) {
+
+  /* Empty boxes are not close to anything */
+  if (a_min[0] > a_max[0] || b_min[0] > b_max[0]) return 0;
+
+  double r2 = 0.;
+  for (int k = 0; k < 3; k++) {
+    const double d = max(a_min[k] + shift[k] - b_max[k],
+                         b_min[k] - a_max[k] - shift[k]);
+    if (d > 0.) r2 += d * d;
+  }
+  return r2 < range * range;
+}
+
+/**
+ * @brief Can any active #part of a pair of cells interact with a #part of the
+ * other cell?
+ *
+ * Uses the bounding boxes of the particles of both cells, which are computed
+ * when the cells are drifted. Cells whose boxes are not up to date (foreign
+ * cells or cells not drifted this step) are assumed to interact.
+ *
+ * In the non-symmetric loops (density, gradient), an active particle i only
+ * sees the particles within its own kernel; in the symmetric ones (force) it
+ * also sees the particles that have it in their kernel.
+ *
+ * @param ci The first #cell.
+ * @param cj The second #cell.
+ * @param shift The periodic shift to apply to the particles of ci.
+ * @param symmetric Is the interaction range set by both smoothing lengths?
+ * @param ti_current The current time.
+ */
+__attribute__((always_inline)) INLINE static int cell_hydro_pair_in_range(
+    const struct cell *ci, const struct cell *cj, const double shift[3],
+    const int symmetric, const integertime_t ti_current) {
+
+  if (ci->nodeID != engine_rank || cj->nodeID != engine_rank ||
+      ci->hydro.ti_bbox != ti_current || cj->hydro.ti_bbox != ti_current)
+    return 1;
+
+  /* The boxes are built from the positions in double precision while the
+   * interactions use single precision, hence the small safety margin. */
+  const double margin = 1.0001 * kernel_gamma;
+
+  /* Active particles of ci against all the particles of cj */
+  const float h_i = symmetric ? max(ci->hydro.h_max_active, cj->hydro.h_max)
+                              : ci->hydro.h_max_active;
+  if (cell_bbox_within_range(ci->hydro.active_bbox_min,
+                             ci->hydro.active_bbox_max, shift,
+                             cj->hydro.bbox_min, cj->hydro.bbox_max,
+                             margin * h_i))
+    return 1;
+
+  /* Active particles of cj against all the particles of ci */
+  const float h_j = symmetric ? max(cj->hydro.h_max_active, ci->hydro.h_max)
+                              : cj->hydro.h_max_active;
+  return cell_bbox_within_range(ci->hydro.bbox_min, ci->hydro.bbox_max, shift,
+                                cj->hydro.active_bbox_min,
+                                cj->hydro.active_bbox_max, margin * h_j);
+}
+
 /**
  * @brief Can a sub-pair star task recurse to a lower level based
  * on the status of the particles in the cell.
@@ -1456,4 +1706,49 @@ __attribute__((always_inline)) INLINE void cell_assign_cell_index(
 #endif
 }
 
+/**
+ * @brief Initialise the locks of a cell whose memory has just been zeroed.
+ *
+ * With locks for which a zeroed lock is a valid unlocked lock, there is
+ * nothing left to do.
+ *
+ * @param c The #cell.
+ */
+__attribute__((always_inline)) INLINE static void cell_init_locks(
+    struct cell *c) {
+
+#if !lock_zero_is_unlocked
+  if (lock_init(&c->hydro.lock) != 0 || lock_init(&c->grav.plock) != 0 ||
+      lock_init(&c->grav.mlock) != 0 || lock_init(&c->stars.lock) != 0 ||
+      lock_init(&c->sinks.lock) != 0 ||
+      lock_init(&c->sinks.sink_formation_lock) != 0 ||
+      lock_init(&c->black_holes.lock) != 0 ||
+      lock_init(&c->stars.star_formation_lock) != 0 ||
+      lock_init(&c->grav.star_formation_lock) != 0)
+    error("Failed to initialize cell spinlocks.");
+#endif
+}
+
+/**
+ * @brief Destroy the locks of a cell before it is recycled or re-used.
+ *
+ * This is a no-op for locks that do not need to be destroyed.
+ *
+ * @param c The #cell.
+ */
+__attribute__((always_inline)) INLINE static void cell_destroy_locks(
+    struct cell *c) {
+
+#if !lock_zero_is_unlocked
+  if (lock_destroy(&c->hydro.lock) != 0 || lock_destroy(&c->grav.plock) != 0 ||
+      lock_destroy(&c->grav.mlock) != 0 || lock_destroy(&c->stars.lock) != 0 ||
+      lock_destroy(&c->sinks.lock) != 0 ||
+      lock_destroy(&c->sinks.sink_formation_lock) != 0 ||
+      lock_destroy(&c->black_holes.lock) != 0 ||
+      lock_destroy(&c->grav.star_formation_lock) != 0 ||
+      lock_destroy(&c->stars.star_formation_lock) != 0)
+    error("Failed to destroy spinlocks.");
+#endif
+}
+
 #endif /* SWIFT_CELL_H */
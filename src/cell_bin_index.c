@@ -0,0 +1,155 @@
+/*******************************************************************************
+ * This file is part of SWIFT.
+ * Copyright (c) 2026 agent (agent@local)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+/* Config parameters. */
+#include <config.h>
+
+/* This object's header. */
+#include "cell.h"
+
+/* Local headers. */
+#include "error.h"
+#include "space.h"
+#include "timeline.h"
+
+/**
+ * @brief Is a #gpart part of the time-bin index of its cell?
+ *
+ * @param gp The #gpart.
+ */
+__attribute__((always_inline)) INLINE static int
+cell_bin_index_gpart_is_indexed(const struct gpart *gp) {
+  return gp->type == swift_type_dark_matter ||
+         gp->type == swift_type_dark_matter_background ||
+         gp->type == swift_type_neutrino;
+}
+
+/**
+ * @brief Build the time-bin index of the #part of a leaf cell.
+ *
+ * The particles are sorted by time-bin using a counting sort. Particles that
+ * are inhibited or not yet created are left out. Called once the particles
+ * have received their new time-step. The index stays valid until the next
+ * rebuild or until a particle of the cell changes time-bin outside of
+ * runner_do_timestep(), as done by the time-step limiter and synchronization.
+ *
+ * @param c The leaf #cell.
+ * @param s The #space.
+ */
+void cell_build_bin_index_parts(struct cell *c, const struct space *s) {
+
+  if (s->part_bin_index == NULL) return;
+
+#ifdef SWIFT_DEBUG_CHECKS
+  if (c->split) error("Building a time-bin index for a split cell!");
+#endif
+
+  const int count = c->hydro.count;
+  const struct part *parts = c->hydro.parts;
+  struct cell_bin_index_entry *index =
+      s->part_bin_index + (c->hydro.parts - s->parts);
+  int offsets[num_time_bins + 2] = {0};
+
+  /* Count the particles in each bin */
+  for (int k = 0; k < count; k++) {
+    const timebin_t bin = parts[k].time_bin;
+
+    /* A particle still waiting to be synchronized cannot be indexed */
+    if (bin < 0) {
+      c->hydro.bin_index_epoch = 0;
+      return;
+    }
+    if (bin <= num_time_bins) offsets[bin + 1]++;
+  }
+
+  /* Start of each bin in the index */
+  for (int b = 1; b < num_time_bins + 2; b++) offsets[b] += offsets[b - 1];
+  const int nr_entries = offsets[num_time_bins + 1];
+
+  /* Fill the index */
+  for (int k = 0; k < count; k++) {
+    const timebin_t bin = parts[k].time_bin;
+    if (bin > num_time_bins) continue;
+
+    struct cell_bin_index_entry *entry = &index[offsets[bin]++];
+    entry->offset = k;
+    entry->time_bin = bin;
+  }
+
+  c->hydro.bin_index = index;
+  c->hydro.bin_index_count = nr_entries;
+  c->hydro.bin_index_epoch = s->bin_index_epoch;
+}
+
+/**
+ * @brief Build the time-bin index of the dark matter and neutrino #gpart of a
+ * leaf cell.
+ *
+ * Only the #gpart without a baryonic counterpart are indexed since the others
+ * are integrated along with their counterpart.
+ *
+ * @param c The leaf #cell.
+ * @param s The #space.
+ */
+void cell_build_bin_index_gparts(struct cell *c, const struct space *s) {
+
+  if (s->gpart_bin_index == NULL) return;
+
+#ifdef SWIFT_DEBUG_CHECKS
+  if (c->split) error("Building a time-bin index for a split cell!");
+#endif
+
+  const int gcount = c->grav.count;
+  const struct gpart *gparts = c->grav.parts;
+  struct cell_bin_index_entry *index =
+      s->gpart_bin_index + (c->grav.parts - s->gparts);
+  int offsets[num_time_bins + 2] = {0};
+
+  /* Count the particles without counterpart in each bin */
+  for (int k = 0; k < gcount; k++) {
+    if (!cell_bin_index_gpart_is_indexed(&gparts[k])) continue;
+
+    const timebin_t bin = gparts[k].time_bin;
+    if (bin < 0) {
+      c->grav.bin_index_epoch = 0;
+      return;
+    }
+    if (bin <= num_time_bins) offsets[bin + 1]++;
+  }
+
+  /* Start of each bin in the index */
+  for (int b = 1; b < num_time_bins + 2; b++) offsets[b] += offsets[b - 1];
+  const int nr_entries = offsets[num_time_bins + 1];
+
+  /* Fill the index */
+  for (int k = 0; k < gcount; k++) {
+    if (!cell_bin_index_gpart_is_indexed(&gparts[k])) continue;
+
+    const timebin_t bin = gparts[k].time_bin;
+    if (bin > num_time_bins) continue;
+
+    struct cell_bin_index_entry *entry = &index[offsets[bin]++];
+    entry->offset = k;
+    entry->time_bin = bin;
+  }
+
+  c->grav.bin_index = index;
+  c->grav.bin_index_count = nr_entries;
+  c->grav.bin_index_epoch = s->bin_index_epoch;
+}
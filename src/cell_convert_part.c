@@ -196,6 +196,10 @@ struct spart *cell_add_spart(struct engine *e, struct cell *const c) {
 
     message("We ran out of free star particles!");
 
+    /* Record the shortfall so the next rebuild can give this cell more. */
+    if (e->s->cells_top_extras_usage != NULL)
+      e->s->cells_top_extras_usage[top - e->s->cells_top].sparts_failed++;
+
     /* Release the local lock before exiting. */
     if (lock_unlock(&top->stars.star_formation_lock) != 0)
       error("Failed to unlock the top-level cell.");
@@ -233,6 +237,10 @@ struct spart *cell_add_spart(struct engine *e, struct cell *const c) {
    * current cell*/
   cell_recursively_shift_sparts(top, progeny, /* main_branch=*/1);
 
+  /* Record the use of the slot for the next rebuild */
+  if (e->s->cells_top_extras_usage != NULL)
+    e->s->cells_top_extras_usage[top - e->s->cells_top].sparts_used++;
+
   /* Make sure the gravity will be recomputed for this particle in the next
    * step
    */
@@ -327,7 +335,11 @@ struct sink *cell_add_sink(struct engine *e, struct cell *const c) {
   /* Are there any extra particles left? */
   if (top->sinks.count == top->sinks.count_total) {
 
-    error("We ran out of free sink particles!");
+    message("We ran out of free sink particles!");
+
+    /* Record the shortfall so the next rebuild can give this cell more. */
+    if (e->s->cells_top_extras_usage != NULL)
+      e->s->cells_top_extras_usage[top - e->s->cells_top].sinks_failed++;
 
     /* Release the local lock before exiting. */
     if (lock_unlock(&top->sinks.sink_formation_lock) != 0)
@@ -359,6 +371,10 @@ struct sink *cell_add_sink(struct engine *e, struct cell *const c) {
       }
 #endif
       c->sinks.parts[i + 1].gpart->id_or_neg_offset--;
+
+      /* Follow the sink in the ID index */
+      id_index_update(&e->s->sinks_id_index, c->sinks.parts[i + 1].id,
+                      &c->sinks.parts[i + 1] - e->s->sinks);
     }
   }
 
@@ -366,6 +382,10 @@ struct sink *cell_add_sink(struct engine *e, struct cell *const c) {
    * current cell*/
   cell_recursively_shift_sinks(top, progeny, /* main_branch=*/1);
 
+  /* Record the use of the slot for the next rebuild */
+  if (e->s->cells_top_extras_usage != NULL)
+    e->s->cells_top_extras_usage[top - e->s->cells_top].sinks_used++;
+
   /* Make sure the gravity will be recomputed for this particle in the next
    * step
    */
@@ -464,6 +484,10 @@ struct gpart *cell_add_gpart(struct engine *e, struct cell *c) {
 
     message("We ran out of free gravity particles!");
 
+    /* Record the shortfall so the next rebuild can give this cell more. */
+    if (e->s->cells_top_extras_usage != NULL)
+      e->s->cells_top_extras_usage[top - e->s->cells_top].gparts_failed++;
+
     /* Release the local lock before exiting. */
     if (lock_unlock(&top->grav.star_formation_lock) != 0)
       error("Failed to unlock the top-level cell.");
@@ -505,6 +529,10 @@ struct gpart *cell_add_gpart(struct engine *e, struct cell *c) {
    * current cell*/
   cell_recursively_shift_gparts(top, progeny, /* main_branch=*/1);
 
+  /* Record the use of the slot for the next rebuild */
+  if (e->s->cells_top_extras_usage != NULL)
+    e->s->cells_top_extras_usage[top - e->s->cells_top].gparts_used++;
+
   /* Make sure the gravity will be recomputed for this particle in the next
    * step
    */
@@ -1033,6 +1061,9 @@ struct sink *cell_convert_part_to_sink(struct engine *e, struct cell *c,
   sp->id = p->id;
   gp->type = swift_type_sink;
 
+  /* Make the new sink findable by the swallowing loops */
+  id_index_insert(&e->s->sinks_id_index, sp->id, sp - e->s->sinks);
+
   /* Re-link things */
   sp->gpart = gp;
   gp->id_or_neg_offset = -(sp - e->s->sinks);
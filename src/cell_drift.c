@@ -159,6 +159,10 @@ void cell_drift_part(struct cell *c, const struct engine *e, int force,
   float dx_max_sort = 0.0f, dx2_max_sort = 0.f;
   float cell_h_max = 0.f;
   float cell_h_max_active = 0.f;
+  double bbox_min[3], bbox_max[3];
+  double active_bbox_min[3], active_bbox_max[3];
+  cell_bbox_init(bbox_min, bbox_max);
+  cell_bbox_init(active_bbox_min, active_bbox_max);
 
   /* Drift irrespective of cell flags? */
   force = (force || cell_get_flag(c, cell_flag_do_hydro_drift));
@@ -208,6 +212,15 @@ void cell_drift_part(struct cell *c, const struct engine *e, int force,
         dx_max_sort = max(dx_max_sort, cp->hydro.dx_max_sort);
         cell_h_max = max(cell_h_max, cp->hydro.h_max);
         cell_h_max_active = max(cell_h_max_active, cp->hydro.h_max_active);
+
+        /* Progeny not drifted now have no particle to interact this step */
+        if (cp->hydro.ti_bbox == ti_current) {
+          cell_bbox_merge(bbox_min, bbox_max, cp->hydro.bbox_min,
+                          cp->hydro.bbox_max);
+          cell_bbox_merge(active_bbox_min, active_bbox_max,
+                          cp->hydro.active_bbox_min,
+                          cp->hydro.active_bbox_max);
+        }
       }
     }
 
@@ -216,6 +229,8 @@ void cell_drift_part(struct cell *c, const struct engine *e, int force,
     c->hydro.h_max_active = cell_h_max_active;
     c->hydro.dx_max_part = dx_max;
     c->hydro.dx_max_sort = dx_max_sort;
+    cell_hydro_set_bbox(c, bbox_min, bbox_max, active_bbox_min,
+                        active_bbox_max, ti_current);
 
     /* Update the time of the last drift */
     c->hydro.ti_old_part = ti_current;
@@ -329,6 +344,9 @@ void cell_drift_part(struct cell *c, const struct engine *e, int force,
       /* Update the maximal smoothing length in the cell */
       cell_h_max = max(cell_h_max, p->h);
 
+      /* Update the extent of the particles in the cell */
+      cell_bbox_add(bbox_min, bbox_max, p->x);
+
       /* Mark the particle has not being swallowed */
       black_holes_mark_part_as_not_swallowed(&p->black_holes_data);
 
@@ -354,6 +372,7 @@ void cell_drift_part(struct cell *c, const struct engine *e, int force,
 
         /* Update the maximal active smoothing length in the cell */
         cell_h_max_active = max(cell_h_max_active, p->h);
+        cell_bbox_add(active_bbox_min, active_bbox_max, p->x);
       }
 
 #ifdef SWIFT_HYDRO_DENSITY_CHECKS
@@ -371,6 +390,8 @@ void cell_drift_part(struct cell *c, const struct engine *e, int force,
     c->hydro.h_max_active = cell_h_max_active;
     c->hydro.dx_max_part = dx_max;
     c->hydro.dx_max_sort = dx_max_sort;
+    cell_hydro_set_bbox(c, bbox_min, bbox_max, active_bbox_min,
+                        active_bbox_max, ti_current);
 
     /* Update the time of the last drift */
     c->hydro.ti_old_part = ti_current;
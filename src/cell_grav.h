@@ -28,6 +28,9 @@
 #include "lock.h"
 #include "timeline.h"
 
+/* Avoid cyclic inclusions */
+struct cell_bin_index_entry;
+
 /**
  * @brief Gravity-related cell variables.
  */
@@ -65,6 +68,9 @@ struct cell_grav {
   /*! Implicit task for the gravity initialisation */
   struct task *init_out;
 
+  /*! Indices of the dark matter #gpart of this leaf sorted by time-bin */
+  struct cell_bin_index_entry *bin_index;
+
   /*! Task computing long range non-periodic gravity interactions */
   struct task *long_range;
 
@@ -77,9 +83,6 @@ struct cell_grav {
   /*! The task to end the force calculation */
   struct task *end_force;
 
-  /*! Task for weighting neutrino particles */
-  struct task *neutrino_weight;
-
   /*! Minimum end of (integer) time step in this cell for gravity tasks. */
   integertime_t ti_end_min;
 
@@ -108,6 +111,12 @@ struct cell_grav {
   /*! Nr of #gpart this cell can hold after addition of new #gpart. */
   int count_total;
 
+  /*! Nr of entries in the time-bin index of this leaf. */
+  int bin_index_count;
+
+  /*! Value of space::bin_index_epoch when the time-bin index was built. */
+  int bin_index_epoch;
+
   /*! Number of #gpart updated in this cell. */
   int updated;
 
@@ -28,6 +28,9 @@
 #include "lock.h"
 #include "timeline.h"
 
+/* Avoid cyclic inclusions */
+struct cell_bin_index_entry;
+
 /**
  * @brief Hydro-related cell variables.
  */
@@ -124,6 +127,21 @@ struct cell_hydro {
     /*! Values of dx_max_sort before the drifts, used for sub-cell tasks. */
     float dx_max_sort_old;
 
+    /*! Lower corner of the bounding box of the #part in this cell. */
+    double bbox_min[3];
+
+    /*! Upper corner of the bounding box of the #part in this cell. */
+    double bbox_max[3];
+
+    /*! Lower corner of the bounding box of the active #part in this cell. */
+    double active_bbox_min[3];
+
+    /*! Upper corner of the bounding box of the active #part in this cell. */
+    double active_bbox_max[3];
+
+    /*! Last (integer) time the bounding boxes were computed. */
+    integertime_t ti_bbox;
+
     /*! Nr of #part this cell can hold after addition of new #part. */
     int count_total;
 
@@ -157,6 +175,15 @@ struct cell_hydro {
    */
   integertime_t ti_beg_max;
 
+  /*! Indices of the #part of this leaf sorted by time-bin. */
+  struct cell_bin_index_entry *bin_index;
+
+  /*! Nr of entries in the time-bin index of this leaf. */
+  int bin_index_count;
+
+  /*! Value of space::bin_index_epoch when the time-bin index was built. */
+  int bin_index_epoch;
+
   /*! Spin lock for various uses (#part case). */
   swift_lock_type lock;
 
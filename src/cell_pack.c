@@ -25,6 +25,9 @@
 /* This object's header. */
 #include "cell.h"
 
+/* Local headers. */
+#include "gravity.h"
+
 /**
  * @brief Pack the data of the given cell and all it's sub-cells.
  *
@@ -184,6 +187,54 @@ void cell_unpack_bpart_swallow(struct cell *c,
   }
 }
 
+/**
+ * @brief Size in bytes of the buffer holding the gas swallow and BH merger
+ * flags of a cell.
+ *
+ * @param c The #cell.
+ */
+size_t cell_bh_swallow_buffer_size(const struct cell *c) {
+
+  return c->hydro.count * sizeof(struct black_holes_part_data) +
+         c->black_holes.count * sizeof(struct black_holes_bpart_data);
+}
+
+/**
+ * @brief Pack the gas swallow flags followed by the BH merger flags of a
+ * cell such that they can be exchanged in a single message.
+ *
+ * @param c The #cell.
+ * @param buff The buffer of size cell_bh_swallow_buffer_size() to fill.
+ */
+void cell_pack_bh_swallow(const struct cell *c, void *buff) {
+
+  struct black_holes_part_data *part_data =
+      (struct black_holes_part_data *)buff;
+  struct black_holes_bpart_data *bpart_data =
+      (struct black_holes_bpart_data *)(part_data + c->hydro.count);
+
+  cell_pack_part_swallow(c, part_data);
+  cell_pack_bpart_swallow(c, bpart_data);
+}
+
+/**
+ * @brief Unpack the gas swallow and BH merger flags of a cell packed by
+ * cell_pack_bh_swallow().
+ *
+ * @param c The #cell.
+ * @param buff The received buffer.
+ */
+void cell_unpack_bh_swallow(struct cell *c, const void *buff) {
+
+  const struct black_holes_part_data *part_data =
+      (const struct black_holes_part_data *)buff;
+  const struct black_holes_bpart_data *bpart_data =
+      (const struct black_holes_bpart_data *)(part_data + c->hydro.count);
+
+  cell_unpack_part_swallow(c, part_data);
+  cell_unpack_bpart_swallow(c, bpart_data);
+}
+
 /**
  * @brief Unpack the data of a given cell and its sub-cells.
  *
@@ -523,6 +574,57 @@ int cell_unpack_multipoles(struct cell *restrict c,
 #endif
 }
 
+/**
+ * @brief Pack the #gpart of a cell needed by the gravity tasks of other nodes.
+ *
+ * The positions are stored in single precision relative to the top-level cell,
+ * which is known on both sides.
+ *
+ * @param c The #cell.
+ * @param pgparts (output) The compact #gpart we pack into.
+ */
+void cell_pack_gparts_compact(const struct cell *c,
+                              struct gpart_compact *pgparts) {
+#ifdef WITH_MPI
+
+  const double *loc = c->top->loc;
+  const struct gpart *gparts = c->grav.parts;
+
+  for (int k = 0; k < c->grav.count; k++)
+    gravity_pack_compact(&gparts[k], &pgparts[k], loc);
+
+#else
+  error("SWIFT was not compiled with MPI support.");
+#endif
+}
+
+/**
+ * @brief Unpack the compact #gpart of a foreign cell.
+ *
+ * @param c The #cell.
+ * @param pgparts The compact #gpart to unpack.
+ * @param ti_current The current time (for the drift checks).
+ */
+void cell_unpack_gparts_compact(struct cell *c,
+                                const struct gpart_compact *pgparts,
+                                const integertime_t ti_current) {
+#ifdef WITH_MPI
+
+  const double *loc = c->top->loc;
+  struct gpart *gparts = c->grav.parts;
+
+  for (int k = 0; k < c->grav.count; k++) {
+    gravity_unpack_compact(&gparts[k], &pgparts[k], loc);
+#ifdef SWIFT_DEBUG_CHECKS
+    gparts[k].ti_drift = ti_current;
+#endif
+  }
+
+#else
+  error("SWIFT was not compiled with MPI support.");
+#endif
+}
+
 /**
  * @brief Pack the counts for star formation of the given cell and all it's
  * sub-cells.
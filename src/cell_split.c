@@ -491,7 +491,7 @@ void cell_reorder_extra_parts(struct cell *c, const ptrdiff_t parts_offset) {
       }
 
 #ifdef SWIFT_DEBUG_CHECKS
-      if (first_not_extra >= count_real + space_extra_parts)
+      if (first_not_extra >= c->hydro.count_total)
         error("Looking for extra particles beyond this cell's range!");
 #endif
 
@@ -543,7 +543,7 @@ void cell_reorder_extra_sparts(struct cell *c, const ptrdiff_t sparts_offset) {
       }
 
 #ifdef SWIFT_DEBUG_CHECKS
-      if (first_not_extra >= count_real + space_extra_sparts)
+      if (first_not_extra >= c->stars.count_total)
         error("Looking for extra particles beyond this cell's range!");
 #endif
 
@@ -599,7 +599,7 @@ void cell_reorder_extra_sinks(struct cell *c, const ptrdiff_t sinks_offset) {
       }
 
 #ifdef SWIFT_DEBUG_CHECKS
-      if (first_not_extra >= count_real + space_extra_sinks)
+      if (first_not_extra >= c->sinks.count_total)
         error("Looking for extra particles beyond this cell's range!");
 #endif
 
@@ -656,7 +656,7 @@ void cell_reorder_extra_gparts(struct cell *c, struct part *parts,
       }
 
 #ifdef SWIFT_DEBUG_CHECKS
-      if (first_not_extra >= count_real + space_extra_gparts)
+      if (first_not_extra >= c->grav.count_total)
         error("Looking for extra particles beyond this cell's range!");
 #endif
 
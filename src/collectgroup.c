@@ -58,7 +58,10 @@ struct mpicollectgroup1 {
   struct star_formation_history sfh;
   float runtime;
   int flush_lightcone_maps;
+  int dump_task_trace;
   double deadtime;
+  double critical_path, work, idle_max;
+  double mpi_wait_offset, time_to_collect_max;
 #ifdef WITH_CSDS
   float csds_file_size_gb;
 #endif
@@ -138,7 +141,22 @@ void collectgroup1_apply(const struct collectgroup1 *grp1, struct engine *e) {
 
   e->runtime = grp1->runtime;
   e->flush_lightcone_maps = grp1->flush_lightcone_maps;
+
+  /* Dump the task trace if asked to or if the tasks of the step were slow */
+  e->task_trace_dump =
+      grp1->dump_task_trace ||
+      (e->task_trace_size > 0 && e->task_trace_dump_threshold > 0.f &&
+       grp1->time_to_collect_max > e->task_trace_dump_threshold);
+
   e->global_deadtime = grp1->deadtime;
+  e->global_critical_path = grp1->critical_path;
+  e->global_work = grp1->work;
+  e->global_idle_max = grp1->idle_max;
+
+  /* The MPI wait of a rank is its time in the rebuild-flag reduction plus the
+   * time it waited for the slowest rank to reach the end of the step. */
+  e->local_mpi_wait += grp1->time_to_collect_max - e->local_time_to_collect;
+  e->global_mpi_wait = grp1->mpi_wait_offset + grp1->time_to_collect_max;
 }
 
 /**
@@ -200,7 +218,13 @@ void collectgroup1_apply(const struct collectgroup1 *grp1, struct engine *e) {
  * @param sfh The star formation history logger
  * @param runtime The runtime of rank in hours.
  * @param flush_lightcone_maps Flag whether lightcone maps should be updated
+ * @param dump_task_trace Flag whether a dump of the task trace was requested
  * @param deadtime The deadtime of rank.
+ * @param critical_path The critical path of the tasks of rank.
+ * @param work The total run time of the tasks of rank.
+ * @param idle_max The longest time a runner of rank was idle.
+ * @param mpi_wait The time rank waited in the rebuild-flag reduction.
+ * @param time_to_collect The time rank took to reach the end of the step.
  * @param csds_file_size_gb The current size of the CSDS.
  */
 void collectgroup1_init(
@@ -216,7 +240,10 @@ void collectgroup1_init(
     integertime_t ti_black_holes_beg_max, int forcerebuild,
     long long total_nr_cells, long long total_nr_tasks, float tasks_per_cell,
     const struct star_formation_history sfh, float runtime,
-    int flush_lightcone_maps, double deadtime, float csds_file_size_gb) {
+    int flush_lightcone_maps, int dump_task_trace, double deadtime,
+    double critical_path,
+    double work, double idle_max, double mpi_wait, double time_to_collect,
+    float csds_file_size_gb) {
 
   grp1->updated = updated;
   grp1->g_updated = g_updated;
@@ -247,7 +274,13 @@ void collectgroup1_init(
   grp1->sfh = sfh;
   grp1->runtime = runtime;
   grp1->flush_lightcone_maps = flush_lightcone_maps;
+  grp1->dump_task_trace = dump_task_trace;
   grp1->deadtime = deadtime;
+  grp1->critical_path = critical_path;
+  grp1->work = work;
+  grp1->idle_max = idle_max;
+  grp1->mpi_wait_offset = mpi_wait - time_to_collect;
+  grp1->time_to_collect_max = time_to_collect;
 #ifdef WITH_CSDS
   grp1->csds_file_size_gb = csds_file_size_gb;
 #endif
@@ -296,7 +329,13 @@ void collectgroup1_reduce(struct collectgroup1 *grp1) {
   mpigrp11.sfh = grp1->sfh;
   mpigrp11.runtime = grp1->runtime;
   mpigrp11.flush_lightcone_maps = grp1->flush_lightcone_maps;
+  mpigrp11.dump_task_trace = grp1->dump_task_trace;
   mpigrp11.deadtime = grp1->deadtime;
+  mpigrp11.critical_path = grp1->critical_path;
+  mpigrp11.work = grp1->work;
+  mpigrp11.idle_max = grp1->idle_max;
+  mpigrp11.mpi_wait_offset = grp1->mpi_wait_offset;
+  mpigrp11.time_to_collect_max = grp1->time_to_collect_max;
 #ifdef WITH_CSDS
   mpigrp11.csds_file_size_gb = grp1->csds_file_size_gb;
 #endif
@@ -336,8 +375,14 @@ void collectgroup1_reduce(struct collectgroup1 *grp1) {
   grp1->sfh = mpigrp12.sfh;
   grp1->runtime = mpigrp12.runtime;
   grp1->flush_lightcone_maps = mpigrp12.flush_lightcone_maps;
+  grp1->dump_task_trace = mpigrp12.dump_task_trace;
 
   grp1->deadtime = mpigrp12.deadtime;
+  grp1->critical_path = mpigrp12.critical_path;
+  grp1->work = mpigrp12.work;
+  grp1->idle_max = mpigrp12.idle_max;
+  grp1->mpi_wait_offset = mpigrp12.mpi_wait_offset;
+  grp1->time_to_collect_max = mpigrp12.time_to_collect_max;
 #ifdef WITH_CSDS
   grp1->csds_file_size_gb = mpigrp12.csds_file_size_gb;
 #endif
@@ -420,9 +465,26 @@ static void doreduce1(struct mpicollectgroup1 *mpigrp11,
   if (mpigrp11->flush_lightcone_maps || mpigrp12->flush_lightcone_maps)
     mpigrp11->flush_lightcone_maps = 1;
 
+  /* The task trace is dumped on all ranks if any asked for it */
+  if (mpigrp11->dump_task_trace || mpigrp12->dump_task_trace)
+    mpigrp11->dump_task_trace = 1;
+
   /* Sum the deadtime. */
   mpigrp11->deadtime += mpigrp12->deadtime;
 
+  /* The critical path is that of the slowest rank, the work is summed. */
+  mpigrp11->critical_path =
+      max(mpigrp11->critical_path, mpigrp12->critical_path);
+  mpigrp11->work += mpigrp12->work;
+  mpigrp11->idle_max = max(mpigrp11->idle_max, mpigrp12->idle_max);
+
+  /* The ranks wait for the slowest one to reach the end of the step, so the
+   * longest MPI wait is the largest offset plus the latest arrival. */
+  mpigrp11->mpi_wait_offset =
+      max(mpigrp11->mpi_wait_offset, mpigrp12->mpi_wait_offset);
+  mpigrp11->time_to_collect_max =
+      max(mpigrp11->time_to_collect_max, mpigrp12->time_to_collect_max);
+
 #ifdef WITH_CSDS
   mpigrp11->csds_file_size_gb += mpigrp12->csds_file_size_gb;
 #endif
@@ -68,9 +68,20 @@ struct collectgroup1 {
   /* Flag to determine if lightcone maps should be updated this step */
   int flush_lightcone_maps;
 
+  /* Was a dump of the task trace requested? */
+  int dump_task_trace;
+
   /* Accumulated dead time during the step. */
   double deadtime;
 
+  /* Critical path, run time of the tasks and runner idle time of the step. */
+  double critical_path, work, idle_max;
+
+  /* Time spent in the rebuild-flag reduction minus the time taken to reach
+   * the end of the step (maximum over the ranks) and the latest time taken
+   * to reach the end of the step. */
+  double mpi_wait_offset, time_to_collect_max;
+
 #ifdef WITH_CSDS
   /* Filesize used by the CSDS (does not correspond to the allocated one) */
   float csds_file_size_gb;
@@ -92,7 +103,10 @@ void collectgroup1_init(
     integertime_t ti_black_holes_beg_max, int forcerebuild,
     long long total_nr_cells, long long total_nr_tasks, float tasks_per_cell,
     const struct star_formation_history sfh, float runtime,
-    int flush_lightcone_maps, double deadtime, float csds_file_size_gb);
+    int flush_lightcone_maps, int dump_task_trace, double deadtime,
+    double critical_path,
+    double work, double idle_max, double mpi_wait, double time_to_collect,
+    float csds_file_size_gb);
 void collectgroup1_reduce(struct collectgroup1 *grp1);
 #ifdef WITH_MPI
 void mpicollect_free_MPI_type(void);
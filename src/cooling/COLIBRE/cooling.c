@@ -45,6 +45,7 @@
 #include "hydro.h"
 #include "interpolate.h"
 #include "io_properties.h"
+#include "memuse_shared.h"
 #include "parser.h"
 #include "part.h"
 #include "physical_constants.h"
@@ -1615,21 +1616,21 @@ void cooling_clean(struct cooling_function_data *cooling) {
   free(cooling->MassFractions);
 
   /* Free the tables */
-  swift_free("cooling_table.Tcooling", cooling->table.Tcooling);
-  swift_free("cooling_table.Ucooling", cooling->table.Ucooling);
-  swift_free("cooling_table.Theating", cooling->table.Theating);
-  swift_free("cooling_table.Uheating", cooling->table.Uheating);
-  swift_free("cooling_table.Tefrac", cooling->table.Telectron_fraction);
-  swift_free("cooling_table.Uefrac", cooling->table.Uelectron_fraction);
-  swift_free("cooling_table.TfromU", cooling->table.T_from_U);
-  swift_free("cooling_table.UfromT", cooling->table.U_from_T);
-  swift_free("cooling_table.Umu", cooling->table.Umu);
-  swift_free("cooling_table.Tmu", cooling->table.Tmu);
-  swift_free("cooling_table.mueq", cooling->table.meanpartmass_Teq);
-  swift_free("cooling_table.Hfracs", cooling->table.logHfracs_Teq);
-  swift_free("cooling_table.Hfracs", cooling->table.logHfracs_all);
-  swift_free("cooling_table.Teq", cooling->table.logTeq);
-  swift_free("cooling_table.Peq", cooling->table.logPeq);
+  swift_shared_free("cooling_table.Tcooling", cooling->table.Tcooling);
+  swift_shared_free("cooling_table.Ucooling", cooling->table.Ucooling);
+  swift_shared_free("cooling_table.Theating", cooling->table.Theating);
+  swift_shared_free("cooling_table.Uheating", cooling->table.Uheating);
+  swift_shared_free("cooling_table.Tefrac", cooling->table.Telectron_fraction);
+  swift_shared_free("cooling_table.Uefrac", cooling->table.Uelectron_fraction);
+  swift_shared_free("cooling_table.TfromU", cooling->table.T_from_U);
+  swift_shared_free("cooling_table.UfromT", cooling->table.U_from_T);
+  swift_shared_free("cooling_table.Umu", cooling->table.Umu);
+  swift_shared_free("cooling_table.Tmu", cooling->table.Tmu);
+  swift_shared_free("cooling_table.mueq", cooling->table.meanpartmass_Teq);
+  swift_shared_free("cooling_table.Hfracs", cooling->table.logHfracs_Teq);
+  swift_shared_free("cooling_table.Hfracs", cooling->table.logHfracs_all);
+  swift_shared_free("cooling_table.Teq", cooling->table.logTeq);
+  swift_shared_free("cooling_table.Peq", cooling->table.logPeq);
 }
 
 /**
@@ -40,6 +40,7 @@
 #include "error.h"
 #include "exp10.h"
 #include "interpolate.h"
+#include "memuse_shared.h"
 
 /**
  * @brief Reads in COLIBRE cooling table header. Consists of tables
@@ -233,14 +234,29 @@ void read_cooling_header(struct cooling_function_data *cooling) {
 }
 
 /**
- * @brief Allocate space for cooling tables and read them
+ * @brief Allocate one of the cooling tables in memory shared by all the ranks
+ * of the node.
  *
- * @param cooling #cooling_function_data structure
+ * @param label The label of the table for the memory logger.
+ * @param count The number of elements in the table.
  */
-void read_cooling_tables(struct cooling_function_data *restrict cooling) {
+static float *allocate_cooling_table(const char *label, const size_t count) {
 
-  /* Abort early if we were not using the cooling module */
-  if (strcmp(cooling->cooling_table_path, "") == 0) return;
+  float *table = NULL;
+  if (swift_shared_memalign(label, (void **)&table, SWIFT_STRUCT_ALIGNMENT,
+                            count * sizeof(float)) != 0)
+    error("Failed to allocate %s array", label);
+  return table;
+}
+
+/**
+ * @brief Read the cooling tables from the file into the (already allocated)
+ * arrays and compute the derived quantities.
+ *
+ * @param cooling #cooling_function_data structure
+ */
+static void read_cooling_tables_data(
+    struct cooling_function_data *restrict cooling) {
 
 #ifdef HAVE_HDF5
   hid_t dataset;
@@ -252,17 +268,9 @@ void read_cooling_tables(struct cooling_function_data *restrict cooling) {
   if (tempfile_id < 0)
     error("unable to open file %s\n", cooling->cooling_table_path);
 
-  /* Allocate and read arrays to store cooling tables. */
+  /* Read the arrays storing the cooling tables. */
 
   /* Mean particle mass (temperature) */
-  if (swift_memalign("cooling_table.Tmu", (void **)&cooling->table.Tmu,
-                     SWIFT_STRUCT_ALIGNMENT,
-                     colibre_cooling_N_redshifts *
-                         colibre_cooling_N_temperature *
-                         colibre_cooling_N_metallicity *
-                         colibre_cooling_N_density * sizeof(float)) != 0)
-    error("Failed to allocate Tmu array\n");
-
   dataset = H5Dopen(tempfile_id, "/Tdep/MeanParticleMass", H5P_DEFAULT);
   status = H5Dread(dataset, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT,
                    cooling->table.Tmu);
@@ -271,14 +279,6 @@ void read_cooling_tables(struct cooling_function_data *restrict cooling) {
   if (status < 0) error("error closing mean particle mass dataset");
 
   /* Mean particle mass (internal energy) */
-  if (swift_memalign("cooling_table.Umu", (void **)&cooling->table.Umu,
-                     SWIFT_STRUCT_ALIGNMENT,
-                     colibre_cooling_N_redshifts *
-                         colibre_cooling_N_internalenergy *
-                         colibre_cooling_N_metallicity *
-                         colibre_cooling_N_density * sizeof(float)) != 0)
-    error("Failed to allocate Umu array\n");
-
   dataset = H5Dopen(tempfile_id, "/Udep/MeanParticleMass", H5P_DEFAULT);
   status = H5Dread(dataset, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT,
                    cooling->table.Umu);
@@ -287,14 +287,6 @@ void read_cooling_tables(struct cooling_function_data *restrict cooling) {
   if (status < 0) error("error closing mean particle mass dataset");
 
   /* Cooling (temperature) */
-  if (swift_memalign(
-          "cooling_table.Tcooling", (void **)&cooling->table.Tcooling,
-          SWIFT_STRUCT_ALIGNMENT,
-          colibre_cooling_N_redshifts * colibre_cooling_N_temperature *
-              colibre_cooling_N_metallicity * colibre_cooling_N_density *
-              colibre_cooling_N_cooltypes * sizeof(float)) != 0)
-    error("Failed to allocate Tcooling array\n");
-
   dataset = H5Dopen(tempfile_id, "/Tdep/Cooling", H5P_DEFAULT);
   status = H5Dread(dataset, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT,
                    cooling->table.Tcooling);
@@ -303,14 +295,6 @@ void read_cooling_tables(struct cooling_function_data *restrict cooling) {
   if (status < 0) error("error closing cooling dataset");
 
   /* Cooling (internal energy) */
-  if (swift_memalign(
-          "cooling_table.Ucooling", (void **)&cooling->table.Ucooling,
-          SWIFT_STRUCT_ALIGNMENT,
-          colibre_cooling_N_redshifts * colibre_cooling_N_internalenergy *
-              colibre_cooling_N_metallicity * colibre_cooling_N_density *
-              colibre_cooling_N_cooltypes * sizeof(float)) != 0)
-    error("Failed to allocate Ucooling array\n");
-
   dataset = H5Dopen(tempfile_id, "/Udep/Cooling", H5P_DEFAULT);
   status = H5Dread(dataset, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT,
                    cooling->table.Ucooling);
@@ -319,14 +303,6 @@ void read_cooling_tables(struct cooling_function_data *restrict cooling) {
   if (status < 0) error("error closing cooling dataset");
 
   /* Heating (temperature) */
-  if (swift_memalign(
-          "cooling_table.Theating", (void **)&cooling->table.Theating,
-          SWIFT_STRUCT_ALIGNMENT,
-          colibre_cooling_N_redshifts * colibre_cooling_N_temperature *
-              colibre_cooling_N_metallicity * colibre_cooling_N_density *
-              colibre_cooling_N_heattypes * sizeof(float)) != 0)
-    error("Failed to allocate Theating array\n");
-
   dataset = H5Dopen(tempfile_id, "/Tdep/Heating", H5P_DEFAULT);
   status = H5Dread(dataset, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT,
                    cooling->table.Theating);
@@ -335,14 +311,6 @@ void read_cooling_tables(struct cooling_function_data *restrict cooling) {
   if (status < 0) error("error closing cooling dataset");
 
   /* Heating (internal energy) */
-  if (swift_memalign(
-          "cooling_table.Uheating", (void **)&cooling->table.Uheating,
-          SWIFT_STRUCT_ALIGNMENT,
-          colibre_cooling_N_redshifts * colibre_cooling_N_internalenergy *
-              colibre_cooling_N_metallicity * colibre_cooling_N_density *
-              colibre_cooling_N_heattypes * sizeof(float)) != 0)
-    error("Failed to allocate Uheating array\n");
-
   dataset = H5Dopen(tempfile_id, "/Udep/Heating", H5P_DEFAULT);
   status = H5Dread(dataset, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT,
                    cooling->table.Uheating);
@@ -351,14 +319,6 @@ void read_cooling_tables(struct cooling_function_data *restrict cooling) {
   if (status < 0) error("error closing cooling dataset");
 
   /* Electron fraction (temperature) */
-  if (swift_memalign(
-          "cooling_table.Tefrac", (void **)&cooling->table.Telectron_fraction,
-          SWIFT_STRUCT_ALIGNMENT,
-          colibre_cooling_N_redshifts * colibre_cooling_N_temperature *
-              colibre_cooling_N_metallicity * colibre_cooling_N_density *
-              colibre_cooling_N_electrontypes * sizeof(float)) != 0)
-    error("Failed to allocate Telectron_fraction array\n");
-
   /* Dataset is named /Tdep/ElectronFractions in the published version of the
    * tables and for historical reasons /Tdep/ElectronFractionsVol in the version
    * used in the COLIBRE repository. Content is identical but we deal
@@ -379,14 +339,6 @@ void read_cooling_tables(struct cooling_function_data *restrict cooling) {
   if (status < 0) error("error closing cooling dataset");
 
   /* Electron fraction (internal energy) */
-  if (swift_memalign(
-          "cooling_table.Uefrac", (void **)&cooling->table.Uelectron_fraction,
-          SWIFT_STRUCT_ALIGNMENT,
-          colibre_cooling_N_redshifts * colibre_cooling_N_internalenergy *
-              colibre_cooling_N_metallicity * colibre_cooling_N_density *
-              colibre_cooling_N_electrontypes * sizeof(float)) != 0)
-    error("Failed to allocate Uelectron_fraction array\n");
-
   /* Dataset is named /Udep/ElectronFractions in the published version of the
    * tables and for historical reasons /Udep/ElectronFractionsVol in the version
    * used in the COLIBRE repository. Content is identical but we deal
@@ -407,14 +359,6 @@ void read_cooling_tables(struct cooling_function_data *restrict cooling) {
   if (status < 0) error("error closing cooling dataset");
 
   /* Internal energy from temperature */
-  if (swift_memalign("cooling_table.UfromT", (void **)&cooling->table.U_from_T,
-                     SWIFT_STRUCT_ALIGNMENT,
-                     colibre_cooling_N_redshifts *
-                         colibre_cooling_N_temperature *
-                         colibre_cooling_N_metallicity *
-                         colibre_cooling_N_density * sizeof(float)) != 0)
-    error("Failed to allocate U_from_T array\n");
-
   dataset = H5Dopen(tempfile_id, "/Tdep/U_from_T", H5P_DEFAULT);
   status = H5Dread(dataset, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT,
                    cooling->table.U_from_T);
@@ -423,14 +367,6 @@ void read_cooling_tables(struct cooling_function_data *restrict cooling) {
   if (status < 0) error("error closing cooling dataset");
 
   /* Temperature from interal energy */
-  if (swift_memalign("cooling_table.TfromU", (void **)&cooling->table.T_from_U,
-                     SWIFT_STRUCT_ALIGNMENT,
-                     colibre_cooling_N_redshifts *
-                         colibre_cooling_N_internalenergy *
-                         colibre_cooling_N_metallicity *
-                         colibre_cooling_N_density * sizeof(float)) != 0)
-    error("Failed to allocate T_from_U array\n");
-
   dataset = H5Dopen(tempfile_id, "/Udep/T_from_U", H5P_DEFAULT);
   status = H5Dread(dataset, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT,
                    cooling->table.T_from_U);
@@ -439,13 +375,6 @@ void read_cooling_tables(struct cooling_function_data *restrict cooling) {
   if (status < 0) error("error closing cooling dataset");
 
   /* Thermal equilibrium temperature */
-  if (swift_memalign("cooling_table.Teq", (void **)&cooling->table.logTeq,
-                     SWIFT_STRUCT_ALIGNMENT,
-                     colibre_cooling_N_redshifts *
-                         colibre_cooling_N_metallicity *
-                         colibre_cooling_N_density * sizeof(float)) != 0)
-    error("Failed to allocate logTeq array\n");
-
   dataset = H5Dopen(tempfile_id, "/ThermEq/Temperature", H5P_DEFAULT);
   status = H5Dread(dataset, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT,
                    cooling->table.logTeq);
@@ -454,14 +383,6 @@ void read_cooling_tables(struct cooling_function_data *restrict cooling) {
   if (status < 0) error("error closing logTeq dataset");
 
   /* Mean particle mass at thermal equilibrium temperature */
-  if (swift_memalign(
-          "cooling_table.mueq", (void **)&cooling->table.meanpartmass_Teq,
-          SWIFT_STRUCT_ALIGNMENT,
-
-          colibre_cooling_N_redshifts * colibre_cooling_N_metallicity *
-              colibre_cooling_N_density * sizeof(float)) != 0)
-    error("Failed to allocate mu array\n");
-
   dataset = H5Dopen(tempfile_id, "/ThermEq/MeanParticleMass", H5P_DEFAULT);
   status = H5Dread(dataset, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT,
                    cooling->table.meanpartmass_Teq);
@@ -470,13 +391,6 @@ void read_cooling_tables(struct cooling_function_data *restrict cooling) {
   if (status < 0) error("error closing mu dataset");
 
   /* Hydrogen fractions at thermal equilibirum temperature */
-  if (swift_memalign(
-          "cooling_table.Hfracs", (void **)&cooling->table.logHfracs_Teq,
-          SWIFT_STRUCT_ALIGNMENT,
-          colibre_cooling_N_redshifts * colibre_cooling_N_metallicity *
-              colibre_cooling_N_density * 3 * sizeof(float)) != 0)
-    error("Failed to allocate hydrogen fractions array\n");
-
   dataset = H5Dopen(tempfile_id, "/ThermEq/HydrogenFractionsVol", H5P_DEFAULT);
   status = H5Dread(dataset, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT,
                    cooling->table.logHfracs_Teq);
@@ -485,14 +399,6 @@ void read_cooling_tables(struct cooling_function_data *restrict cooling) {
   if (status < 0) error("error closing hydrogen fractions dataset");
 
   /* All hydrogen fractions */
-  if (swift_memalign(
-          "cooling_table.Hfracs", (void **)&cooling->table.logHfracs_all,
-          SWIFT_STRUCT_ALIGNMENT,
-          colibre_cooling_N_redshifts * colibre_cooling_N_temperature *
-              colibre_cooling_N_metallicity * colibre_cooling_N_density * 3 *
-              sizeof(float)) != 0)
-    error("Failed to allocate big hydrogen fractions array\n");
-
   dataset = H5Dopen(tempfile_id, "/Tdep/HydrogenFractionsVol", H5P_DEFAULT);
   status = H5Dread(dataset, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT,
                    cooling->table.logHfracs_all);
@@ -503,14 +409,6 @@ void read_cooling_tables(struct cooling_function_data *restrict cooling) {
   /* Close the file */
   H5Fclose(tempfile_id);
 
-  /* Pressure at thermal equilibrium temperature */
-  if (swift_memalign("cooling_table.Peq", (void **)&cooling->table.logPeq,
-                     SWIFT_STRUCT_ALIGNMENT,
-                     colibre_cooling_N_redshifts *
-                         colibre_cooling_N_metallicity *
-                         colibre_cooling_N_density * sizeof(float)) != 0)
-    error("Failed to allocate logPeq array\n");
-
   const float log10_kB_cgs = cooling->log10_kB_cgs;
 
   /* Compute the pressures at thermal eq. */
@@ -536,11 +434,59 @@ void read_cooling_tables(struct cooling_function_data *restrict cooling) {
     }
   }
 
-#ifdef SWIFT_DEBUG_CHECKS
-  message("Done reading in general cooling table");
-#endif
 
-#else
-  error("Need HDF5 to read cooling tables");
-#endif
+/**
+ * @brief Allocate space for cooling tables and read them
+ *
+ * The tables are shared by all the ranks of a node and only read by one of
+ * them.
+ *
+ * @param cooling #cooling_function_data structure
+ */
+void read_cooling_tables(struct cooling_function_data *restrict cooling) {
+
+  /* Abort early if we were not using the cooling module */
+  if (strcmp(cooling->cooling_table_path, "") == 0) return;
+
+  /* Size of the temperature, internal energy and equilibrium tables */
+  const size_t N_T = colibre_cooling_N_redshifts *
+                     colibre_cooling_N_temperature *
+                     colibre_cooling_N_metallicity * colibre_cooling_N_density;
+  const size_t N_U = colibre_cooling_N_redshifts *
+                     colibre_cooling_N_internalenergy *
+                     colibre_cooling_N_metallicity * colibre_cooling_N_density;
+  const size_t N_eq = colibre_cooling_N_redshifts *
+                      colibre_cooling_N_metallicity * colibre_cooling_N_density;
+
+  /* Allocate arrays to store cooling tables. */
+  cooling->table.Tmu = allocate_cooling_table("cooling_table.Tmu", N_T);
+  cooling->table.Umu = allocate_cooling_table("cooling_table.Umu", N_U);
+  cooling->table.Tcooling = allocate_cooling_table(
+      "cooling_table.Tcooling", N_T * colibre_cooling_N_cooltypes);
+  cooling->table.Ucooling = allocate_cooling_table(
+      "cooling_table.Ucooling", N_U * colibre_cooling_N_cooltypes);
+  cooling->table.Theating = allocate_cooling_table(
+      "cooling_table.Theating", N_T * colibre_cooling_N_heattypes);
+  cooling->table.Uheating = allocate_cooling_table(
+      "cooling_table.Uheating", N_U * colibre_cooling_N_heattypes);
+  cooling->table.Telectron_fraction = allocate_cooling_table(
+      "cooling_table.Tefrac", N_T * colibre_cooling_N_electrontypes);
+  cooling->table.Uelectron_fraction = allocate_cooling_table(
+      "cooling_table.Uefrac", N_U * colibre_cooling_N_electrontypes);
+  cooling->table.U_from_T = allocate_cooling_table("cooling_table.UfromT", N_T);
+  cooling->table.T_from_U = allocate_cooling_table("cooling_table.TfromU", N_U);
+  cooling->table.logTeq = allocate_cooling_table("cooling_table.Teq", N_eq);
+  cooling->table.meanpartmass_Teq =
+      allocate_cooling_table("cooling_table.mueq", N_eq);
+  cooling->table.logHfracs_Teq =
+      allocate_cooling_table("cooling_table.Hfracs", N_eq * 3);
+  cooling->table.logHfracs_all =
+      allocate_cooling_table("cooling_table.Hfracs", N_T * 3);
+  cooling->table.logPeq = allocate_cooling_table("cooling_table.Peq", N_eq);
+
+  /* Only one rank per node reads the tables */
+  if (swift_shared_is_writer()) read_cooling_tables_data(cooling);
+
+  /* Make the tables visible to all the ranks */
+  swift_shared_barrier();
 }
@@ -43,6 +43,7 @@
 #include "hydro.h"
 #include "interpolate.h"
 #include "io_properties.h"
+#include "memuse_shared.h"
 #include "parser.h"
 #include "part.h"
 #include "physical_constants.h"
@@ -156,33 +157,60 @@ void cooling_update(const struct cosmology *cosmo,
   }
 
   /* Do we already have the correct tables loaded? */
-  if (cooling->z_index == z_index) return;
+  if (cooling->z_index == z_index) {
 
-  /* Which table should we load ? */
-  if (z_index >= eagle_cooling_N_redshifts) {
+    /* Interpolate them to the new redshift if we use the fast mode */
+    if (cooling->use_collapsed_tables)
+      collapse_cooling_tables(cooling, redshift);
+    return;
+  }
 
-    if (z_index == eagle_cooling_N_redshifts + 1) {
+  /* The tables are shared by all the ranks of a node. Wait for everyone to be
+   * done with the old ones before they get overwritten. */
+  swift_shared_barrier();
 
-      /* Bewtween re-ionization and first table */
-      get_redshift_invariant_table(cooling, /* photodis=*/0);
+  /* Only one rank per node reads the tables */
+  if (swift_shared_is_writer()) {
 
-    } else {
+    /* Which table should we load ? */
+    if (z_index >= eagle_cooling_N_redshifts) {
 
-      /* Above re-ionization */
-      get_redshift_invariant_table(cooling, /* photodis=*/1);
-    }
+      if (z_index == eagle_cooling_N_redshifts + 1) {
 
-  } else {
+        /* Bewtween re-ionization and first table */
+        get_redshift_invariant_table(cooling, /* photodis=*/0);
+
+      } else {
+
+        /* Above re-ionization */
+        get_redshift_invariant_table(cooling, /* photodis=*/1);
+      }
+
+    } else {
 
-    /* Normal case: two tables bracketing the current z */
-    const int low_z_index = z_index;
-    const int high_z_index = z_index + 1;
+      /* Normal case: two tables bracketing the current z */
+      const int low_z_index = z_index;
+      const int high_z_index = z_index + 1;
 
-    get_cooling_table(cooling, low_z_index, high_z_index);
+      /* Use the table read in the background if we can */
+      if (!cooling->prefetch_tables ||
+          !get_prefetched_cooling_table(cooling, low_z_index, high_z_index))
+        get_cooling_table(cooling, low_z_index, high_z_index);
+
+      /* The redshift can only decrease. Start reading the next table now. */
+      if (cooling->prefetch_tables)
+        cooling_tables_prefetch_launch(cooling, low_z_index - 1);
+    }
   }
 
+  /* Make the new tables visible to all the ranks */
+  swift_shared_barrier();
+
   /* Store the currently loaded index */
   cooling->z_index = z_index;
+
+  /* Interpolate the new tables to the current redshift for the fast mode */
+  if (cooling->use_collapsed_tables) collapse_cooling_tables(cooling, redshift);
 }
 
 /**
@@ -343,60 +371,63 @@ INLINE static double bisection_iter(
 }
 
 /**
- * @brief Apply the cooling function to a particle.
+ * @brief Particle properties entering the implicit cooling solve.
  *
- * We want to compute u_new such that u_new = u_old + dt * du/dt(u_new, X),
- * where X stands for the metallicity, density and redshift. These are
- * kept constant.
- *
- * We first compute du/dt(u_old). If dt * du/dt(u_old) is small enough, we
- * use an explicit integration and use this as our solution.
- *
- * Otherwise, we try to find a solution to the implicit time-integration
- * problem. This leads to the root-finding problem:
- *
- * f(u_new) = u_new - u_old - dt * du/dt(u_new, X) = 0
- *
- * We first try a few Newton-Raphson iteration if it does not converge, we
- * revert to a bisection scheme.
- *
- * This is done by first bracketing the solution and then iterating
- * towards the solution by reducing the window down to a certain tolerance.
- * Note there is always at least one solution since
- * f(+inf) is < 0 and f(-inf) is > 0.
+ * These are fixed over the course of the solve and only depend on the
+ * particle's state at the start of the step.
+ */
+struct cooling_solve_data {
+
+  /*! Internal energy at the last kick step (internal units) */
+  float u_start;
+
+  /*! Internal energy at the end of the step without cooling (CGS) */
+  double u_0_cgs;
+
+  /*! Time-step (CGS) */
+  double dt_cgs;
+
+  /*! Hydrogen number density (CGS) */
+  double n_H_cgs;
+
+  /*! Factor converting a cooling rate into a rate of change of energy */
+  double ratefact_cgs;
+
+  /*! Cooling rate coming from He reionization (CGS) */
+  double Lambda_He_reion_cgs;
+
+  /*! Hydrogen number density index and offset in the tables */
+  int n_H_index;
+  float d_n_H;
+
+  /*! Helium fraction index and offset in the tables */
+  int He_index;
+  float d_He;
+
+  /*! Metal abundance ratios to solar */
+  float abundance_ratio[eagle_cooling_N_abundances];
+};
+
+/**
+ * @brief Computes the quantities entering the cooling solve of a particle.
  *
  * @param phys_const The physical constants in internal units.
  * @param us The internal system of units.
  * @param cosmo The current cosmological model.
  * @param hydro_properties the hydro_props struct
- * @param floor_props Properties of the entropy floor.
  * @param cooling The #cooling_function_data used in the run.
  * @param p Pointer to the particle data.
  * @param xp Pointer to the extended particle data.
  * @param dt The cooling time-step of this particle.
  * @param dt_therm The hydro time-step of this particle.
- * @param time The current time (since the Big Bang or start of the run) in
- * internal units.
+ * @param d (return) The quantities needed by the solver.
  */
-void cooling_cool_part(const struct phys_const *phys_const,
-                       const struct unit_system *us,
-                       const struct cosmology *cosmo,
-                       const struct hydro_props *hydro_properties,
-                       const struct entropy_floor_properties *floor_props,
-                       const struct cooling_function_data *cooling,
-                       struct part *restrict p, struct xpart *restrict xp,
-                       const float dt, const float dt_therm,
-                       const double time) {
-
-  /* No cooling happens over zero time */
-  if (dt == 0.) return;
-
-#ifdef SWIFT_DEBUG_CHECKS
-  if (cooling->Redshifts == NULL)
-    error(
-        "Cooling function has not been initialised. Did you forget the "
-        "--cooling runtime flag?");
-#endif
+INLINE static void cooling_prepare_solve(
+    const struct phys_const *phys_const, const struct unit_system *us,
+    const struct cosmology *cosmo, const struct hydro_props *hydro_properties,
+    const struct cooling_function_data *cooling, const struct part *restrict p,
+    const struct xpart *restrict xp, const float dt, const float dt_therm,
+    struct cooling_solve_data *restrict d) {
 
   /* Get internal energy at the last kick step */
   const float u_start = hydro_get_physical_internal_energy(p, xp, cosmo);
@@ -423,8 +454,7 @@ void cooling_cool_part(const struct phys_const *phys_const,
    * Note that we need to add S and Ca that are in the tables but not tracked
    * by the particles themselves.
    * The order is [H, He, C, N, O, Ne, Mg, Si, S, Ca, Fe] */
-  float abundance_ratio[eagle_cooling_N_abundances];
-  abundance_ratio_to_solar(p, cooling, abundance_ratio);
+  abundance_ratio_to_solar(p, cooling, d->abundance_ratio);
 
   /* Get the Hydrogen and Helium mass fractions */
   const float *const metal_fraction =
@@ -448,12 +478,10 @@ void cooling_cool_part(const struct phys_const *phys_const,
   /* compute hydrogen number density and helium fraction table indices and
    * offsets (These are fixed for any value of u, so no need to recompute them)
    */
-  int He_index, n_H_index;
-  float d_He, d_n_H;
-  get_index_1d(cooling->HeFrac, eagle_cooling_N_He_frac, HeFrac, &He_index,
-               &d_He);
-  get_index_1d(cooling->nH, eagle_cooling_N_density, log10(n_H_cgs), &n_H_index,
-               &d_n_H);
+  get_index_1d(cooling->HeFrac, eagle_cooling_N_He_frac, HeFrac, &d->He_index,
+               &d->d_He);
+  get_index_1d(cooling->nH, eagle_cooling_N_density, log10(n_H_cgs),
+               &d->n_H_index, &d->d_n_H);
 
   /* Start by computing the cooling (heating actually) rate from Helium
      re-ionization as this needs to be added on no matter what */
@@ -463,34 +491,55 @@ void cooling_cool_part(const struct phys_const *phys_const,
       eagle_helium_reionization_extraheat(cosmo->z, delta_redshift, cooling);
 
   /* Convert this into a rate */
-  const double Lambda_He_reion_cgs =
-      Helium_reion_heat_cgs / (dt_cgs * ratefact_cgs);
+  d->Lambda_He_reion_cgs = Helium_reion_heat_cgs / (dt_cgs * ratefact_cgs);
 
-  /* Let's compute the internal energy at the end of the step */
-  /* Initialise to the initial energy to appease compiler; this will never not
-     be overwritten. */
-  double u_final_cgs = u_0_cgs;
-
-  /* First try an explicit integration (note we ignore the derivative) */
-  const double LambdaNet_cgs =
-      Lambda_He_reion_cgs +
-      eagle_cooling_rate(log10(u_0_cgs), cosmo->z, n_H_cgs, abundance_ratio,
-                         n_H_index, d_n_H, He_index, d_He, cooling);
-
-  /* if cooling rate is small, take the explicit solution */
-  if (fabs(ratefact_cgs * LambdaNet_cgs * dt_cgs) <
-      explicit_tolerance * u_0_cgs) {
-
-    u_final_cgs = u_0_cgs + ratefact_cgs * LambdaNet_cgs * dt_cgs;
+  d->u_start = u_start;
+  d->u_0_cgs = u_0_cgs;
+  d->dt_cgs = dt_cgs;
+  d->n_H_cgs = n_H_cgs;
+  d->ratefact_cgs = ratefact_cgs;
+}
 
-  } else {
+/**
+ * @brief Computes the net cooling rate of a particle at a given energy.
+ *
+ * @param u_cgs The internal energy (CGS).
+ * @param redshift The current redshift.
+ * @param d The quantities describing the particle.
+ * @param cooling The #cooling_function_data used in the run.
+ */
+INLINE static double cooling_solve_rate(
+    const double u_cgs, const double redshift,
+    const struct cooling_solve_data *restrict d,
+    const struct cooling_function_data *cooling) {
+
+  return d->Lambda_He_reion_cgs +
+         eagle_cooling_rate(log10(u_cgs), redshift, d->n_H_cgs,
+                            d->abundance_ratio, d->n_H_index, d->d_n_H,
+                            d->He_index, d->d_He, cooling);
+}
 
-    /* Otherwise, go the bisection route. */
-    u_final_cgs =
-        bisection_iter(u_0_cgs, n_H_cgs, cosmo->z, n_H_index, d_n_H, He_index,
-                       d_He, Lambda_He_reion_cgs, ratefact_cgs, cooling,
-                       abundance_ratio, dt_cgs, p->id);
-  }
+/**
+ * @brief Applies the limits to the new energy of a particle and updates its
+ * energy derivative accordingly.
+ *
+ * @param cosmo The current cosmological model.
+ * @param hydro_properties the hydro_props struct
+ * @param floor_props Properties of the entropy floor.
+ * @param cooling The #cooling_function_data used in the run.
+ * @param p Pointer to the particle data.
+ * @param xp Pointer to the extended particle data.
+ * @param u_start Internal energy at the last kick step.
+ * @param u_final_cgs The energy at the end of the step (CGS).
+ * @param dt The cooling time-step of this particle.
+ * @param dt_therm The hydro time-step of this particle.
+ */
+INLINE static void cooling_finalise_solve(
+    const struct cosmology *cosmo, const struct hydro_props *hydro_properties,
+    const struct entropy_floor_properties *floor_props,
+    const struct cooling_function_data *cooling, struct part *restrict p,
+    struct xpart *restrict xp, const float u_start, const double u_final_cgs,
+    const float dt, const float dt_therm) {
 
   /* Convert back to internal units */
   double u_final = u_final_cgs * cooling->internal_energy_from_cgs;
@@ -522,6 +571,294 @@ void cooling_cool_part(const struct phys_const *phys_const,
   xp->cooling_data.radiated_energy -= hydro_get_mass(p) * cooling_du_dt * dt;
 }
 
+/**
+ * @brief Apply the cooling function to a particle.
+ *
+ * We want to compute u_new such that u_new = u_old + dt * du/dt(u_new, X),
+ * where X stands for the metallicity, density and redshift. These are
+ * kept constant.
+ *
+ * We first compute du/dt(u_old). If dt * du/dt(u_old) is small enough, we
+ * use an explicit integration and use this as our solution.
+ *
+ * Otherwise, we try to find a solution to the implicit time-integration
+ * problem. This leads to the root-finding problem:
+ *
+ * f(u_new) = u_new - u_old - dt * du/dt(u_new, X) = 0
+ *
+ * We first try a few Newton-Raphson iteration if it does not converge, we
+ * revert to a bisection scheme.
+ *
+ * This is done by first bracketing the solution and then iterating
+ * towards the solution by reducing the window down to a certain tolerance.
+ * Note there is always at least one solution since
+ * f(+inf) is < 0 and f(-inf) is > 0.
+ *
+ * @param phys_const The physical constants in internal units.
+ * @param us The internal system of units.
+ * @param cosmo The current cosmological model.
+ * @param hydro_properties the hydro_props struct
+ * @param floor_props Properties of the entropy floor.
+ * @param cooling The #cooling_function_data used in the run.
+ * @param p Pointer to the particle data.
+ * @param xp Pointer to the extended particle data.
+ * @param dt The cooling time-step of this particle.
+ * @param dt_therm The hydro time-step of this particle.
+ * @param time The current time (since the Big Bang or start of the run) in
+ * internal units.
+ */
+void cooling_cool_part(const struct phys_const *phys_const,
+                       const struct unit_system *us,
+                       const struct cosmology *cosmo,
+                       const struct hydro_props *hydro_properties,
+                       const struct entropy_floor_properties *floor_props,
+                       const struct cooling_function_data *cooling,
+                       struct part *restrict p, struct xpart *restrict xp,
+                       const float dt, const float dt_therm,
+                       const double time) {
+
+  /* No cooling happens over zero time */
+  if (dt == 0.) return;
+
+#ifdef SWIFT_DEBUG_CHECKS
+  if (cooling->Redshifts == NULL)
+    error(
+        "Cooling function has not been initialised. Did you forget the "
+        "--cooling runtime flag?");
+#endif
+
+  /* Collect everything we need to know about this particle */
+  struct cooling_solve_data d;
+  cooling_prepare_solve(phys_const, us, cosmo, hydro_properties, cooling, p,
+                        xp, dt, dt_therm, &d);
+
+  /* Let's compute the internal energy at the end of the step */
+  /* Initialise to the initial energy to appease compiler; this will never not
+     be overwritten. */
+  double u_final_cgs = d.u_0_cgs;
+
+  /* First try an explicit integration (note we ignore the derivative) */
+  const double LambdaNet_cgs =
+      cooling_solve_rate(d.u_0_cgs, cosmo->z, &d, cooling);
+
+  /* if cooling rate is small, take the explicit solution */
+  if (fabs(d.ratefact_cgs * LambdaNet_cgs * d.dt_cgs) <
+      explicit_tolerance * d.u_0_cgs) {
+
+    u_final_cgs = d.u_0_cgs + d.ratefact_cgs * LambdaNet_cgs * d.dt_cgs;
+
+  } else {
+
+    /* Otherwise, go the bisection route. */
+    u_final_cgs = bisection_iter(
+        d.u_0_cgs, d.n_H_cgs, cosmo->z, d.n_H_index, d.d_n_H, d.He_index,
+        d.d_He, d.Lambda_He_reion_cgs, d.ratefact_cgs, cooling,
+        d.abundance_ratio, d.dt_cgs, p->id);
+  }
+
+  /* Apply the limits and update the particle */
+  cooling_finalise_solve(cosmo, hydro_properties, floor_props, cooling, p, xp,
+                         d.u_start, u_final_cgs, dt, dt_therm);
+}
+
+/**
+ * @brief Apply the cooling function to a batch of particles.
+ *
+ * This solves exactly the same problem as cooling_cool_part() for each of the
+ * particles, with the same sequence of operations, and hence yields identical
+ * results. The bracketing and bisection iterations are however run in
+ * lockstep over all the particles of the batch that need an implicit solve:
+ * each iteration evaluates the rates of all the unconverged particles before
+ * updating all their brackets. This keeps the table accesses of similar
+ * particles together and lets the compiler vectorize the bracket updates.
+ *
+ * @param phys_const The physical constants in internal units.
+ * @param us The internal system of units.
+ * @param cosmo The current cosmological model.
+ * @param hydro_properties the hydro_props struct
+ * @param floor_props Properties of the entropy floor.
+ * @param cooling The #cooling_function_data used in the run.
+ * @param parts Pointers to the particles.
+ * @param xparts Pointers to the extended particles.
+ * @param dt The cooling time-steps of the particles.
+ * @param dt_therm The hydro time-steps of the particles.
+ * @param count The number of particles (at most #COOLING_BATCH_SIZE).
+ * @param time The current time (since the Big Bang or start of the run) in
+ * internal units.
+ */
+void cooling_cool_part_batch(
+    const struct phys_const *phys_const, const struct unit_system *us,
+    const struct cosmology *cosmo, const struct hydro_props *hydro_properties,
+    const struct entropy_floor_properties *floor_props,
+    const struct cooling_function_data *cooling, struct part **parts,
+    struct xpart **xparts, const float *dt, const float *dt_therm,
+    const int count, const double time) {
+
+#ifdef SWIFT_DEBUG_CHECKS
+  if (count > COOLING_BATCH_SIZE) error("Cooling batch is too large!");
+  if (cooling->Redshifts == NULL)
+    error(
+        "Cooling function has not been initialised. Did you forget the "
+        "--cooling runtime flag?");
+#endif
+
+  const double redshift = cosmo->z;
+
+  struct cooling_solve_data d[COOLING_BATCH_SIZE];
+
+  /* Solver state of each lane */
+  double u_lower_cgs[COOLING_BATCH_SIZE];
+  double u_upper_cgs[COOLING_BATCH_SIZE];
+  double u_next_cgs[COOLING_BATCH_SIZE];
+  double LambdaNet_cgs[COOLING_BATCH_SIZE];
+  double u_final_cgs[COOLING_BATCH_SIZE];
+  int is_cooling[COOLING_BATCH_SIZE];
+  int todo[COOLING_BATCH_SIZE];
+  int num_todo = 0;
+
+  /* Gather the particle properties and try the explicit solution */
+  for (int k = 0; k < count; k++) {
+
+    /* No cooling happens over zero time */
+    todo[k] = 0;
+    if (dt[k] == 0.) continue;
+
+    cooling_prepare_solve(phys_const, us, cosmo, hydro_properties, cooling,
+                          parts[k], xparts[k], dt[k], dt_therm[k], &d[k]);
+
+    /* First try an explicit integration (note we ignore the derivative) */
+    LambdaNet_cgs[k] =
+        cooling_solve_rate(d[k].u_0_cgs, redshift, &d[k], cooling);
+
+    /* if cooling rate is small, take the explicit solution */
+    if (fabs(d[k].ratefact_cgs * LambdaNet_cgs[k] * d[k].dt_cgs) <
+        explicit_tolerance * d[k].u_0_cgs) {
+
+      u_final_cgs[k] =
+          d[k].u_0_cgs + d[k].ratefact_cgs * LambdaNet_cgs[k] * d[k].dt_cgs;
+
+    } else {
+
+      /* Otherwise, go the bisection route. The rate we just computed is the
+       * first guess of the bracketing. */
+      todo[k] = 1;
+      num_todo++;
+      is_cooling[k] = LambdaNet_cgs[k] < 0.;
+      u_lower_cgs[k] = d[k].u_0_cgs / bracket_factor;
+      u_upper_cgs[k] = d[k].u_0_cgs * bracket_factor;
+      u_next_cgs[k] = is_cooling[k] ? u_lower_cgs[k] : u_upper_cgs[k];
+    }
+  }
+
+  /*************************************/
+  /* Let's try to bracket the solution */
+  /*************************************/
+
+  int active[COOLING_BATCH_SIZE];
+  for (int k = 0; k < count; k++) active[k] = todo[k];
+  int num_active = num_todo;
+
+  for (int i = 0; num_active > 0; i++) {
+
+    /* New rates at the trial end of the brackets */
+    for (int k = 0; k < count; k++)
+      if (active[k])
+        LambdaNet_cgs[k] =
+            cooling_solve_rate(u_next_cgs[k], redshift, &d[k], cooling);
+
+    /* Have we bracketed the solution? If not, move the brackets. */
+    for (int k = 0; k < count; k++) {
+      if (!active[k]) continue;
+
+      const double f = u_next_cgs[k] - d[k].u_0_cgs -
+                       LambdaNet_cgs[k] * d[k].ratefact_cgs * d[k].dt_cgs;
+      const int bracketed = is_cooling[k] ? !(f > 0.) : !(f < 0.);
+
+      if (bracketed || i >= bisection_max_iterations) {
+
+        if (i >= bisection_max_iterations)
+          error(
+              "particle %llu exceeded max iterations searching for bounds "
+              "when %s, u_ini_cgs %.5e n_H_cgs %.5e",
+              parts[k]->id, is_cooling[k] ? "cooling" : "heating",
+              d[k].u_0_cgs, d[k].n_H_cgs);
+
+        active[k] = 0;
+        num_active--;
+        continue;
+      }
+
+      if (is_cooling[k]) {
+        u_lower_cgs[k] /= bracket_factor;
+        u_upper_cgs[k] /= bracket_factor;
+        u_next_cgs[k] = u_lower_cgs[k];
+      } else {
+        u_lower_cgs[k] *= bracket_factor;
+        u_upper_cgs[k] *= bracket_factor;
+        u_next_cgs[k] = u_upper_cgs[k];
+      }
+    }
+  }
+
+  /********************************************/
+  /* We now have an upper and lower bound.    */
+  /* Let's iterate by reducing the bracketing */
+  /********************************************/
+
+  for (int i = 1; num_todo > 0; i++) {
+
+    /* New guesses and rates */
+    for (int k = 0; k < count; k++) {
+      if (!todo[k]) continue;
+      u_next_cgs[k] = 0.5 * (u_lower_cgs[k] + u_upper_cgs[k]);
+      LambdaNet_cgs[k] =
+          cooling_solve_rate(u_next_cgs[k], redshift, &d[k], cooling);
+
+#ifdef SWIFT_DEBUG_CHECKS
+      if (u_next_cgs[k] <= 0)
+        error(
+            "Got negative energy! u_next_cgs=%.5e u_upper=%.5e u_lower=%.5e "
+            "Lambda=%.5e",
+            u_next_cgs[k], u_upper_cgs[k], u_lower_cgs[k], LambdaNet_cgs[k]);
+#endif
+    }
+
+    /* Where do we go next? */
+    for (int k = 0; k < count; k++) {
+      if (!todo[k]) continue;
+
+      if (u_next_cgs[k] - d[k].u_0_cgs -
+              LambdaNet_cgs[k] * d[k].ratefact_cgs * d[k].dt_cgs >
+          0.0) {
+        u_upper_cgs[k] = u_next_cgs[k];
+      } else {
+        u_lower_cgs[k] = u_next_cgs[k];
+      }
+
+      /* Converged? */
+      if (!(fabs(u_upper_cgs[k] - u_lower_cgs[k]) / u_next_cgs[k] >
+                bisection_tolerance &&
+            i < bisection_max_iterations)) {
+
+        if (i >= bisection_max_iterations)
+          error("Particle id %llu failed to converge", parts[k]->id);
+
+        u_final_cgs[k] = u_upper_cgs[k];
+        todo[k] = 0;
+        num_todo--;
+      }
+    }
+  }
+
+  /* Apply the limits and update the particles */
+  for (int k = 0; k < count; k++) {
+    if (dt[k] == 0.) continue;
+    cooling_finalise_solve(cosmo, hydro_properties, floor_props, cooling,
+                           parts[k], xparts[k], d[k].u_start, u_final_cgs[k],
+                           dt[k], dt_therm[k]);
+  }
+}
+
 /**
  * @brief Computes the cooling time-step.
  *
@@ -956,6 +1293,14 @@ void cooling_init_backend(struct swift_params *parameter_file,
   cooling->S_over_Si_ratio_in_solar = parser_get_opt_param_float(
       parameter_file, "EAGLECooling:S_over_Si_in_solar", 1.f);
 
+  /* Optional parameter to read the tables ahead of time */
+  cooling->prefetch_tables = parser_get_opt_param_int(
+      parameter_file, "EAGLECooling:prefetch_tables", 0);
+
+  /* Are we using the tables interpolated to the current redshift? */
+  cooling->use_collapsed_tables = parser_get_opt_param_int(
+      parameter_file, "EAGLECooling:use_collapsed_tables", 0);
+
   /* Convert H_reion_heat_cgs and He_reion_heat_cgs to cgs
    * (units used internally by the cooling routines). This is done by
    * multiplying by 'eV/m_H' in internal units, then converting to cgs units.
@@ -980,6 +1325,7 @@ void cooling_init_backend(struct swift_params *parameter_file,
 
   /* Allocate space for cooling tables */
   allocate_cooling_tables(cooling);
+  if (cooling->use_collapsed_tables) allocate_collapsed_cooling_tables(cooling);
 
   /* Compute conversion factors */
   cooling->internal_energy_to_cgs =
@@ -1026,6 +1372,10 @@ void cooling_init_backend(struct swift_params *parameter_file,
   /* Set the redshift indices to invalid values */
   cooling->z_index = -10;
 
+  /* Nothing being read in the background yet */
+  cooling->prefetch.launched = 0;
+  cooling->prefetch.image = NULL;
+
   /* set previous_z_index and to last value of redshift table*/
   cooling->previous_z_index = eagle_cooling_N_redshifts - 2;
 }
@@ -1050,6 +1400,11 @@ void cooling_restore_tables(struct cooling_function_data *cooling,
 
   /* Allocate memory for the tables */
   allocate_cooling_tables(cooling);
+  if (cooling->use_collapsed_tables) allocate_collapsed_cooling_tables(cooling);
+
+  /* Nothing being read in the background */
+  cooling->prefetch.launched = 0;
+  cooling->prefetch.image = NULL;
 
   /* Force a re-read of the cooling tables */
   cooling->z_index = -10;
@@ -1076,6 +1431,9 @@ void cooling_print_backend(const struct cooling_function_data *cooling) {
  */
 void cooling_clean(struct cooling_function_data *cooling) {
 
+  /* Wait for any table being read in the background */
+  cooling_tables_prefetch_clean(cooling);
+
   /* Free the side arrays */
   swift_free("cooling", cooling->Redshifts);
   swift_free("cooling", cooling->nH);
@@ -1086,11 +1444,15 @@ void cooling_clean(struct cooling_function_data *cooling) {
   swift_free("cooling", cooling->SolarAbundances_inv);
 
   /* Free the tables */
-  swift_free("cooling-tables", cooling->table.metal_heating);
-  swift_free("cooling-tables", cooling->table.electron_abundance);
-  swift_free("cooling-tables", cooling->table.temperature);
-  swift_free("cooling-tables", cooling->table.H_plus_He_heating);
-  swift_free("cooling-tables", cooling->table.H_plus_He_electron_abundance);
+  swift_shared_free("cooling-tables", cooling->table.metal_heating);
+  swift_shared_free("cooling-tables", cooling->table.electron_abundance);
+  swift_shared_free("cooling-tables", cooling->table.temperature);
+  swift_shared_free("cooling-tables", cooling->table.H_plus_He_heating);
+  swift_shared_free("cooling-tables",
+                    cooling->table.H_plus_He_electron_abundance);
+
+  /* Free the tables interpolated to the current redshift */
+  if (cooling->use_collapsed_tables) free_collapsed_cooling_tables(cooling);
 }
 
 /**
@@ -1117,6 +1479,13 @@ void cooling_struct_dump(const struct cooling_function_data *cooling,
   cooling_copy.table.H_plus_He_electron_abundance = NULL;
   cooling_copy.table.temperature = NULL;
   cooling_copy.table.electron_abundance = NULL;
+  cooling_copy.prefetch.launched = 0;
+  cooling_copy.prefetch.image = NULL;
+  cooling_copy.collapsed.metal_heating = NULL;
+  cooling_copy.collapsed.H_plus_He_heating = NULL;
+  cooling_copy.collapsed.H_plus_He_electron_abundance = NULL;
+  cooling_copy.collapsed.temperature = NULL;
+  cooling_copy.collapsed.electron_abundance = NULL;
 
   restart_write_blocks((void *)&cooling_copy,
                        sizeof(struct cooling_function_data), 1, stream,
@@ -36,6 +36,10 @@ struct entropy_floor_properties;
 struct space;
 struct phys_const;
 
+/*! Maximal number of particles cooled together by cooling_cool_part_batch().
+ * Defining this tells the runners to use the batched solver. */
+#define COOLING_BATCH_SIZE 32
+
 void cooling_update(const struct cosmology *cosmo,
                     struct cooling_function_data *cooling, struct space *s);
 
@@ -48,6 +52,14 @@ void cooling_cool_part(const struct phys_const *phys_const,
                        struct part *restrict p, struct xpart *restrict xp,
                        const float dt, const float dt_therm, const double time);
 
+void cooling_cool_part_batch(
+    const struct phys_const *phys_const, const struct unit_system *us,
+    const struct cosmology *cosmo, const struct hydro_props *hydro_properties,
+    const struct entropy_floor_properties *floor_props,
+    const struct cooling_function_data *cooling, struct part **parts,
+    struct xpart **xparts, const float *dt, const float *dt_therm,
+    const int count, const double time);
+
 float cooling_timestep(const struct cooling_function_data *restrict cooling,
                        const struct phys_const *restrict phys_const,
                        const struct cosmology *restrict cosmo,
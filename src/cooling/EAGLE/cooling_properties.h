@@ -19,6 +19,10 @@
 #ifndef SWIFT_COOLING_PROPERTIES_EAGLE_H
 #define SWIFT_COOLING_PROPERTIES_EAGLE_H
 
+/* System includes. */
+#include <pthread.h>
+#include <stddef.h>
+
 #define eagle_table_path_name_length 500
 
 /**
@@ -42,6 +46,55 @@ struct cooling_tables {
   float *electron_abundance;
 };
 
+/**
+ * @brief Cooling tables interpolated to the current redshift.
+ *
+ * Used by the optional fast mode, where the solver interpolates in these
+ * lower-dimensional tables instead of the full ones.
+ */
+struct cooling_collapsed_tables {
+
+  /*! Metal-free heating rates [nH][He][T] */
+  float *H_plus_He_heating;
+
+  /*! Metal-free electron abundances [nH][He][T] */
+  float *H_plus_He_electron_abundance;
+
+  /*! Temperatures as a function of internal energy [nH][He][u] */
+  float *temperature;
+
+  /*! Solar electron abundances [nH][T] */
+  float *electron_abundance;
+
+  /*! Metal heating rates, all the elements stored together [nH][T][elem] */
+  float *metal_heating;
+};
+
+/**
+ * @brief Raw content of a cooling table file read in the background ahead of
+ * the time it is needed.
+ */
+struct cooling_tables_prefetch {
+
+  /*! The thread doing the reading */
+  pthread_t thread;
+
+  /*! Has a read been launched and not yet been collected? */
+  int launched;
+
+  /*! Index along the redshift axis of the table being read */
+  int z_index;
+
+  /*! Raw bytes of the file */
+  void *image;
+
+  /*! Size of the file in bytes */
+  size_t image_size;
+
+  /*! Name of the file being read */
+  char fname[eagle_table_path_name_length + 12];
+};
+
 /**
  * @brief Properties of the cooling function.
  */
@@ -127,6 +180,18 @@ struct cooling_function_data {
   /*! Index of the previous tables along the redshift index of the tables */
   int previous_z_index;
 
+  /*! Are we reading the next redshift table in the background? */
+  int prefetch_tables;
+
+  /*! Table being read in the background */
+  struct cooling_tables_prefetch prefetch;
+
+  /*! Are we using the tables collapsed to the current redshift? */
+  int use_collapsed_tables;
+
+  /*! Tables collapsed to the current redshift */
+  struct cooling_collapsed_tables collapsed;
+
   /*! Dummy temporary value to compile the new temporary (?) BH model */
   float dlogT_EOS;
 };
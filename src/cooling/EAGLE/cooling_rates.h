@@ -510,6 +510,132 @@ INLINE static double eagle_metal_cooling_rate(
   return Lambda_net;
 }
 
+/**
+ * @brief Computes the net cooling rate using the tables collapsed to the
+ * current redshift.
+ *
+ * Same as eagle_metal_cooling_rate() but without the redshift dimension. The
+ * metal-line contributions of all the elements are summed at the corners of
+ * the (nH, T) cell before being interpolated, which only needs one
+ * interpolation instead of one per element. The results agree with the full
+ * interpolation up to round-off.
+ *
+ * @param log10_u_cgs Log base 10 of internal energy per unit mass in CGS units.
+ * @param redshift The current redshift.
+ * @param n_H_cgs The Hydrogen number density in CGS units.
+ * @param solar_ratio Array of ratios of particle metal abundances
+ * to solar metal abundances
+ * @param n_H_index Particle hydrogen number density index
+ * @param d_n_H Particle hydrogen number density offset
+ * @param He_index Particle helium fraction index
+ * @param d_He Particle helium fraction offset
+ * @param cooling Cooling data structure
+ *
+ * @return The cooling rate
+ */
+INLINE static double eagle_collapsed_cooling_rate(
+    const double log10_u_cgs, const double redshift, const double n_H_cgs,
+    const float solar_ratio[eagle_cooling_N_abundances], const int n_H_index,
+    const float d_n_H, const int He_index, const float d_He,
+    const struct cooling_function_data *cooling) {
+
+  const struct cooling_collapsed_tables *table = &cooling->collapsed;
+
+  /* Get index of u along the internal energy axis */
+  int u_index;
+  float d_u;
+  get_index_1d(cooling->Therm, eagle_cooling_N_temperature, log10_u_cgs,
+               &u_index, &d_u);
+
+  /* Temperature */
+  double log_10_T = interpolation_3d(table->temperature,          /* */
+                                     n_H_index, He_index, u_index, /* */
+                                     d_n_H, d_He, d_u,             /* */
+                                     eagle_cooling_N_density,      /* */
+                                     eagle_cooling_N_He_frac,      /* */
+                                     eagle_cooling_N_temperature); /* */
+
+  /* Special case for temperatures below the start of the table */
+  if (u_index == 0 && d_u == 0.f) log_10_T += log10_u_cgs - cooling->Temp[0];
+
+  /* Get index along temperature dimension of the tables */
+  int T_index;
+  float d_T;
+  get_index_1d(cooling->Temp, eagle_cooling_N_temperature, log_10_T, &T_index,
+               &d_T);
+
+  /* Metal-free cooling */
+  const double Lambda_free =
+      interpolation_3d(table->H_plus_He_heating,   /* */
+                       n_H_index, He_index, T_index, /* */
+                       d_n_H, d_He, d_T,             /* */
+                       eagle_cooling_N_density,      /* */
+                       eagle_cooling_N_He_frac,      /* */
+                       eagle_cooling_N_temperature); /* */
+
+  /* Electron abundance */
+  const double H_plus_He_electron_abundance =
+      interpolation_3d(table->H_plus_He_electron_abundance, /* */
+                       n_H_index, He_index, T_index,        /* */
+                       d_n_H, d_He, d_T,                    /* */
+                       eagle_cooling_N_density,             /* */
+                       eagle_cooling_N_He_frac,             /* */
+                       eagle_cooling_N_temperature);        /* */
+
+  /* Compton cooling (*not* stored in the tables before re-ionisation) */
+  double Lambda_Compton = 0.;
+  if ((redshift > cooling->Redshifts[eagle_cooling_N_redshifts - 1]) ||
+      (redshift > cooling->H_reion_z)) {
+
+    const double T = exp10(log_10_T);
+
+    /* Note the minus sign */
+    Lambda_Compton -= eagle_Compton_cooling_rate(cooling, redshift, n_H_cgs, T,
+                                                 H_plus_He_electron_abundance);
+  }
+
+  /* Solar electron abundance */
+  const double solar_electron_abundance =
+      interpolation_2d(table->electron_abundance, /* */
+                       n_H_index, T_index,        /* */
+                       d_n_H, d_T,                /* */
+                       eagle_cooling_N_density,   /* */
+                       eagle_cooling_N_temperature);
+
+  const double electron_abundance_ratio =
+      H_plus_He_electron_abundance / solar_electron_abundance;
+
+  /* Metal-line cooling: sum the elements at the 4 corners of the cell. The
+   * rates of all the elements at a given (nH, T) are contiguous. */
+  float ratio[eagle_cooling_N_metal];
+  for (int elem = 0; elem < eagle_cooling_N_metal; elem++)
+    ratio[elem] = solar_ratio[elem + 2] > 0.f ? solar_ratio[elem + 2] : 0.f;
+
+  float corner[2][2];
+  for (int i = 0; i < 2; i++) {
+    for (int j = 0; j < 2; j++) {
+
+      const float *rates = &table->metal_heating[row_major_index_3d(
+          n_H_index + i, T_index + j, 0, eagle_cooling_N_density,
+          eagle_cooling_N_temperature, eagle_cooling_N_metal)];
+
+      float sum = 0.f;
+      for (int elem = 0; elem < eagle_cooling_N_metal; elem++)
+        sum += rates[elem] * ratio[elem];
+      corner[i][j] = sum;
+    }
+  }
+
+  const float t_n_H = 1.f - d_n_H;
+  const float t_T = 1.f - d_T;
+  const double Lambda_metal =
+      (t_n_H * t_T * corner[0][0] + t_n_H * d_T * corner[0][1] +
+       d_n_H * t_T * corner[1][0] + d_n_H * d_T * corner[1][1]) *
+      electron_abundance_ratio;
+
+  return Lambda_free + Lambda_Compton + Lambda_metal;
+}
+
 /**
  * @brief Wrapper function used to calculate cooling rate.
  * Table indices and offsets for redshift, hydrogen number density and
@@ -534,6 +660,12 @@ INLINE static double eagle_cooling_rate(
     const int n_H_index, const float d_n_H, const int He_index,
     const float d_He, const struct cooling_function_data *cooling) {
 
+  /* Fast mode using the tables interpolated to the current redshift? */
+  if (cooling->use_collapsed_tables)
+    return eagle_collapsed_cooling_rate(log10_u_cgs, redshift, n_H_cgs,
+                                        abundance_ratio, n_H_index, d_n_H,
+                                        He_index, d_He, cooling);
+
   return eagle_metal_cooling_rate(log10_u_cgs, redshift, n_H_cgs,
                                   abundance_ratio, n_H_index, d_n_H, He_index,
                                   d_He, cooling, /* element_lambda=*/NULL);
@@ -28,6 +28,8 @@
 /* System includes. */
 #include <hdf5.h>
 #include <math.h>
+#include <pthread.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -37,6 +39,7 @@
 #include "cooling_tables.h"
 #include "error.h"
 #include "interpolate.h"
+#include "memuse_shared.h"
 
 /**
  * @brief Names of the elements in the order they are stored in the files
@@ -316,43 +319,204 @@ void allocate_cooling_tables(struct cooling_function_data *restrict cooling) {
 
   /* Allocate arrays to store cooling tables. Arrays contain two tables of
    * cooling rates with one table being for the redshift above current redshift
-   * and one below. */
+   * and one below. These are shared by all the ranks of a node. */
 
-  if (swift_memalign("cooling-tables", (void **)&cooling->table.metal_heating,
-                     SWIFT_STRUCT_ALIGNMENT,
-                     eagle_cooling_N_loaded_redshifts *
-                         num_elements_metal_heating * sizeof(float)) != 0)
+  if (swift_shared_memalign(
+          "cooling-tables", (void **)&cooling->table.metal_heating,
+          SWIFT_STRUCT_ALIGNMENT,
+          eagle_cooling_N_loaded_redshifts * num_elements_metal_heating *
+              sizeof(float)) != 0)
     error("Failed to allocate metal_heating array");
 
-  if (swift_memalign("cooling-tables",
-                     (void **)&cooling->table.electron_abundance,
-                     SWIFT_STRUCT_ALIGNMENT,
-                     eagle_cooling_N_loaded_redshifts *
-                         num_elements_electron_abundance * sizeof(float)) != 0)
+  if (swift_shared_memalign(
+          "cooling-tables", (void **)&cooling->table.electron_abundance,
+          SWIFT_STRUCT_ALIGNMENT,
+          eagle_cooling_N_loaded_redshifts * num_elements_electron_abundance *
+              sizeof(float)) != 0)
     error("Failed to allocate electron_abundance array");
 
-  if (swift_memalign("cooling-tables", (void **)&cooling->table.temperature,
-                     SWIFT_STRUCT_ALIGNMENT,
-                     eagle_cooling_N_loaded_redshifts *
-                         num_elements_temperature * sizeof(float)) != 0)
+  if (swift_shared_memalign(
+          "cooling-tables", (void **)&cooling->table.temperature,
+          SWIFT_STRUCT_ALIGNMENT,
+          eagle_cooling_N_loaded_redshifts * num_elements_temperature *
+              sizeof(float)) != 0)
     error("Failed to allocate temperature array");
 
-  if (swift_memalign("cooling-tables",
-                     (void **)&cooling->table.H_plus_He_heating,
-                     SWIFT_STRUCT_ALIGNMENT,
-                     eagle_cooling_N_loaded_redshifts *
-                         num_elements_HpHe_heating * sizeof(float)) != 0)
+  if (swift_shared_memalign(
+          "cooling-tables", (void **)&cooling->table.H_plus_He_heating,
+          SWIFT_STRUCT_ALIGNMENT,
+          eagle_cooling_N_loaded_redshifts * num_elements_HpHe_heating *
+              sizeof(float)) != 0)
     error("Failed to allocate H_plus_He_heating array");
 
-  if (swift_memalign("cooling-tables",
-                     (void **)&cooling->table.H_plus_He_electron_abundance,
-                     SWIFT_STRUCT_ALIGNMENT,
-                     eagle_cooling_N_loaded_redshifts *
-                         num_elements_HpHe_electron_abundance *
-                         sizeof(float)) != 0)
+  if (swift_shared_memalign(
+          "cooling-tables",
+          (void **)&cooling->table.H_plus_He_electron_abundance,
+          SWIFT_STRUCT_ALIGNMENT,
+          eagle_cooling_N_loaded_redshifts *
+              num_elements_HpHe_electron_abundance * sizeof(float)) != 0)
     error("Failed to allocate H_plus_He_electron_abundance array");
 }
 
+/**
+ * @brief Allocate the tables collapsed to the current redshift.
+ *
+ * These are private to each rank as they are rebuilt at every step.
+ *
+ * @param cooling #cooling_function_data structure
+ */
+void allocate_collapsed_cooling_tables(
+    struct cooling_function_data *restrict cooling) {
+
+  struct cooling_collapsed_tables *collapsed = &cooling->collapsed;
+
+  if (swift_memalign("cooling-collapsed", (void **)&collapsed->metal_heating,
+                     SWIFT_STRUCT_ALIGNMENT,
+                     num_elements_metal_heating * sizeof(float)) != 0)
+    error("Failed to allocate collapsed metal_heating array");
+
+  if (swift_memalign("cooling-collapsed",
+                     (void **)&collapsed->electron_abundance,
+                     SWIFT_STRUCT_ALIGNMENT,
+                     num_elements_electron_abundance * sizeof(float)) != 0)
+    error("Failed to allocate collapsed electron_abundance array");
+
+  if (swift_memalign("cooling-collapsed", (void **)&collapsed->temperature,
+                     SWIFT_STRUCT_ALIGNMENT,
+                     num_elements_temperature * sizeof(float)) != 0)
+    error("Failed to allocate collapsed temperature array");
+
+  if (swift_memalign("cooling-collapsed",
+                     (void **)&collapsed->H_plus_He_heating,
+                     SWIFT_STRUCT_ALIGNMENT,
+                     num_elements_HpHe_heating * sizeof(float)) != 0)
+    error("Failed to allocate collapsed H_plus_He_heating array");
+
+  if (swift_memalign("cooling-collapsed",
+                     (void **)&collapsed->H_plus_He_electron_abundance,
+                     SWIFT_STRUCT_ALIGNMENT,
+                     num_elements_HpHe_electron_abundance * sizeof(float)) !=
+      0)
+    error("Failed to allocate collapsed H_plus_He_electron_abundance array");
+}
+
+/**
+ * @brief Free the tables collapsed to the current redshift.
+ *
+ * @param cooling #cooling_function_data structure
+ */
+void free_collapsed_cooling_tables(
+    struct cooling_function_data *restrict cooling) {
+
+  struct cooling_collapsed_tables *collapsed = &cooling->collapsed;
+
+  swift_free("cooling-collapsed", collapsed->metal_heating);
+  swift_free("cooling-collapsed", collapsed->electron_abundance);
+  swift_free("cooling-collapsed", collapsed->temperature);
+  swift_free("cooling-collapsed", collapsed->H_plus_He_heating);
+  swift_free("cooling-collapsed", collapsed->H_plus_He_electron_abundance);
+  collapsed->metal_heating = NULL;
+  collapsed->electron_abundance = NULL;
+  collapsed->temperature = NULL;
+  collapsed->H_plus_He_heating = NULL;
+  collapsed->H_plus_He_electron_abundance = NULL;
+}
+
+/**
+ * @brief Interpolate the currently loaded tables to the current redshift.
+ *
+ * The H + He and electron abundance tables keep their layout minus the
+ * redshift axis. The metal heating rates are re-ordered such that the rates
+ * of all the elements at a given (nH, T) are contiguous in memory.
+ *
+ * Must be called after cooling->dz has been updated for the current redshift.
+ *
+ * @param cooling #cooling_function_data structure
+ * @param redshift The current redshift.
+ */
+void collapse_cooling_tables(struct cooling_function_data *restrict cooling,
+                             const float redshift) {
+
+  const struct cooling_tables *table = &cooling->table;
+  struct cooling_collapsed_tables *collapsed = &cooling->collapsed;
+
+  /* Above the last redshift, only one redshift-invariant table is loaded */
+  if (redshift > cooling->Redshifts[eagle_cooling_N_redshifts - 1]) {
+
+    memcpy(collapsed->H_plus_He_heating, table->H_plus_He_heating,
+           num_elements_HpHe_heating * sizeof(float));
+    memcpy(collapsed->H_plus_He_electron_abundance,
+           table->H_plus_He_electron_abundance,
+           num_elements_HpHe_electron_abundance * sizeof(float));
+    memcpy(collapsed->temperature, table->temperature,
+           num_elements_temperature * sizeof(float));
+    memcpy(collapsed->electron_abundance, table->electron_abundance,
+           num_elements_electron_abundance * sizeof(float));
+
+    for (int elem = 0; elem < eagle_cooling_N_metal; elem++) {
+      for (int i = 0; i < eagle_cooling_N_density; i++) {
+        for (int j = 0; j < eagle_cooling_N_temperature; j++) {
+          collapsed->metal_heating[row_major_index_3d(
+              i, j, elem, eagle_cooling_N_density, eagle_cooling_N_temperature,
+              eagle_cooling_N_metal)] =
+              table->metal_heating[row_major_index_3d(
+                  elem, i, j, eagle_cooling_N_metal, eagle_cooling_N_density,
+                  eagle_cooling_N_temperature)];
+        }
+      }
+    }
+
+    return;
+  }
+
+  /* Linear interpolation between the two tables bracketing the redshift */
+  const float dz = cooling->dz;
+  const float tz = 1.f - dz;
+
+  for (size_t i = 0; i < num_elements_HpHe_heating; i++) {
+    collapsed->H_plus_He_heating[i] =
+        tz * table->H_plus_He_heating[i] +
+        dz * table->H_plus_He_heating[i + num_elements_HpHe_heating];
+  }
+
+  for (size_t i = 0; i < num_elements_HpHe_electron_abundance; i++) {
+    collapsed->H_plus_He_electron_abundance[i] =
+        tz * table->H_plus_He_electron_abundance[i] +
+        dz * table->H_plus_He_electron_abundance
+                 [i + num_elements_HpHe_electron_abundance];
+  }
+
+  for (size_t i = 0; i < num_elements_temperature; i++) {
+    collapsed->temperature[i] =
+        tz * table->temperature[i] +
+        dz * table->temperature[i + num_elements_temperature];
+  }
+
+  for (size_t i = 0; i < num_elements_electron_abundance; i++) {
+    collapsed->electron_abundance[i] =
+        tz * table->electron_abundance[i] +
+        dz * table->electron_abundance[i + num_elements_electron_abundance];
+  }
+
+  for (int elem = 0; elem < eagle_cooling_N_metal; elem++) {
+    for (int i = 0; i < eagle_cooling_N_density; i++) {
+      for (int j = 0; j < eagle_cooling_N_temperature; j++) {
+        collapsed->metal_heating[row_major_index_3d(
+            i, j, elem, eagle_cooling_N_density, eagle_cooling_N_temperature,
+            eagle_cooling_N_metal)] =
+            tz * table->metal_heating[row_major_index_4d(
+                     elem, 0, i, j, eagle_cooling_N_metal,
+                     eagle_cooling_N_loaded_redshifts, eagle_cooling_N_density,
+                     eagle_cooling_N_temperature)] +
+            dz * table->metal_heating[row_major_index_4d(
+                     elem, 1, i, j, eagle_cooling_N_metal,
+                     eagle_cooling_N_loaded_redshifts, eagle_cooling_N_density,
+                     eagle_cooling_N_temperature)];
+      }
+    }
+  }
+}
+
 /**
  * @brief Get the redshift invariant table of cooling rates (before reionization
  * at redshift ~9) Reads in table of cooling rates and electron abundances due
@@ -556,6 +720,213 @@ void get_redshift_invariant_table(
 #endif
 }
 
+/**
+ * @brief Temporary buffers used to read one redshift slice of the tables
+ * before they get transposed into the internal layout.
+ */
+struct cooling_tables_read_buffers {
+  float *net_cooling_rate;
+  float *electron_abundance;
+  float *temperature;
+  float *he_net_cooling_rate;
+  float *he_electron_abundance;
+};
+
+/**
+ * @brief Allocate the temporary buffers used to read one redshift slice.
+ *
+ * @param buf The #cooling_tables_read_buffers to fill.
+ */
+static void cooling_tables_read_buffers_allocate(
+    struct cooling_tables_read_buffers *buf) {
+
+  if (swift_memalign("cooling-temp", (void **)&buf->net_cooling_rate,
+                     SWIFT_STRUCT_ALIGNMENT,
+                     num_elements_cooling_rate * sizeof(float)) != 0)
+    error("Failed to allocate net_cooling_rate array");
+  if (swift_memalign("cooling-temp", (void **)&buf->electron_abundance,
+                     SWIFT_STRUCT_ALIGNMENT,
+                     num_elements_electron_abundance * sizeof(float)) != 0)
+    error("Failed to allocate electron_abundance array");
+  if (swift_memalign("cooling-temp", (void **)&buf->temperature,
+                     SWIFT_STRUCT_ALIGNMENT,
+                     num_elements_temperature * sizeof(float)) != 0)
+    error("Failed to allocate temperature array");
+  if (swift_memalign("cooling-temp", (void **)&buf->he_net_cooling_rate,
+                     SWIFT_STRUCT_ALIGNMENT,
+                     num_elements_HpHe_heating * sizeof(float)) != 0)
+    error("Failed to allocate he_net_cooling_rate array");
+  if (swift_memalign("cooling-temp", (void **)&buf->he_electron_abundance,
+                     SWIFT_STRUCT_ALIGNMENT,
+                     num_elements_HpHe_electron_abundance * sizeof(float)) != 0)
+    error("Failed to allocate he_electron_abundance array");
+}
+
+/**
+ * @brief Free the temporary buffers used to read one redshift slice.
+ *
+ * @param buf The #cooling_tables_read_buffers to free.
+ */
+static void cooling_tables_read_buffers_free(
+    struct cooling_tables_read_buffers *buf) {
+
+  swift_free("cooling-temp", buf->net_cooling_rate);
+  swift_free("cooling-temp", buf->electron_abundance);
+  swift_free("cooling-temp", buf->temperature);
+  swift_free("cooling-temp", buf->he_net_cooling_rate);
+  swift_free("cooling-temp", buf->he_electron_abundance);
+}
+
+#ifdef HAVE_HDF5
+
+/**
+ * @brief Read the content of one redshift-dependent table file and store it
+ * in the slice local_z_index of the loaded tables.
+ *
+ * @param file_id The (already opened) HDF5 file to read from.
+ * @param table The #cooling_tables to fill.
+ * @param local_z_index Index along the redshift dimension of the loaded
+ * tables.
+ * @param buf Temporary buffers used for the reading.
+ */
+static void read_cooling_table_slice(
+    const hid_t file_id, struct cooling_tables *restrict table,
+    const int local_z_index, const struct cooling_tables_read_buffers *buf) {
+
+#ifdef SWIFT_DEBUG_CHECKS
+  if (local_z_index >= eagle_cooling_N_loaded_redshifts)
+    error("Reading invalid number of tables along z axis.");
+#endif
+
+  char set_name[64];
+
+  /* read in cooling rates due to metals */
+  for (int specs = 0; specs < eagle_cooling_N_metal; specs++) {
+
+    sprintf(set_name, "/%s/Net_Cooling", eagle_tables_element_names[specs]);
+    hid_t dataset = H5Dopen(file_id, set_name, H5P_DEFAULT);
+    herr_t status = H5Dread(dataset, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL,
+                            H5P_DEFAULT, buf->net_cooling_rate);
+    if (status < 0) error("error reading metal cooling rate table");
+    status = H5Dclose(dataset);
+    if (status < 0) error("error closing cooling dataset");
+
+    /* Transpose from order tables are stored in (temperature, nH)
+     * to (metal species, redshift, nH, temperature) where fastest
+     * varying index is on right. Tables contain cooling rates but we
+     * want rate of change of internal energy, hence minus sign. */
+    for (int i = 0; i < eagle_cooling_N_density; i++) {
+      for (int j = 0; j < eagle_cooling_N_temperature; j++) {
+
+        /* Index in the HDF5 table */
+        const int hdf5_index = row_major_index_2d(
+            j, i, eagle_cooling_N_temperature, eagle_cooling_N_density);
+
+        /* Index in the internal table */
+        const int internal_index = row_major_index_4d(
+            specs, local_z_index, i, j, eagle_cooling_N_metal,
+            eagle_cooling_N_loaded_redshifts, eagle_cooling_N_density,
+            eagle_cooling_N_temperature);
+
+        /* Change the sign and transpose */
+        table->metal_heating[internal_index] =
+            -buf->net_cooling_rate[hdf5_index];
+      }
+    }
+  }
+
+  /* read in cooling rates due to H + He */
+  strcpy(set_name, "/Metal_free/Net_Cooling");
+  hid_t dataset = H5Dopen(file_id, set_name, H5P_DEFAULT);
+  herr_t status = H5Dread(dataset, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL,
+                          H5P_DEFAULT, buf->he_net_cooling_rate);
+  if (status < 0) error("error reading metal free cooling rate table");
+  status = H5Dclose(dataset);
+  if (status < 0) error("error closing cooling dataset");
+
+  /* read in Temperature */
+  strcpy(set_name, "/Metal_free/Temperature/Temperature");
+  dataset = H5Dopen(file_id, set_name, H5P_DEFAULT);
+  status = H5Dread(dataset, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT,
+                   buf->temperature);
+  if (status < 0) error("error reading temperature table");
+  status = H5Dclose(dataset);
+  if (status < 0) error("error closing cooling dataset");
+
+  /* Read in H + He electron abundance */
+  strcpy(set_name, "/Metal_free/Electron_density_over_n_h");
+  dataset = H5Dopen(file_id, set_name, H5P_DEFAULT);
+  status = H5Dread(dataset, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT,
+                   buf->he_electron_abundance);
+  if (status < 0) error("error reading electron density table");
+  status = H5Dclose(dataset);
+  if (status < 0) error("error closing cooling dataset");
+
+  /* Transpose from order tables are stored in (helium fraction, temperature,
+   * nH) to (redshift, nH, helium fraction, temperature) where fastest
+   * varying index is on right. */
+  for (int i = 0; i < eagle_cooling_N_He_frac; i++) {
+    for (int j = 0; j < eagle_cooling_N_temperature; j++) {
+      for (int k = 0; k < eagle_cooling_N_density; k++) {
+
+        /* Index in the HDF5 table */
+        const int hdf5_index = row_major_index_3d(
+            i, j, k, eagle_cooling_N_He_frac, eagle_cooling_N_temperature,
+            eagle_cooling_N_density);
+
+        /* Index in the internal table */
+        const int internal_index = row_major_index_4d(
+            local_z_index, k, i, j, eagle_cooling_N_loaded_redshifts,
+            eagle_cooling_N_density, eagle_cooling_N_He_frac,
+            eagle_cooling_N_temperature);
+
+        /* Change the sign and transpose */
+        table->H_plus_He_heating[internal_index] =
+            -buf->he_net_cooling_rate[hdf5_index];
+
+        /* Convert to log T and transpose */
+        table->temperature[internal_index] =
+            log10(buf->temperature[hdf5_index]);
+
+        /* Just transpose */
+        table->H_plus_He_electron_abundance[internal_index] =
+            buf->he_electron_abundance[hdf5_index];
+      }
+    }
+  }
+
+  /* read in electron densities due to metals */
+  strcpy(set_name, "/Solar/Electron_density_over_n_h");
+  dataset = H5Dopen(file_id, set_name, H5P_DEFAULT);
+  status = H5Dread(dataset, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT,
+                   buf->electron_abundance);
+  if (status < 0) error("error reading solar electron density table");
+  status = H5Dclose(dataset);
+  if (status < 0) error("error closing cooling dataset");
+
+  /* Transpose from order tables are stored in (temperature, nH) to
+   * (redshift, nH, temperature) where fastest varying index is on right. */
+  for (int i = 0; i < eagle_cooling_N_temperature; i++) {
+    for (int j = 0; j < eagle_cooling_N_density; j++) {
+
+      /* Index in the HDF5 table */
+      const int hdf5_index = row_major_index_2d(
+          i, j, eagle_cooling_N_temperature, eagle_cooling_N_density);
+
+      /* Index in the internal table */
+      const int internal_index = row_major_index_3d(
+          local_z_index, j, i, eagle_cooling_N_loaded_redshifts,
+          eagle_cooling_N_density, eagle_cooling_N_temperature);
+
+      /* Just transpose */
+      table->electron_abundance[internal_index] =
+          buf->electron_abundance[hdf5_index];
+    }
+  }
+}
+
+#endif /* HAVE_HDF5 */
+
 /**
  * @brief Get redshift dependent table of cooling rates.
  * Reads in table of cooling rates and electron abundances due to
@@ -576,34 +947,9 @@ void get_cooling_table(struct cooling_function_data *restrict cooling,
 
 #ifdef HAVE_HDF5
 
-  /* Temporary tables */
-  float *net_cooling_rate = NULL;
-  float *electron_abundance = NULL;
-  float *temperature = NULL;
-  float *he_net_cooling_rate = NULL;
-  float *he_electron_abundance = NULL;
-
   /* Allocate arrays for reading in cooling tables.  */
-  if (swift_memalign("cooling-temp", (void **)&net_cooling_rate,
-                     SWIFT_STRUCT_ALIGNMENT,
-                     num_elements_cooling_rate * sizeof(float)) != 0)
-    error("Failed to allocate net_cooling_rate array");
-  if (swift_memalign("cooling-temp", (void **)&electron_abundance,
-                     SWIFT_STRUCT_ALIGNMENT,
-                     num_elements_electron_abundance * sizeof(float)) != 0)
-    error("Failed to allocate electron_abundance array");
-  if (swift_memalign("cooling-temp", (void **)&temperature,
-                     SWIFT_STRUCT_ALIGNMENT,
-                     num_elements_temperature * sizeof(float)) != 0)
-    error("Failed to allocate temperature array");
-  if (swift_memalign("cooling-temp", (void **)&he_net_cooling_rate,
-                     SWIFT_STRUCT_ALIGNMENT,
-                     num_elements_HpHe_heating * sizeof(float)) != 0)
-    error("Failed to allocate he_net_cooling_rate array");
-  if (swift_memalign("cooling-temp", (void **)&he_electron_abundance,
-                     SWIFT_STRUCT_ALIGNMENT,
-                     num_elements_HpHe_electron_abundance * sizeof(float)) != 0)
-    error("Failed to allocate he_electron_abundance array");
+  struct cooling_tables_read_buffers buf;
+  cooling_tables_read_buffers_allocate(&buf);
 
   /* Read in tables, transpose so that values for indices which vary most are
    * adjacent. Repeat for redshift above and redshift below current value.  */
@@ -612,11 +958,6 @@ void get_cooling_table(struct cooling_function_data *restrict cooling,
     /* Index along redhsift dimension for the subset of tables we read */
     const int local_z_index = z_index - low_z_index;
 
-#ifdef SWIFT_DEBUG_CHECKS
-    if (local_z_index >= eagle_cooling_N_loaded_redshifts)
-      error("Reading invalid number of tables along z axis.");
-#endif
-
     /* Open table for this redshift index */
     char fname[eagle_table_path_name_length + 12];
     sprintf(fname, "%sz_%1.3f.hdf5", cooling->cooling_table_path,
@@ -627,147 +968,214 @@ void get_cooling_table(struct cooling_function_data *restrict cooling,
     hid_t file_id = H5Fopen(fname, H5F_ACC_RDONLY, H5P_DEFAULT);
     if (file_id < 0) error("unable to open file %s", fname);
 
-    char set_name[64];
+    read_cooling_table_slice(file_id, &cooling->table, local_z_index, &buf);
 
-    /* read in cooling rates due to metals */
-    for (int specs = 0; specs < eagle_cooling_N_metal; specs++) {
+    herr_t status = H5Fclose(file_id);
+    if (status < 0) error("error closing file");
+  }
 
-      sprintf(set_name, "/%s/Net_Cooling", eagle_tables_element_names[specs]);
-      hid_t dataset = H5Dopen(file_id, set_name, H5P_DEFAULT);
-      herr_t status = H5Dread(dataset, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL,
-                              H5P_DEFAULT, net_cooling_rate);
-      if (status < 0) error("error reading metal cooling rate table");
-      status = H5Dclose(dataset);
-      if (status < 0) error("error closing cooling dataset");
+  cooling_tables_read_buffers_free(&buf);
 
-      /* Transpose from order tables are stored in (temperature, nH)
-       * to (metal species, redshift, nH, temperature) where fastest
-       * varying index is on right. Tables contain cooling rates but we
-       * want rate of change of internal energy, hence minus sign. */
-      for (int i = 0; i < eagle_cooling_N_density; i++) {
-        for (int j = 0; j < eagle_cooling_N_temperature; j++) {
+#ifdef SWIFT_DEBUG_CHECKS
+  message("Done reading in general cooling table");
+#endif
 
-          /* Index in the HDF5 table */
-          const int hdf5_index = row_major_index_2d(
-              j, i, eagle_cooling_N_temperature, eagle_cooling_N_density);
+#else
+  error("Need HDF5 to read cooling tables");
+#endif
+}
 
-          /* Index in the internal table */
-          const int internal_index = row_major_index_4d(
-              specs, local_z_index, i, j, eagle_cooling_N_metal,
-              eagle_cooling_N_loaded_redshifts, eagle_cooling_N_density,
-              eagle_cooling_N_temperature);
+/**
+ * @brief Body of the background thread reading a cooling table file.
+ *
+ * The whole file is read into memory as a raw array of bytes. No HDF5
+ * call is made here as the library may not be thread-safe; the image is
+ * decoded on the main thread in get_prefetched_cooling_table().
+ *
+ * @param arg The #cooling_tables_prefetch to fill.
+ */
+static void *cooling_tables_prefetch_read(void *arg) {
 
-          /* Change the sign and transpose */
-          cooling->table.metal_heating[internal_index] =
-              -net_cooling_rate[hdf5_index];
-        }
-      }
-    }
+  struct cooling_tables_prefetch *pf = (struct cooling_tables_prefetch *)arg;
 
-    /* read in cooling rates due to H + He */
-    strcpy(set_name, "/Metal_free/Net_Cooling");
-    hid_t dataset = H5Dopen(file_id, set_name, H5P_DEFAULT);
-    herr_t status = H5Dread(dataset, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL,
-                            H5P_DEFAULT, he_net_cooling_rate);
-    if (status < 0) error("error reading metal free cooling rate table");
-    status = H5Dclose(dataset);
-    if (status < 0) error("error closing cooling dataset");
+  FILE *file = fopen(pf->fname, "rb");
+  if (file == NULL) error("Unable to open file %s", pf->fname);
 
-    /* read in Temperature */
-    strcpy(set_name, "/Metal_free/Temperature/Temperature");
-    dataset = H5Dopen(file_id, set_name, H5P_DEFAULT);
-    status = H5Dread(dataset, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT,
-                     temperature);
-    if (status < 0) error("error reading temperature table");
-    status = H5Dclose(dataset);
-    if (status < 0) error("error closing cooling dataset");
+  if (fseek(file, 0, SEEK_END) != 0) error("Unable to seek in %s", pf->fname);
+  const long size = ftell(file);
+  if (size <= 0) error("Invalid size for file %s", pf->fname);
+  rewind(file);
 
-    /* Read in H + He electron abundance */
-    strcpy(set_name, "/Metal_free/Electron_density_over_n_h");
-    dataset = H5Dopen(file_id, set_name, H5P_DEFAULT);
-    status = H5Dread(dataset, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT,
-                     he_electron_abundance);
-    if (status < 0) error("error reading electron density table");
-    status = H5Dclose(dataset);
-    if (status < 0) error("error closing cooling dataset");
+  pf->image = swift_malloc("cooling-prefetch", size);
+  if (pf->image == NULL) error("Failed to allocate cooling table image");
 
-    /* Transpose from order tables are stored in (helium fraction, temperature,
-     * nH) to (redshift, nH, helium fraction, temperature) where fastest
-     * varying index is on right. */
-    for (int i = 0; i < eagle_cooling_N_He_frac; i++) {
-      for (int j = 0; j < eagle_cooling_N_temperature; j++) {
-        for (int k = 0; k < eagle_cooling_N_density; k++) {
-
-          /* Index in the HDF5 table */
-          const int hdf5_index = row_major_index_3d(
-              i, j, k, eagle_cooling_N_He_frac, eagle_cooling_N_temperature,
-              eagle_cooling_N_density);
-
-          /* Index in the internal table */
-          const int internal_index = row_major_index_4d(
-              local_z_index, k, i, j, eagle_cooling_N_loaded_redshifts,
-              eagle_cooling_N_density, eagle_cooling_N_He_frac,
-              eagle_cooling_N_temperature);
-
-          /* Change the sign and transpose */
-          cooling->table.H_plus_He_heating[internal_index] =
-              -he_net_cooling_rate[hdf5_index];
-
-          /* Convert to log T and transpose */
-          cooling->table.temperature[internal_index] =
-              log10(temperature[hdf5_index]);
-
-          /* Just transpose */
-          cooling->table.H_plus_He_electron_abundance[internal_index] =
-              he_electron_abundance[hdf5_index];
-        }
-      }
-    }
+  if (fread(pf->image, 1, size, file) != (size_t)size)
+    error("Failed to read file %s", pf->fname);
+  fclose(file);
 
-    /* read in electron densities due to metals */
-    strcpy(set_name, "/Solar/Electron_density_over_n_h");
-    dataset = H5Dopen(file_id, set_name, H5P_DEFAULT);
-    status = H5Dread(dataset, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT,
-                     electron_abundance);
-    if (status < 0) error("error reading solar electron density table");
-    status = H5Dclose(dataset);
-    if (status < 0) error("error closing cooling dataset");
+  pf->image_size = size;
+  return NULL;
+}
+
+/**
+ * @brief Start reading the redshift-dependent table with index z_index in the
+ * background.
+ *
+ * The redshift only ever decreases, so once the pair (z_index + 1, z_index +
+ * 2) has been loaded, the next pair needed by the run is (z_index, z_index +
+ * 1). Only the table z_index is new; the other one is already in memory. We
+ * hence only need to read one file per table boundary and can do so while the
+ * code is busy with the time-steps leading to the boundary.
+ *
+ * Does nothing if a read is already in flight.
+ *
+ * @param cooling #cooling_function_data structure
+ * @param z_index Index along the redshift axis of the table to read.
+ */
+void cooling_tables_prefetch_launch(
+    struct cooling_function_data *restrict cooling, const int z_index) {
 
-    /* Transpose from order tables are stored in (temperature, nH) to
-     * (redshift, nH, temperature) where fastest varying index is on right. */
-    for (int i = 0; i < eagle_cooling_N_temperature; i++) {
-      for (int j = 0; j < eagle_cooling_N_density; j++) {
+  struct cooling_tables_prefetch *pf = &cooling->prefetch;
 
-        /* Index in the HDF5 table */
-        const int hdf5_index = row_major_index_2d(
-            i, j, eagle_cooling_N_temperature, eagle_cooling_N_density);
+  if (pf->launched) return;
+  if (z_index < 0 || z_index >= eagle_cooling_N_redshifts) return;
 
-        /* Index in the internal table */
-        const int internal_index = row_major_index_3d(
-            local_z_index, j, i, eagle_cooling_N_loaded_redshifts,
-            eagle_cooling_N_density, eagle_cooling_N_temperature);
+  sprintf(pf->fname, "%sz_%1.3f.hdf5", cooling->cooling_table_path,
+          cooling->Redshifts[z_index]);
+  pf->z_index = z_index;
+  pf->image = NULL;
+  pf->image_size = 0;
 
-        /* Just transpose */
-        cooling->table.electron_abundance[internal_index] =
-            electron_abundance[hdf5_index];
-      }
-    }
+  if (pthread_create(&pf->thread, NULL, &cooling_tables_prefetch_read, pf) != 0)
+    error("Failed to create the cooling table pre-fetching thread.");
+  pf->launched = 1;
+}
 
-    status = H5Fclose(file_id);
-    if (status < 0) error("error closing file");
+/**
+ * @brief Wait for the background read (if any) to complete and release the
+ * memory it used.
+ *
+ * @param cooling #cooling_function_data structure
+ */
+void cooling_tables_prefetch_clean(
+    struct cooling_function_data *restrict cooling) {
+
+  struct cooling_tables_prefetch *pf = &cooling->prefetch;
+
+  if (pf->launched) {
+    if (pthread_join(pf->thread, NULL) != 0)
+      error("Failed to join the cooling table pre-fetching thread.");
+    pf->launched = 0;
   }
 
-  swift_free("cooling-temp", net_cooling_rate);
-  swift_free("cooling-temp", electron_abundance);
-  swift_free("cooling-temp", temperature);
-  swift_free("cooling-temp", he_net_cooling_rate);
-  swift_free("cooling-temp", he_electron_abundance);
+  if (pf->image != NULL) swift_free("cooling-prefetch", pf->image);
+  pf->image = NULL;
+  pf->image_size = 0;
+}
 
-#ifdef SWIFT_DEBUG_CHECKS
-  message("Done reading in general cooling table");
-#endif
+/**
+ * @brief Move the table currently in the low-redshift slot of the loaded
+ * tables to the high-redshift slot.
+ *
+ * @param table The #cooling_tables to modify.
+ */
+static void cooling_tables_shift_slice(struct cooling_tables *restrict table) {
+
+  /* Metal heating is stored as (metal species, redshift, nH, temperature) */
+  const size_t metal_slice =
+      eagle_cooling_N_density * eagle_cooling_N_temperature;
+  for (int specs = 0; specs < eagle_cooling_N_metal; specs++) {
+    float *species = table->metal_heating +
+                     specs * eagle_cooling_N_loaded_redshifts * metal_slice;
+    memcpy(species + metal_slice, species, metal_slice * sizeof(float));
+  }
+
+  /* All the other tables have redshift as their slowest varying index */
+  memcpy(table->H_plus_He_heating + num_elements_HpHe_heating,
+         table->H_plus_He_heating, num_elements_HpHe_heating * sizeof(float));
+  memcpy(table->H_plus_He_electron_abundance +
+             num_elements_HpHe_electron_abundance,
+         table->H_plus_He_electron_abundance,
+         num_elements_HpHe_electron_abundance * sizeof(float));
+  memcpy(table->temperature + num_elements_temperature, table->temperature,
+         num_elements_temperature * sizeof(float));
+  memcpy(table->electron_abundance + num_elements_electron_abundance,
+         table->electron_abundance,
+         num_elements_electron_abundance * sizeof(float));
+}
+
+/**
+ * @brief Get redshift dependent table of cooling rates using the data read
+ * ahead of time by the pre-fetching thread.
+ *
+ * This is only possible if the pre-fetched table is the new low-redshift
+ * table and the currently loaded low-redshift table is the new high-redshift
+ * one. In all other cases (e.g. a time-step jumping over several tables) the
+ * pre-fetched data is discarded and the caller has to fall back to
+ * get_cooling_table().
+ *
+ * @param cooling #cooling_function_data structure
+ * @param low_z_index Index of the lowest redshift table to load.
+ * @param high_z_index Index of the highest redshift table to load.
+ * @return 1 if the tables were updated, 0 otherwise.
+ */
+int get_prefetched_cooling_table(struct cooling_function_data *restrict cooling,
+                                 const int low_z_index,
+                                 const int high_z_index) {
+
+#ifdef HAVE_HDF5
+
+  struct cooling_tables_prefetch *pf = &cooling->prefetch;
+
+  if (!pf->launched) return 0;
+
+  /* Wait for the read to complete (hopefully long done) */
+  if (pthread_join(pf->thread, NULL) != 0)
+    error("Failed to join the cooling table pre-fetching thread.");
+  pf->launched = 0;
+
+  /* Is the pre-fetched data what we need? */
+  if (pf->z_index != low_z_index || high_z_index != low_z_index + 1 ||
+      cooling->z_index != high_z_index) {
+    cooling_tables_prefetch_clean(cooling);
+    return 0;
+  }
+
+  message("Reading cooling table 'z_%1.3f.hdf5' (pre-fetched)",
+          cooling->Redshifts[low_z_index]);
+
+  /* The old low-redshift table is the new high-redshift one */
+  cooling_tables_shift_slice(&cooling->table);
+
+  /* Open the in-memory image of the file */
+  const hid_t fapl_id = H5Pcreate(H5P_FILE_ACCESS);
+  if (fapl_id < 0) error("Unable to create file access property list");
+  if (H5Pset_fapl_core(fapl_id, pf->image_size, /*backing_store=*/0) < 0)
+    error("Unable to set the core file driver");
+  if (H5Pset_file_image(fapl_id, pf->image, pf->image_size) < 0)
+    error("Unable to set the file image for %s", pf->fname);
+
+  /* Note: the name given to a file image must not exist on disk */
+  char image_name[64];
+  sprintf(image_name, "cooling_table_image_z_%1.3f",
+          cooling->Redshifts[low_z_index]);
+  const hid_t file_id = H5Fopen(image_name, H5F_ACC_RDONLY, fapl_id);
+  if (file_id < 0) error("unable to open file image of %s", pf->fname);
+
+  struct cooling_tables_read_buffers buf;
+  cooling_tables_read_buffers_allocate(&buf);
+  read_cooling_table_slice(file_id, &cooling->table, /*local_z_index=*/0,
+                           &buf);
+  cooling_tables_read_buffers_free(&buf);
+
+  if (H5Fclose(file_id) < 0) error("error closing file");
+  if (H5Pclose(fapl_id) < 0) error("error closing file access property list");
+
+  cooling_tables_prefetch_clean(cooling);
+  return 1;
 
 #else
   error("Need HDF5 to read cooling tables");
+  return 0;
 #endif
 }
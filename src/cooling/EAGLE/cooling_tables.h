@@ -58,9 +58,24 @@ void read_cooling_header(const char *fname,
 
 void allocate_cooling_tables(struct cooling_function_data *restrict cooling);
 
+void allocate_collapsed_cooling_tables(
+    struct cooling_function_data *restrict cooling);
+void free_collapsed_cooling_tables(
+    struct cooling_function_data *restrict cooling);
+void collapse_cooling_tables(struct cooling_function_data *restrict cooling,
+                             const float redshift);
+
 void get_redshift_invariant_table(
     struct cooling_function_data *restrict cooling, const int photodis);
 void get_cooling_table(struct cooling_function_data *restrict cooling,
                        const int low_z_index, const int high_z_index);
 
+void cooling_tables_prefetch_launch(
+    struct cooling_function_data *restrict cooling, const int z_index);
+int get_prefetched_cooling_table(struct cooling_function_data *restrict cooling,
+                                 const int low_z_index,
+                                 const int high_z_index);
+void cooling_tables_prefetch_clean(
+    struct cooling_function_data *restrict cooling);
+
 #endif
@@ -104,6 +104,7 @@
 #include "tools.h"
 #include "units.h"
 #include "velociraptor_interface.h"
+#include "version.h"
 
 const char *engine_policy_names[] = {"none",
                                      "rand",
@@ -1205,8 +1206,14 @@ void engine_rebuild(struct engine *e, const int repartitioned,
   e->restarting = 0;
 
   /* Report the time spent in the different task categories */
-  if (e->verbose && !repartitioned)
+  if (e->verbose && !repartitioned) {
     scheduler_report_task_times(&e->sched, e->nr_threads);
+    scheduler_report_task_time_histogram(&e->sched);
+  }
+
+  /* Use the task times to tune the split sizes before we lose the tasks */
+  if (e->s->auto_tune_split && !repartitioned)
+    space_tune_split_sizes(e->s, &e->sched, e->nr_threads, e->verbose);
 
   /* Give some breathing space */
   scheduler_free_tasks(&e->sched);
@@ -1412,6 +1419,7 @@ int engine_prepare(struct engine *e) {
 #ifdef WITH_MPI
   MPI_Allreduce(MPI_IN_PLACE, &e->forcerebuild, 1, MPI_INT, MPI_MAX,
                 MPI_COMM_WORLD);
+  e->local_mpi_wait += clocks_from_ticks(getticks() - tic3);
 #endif
 
   if (e->verbose)
@@ -1456,8 +1464,10 @@ int engine_prepare(struct engine *e) {
       pm_mesh_free(e->mesh);
 
     /* And repartition */
+    const ticks tic_repart = getticks();
     engine_repartition(e);
     repartitioned = 1;
+    e->phase_times.rebuild += clocks_from_ticks(getticks() - tic_repart);
 
     /* Reallocate the mesh */
     if ((e->policy & engine_policy_self_gravity) && e->s->periodic)
@@ -1473,7 +1483,9 @@ int engine_prepare(struct engine *e) {
     drifted_all = 1;
 
     /* And rebuild */
+    const ticks tic_rebuild = getticks();
     engine_rebuild(e, repartitioned, 0);
+    e->phase_times.rebuild += clocks_from_ticks(getticks() - tic_rebuild);
   }
 
 #ifdef SWIFT_DEBUG_CHECKS
@@ -1585,6 +1597,73 @@ void engine_print_stats(struct engine *e) {
             clocks_getunit());
 }
 
+/**
+ * @brief Report where the time of the steps went since the particles were
+ * initialised.
+ *
+ * Prints the minimum, mean and maximum over the ranks of the time spent in
+ * each phase of the steps. If Scheduler:write_phase_times is set, they are
+ * also appended as one JSON object to the file "phase_times.jsonl", so that
+ * the runs of a scaling test can be collected. The time not spent in any of
+ * the measured phases (unskipping, drifts, ...) is reported as "other".
+ * After a restart, only the steps since the restart are included.
+ *
+ * Must be called by all the ranks.
+ *
+ * @param e The #engine.
+ */
+void engine_report_phase_times(const struct engine *e) {
+
+  const struct engine_phase_times *t = &e->phase_times;
+  const char *names[6] = {"rebuild", "tasks", "mpi_wait",
+                          "io",      "other", "total"};
+  const double other = t->total - t->rebuild - t->tasks - t->mpi_wait - t->io;
+  const double local[6] = {t->rebuild, t->tasks, t->mpi_wait,
+                           t->io,      other,    t->total};
+
+  /* Aggregate the data from the different nodes. */
+  double min[6], max[6], sum[6];
+#ifdef WITH_MPI
+  if (MPI_Reduce(local, min, 6, MPI_DOUBLE, MPI_MIN, 0, MPI_COMM_WORLD) !=
+          MPI_SUCCESS ||
+      MPI_Reduce(local, max, 6, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD) !=
+          MPI_SUCCESS ||
+      MPI_Reduce(local, sum, 6, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD) !=
+          MPI_SUCCESS)
+    error("Failed to aggregate the phase times.");
+#else
+  for (int k = 0; k < 6; k++) min[k] = max[k] = sum[k] = local[k];
+#endif
+
+  if (e->nodeID != 0 || t->steps == 0) return;
+
+  message("Time spent in the %d steps (min / mean / max over the ranks):",
+          t->steps);
+  for (int k = 0; k < 6; k++)
+    message("%10s: %12.3f %12.3f %12.3f %s (%5.1f%%)", names[k], min[k],
+            sum[k] / e->nr_nodes, max[k], clocks_getunit(),
+            sum[5] > 0. ? 100. * sum[k] / sum[5] : 0.);
+
+  if (!e->write_phase_times) return;
+
+  const char *file_name = "phase_times.jsonl";
+  FILE *file = fopen(file_name, "a");
+  if (file == NULL) error("Could not open the file '%s'.", file_name);
+
+  fprintf(file,
+          "{\"revision\": \"%s\", \"nr_nodes\": %d, \"nr_threads\": %d, "
+          "\"steps\": %d, \"total_nr_parts\": %lld, \"total_nr_gparts\": "
+          "%lld, \"time_unit\": \"%s\"",
+          git_revision(), e->nr_nodes, e->nr_threads, t->steps,
+          e->total_nr_parts, e->total_nr_gparts, clocks_getunit());
+  for (int k = 0; k < 6; k++)
+    fprintf(file,
+            ", \"%s\": {\"min\": %.6g, \"mean\": %.6g, \"max\": %.6g}",
+            names[k], min[k], sum[k] / e->nr_nodes, max[k]);
+  fprintf(file, "}\n");
+  fclose(file);
+}
+
 /**
  * @brief Sets all the force, drift and kick tasks to be skipped.
  *
@@ -1625,8 +1704,7 @@ void engine_skip_force_and_kick(struct engine *e) {
         t->type == task_type_bh_out || t->type == task_type_rt_ghost1 ||
         t->type == task_type_rt_ghost2 || t->type == task_type_rt_tchem ||
         t->type == task_type_rt_advance_cell_time ||
-        t->type == task_type_neutrino_weight || t->type == task_type_csds ||
-        t->subtype == task_subtype_force ||
+        t->type == task_type_csds || t->subtype == task_subtype_force ||
         t->subtype == task_subtype_limiter ||
         t->subtype == task_subtype_gradient ||
         t->subtype == task_subtype_stars_prep1 ||
@@ -1638,7 +1716,6 @@ void engine_skip_force_and_kick(struct engine *e) {
         t->subtype == task_subtype_do_bh_swallow ||
         t->subtype == task_subtype_bpart_rho ||
         t->subtype == task_subtype_part_swallow ||
-        t->subtype == task_subtype_bpart_merger ||
         t->subtype == task_subtype_bpart_swallow ||
         t->subtype == task_subtype_bpart_feedback ||
         t->subtype == task_subtype_sink_swallow ||
@@ -1701,6 +1778,8 @@ void engine_launch(struct engine *e, const char *call) {
   /* reset the active time counters for the runners */
   for (int i = 0; i < e->nr_threads; ++i) {
     runner_reset_active_time(&e->runners[i]);
+    e->runners[i].hydro_pair_count = 0;
+    e->runners[i].hydro_pair_culled = 0;
   }
 
   /* Prepare the scheduler. */
@@ -1726,15 +1805,63 @@ void engine_launch(struct engine *e, const char *call) {
 
   /* accumulate active counts for all runners */
   ticks active_time = 0;
+  long long hydro_pair_count = 0, hydro_pair_culled = 0;
   for (int i = 0; i < e->nr_threads; ++i) {
     active_time += runner_get_active_time(&e->runners[i]);
+    hydro_pair_count += e->runners[i].hydro_pair_count;
+    hydro_pair_culled += e->runners[i].hydro_pair_culled;
   }
   e->sched.deadtime.active_ticks += active_time;
   e->sched.deadtime.waiting_ticks += getticks() - tic;
 
-  if (e->verbose)
+  if (e->verbose) {
     message("(%s) took %.3f %s.", call, clocks_from_ticks(getticks() - tic),
             clocks_getunit());
+    if (hydro_pair_count > 0)
+      message(
+          "(%s) %lld hydro cell pairs activated, %lld had particles in range.",
+          call, hydro_pair_count, hydro_pair_count - hydro_pair_culled);
+  }
+}
+
+/**
+ * @brief Analyse how the time of the last launch of the tasks was spent.
+ *
+ * Measures the total run time of the tasks, the longest time a runner was
+ * idle and, if requested, the critical path through the tasks that ran. The
+ * values are gathered over the ranks at the end of the step and written to
+ * the timesteps file.
+ *
+ * @param e The #engine.
+ * @param tic_launch When the tasks were launched.
+ * @param toc_launch When the runners were done.
+ */
+static void engine_analyse_tasks(struct engine *e, const ticks tic_launch,
+                                 const ticks toc_launch) {
+
+  const ticks tic = getticks();
+
+  const ticks launch_time = toc_launch - tic_launch;
+  ticks work = 0, idle_max = 0;
+  for (int i = 0; i < e->nr_threads; ++i) {
+    const ticks active_time = runner_get_active_time(&e->runners[i]);
+    work += active_time;
+    if (active_time < launch_time && launch_time - active_time > idle_max)
+      idle_max = launch_time - active_time;
+  }
+
+  e->local_work = clocks_from_ticks(work);
+  e->local_idle_max = clocks_from_ticks(idle_max);
+  e->local_critical_path =
+      e->critical_path_analysis
+          ? clocks_from_ticks(scheduler_critical_path(&e->sched, tic_launch))
+          : 0.;
+
+  if (e->verbose)
+    message("Critical path: %.3f %s, work: %.3f %s, took %.3f %s.",
+            e->local_critical_path, clocks_getunit(), e->local_work,
+            clocks_getunit(), clocks_from_ticks(getticks() - tic),
+            clocks_getunit());
 }
 
 /**
@@ -1785,6 +1912,9 @@ void engine_run_rt_sub_cycles(struct engine *e) {
   if (!(e->policy & engine_policy_rt)) return;
   if (e->max_nr_rt_subcycles <= 1) return;
 
+  const int with_cosmology = (e->policy & engine_policy_cosmology);
+  const int lightweight = e->rt_lightweight_subcycles;
+
   /* Get the subcycling step */
   const integertime_t rt_step_size = e->ti_rt_end_min - e->ti_current;
   if (rt_step_size == 0) {
@@ -1804,12 +1934,14 @@ void engine_run_rt_sub_cycles(struct engine *e) {
 
   /* Get some time variables for printouts. Don't update the ones in the
    * engine like in the regular step, or the outputs in the regular steps
-   * will be wrong. */
-  /* think cosmology one day: needs adapting here */
-  if (e->policy & engine_policy_cosmology)
-    error("Can't run RT subcycling with cosmology yet");
-  const double dt_subcycle = rt_step_size * e->time_base;
-  double time = e->ti_current_subcycle * e->time_base + e->time_begin;
+   * will be wrong. With cosmology, we print the scale-factor instead of
+   * the time. */
+  double dt_subcycle;
+  if (with_cosmology)
+    dt_subcycle = cosmology_get_delta_time(
+        e->cosmology, e->ti_current, e->ti_current + rt_step_size);
+  else
+    dt_subcycle = rt_step_size * e->time_base;
 
   /* Collect and print info before it's gone */
   engine_collect_end_of_sub_cycle(e);
@@ -1821,6 +1953,23 @@ void engine_run_rt_sub_cycles(struct engine *e) {
         e->max_active_bin_subcycle, e->rt_updates);
   }
 
+  /* Nothing more to do? */
+  if (nr_rt_cycles <= 1) {
+    e->rt_updates = 0ll;
+    return;
+  }
+
+  /* The RT tasks of the sub-cycles see the cosmology at the time of the
+   * sub-cycle. Keep the state of the regular step to restore it after. */
+  struct cosmology cosmo_regular_step;
+  if (with_cosmology) cosmo_regular_step = *e->cosmology;
+
+  /* Task activations of this step's sub-cycles, by highest active bin */
+  struct rt_sub_cycle_cache cache;
+  bzero(&cache, sizeof(struct rt_sub_cycle_cache));
+  long long rt_updates_sub_cycles = 0ll;
+  const ticks tic_sub_cycles = getticks();
+
   /* Note: zeroth sub-cycle already happened during the regular tasks,
    * so we need to do one less than that. */
   for (int sub_cycle = 1; sub_cycle < nr_rt_cycles; ++sub_cycle) {
@@ -1831,27 +1980,65 @@ void engine_run_rt_sub_cycles(struct engine *e) {
     e->max_active_bin_subcycle = get_max_active_bin(e->ti_current_subcycle);
     e->min_active_bin_subcycle =
         get_min_active_bin(e->ti_current_subcycle, ti_subcycle_old);
-    /* think cosmology one day: needs adapting here */
-    if (e->policy & engine_policy_cosmology)
-      error("Can't run RT subcycling with cosmology yet");
-    time = e->ti_current_subcycle * e->time_base + e->time_begin;
 
-    /* Do the actual work now. */
-    engine_unskip_rt_sub_cycle(e);
-    engine_launch(e, "cycles");
+    double time;
+    if (with_cosmology) {
+      cosmology_update(e->cosmology, e->physical_constants,
+                       e->ti_current_subcycle);
+      time = e->cosmology->a;
+      dt_subcycle =
+          cosmology_get_delta_time(e->cosmology, e->ti_current_subcycle,
+                                   e->ti_current_subcycle + rt_step_size);
+    } else {
+      time = e->ti_current_subcycle * e->time_base + e->time_begin;
+    }
+
+    if (lightweight) {
+
+      /* Activate the RT tasks (re-using earlier activations if possible),
+       * run them and only collect from the cells that were active. */
+      const int num_active_cells = engine_unskip_rt_sub_cycle_cached(e, &cache);
+      engine_launch(e, "cycles");
+      engine_collect_end_of_sub_cycle_cells(
+          e, cache.cells_active[e->max_active_bin_subcycle], num_active_cells);
+      rt_updates_sub_cycles += e->rt_updates;
+
+    } else {
+
+      /* Do the actual work now. */
+      engine_unskip_rt_sub_cycle(e);
+      engine_launch(e, "cycles");
+
+      /* Collect number of updates and print */
+      engine_collect_end_of_sub_cycle(e);
+
+      if (e->nodeID == 0) {
+        printf(
+            "  %6d cycle %3d %s=%13.6e     dt=%14e "
+            "min/max active bin=%2d/%2d rt_updates=%18lld\n",
+            e->step, sub_cycle, with_cosmology ? "   a" : "time", time,
+            dt_subcycle, e->min_active_bin_subcycle,
+            e->max_active_bin_subcycle, e->rt_updates);
+      }
+    }
+  }
 
-    /* Collect number of updates and print */
-    engine_collect_end_of_sub_cycle(e);
+  /* Print a summary of all the sub-cycles of this step */
+  if (lightweight) {
+    e->rt_updates = rt_updates_sub_cycles;
+    engine_reduce_rt_updates(e);
 
     if (e->nodeID == 0) {
       printf(
-          "  %6d cycle %3d time=%13.6e     dt=%14e "
-          "min/max active bin=%2d/%2d rt_updates=%18lld\n",
-          e->step, sub_cycle, time, dt_subcycle, e->min_active_bin_subcycle,
-          e->max_active_bin_subcycle, e->rt_updates);
+          "  %6d cycles 1-%d took %.3f %s rt_updates=%18lld\n", e->step,
+          nr_rt_cycles - 1, clocks_from_ticks(getticks() - tic_sub_cycles),
+          clocks_getunit(), e->rt_updates);
     }
   }
 
+  engine_rt_sub_cycle_cache_clean(&cache);
+  if (with_cosmology) *e->cosmology = cosmo_regular_step;
+
   /* Once we're done, clean up after ourselves */
   e->rt_updates = 0ll;
 }
@@ -2030,7 +2217,9 @@ void engine_init_particles(struct engine *e, int flag_entropy_ICs,
 
   /* Run the 0th time-step */
   TIMER_TIC2;
+  const ticks tic_tasks = getticks();
   engine_launch(e, "tasks");
+  engine_analyse_tasks(e, tic_tasks, getticks());
   TIMER_TOC2(timer_runners);
 
 #ifdef SWIFT_HYDRO_DENSITY_CHECKS
@@ -2069,6 +2258,10 @@ void engine_init_particles(struct engine *e, int flag_entropy_ICs,
                           e->sched.deadtime.active_ticks;
   e->local_deadtime = clocks_from_ticks(deadticks);
 
+  /* Nothing to wait for yet. */
+  e->local_mpi_wait = 0.;
+  e->local_time_to_collect = 0.;
+
   /* Recover the (integer) end of the next time-step */
   engine_collect_end_of_step(e, 1);
 
@@ -2195,6 +2388,9 @@ void engine_init_particles(struct engine *e, int flag_entropy_ICs,
   e->forcerebuild = 1;
   e->wallclock_time = (float)clocks_diff(&time1, &time2);
 
+  /* Only account for the time of the steps from here */
+  bzero(&e->phase_times, sizeof(struct engine_phase_times));
+
 #ifdef SWIFT_GRAVITY_FORCE_CHECKS
   e->force_checks_snapshot_flag = 0;
 #endif
@@ -2226,6 +2422,7 @@ int engine_step(struct engine *e) {
   /* reset the deadtime information in the scheduler */
   e->sched.deadtime.active_ticks = 0;
   e->sched.deadtime.waiting_ticks = 0;
+  e->local_mpi_wait = 0.;
 
 #if defined(SWIFT_MPIUSE_REPORTS) && defined(WITH_MPI)
   /* We may want to compare times across ranks, so make sure all steps start
@@ -2270,11 +2467,12 @@ int engine_step(struct engine *e) {
       fprintf(
           e->file_timesteps,
           "  %6d %14e %12.7f %12.7f %14e %4d %4d %12lld %12lld %12lld %12lld "
-          "%12lld %21.3f %6d %17.3f\n",
+          "%12lld %21.3f %6d %17.3f %19.3f %19.3f %19.3f %19.3f\n",
           e->step, e->time, e->cosmology->a, e->cosmology->z, e->time_step,
           e->min_active_bin, e->max_active_bin, e->updates, e->g_updates,
           e->s_updates, e->sink_updates, e->b_updates, e->wallclock_time,
-          e->step_props, dead_time);
+          e->step_props, dead_time, e->global_critical_path, e->global_work,
+          e->global_idle_max, e->global_mpi_wait);
 #ifdef SWIFT_DEBUG_CHECKS
     fflush(e->file_timesteps);
 #endif
@@ -2508,8 +2706,9 @@ int engine_step(struct engine *e) {
   if ((e->policy & engine_policy_self_gravity) && e->s->periodic &&
       e->mesh->ti_end_mesh_next == e->ti_current) {
 
-    /* We might need to drift things */
-    if (!drifted_all) engine_drift_all(e, /*drift_mpole=*/0);
+    /* We might need to drift things (the mesh only reads the gparts) */
+    if (!drifted_all)
+      engine_drift_all_types(e, /*drift_mpole=*/0, engine_drift_types_gpart);
 
     /* ... and recompute */
     pm_mesh_compute_potential(e->mesh, e->s, &e->threadpool, e->verbose);
@@ -2546,9 +2745,15 @@ int engine_step(struct engine *e) {
 
   /* Start all the tasks. */
   TIMER_TIC;
+  const ticks tic_tasks = getticks();
   engine_launch(e, "tasks");
+  const ticks toc_tasks = getticks();
+  e->phase_times.tasks += clocks_from_ticks(toc_tasks - tic_tasks);
   TIMER_TOC(timer_runners);
 
+  /* Where did the time of the tasks go? */
+  engine_analyse_tasks(e, tic_tasks, toc_tasks);
+
   /* Now record the CPU times used by the tasks. */
 #ifdef WITH_MPI
   double end_usertime = 0.0;
@@ -2558,6 +2763,11 @@ int engine_step(struct engine *e) {
   e->systime_last_step = end_systime - start_systime;
 #endif
 
+  /* How much of the room for new particles did this step use? */
+  if (e->verbose &&
+      (e->policy & (engine_policy_star_formation | engine_policy_sinks)))
+    space_report_extras_usage(e->s);
+
 #ifdef SWIFT_HYDRO_DENSITY_CHECKS
   /* Run the brute-force hydro calculation for some parts */
   if (e->policy & engine_policy_hydro)
@@ -2613,8 +2823,12 @@ int engine_step(struct engine *e) {
                           e->sched.deadtime.active_ticks;
   e->local_deadtime = clocks_from_ticks(deadticks);
 
+  /* The ranks will wait for the slowest one to get here. */
+  e->local_time_to_collect = clocks_from_ticks(getticks() - e->tic_step);
+
   /* Collect information about the next time-step */
   engine_collect_end_of_step(e, 1);
+  e->phase_times.mpi_wait += e->local_mpi_wait;
   e->forcerebuild = e->collect_group1.forcerebuild;
   e->updates_since_rebuild += e->collect_group1.updated;
   e->g_updates_since_rebuild += e->collect_group1.g_updated;
@@ -2661,6 +2875,7 @@ int engine_step(struct engine *e) {
 #endif
 
   /* Create a restart file if needed. */
+  const ticks tic_io = getticks();
   const int force_stop =
       engine_dump_restarts(e, 0, e->restart_onexit && engine_is_done(e));
 
@@ -2669,6 +2884,7 @@ int engine_step(struct engine *e) {
    * Note that if the run was forced to stop, we do not dump,
    * we will do so when the run is restarted*/
   if (!force_stop) engine_io(e);
+  e->phase_times.io += clocks_from_ticks(getticks() - tic_io);
 
 #ifdef SWIFT_RT_DEBUG_CHECKS
   /* if we're running the debug RT scheme, do some checks after every step.
@@ -2689,6 +2905,8 @@ int engine_step(struct engine *e) {
 
   clocks_gettime(&time2);
   e->wallclock_time = (float)clocks_diff(&time1, &time2);
+  e->phase_times.total += e->wallclock_time;
+  e->phase_times.steps++;
 
   /* Time in ticks at the end of this step. */
   e->toc_step = getticks();
@@ -3136,6 +3354,8 @@ void engine_init(
   e->dt_max = parser_get_param_double(params, "TimeIntegration:dt_max");
   e->max_nr_rt_subcycles = parser_get_opt_param_int(
       params, "TimeIntegration:max_nr_rt_subcycles", /*default=*/0);
+  e->rt_lightweight_subcycles = parser_get_opt_param_int(
+      params, "TimeIntegration:rt_lightweight_subcycles", /*default=*/1);
   e->dt_max_RMS_displacement = FLT_MAX;
   e->max_RMS_displacement_factor = parser_get_opt_param_double(
       params, "TimeIntegration:max_dt_RMS_factor", 0.25);
@@ -3550,6 +3770,7 @@ void engine_clean(struct engine *e, const int fof, const int restart) {
 #endif
     gravity_cache_clean(&e->runners[k].ci_gravity_cache);
     gravity_cache_clean(&e->runners[k].cj_gravity_cache);
+    task_trace_clean(&e->runners[k].trace);
   }
   swift_free("runners", e->runners);
   free(e->snapshot_units);
@@ -3726,6 +3947,9 @@ void engine_struct_restore(struct engine *e, FILE *stream) {
   e->sched.tid_active = NULL;
   e->sched.size = 0;
 
+  /* Only report the phase times of the steps since the restart. */
+  bzero(&e->phase_times, sizeof(struct engine_phase_times));
+
   /* Now for the other pointers, these use their own restore functions. */
   /* Note all this memory leaks, but is used once. */
   struct space *s = (struct space *)malloc(sizeof(struct space));
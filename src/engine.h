@@ -110,6 +110,18 @@ enum engine_step_properties {
   engine_step_prop_done = (1 << 10),
 };
 
+/**
+ * @brief The particle types engine_drift_all_types() can be asked to drift.
+ */
+enum engine_drift_types {
+  engine_drift_types_part = (1 << 0),
+  engine_drift_types_gpart = (1 << 1),
+  engine_drift_types_spart = (1 << 2),
+  engine_drift_types_bpart = (1 << 3),
+  engine_drift_types_sink = (1 << 4),
+  engine_drift_types_all = (1 << 5) - 1,
+};
+
 /* Some constants */
 #define engine_maxproxies 64
 #define engine_tasksreweight 1
@@ -137,6 +149,53 @@ extern int engine_rank;
  */
 extern int engine_current_step;
 
+/**
+ * @brief The RT tasks and top-level cells activated during the sub-cycles of
+ * a step, indexed by the highest active time-bin of the sub-cycle.
+ *
+ * The particles keep their RT time-bins during the sub-cycles of a step, so
+ * two sub-cycles with the same highest active bin activate the same tasks.
+ */
+struct rt_sub_cycle_cache {
+
+  /*! Indices of the activated tasks (or NULL if not recorded yet) */
+  int *tid_active[num_time_bins + 1];
+
+  /*! Number of activated tasks */
+  int active_count[num_time_bins + 1];
+
+  /*! Indices of the active local top-level cells */
+  int *cells_active[num_time_bins + 1];
+
+  /*! Number of active local top-level cells */
+  int num_cells_active[num_time_bins + 1];
+};
+
+/**
+ * @brief Wall-clock time spent in the main phases of the steps, accumulated
+ * since the particles were initialised.
+ */
+struct engine_phase_times {
+
+  /*! Rebuilding the tree and tasks, including repartitioning */
+  double rebuild;
+
+  /*! Running the tasks of the step */
+  double tasks;
+
+  /*! Waiting for the other ranks (the local MPI wait of the steps) */
+  double mpi_wait;
+
+  /*! Writing snapshots, statistics and restart files */
+  double io;
+
+  /*! The whole steps */
+  double total;
+
+  /*! Nr of steps accumulated */
+  int steps;
+};
+
 /* Data structure for the engine. */
 struct engine {
 
@@ -205,6 +264,10 @@ struct engine {
   /* Maximal number of radiative transfer sub-cycles per hydro step */
   int max_nr_rt_subcycles;
 
+  /* Re-use the RT task activations and reduce the collections between RT
+   * sub-cycles? */
+  int rt_lightweight_subcycles;
+
   /* Time step */
   double time_step;
 
@@ -462,6 +525,25 @@ struct engine {
   /* Wallclock time of the last time-step */
   float wallclock_time;
 
+  /* Where the time of the steps went since the start (or the restart). */
+  struct engine_phase_times phase_times;
+
+  /* Append the phase times to phase_times.jsonl at the end of the run? */
+  int write_phase_times;
+
+  /* Nr of tasks remembered by each runner for the task trace (0 for none). */
+  int task_trace_size;
+
+  /* Time from the start of a step to the end of its tasks above which its
+   * task trace is dumped. */
+  float task_trace_dump_threshold;
+
+  /* Dump the task trace at the end of this step? */
+  int task_trace_dump;
+
+  /* Compute the critical path of the tasks of each step? */
+  int critical_path_analysis;
+
   /* Are we in the process of restaring a simulation? */
   int restarting;
 
@@ -626,6 +708,20 @@ struct engine {
   /* The globally accumulated deadtime. */
   double global_deadtime;
 
+  /* The local critical path of the tasks, their total run time and the
+   * longest time a runner was idle while they ran. */
+  double local_critical_path, local_work, local_idle_max;
+
+  /* The local MPI wait of the step (time spent in the reduction of the
+   * rebuild flag plus, once the step is collected, the time spent waiting
+   * for the slowest rank to reach the end of the step) and the time from
+   * the start of the step to the end-of-step reduction. */
+  double local_mpi_wait, local_time_to_collect;
+
+  /* The global critical path, total run time, runner idle time and MPI wait
+   * (maximum over the ranks, except for the run time which is summed). */
+  double global_critical_path, global_work, global_idle_max, global_mpi_wait;
+
   /* Time-integration mesh kick to apply to the particle velocities for
    * snapshots */
   float dt_kick_grav_mesh_for_io;
@@ -679,18 +775,27 @@ void engine_compute_next_los_time(struct engine *e);
 void engine_compute_next_ps_time(struct engine *e);
 void engine_recompute_displacement_constraint(struct engine *e);
 void engine_unskip(struct engine *e);
-void engine_unskip_rt_sub_cycle(struct engine *e);
+int engine_unskip_rt_sub_cycle(struct engine *e);
+int engine_unskip_rt_sub_cycle_cached(struct engine *e,
+                                      struct rt_sub_cycle_cache *cache);
+void engine_rt_sub_cycle_cache_clean(struct rt_sub_cycle_cache *cache);
 void engine_drift_all(struct engine *e, const int drift_mpoles);
+void engine_drift_all_types(struct engine *e, const int drift_mpoles,
+                            const int types);
 void engine_drift_top_multipoles(struct engine *e);
 void engine_reconstruct_multipoles(struct engine *e);
 void engine_allocate_foreign_particles(struct engine *e, const int fof);
 void engine_print_stats(struct engine *e);
+void engine_report_phase_times(const struct engine *e);
 void engine_io(struct engine *e);
 void engine_io_check_snapshot_triggers(struct engine *e);
 void engine_io_verify_triggers_size(const struct engine *e);
 void engine_collect_end_of_step(struct engine *e, int apply);
 void engine_collect_end_of_sub_cycle(struct engine *e);
-void engine_dump_snapshot(struct engine *e);
+void engine_collect_end_of_sub_cycle_cells(struct engine *e, int *cells,
+                                           const int num_cells);
+void engine_reduce_rt_updates(struct engine *e);
+void engine_dump_snapshot(struct engine *e, const int drift_types);
 void engine_run_on_dump(struct engine *e);
 void engine_init_output_lists(struct engine *e, struct swift_params *params,
                               const struct output_options *output_options);
@@ -29,6 +29,7 @@
 #include "active.h"
 #include "lightcone/lightcone_array.h"
 #include "star_formation_logger.h"
+#include "task_trace.h"
 #include "timeline.h"
 
 /**
@@ -266,8 +267,10 @@ void engine_collect_end_of_step(struct engine *e, int apply) {
       data.ti_sinks_beg_max, data.ti_black_holes_end_min,
       data.ti_black_holes_beg_max, e->forcerebuild, e->s->tot_cells,
       e->sched.nr_tasks, (float)e->sched.nr_tasks / (float)e->s->tot_cells,
-      data.sfh, data.runtime, data.flush_lightcone_maps, data.deadtime,
-      data.csds_file_size_gb);
+      data.sfh, data.runtime, data.flush_lightcone_maps,
+      task_trace_dump_requested(e), data.deadtime, e->local_critical_path,
+      e->local_work, e->local_idle_max, e->local_mpi_wait,
+      e->local_time_to_collect, data.csds_file_size_gb);
 
 /* Aggregate collective data from the different nodes for this step. */
 #ifdef WITH_MPI
@@ -389,23 +392,32 @@ void engine_collect_end_of_sub_cycle_mapper(void *map_data, int num_elements,
 }
 
 /**
- * @brief Collects additional data at the end of a subcycle.
- * This function does not collect any data relevant to the
- * time-steps or time integration.
+ * @brief Collects additional data at the end of a subcycle from a list of
+ * local top-level cells.
+ *
+ * This does not reduce the data over the nodes. Cells that were not active in
+ * the sub-cycle have nothing to collect and can be left out of the list.
  *
  * @param e The #engine.
+ * @param cells The indices of the top-level cells to collect from.
+ * @param num_cells The number of cells in the list.
  */
-void engine_collect_end_of_sub_cycle(struct engine *e) {
+void engine_collect_end_of_sub_cycle_cells(struct engine *e, int *cells,
+                                           const int num_cells) {
 
-  const ticks tic = getticks();
-  struct space *s = e->s;
+  threadpool_map(&e->threadpool, engine_collect_end_of_sub_cycle_mapper, cells,
+                 num_cells, sizeof(int), threadpool_auto_chunk_size, e);
+}
 
-  /* Collect information from the local top-level cells */
-  threadpool_map(&e->threadpool, engine_collect_end_of_sub_cycle_mapper,
-                 s->local_cells_top, s->nr_local_cells, sizeof(int),
-                 threadpool_auto_chunk_size, e);
+/**
+ * @brief Sums the number of RT updates over all the nodes.
+ *
+ * The total is only stored on rank 0.
+ *
+ * @param e The #engine.
+ */
+void engine_reduce_rt_updates(struct engine *e) {
 
-  /* Aggregate collective data from the different nodes for this step. */
 #ifdef WITH_MPI
   long long rt_updates_tot = 0ll;
   int test = MPI_Reduce(&e->rt_updates, &rt_updates_tot, 1, MPI_LONG_LONG,
@@ -414,6 +426,26 @@ void engine_collect_end_of_sub_cycle(struct engine *e) {
   /* Overwrite only on rank 0. */
   if (e->nodeID == 0) e->rt_updates = rt_updates_tot;
 #endif
+}
+
+/**
+ * @brief Collects additional data at the end of a subcycle.
+ * This function does not collect any data relevant to the
+ * time-steps or time integration.
+ *
+ * @param e The #engine.
+ */
+void engine_collect_end_of_sub_cycle(struct engine *e) {
+
+  const ticks tic = getticks();
+  struct space *s = e->s;
+
+  /* Collect information from the local top-level cells */
+  engine_collect_end_of_sub_cycle_cells(e, s->local_cells_top,
+                                        s->nr_local_cells);
+
+  /* Aggregate collective data from the different nodes for this step. */
+  engine_reduce_rt_updates(e);
 
   if (e->verbose)
     message("took %.3f %s.", clocks_from_ticks(getticks() - tic),
@@ -504,11 +504,13 @@ void engine_config(int restart, int fof, struct engine *e,
 
       fprintf(e->file_timesteps,
               "# %6s %14s %12s %12s %14s %9s %12s %12s %12s %12s %12s %16s "
-              "[%s] %6s %12s [%s]\n",
+              "[%s] %6s %12s [%s] %14s [%s] %14s [%s] %14s [%s] %14s [%s]\n",
               "Step", "Time", "Scale-factor", "Redshift", "Time-step",
               "Time-bins", "Updates", "g-Updates", "s-Updates", "Sink-Updates",
               "b-Updates", "Wall-clock time", clocks_getunit(), "Props",
-              "Dead time", clocks_getunit());
+              "Dead time", clocks_getunit(), "Critical path", clocks_getunit(),
+              "Work", clocks_getunit(), "Max idle", clocks_getunit(),
+              "MPI wait", clocks_getunit());
       fflush(e->file_timesteps);
     }
 
@@ -851,6 +853,32 @@ void engine_config(int restart, int fof, struct engine *e,
   e->sched.mpi_message_limit =
       parser_get_opt_param_int(params, "Scheduler:mpi_message_limit", 4) * 1024;
 
+  /* Send the gravity particles with their positions in single precision
+   * relative to their top-level cell? Can be changed on restart. */
+  e->sched.mpi_compact_gparts =
+      parser_get_opt_param_int(params, "Scheduler:mpi_compact_gparts", 0);
+
+  /* Number of tasks remembered by each runner and step time (in ms) above
+   * which they are dumped. Can be changed on restart. */
+  e->task_trace_size = parser_get_opt_param_int(
+      params, "Scheduler:task_trace_size", task_trace_size_default);
+  e->task_trace_dump_threshold = parser_get_opt_param_float(
+      params, "Scheduler:task_trace_dump_threshold", 0.f);
+  if (e->task_trace_size < 0)
+    error("Scheduler:task_trace_size must be positive or zero.");
+  if (e->task_trace_size > 0) task_trace_init_signal();
+  e->task_trace_dump = 0;
+
+  /* Compute the critical path of the tasks of each step? Can be changed on
+   * restart. */
+  e->critical_path_analysis =
+      parser_get_opt_param_int(params, "Scheduler:critical_path_analysis", 1);
+
+  /* Write the phase times to a file at the end of the run? Can be changed on
+   * restart. */
+  e->write_phase_times =
+      parser_get_opt_param_int(params, "Scheduler:write_phase_times", 0);
+
   if (restart) {
 
     /* Overwrite the constants for the scheduler */
@@ -947,17 +975,23 @@ void engine_config(int restart, int fof, struct engine *e,
       e->runners[k].qid = k * nr_queues / e->nr_threads;
     }
 
-    /* Allocate particle caches. */
+    /* Allocate particle caches. Leave room for the largest split size the
+     * tuning can reach. */
+    const int gravity_cache_size =
+        e->s->auto_tune_split
+            ? space_auto_tune_max_split_factor * space_splitsize
+            : space_splitsize;
     e->runners[k].ci_gravity_cache.count = 0;
     e->runners[k].cj_gravity_cache.count = 0;
-    gravity_cache_init(&e->runners[k].ci_gravity_cache, space_splitsize);
-    gravity_cache_init(&e->runners[k].cj_gravity_cache, space_splitsize);
+    gravity_cache_init(&e->runners[k].ci_gravity_cache, gravity_cache_size);
+    gravity_cache_init(&e->runners[k].cj_gravity_cache, gravity_cache_size);
 #ifdef WITH_VECTORIZATION
     e->runners[k].ci_cache.count = 0;
     e->runners[k].cj_cache.count = 0;
     cache_init(&e->runners[k].ci_cache, CACHE_SIZE);
     cache_init(&e->runners[k].cj_cache, CACHE_SIZE);
 #endif
+    task_trace_init(&e->runners[k].trace, e->task_trace_size);
 
     if (verbose) {
       if (with_aff)
@@ -321,6 +321,22 @@ void engine_do_drift_all_multipole_mapper(void *map_data, int num_elements,
  * @param drift_mpoles Do we want to drift all the multipoles as well?
  */
 void engine_drift_all(struct engine *e, const int drift_mpoles) {
+  engine_drift_all_types(e, drift_mpoles, engine_drift_types_all);
+}
+
+/**
+ * @brief Drift all the particles of some types forward to the current time.
+ *
+ * Operations that only read some of the particle types (the mesh, a line of
+ * sight, a snapshot writing a subset of the types) can leave the others where
+ * they are; they get drifted by their tasks or by the next full drift.
+ *
+ * @param e The #engine.
+ * @param drift_mpoles Do we want to drift all the multipoles as well?
+ * @param types The particle types to drift (#engine_drift_types).
+ */
+void engine_drift_all_types(struct engine *e, const int drift_mpoles,
+                            const int types) {
 
   const ticks tic = getticks();
 
@@ -344,27 +360,27 @@ void engine_drift_all(struct engine *e, const int drift_mpoles) {
 
     /* Normal case: We have a list of local cells with tasks to play with */
 
-    if (e->s->nr_parts > 0) {
+    if ((types & engine_drift_types_part) && e->s->nr_parts > 0) {
       threadpool_map(&e->threadpool, engine_do_drift_all_part_mapper,
                      e->s->local_cells_top, e->s->nr_local_cells, sizeof(int),
                      threadpool_auto_chunk_size, e);
     }
-    if (e->s->nr_gparts > 0) {
+    if ((types & engine_drift_types_gpart) && e->s->nr_gparts > 0) {
       threadpool_map(&e->threadpool, engine_do_drift_all_gpart_mapper,
                      e->s->local_cells_top, e->s->nr_local_cells, sizeof(int),
                      threadpool_auto_chunk_size, e);
     }
-    if (e->s->nr_sparts > 0) {
+    if ((types & engine_drift_types_spart) && e->s->nr_sparts > 0) {
       threadpool_map(&e->threadpool, engine_do_drift_all_spart_mapper,
                      e->s->local_cells_top, e->s->nr_local_cells, sizeof(int),
                      threadpool_auto_chunk_size, e);
     }
-    if (e->s->nr_sinks > 0) {
+    if ((types & engine_drift_types_sink) && e->s->nr_sinks > 0) {
       threadpool_map(&e->threadpool, engine_do_drift_all_sink_mapper,
                      e->s->local_cells_top, e->s->nr_local_cells, sizeof(int),
                      threadpool_auto_chunk_size, e);
     }
-    if (e->s->nr_bparts > 0) {
+    if ((types & engine_drift_types_bpart) && e->s->nr_bparts > 0) {
       threadpool_map(&e->threadpool, engine_do_drift_all_bpart_mapper,
                      e->s->local_cells_top, e->s->nr_local_cells, sizeof(int),
                      threadpool_auto_chunk_size, e);
@@ -381,27 +397,27 @@ void engine_drift_all(struct engine *e, const int drift_mpoles) {
     /* When restarting, the list of local cells with tasks does not yet
        exist. We use the raw list of top-level cells instead */
 
-    if (e->s->nr_parts > 0) {
+    if ((types & engine_drift_types_part) && e->s->nr_parts > 0) {
       threadpool_map(&e->threadpool, engine_do_drift_all_part_mapper,
                      e->s->cells_top, e->s->nr_cells, sizeof(struct cell),
                      threadpool_auto_chunk_size, e);
     }
-    if (e->s->nr_sparts > 0) {
+    if ((types & engine_drift_types_spart) && e->s->nr_sparts > 0) {
       threadpool_map(&e->threadpool, engine_do_drift_all_spart_mapper,
                      e->s->cells_top, e->s->nr_cells, sizeof(struct cell),
                      threadpool_auto_chunk_size, e);
     }
-    if (e->s->nr_sinks > 0) {
+    if ((types & engine_drift_types_sink) && e->s->nr_sinks > 0) {
       threadpool_map(&e->threadpool, engine_do_drift_all_sink_mapper,
                      e->s->cells_top, e->s->nr_cells, sizeof(struct cell),
                      threadpool_auto_chunk_size, e);
     }
-    if (e->s->nr_bparts > 0) {
+    if ((types & engine_drift_types_bpart) && e->s->nr_bparts > 0) {
       threadpool_map(&e->threadpool, engine_do_drift_all_bpart_mapper,
                      e->s->cells_top, e->s->nr_cells, sizeof(struct cell),
                      threadpool_auto_chunk_size, e);
     }
-    if (e->s->nr_gparts > 0) {
+    if ((types & engine_drift_types_gpart) && e->s->nr_gparts > 0) {
       threadpool_map(&e->threadpool, engine_do_drift_all_gpart_mapper,
                      e->s->cells_top, e->s->nr_cells, sizeof(struct cell),
                      threadpool_auto_chunk_size, e);
@@ -413,22 +429,26 @@ void engine_drift_all(struct engine *e, const int drift_mpoles) {
     }
   }
 
-  /* Synchronize particle positions */
-  space_synchronize_particle_positions(e->s);
+  /* The rest only makes sense once every type is at the current time */
+  if (types == engine_drift_types_all) {
+
+    /* Synchronize particle positions */
+    space_synchronize_particle_positions(e->s);
 
 #ifdef SWIFT_DEBUG_CHECKS
-  /* Check that all cells have been drifted to the current time. */
-  space_check_drift_point(
-      e->s, e->ti_current,
-      drift_mpoles && (e->policy & engine_policy_self_gravity));
-  part_verify_links(e->s->parts, e->s->gparts, e->s->sinks, e->s->sparts,
-                    e->s->bparts, e->s->nr_parts, e->s->nr_gparts,
-                    e->s->nr_sinks, e->s->nr_sparts, e->s->nr_bparts,
-                    e->verbose);
+    /* Check that all cells have been drifted to the current time. */
+    space_check_drift_point(
+        e->s, e->ti_current,
+        drift_mpoles && (e->policy & engine_policy_self_gravity));
+    part_verify_links(e->s->parts, e->s->gparts, e->s->sinks, e->s->sparts,
+                      e->s->bparts, e->s->nr_parts, e->s->nr_gparts,
+                      e->s->nr_sinks, e->s->nr_sparts, e->s->nr_bparts,
+                      e->verbose);
 #endif
 
-  /* All particles have now been drifted to ti_current */
-  e->ti_earliest_undrifted = e->ti_current;
+    /* All particles have now been drifted to ti_current */
+    e->ti_earliest_undrifted = e->ti_current;
+  }
 
   if (e->verbose)
     message("took %.3f %s.", clocks_from_ticks(getticks() - tic),
@@ -268,17 +268,25 @@ int engine_dump_restarts(struct engine *e, const int drifted_all,
  * @brief Writes a snapshot with the current state of the engine
  *
  * @param e The #engine.
+ * @param drift_types The #engine_drift_types that were drifted for this
+ * snapshot.
  */
-void engine_dump_snapshot(struct engine *e) {
+void engine_dump_snapshot(struct engine *e, const int drift_types) {
 
   struct clocks_time time1, time2;
   clocks_gettime(&time1);
 
 #ifdef SWIFT_DEBUG_CHECKS
-  /* Check that all cells have been drifted to the current time.
-   * That can include cells that have not
+  /* Check that all cells have been drifted to the current time for the
+   * types this snapshot drifted. That can include cells that have not
    * previously been active on this rank. */
-  space_check_drift_point(e->s, e->ti_current, /* check_mpole=*/0);
+  integertime_t ti_drift = e->ti_current;
+  if (drift_types & engine_drift_types_part)
+    space_map_cells_pre(e->s, 1, cell_check_part_drift_point, &ti_drift);
+  if (drift_types & engine_drift_types_gpart)
+    space_map_cells_pre(e->s, 1, cell_check_gpart_drift_point, &ti_drift);
+  if (drift_types & engine_drift_types_spart)
+    space_map_cells_pre(e->s, 1, cell_check_spart_drift_point, &ti_drift);
 
   /* Be verbose about this */
   if (e->nodeID == 0) {
@@ -398,6 +406,48 @@ void engine_run_on_dump(struct engine *e) {
   }
 }
 
+/**
+ * @brief Work out which particle types a snapshot needs drifted.
+ *
+ * Only the types the current output selection writes at least one field for
+ * are needed, unless the snapshot also triggers a FoF, VELOCIraptor or
+ * power-spectrum calculation.
+ *
+ * @param e The #engine.
+ *
+ * @return The #engine_drift_types to drift.
+ */
+static int engine_io_snapshot_drift_types(const struct engine *e) {
+
+  if ((e->policy & engine_policy_fof && e->snapshot_invoke_fof) ||
+      (e->policy & engine_policy_structure_finding && e->snapshot_invoke_stf &&
+       !e->stf_this_timestep) ||
+      (e->policy & engine_policy_power_spectra && e->snapshot_invoke_ps))
+    return engine_drift_types_all;
+
+  char selection_name[FIELD_BUFFER_SIZE] = select_output_header_default_name;
+  if (e->output_list_snapshots)
+    output_list_get_current_select_output(e->output_list_snapshots,
+                                          selection_name);
+
+  int written[swift_type_count];
+  for (int ptype = 0; ptype < swift_type_count; ++ptype)
+    written[ptype] = output_options_get_num_fields_to_write(
+                         e->output_options, selection_name, ptype) > 0;
+
+  int types = 0;
+  if (written[swift_type_gas]) types |= engine_drift_types_part;
+  if (written[swift_type_dark_matter] ||
+      written[swift_type_dark_matter_background] ||
+      written[swift_type_neutrino])
+    types |= engine_drift_types_gpart;
+  if (written[swift_type_stars]) types |= engine_drift_types_spart;
+  if (written[swift_type_black_hole]) types |= engine_drift_types_bpart;
+  if (written[swift_type_sink]) types |= engine_drift_types_sink;
+
+  return types;
+}
+
 /**
  * @brief Check whether any kind of i/o has to be performed during this
  * step.
@@ -492,8 +542,13 @@ void engine_io(struct engine *e) {
       e->time = ti_output * e->time_base + e->time_begin;
     }
 
-    /* Drift everyone */
-    engine_drift_all(e, /*drift_mpole=*/0);
+    /* Drift the particles this output reads */
+    int drift_types = engine_drift_types_all;
+    if (type == output_snapshot)
+      drift_types = engine_io_snapshot_drift_types(e);
+    else if (type == output_los)
+      drift_types = engine_drift_types_part;
+    engine_drift_all_types(e, /*drift_mpole=*/0, drift_types);
 
     /* Write some form of output */
     switch (type) {
@@ -541,7 +596,7 @@ void engine_io(struct engine *e) {
         }
 
         /* Dump... */
-        engine_dump_snapshot(e);
+        engine_dump_snapshot(e, drift_types);
 
         /* Free the memory allocated for VELOCIraptor i/o. */
         if (with_stf && e->snapshot_invoke_stf && e->s->gpart_group_data) {
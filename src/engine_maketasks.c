@@ -444,18 +444,19 @@ void engine_addtasks_send_stars(struct engine *e, struct cell *ci,
 /**
  * @brief Add send tasks for the black holes pairs to a hierarchy of cells.
  *
+ * The gas swallow flags and the BH merger flags are sent together in a
+ * single exchange as both are ready after the first swallow ghost.
+ *
  * @param e The #engine.
  * @param ci The sending #cell.
  * @param cj Dummy cell containing the nodeID of the receiving node.
  * @param t_rho The density comm. task, if it has already been created.
- * @param t_bh_merger The BH swallow comm. task, if it has already been created.
- * @param t_gas_swallow The gas swallow comm. task, if it has already been
- * created.
+ * @param t_gas_swallow The gas and BH swallow comm. task, if it has already
+ * been created.
  * @param t_feedback The send_feed #task, if it has already been created.
  */
 void engine_addtasks_send_black_holes(struct engine *e, struct cell *ci,
                                       struct cell *cj, struct task *t_rho,
-                                      struct task *t_bh_merger,
                                       struct task *t_gas_swallow,
                                       struct task *t_feedback) {
 
@@ -486,9 +487,6 @@ void engine_addtasks_send_black_holes(struct engine *e, struct cell *ci,
       t_rho = scheduler_addtask(s, task_type_send, task_subtype_bpart_rho,
                                 ci->mpi.tag, 0, ci, cj);
 
-      t_bh_merger = scheduler_addtask(
-          s, task_type_send, task_subtype_bpart_merger, ci->mpi.tag, 0, ci, cj);
-
       t_gas_swallow = scheduler_addtask(
           s, task_type_send, task_subtype_part_swallow, ci->mpi.tag, 0, ci, cj);
 
@@ -510,19 +508,15 @@ void engine_addtasks_send_black_holes(struct engine *e, struct cell *ci,
       scheduler_addunlock(s, t_rho,
                           ci->hydro.super->black_holes.swallow_ghost_0);
 
-      scheduler_addunlock(s, ci->hydro.super->black_holes.swallow_ghost_0,
-                          t_bh_merger);
-      scheduler_addunlock(s, t_bh_merger,
-                          ci->hydro.super->black_holes.swallow_ghost_2);
-
       scheduler_addunlock(s, ci->hydro.super->black_holes.swallow_ghost_0,
                           t_gas_swallow);
       scheduler_addunlock(s, t_gas_swallow,
                           ci->hydro.super->black_holes.swallow_ghost_1);
+      scheduler_addunlock(s, t_gas_swallow,
+                          ci->hydro.super->black_holes.swallow_ghost_2);
     }
 
     engine_addlink(e, &ci->mpi.send, t_rho);
-    engine_addlink(e, &ci->mpi.send, t_bh_merger);
     engine_addlink(e, &ci->mpi.send, t_gas_swallow);
     engine_addlink(e, &ci->mpi.send, t_feedback);
   }
@@ -532,8 +526,7 @@ void engine_addtasks_send_black_holes(struct engine *e, struct cell *ci,
     for (int k = 0; k < 8; k++)
       if (ci->progeny[k] != NULL)
         engine_addtasks_send_black_holes(e, ci->progeny[k], cj, t_rho,
-                                         t_bh_merger, t_gas_swallow,
-                                         t_feedback);
+                                         t_gas_swallow, t_feedback);
 
 #else
   error("SWIFT was not compiled with MPI support.");
@@ -956,18 +949,19 @@ void engine_addtasks_recv_stars(struct engine *e, struct cell *c,
 /**
  * @brief Add recv tasks for black_holes pairs to a hierarchy of cells.
  *
+ * The gas swallow flags and the BH merger flags are received together in a
+ * single exchange.
+ *
  * @param e The #engine.
  * @param c The foreign #cell.
  * @param t_rho The density comm. task, if it has already been created.
- * @param t_bh_merger The BH swallow comm. task, if it has already been created.
- * @param t_gas_swallow The gas swallow comm. task, if it has already been
- * created.
+ * @param t_gas_swallow The gas and BH swallow comm. task, if it has already
+ * been created.
  * @param t_feedback The recv_feed #task, if it has already been created.
  * @param tend The top-level time-step communication #task.
  */
 void engine_addtasks_recv_black_holes(struct engine *e, struct cell *c,
                                       struct task *t_rho,
-                                      struct task *t_bh_merger,
                                       struct task *t_gas_swallow,
                                       struct task *t_feedback,
                                       struct task *const tend) {
@@ -990,9 +984,6 @@ void engine_addtasks_recv_black_holes(struct engine *e, struct cell *c,
     t_rho = scheduler_addtask(s, task_type_recv, task_subtype_bpart_rho,
                               c->mpi.tag, 0, c, NULL);
 
-    t_bh_merger = scheduler_addtask(
-        s, task_type_recv, task_subtype_bpart_merger, c->mpi.tag, 0, c, NULL);
-
     t_gas_swallow = scheduler_addtask(
         s, task_type_recv, task_subtype_part_swallow, c->mpi.tag, 0, c, NULL);
 
@@ -1002,7 +993,6 @@ void engine_addtasks_recv_black_holes(struct engine *e, struct cell *c,
 
   if (t_rho != NULL) {
     engine_addlink(e, &c->mpi.recv, t_rho);
-    engine_addlink(e, &c->mpi.recv, t_bh_merger);
     engine_addlink(e, &c->mpi.recv, t_gas_swallow);
     engine_addlink(e, &c->mpi.recv, t_feedback);
 
@@ -1021,7 +1011,6 @@ void engine_addtasks_recv_black_holes(struct engine *e, struct cell *c,
     for (struct link *l = c->black_holes.swallow; l != NULL; l = l->next) {
       scheduler_addunlock(s, t_rho, l->t);
       scheduler_addunlock(s, l->t, t_gas_swallow);
-      scheduler_addunlock(s, l->t, t_bh_merger);
     }
     for (struct link *l = c->black_holes.do_gas_swallow; l != NULL;
          l = l->next) {
@@ -1029,7 +1018,7 @@ void engine_addtasks_recv_black_holes(struct engine *e, struct cell *c,
     }
     for (struct link *l = c->black_holes.do_bh_swallow; l != NULL;
          l = l->next) {
-      scheduler_addunlock(s, t_bh_merger, l->t);
+      scheduler_addunlock(s, t_gas_swallow, l->t);
       scheduler_addunlock(s, l->t, t_feedback);
     }
     for (struct link *l = c->black_holes.feedback; l != NULL; l = l->next) {
@@ -1042,7 +1031,7 @@ void engine_addtasks_recv_black_holes(struct engine *e, struct cell *c,
   if (c->split)
     for (int k = 0; k < 8; k++)
       if (c->progeny[k] != NULL)
-        engine_addtasks_recv_black_holes(e, c->progeny[k], t_rho, t_bh_merger,
+        engine_addtasks_recv_black_holes(e, c->progeny[k], t_rho,
                                          t_gas_swallow, t_feedback, tend);
 
 #else
@@ -1175,13 +1164,6 @@ void engine_make_hierarchical_tasks_common(struct engine *e, struct cell *c) {
       c->kick2 = scheduler_addtask(s, task_type_kick2, task_subtype_none, 0, 0,
                                    c, NULL);
 
-      /* Weighting task for neutrinos after the last kick */
-      if (e->neutrino_properties->use_delta_f) {
-        c->grav.neutrino_weight = scheduler_addtask(
-            s, task_type_neutrino_weight, task_subtype_none, 0, 0, c, NULL);
-        scheduler_addunlock(s, c->kick1, c->grav.neutrino_weight);
-      }
-
 #if defined(WITH_CSDS)
       struct task *kick2_or_csds;
       if (with_csds) {
@@ -4254,7 +4236,6 @@ void engine_addtasks_send_mapper(void *map_data, int num_elements,
     if ((e->policy & engine_policy_black_holes) &&
         (type & proxy_cell_type_hydro))
       engine_addtasks_send_black_holes(e, ci, cj, /*t_rho=*/NULL,
-                                       /*t_swallow=*/NULL,
                                        /*t_gas_swallow=*/NULL,
                                        /*t_feedback=*/NULL);
 
@@ -4321,7 +4302,6 @@ void engine_addtasks_recv_mapper(void *map_data, int num_elements,
     if ((e->policy & engine_policy_black_holes) &&
         (type & proxy_cell_type_hydro))
       engine_addtasks_recv_black_holes(e, ci, /*t_rho=*/NULL,
-                                       /*t_swallow=*/NULL,
                                        /*t_gas_swallow=*/NULL,
                                        /*t_feedback=*/NULL, tend);
 
@@ -1243,10 +1243,9 @@ void engine_marktasks_mapper(void *map_data, int num_elements,
         if (ci_nodeID != nodeID) {
 
           /* Receive the foreign parts to compute BH accretion rates and do the
-           * swallowing */
+           * swallowing (the BH merger flags come with the gas swallow ones) */
           scheduler_activate_recv(s, ci->mpi.recv, task_subtype_rho);
           scheduler_activate_recv(s, ci->mpi.recv, task_subtype_part_swallow);
-          scheduler_activate_recv(s, ci->mpi.recv, task_subtype_bpart_merger);
 
           /* Send the local BHs to tag the particles to swallow and to do
            * feedback */
@@ -1267,8 +1266,6 @@ void engine_marktasks_mapper(void *map_data, int num_elements,
           scheduler_activate_send(s, cj->mpi.send, task_subtype_rho, ci_nodeID);
           scheduler_activate_send(s, cj->mpi.send, task_subtype_part_swallow,
                                   ci_nodeID);
-          scheduler_activate_send(s, cj->mpi.send, task_subtype_bpart_merger,
-                                  ci_nodeID);
 
           /* Drift the cell which will be sent; note that not all sent
              particles will be drifted, only those that are needed. */
@@ -1277,10 +1274,9 @@ void engine_marktasks_mapper(void *map_data, int num_elements,
         } else if (cj_nodeID != nodeID) {
 
           /* Receive the foreign parts to compute BH accretion rates and do the
-           * swallowing */
+           * swallowing (the BH merger flags come with the gas swallow ones) */
           scheduler_activate_recv(s, cj->mpi.recv, task_subtype_rho);
           scheduler_activate_recv(s, cj->mpi.recv, task_subtype_part_swallow);
-          scheduler_activate_recv(s, cj->mpi.recv, task_subtype_bpart_merger);
 
           /* Send the local BHs to tag the particles to swallow and to do
            * feedback */
@@ -1301,8 +1297,6 @@ void engine_marktasks_mapper(void *map_data, int num_elements,
           scheduler_activate_send(s, ci->mpi.send, task_subtype_rho, cj_nodeID);
           scheduler_activate_send(s, ci->mpi.send, task_subtype_part_swallow,
                                   cj_nodeID);
-          scheduler_activate_send(s, ci->mpi.send, task_subtype_bpart_merger,
-                                  cj_nodeID);
 
           /* Drift the cell which will be sent; note that not all sent
              particles will be drifted, only those that are needed. */
@@ -1467,13 +1461,6 @@ void engine_marktasks_mapper(void *map_data, int num_elements,
       if (cell_is_active_gravity(t->ci, e)) scheduler_activate(s, t);
     }
 
-    /* Activate the weighting task for neutrinos */
-    else if (t_type == task_type_neutrino_weight) {
-      if (cell_is_active_gravity(t->ci, e)) {
-        scheduler_activate(s, t);
-      }
-    }
-
     /* Kick ? */
     else if (t_type == task_type_kick1 || t_type == task_type_kick2) {
 
@@ -536,9 +536,13 @@ void engine_do_unskip_sub_cycle_mapper(void *map_data, int num_elements,
 /**
  * @brief Unskip all the RT tasks that are active during this sub-cycle.
  *
+ * The active local top-level cells are moved to the start of
+ * s->local_cells_with_tasks_top.
+ *
  * @param e The #engine.
+ * @return The number of active local top-level cells.
  */
-void engine_unskip_rt_sub_cycle(struct engine *e) {
+int engine_unskip_rt_sub_cycle(struct engine *e) {
 
   const ticks tic = getticks();
   struct space *s = e->s;
@@ -568,4 +572,91 @@ void engine_unskip_rt_sub_cycle(struct engine *e) {
   if (e->verbose)
     message("took %.3f %s.", clocks_from_ticks(getticks() - tic),
             clocks_getunit());
+
+  return num_active_cells;
+}
+
+/**
+ * @brief Unskip all the RT tasks that are active during this sub-cycle,
+ * re-using the activations of an earlier sub-cycle of the same step with the
+ * same highest active time-bin if there is one.
+ *
+ * Replaying the list of tasks avoids walking the cell hierarchies and the
+ * task links again. The first sub-cycle with a given highest active bin does
+ * the regular unskip and records the result in the cache.
+ *
+ * @param e The #engine.
+ * @param cache The activations recorded so far during this step.
+ * @return The number of active local top-level cells, whose indices are in
+ * cache->cells_active[e->max_active_bin_subcycle].
+ */
+int engine_unskip_rt_sub_cycle_cached(struct engine *e,
+                                      struct rt_sub_cycle_cache *cache) {
+
+  const ticks tic = getticks();
+  struct scheduler *sched = &e->sched;
+  const timebin_t bin = e->max_active_bin_subcycle;
+
+  /* First time we see this set of active bins: regular unskip */
+  if (cache->tid_active[bin] == NULL) {
+
+    if (sched->active_count != 0)
+      error("Tasks have been activated before the RT sub-cycle unskip!");
+
+    const int num_active_cells = engine_unskip_rt_sub_cycle(e);
+
+    /* Record what was activated */
+    cache->active_count[bin] = sched->active_count;
+    cache->num_cells_active[bin] = num_active_cells;
+    cache->tid_active[bin] =
+        (int *)malloc((sched->active_count + 1) * sizeof(int));
+    cache->cells_active[bin] =
+        (int *)malloc((num_active_cells + 1) * sizeof(int));
+    if (cache->tid_active[bin] == NULL || cache->cells_active[bin] == NULL)
+      error("Failed to allocate the RT sub-cycle cache.");
+    memcpy(cache->tid_active[bin], sched->tid_active,
+           sched->active_count * sizeof(int));
+    memcpy(cache->cells_active[bin], e->s->local_cells_with_tasks_top,
+           num_active_cells * sizeof(int));
+
+    return num_active_cells;
+  }
+
+  /* Re-activate the same tasks */
+  const int *tid_active = cache->tid_active[bin];
+  for (int k = 0; k < cache->active_count[bin]; k++) {
+    struct task *t = &sched->tasks[tid_active[k]];
+    scheduler_activate(sched, t);
+
+#ifdef WITH_MPI
+    /* No RT sorts during sub-cycles: the regular unskip flags the cells
+     * receiving RT data, and the recv task clears the flag when it runs. */
+    if (t->type == task_type_recv && (t->subtype == task_subtype_rt_gradient ||
+                                      t->subtype == task_subtype_rt_transport))
+      cell_set_skip_rt_sort_flag_up(t->ci);
+#endif
+  }
+
+  if (e->verbose)
+    message("took %.3f %s.", clocks_from_ticks(getticks() - tic),
+            clocks_getunit());
+
+  return cache->num_cells_active[bin];
+}
+
+/**
+ * @brief Free the content of a #rt_sub_cycle_cache.
+ *
+ * @param cache The #rt_sub_cycle_cache.
+ */
+void engine_rt_sub_cycle_cache_clean(struct rt_sub_cycle_cache *cache) {
+
+  for (int bin = 0; bin < num_time_bins + 1; bin++) {
+    free(cache->tid_active[bin]);
+    free(cache->cells_active[bin]);
+    cache->tid_active[bin] = NULL;
+    cache->cells_active[bin] = NULL;
+    cache->active_count[bin] = 0;
+    cache->num_cells_active[bin] = 0;
+  }
 }
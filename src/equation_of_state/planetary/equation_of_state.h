@@ -2295,6 +2295,12 @@ __attribute__((always_inline)) INLINE static void eos_init(
     convert_units_HM80(&e->HM80_rock, us);
   }
 
+  // Look-up structure for the SESAME-style tables
+  const int SESAME_use_uniform_grid = parser_get_opt_param_int(
+      params, "EoS:planetary_SESAME_use_uniform_grid", 0);
+  const int SESAME_grid_factor = parser_get_opt_param_int(
+      params, "EoS:planetary_SESAME_uniform_grid_factor", 2);
+
   // SESAME
   if (parser_get_opt_param_int(params, "EoS:planetary_use_SESAME_iron", 0)) {
     char SESAME_iron_table_file[PARSER_MAX_LINE_SIZE];
@@ -2304,6 +2310,8 @@ __attribute__((always_inline)) INLINE static void eos_init(
     load_table_SESAME(&e->SESAME_iron, SESAME_iron_table_file);
     prepare_table_SESAME(&e->SESAME_iron);
     convert_units_SESAME(&e->SESAME_iron, us);
+    resample_table_SESAME(&e->SESAME_iron, SESAME_use_uniform_grid,
+                          SESAME_grid_factor);
   }
   if (parser_get_opt_param_int(params, "EoS:planetary_use_SESAME_basalt", 0)) {
     char SESAME_basalt_table_file[PARSER_MAX_LINE_SIZE];
@@ -2313,6 +2321,8 @@ __attribute__((always_inline)) INLINE static void eos_init(
     load_table_SESAME(&e->SESAME_basalt, SESAME_basalt_table_file);
     prepare_table_SESAME(&e->SESAME_basalt);
     convert_units_SESAME(&e->SESAME_basalt, us);
+    resample_table_SESAME(&e->SESAME_basalt, SESAME_use_uniform_grid,
+                          SESAME_grid_factor);
   }
   if (parser_get_opt_param_int(params, "EoS:planetary_use_SESAME_water", 0)) {
     char SESAME_water_table_file[PARSER_MAX_LINE_SIZE];
@@ -2322,6 +2332,8 @@ __attribute__((always_inline)) INLINE static void eos_init(
     load_table_SESAME(&e->SESAME_water, SESAME_water_table_file);
     prepare_table_SESAME(&e->SESAME_water);
     convert_units_SESAME(&e->SESAME_water, us);
+    resample_table_SESAME(&e->SESAME_water, SESAME_use_uniform_grid,
+                          SESAME_grid_factor);
   }
   if (parser_get_opt_param_int(params, "EoS:planetary_use_SS08_water", 0)) {
     char SS08_water_table_file[PARSER_MAX_LINE_SIZE];
@@ -2331,6 +2343,8 @@ __attribute__((always_inline)) INLINE static void eos_init(
     load_table_SESAME(&e->SS08_water, SS08_water_table_file);
     prepare_table_SESAME(&e->SS08_water);
     convert_units_SESAME(&e->SS08_water, us);
+    resample_table_SESAME(&e->SS08_water, SESAME_use_uniform_grid,
+                          SESAME_grid_factor);
   }
 
   // ANEOS -- using SESAME-style tables
@@ -2344,6 +2358,8 @@ __attribute__((always_inline)) INLINE static void eos_init(
     load_table_SESAME(&e->ANEOS_forsterite, ANEOS_forsterite_table_file);
     prepare_table_SESAME(&e->ANEOS_forsterite);
     convert_units_SESAME(&e->ANEOS_forsterite, us);
+    resample_table_SESAME(&e->ANEOS_forsterite, SESAME_use_uniform_grid,
+                          SESAME_grid_factor);
   }
   if (parser_get_opt_param_int(params, "EoS:planetary_use_ANEOS_iron", 0)) {
     char ANEOS_iron_table_file[PARSER_MAX_LINE_SIZE];
@@ -2353,6 +2369,8 @@ __attribute__((always_inline)) INLINE static void eos_init(
     load_table_SESAME(&e->ANEOS_iron, ANEOS_iron_table_file);
     prepare_table_SESAME(&e->ANEOS_iron);
     convert_units_SESAME(&e->ANEOS_iron, us);
+    resample_table_SESAME(&e->ANEOS_iron, SESAME_use_uniform_grid,
+                          SESAME_grid_factor);
   }
   if (parser_get_opt_param_int(params, "EoS:planetary_use_ANEOS_Fe85Si15", 0)) {
     char ANEOS_Fe85Si15_table_file[PARSER_MAX_LINE_SIZE];
@@ -2362,6 +2380,8 @@ __attribute__((always_inline)) INLINE static void eos_init(
     load_table_SESAME(&e->ANEOS_Fe85Si15, ANEOS_Fe85Si15_table_file);
     prepare_table_SESAME(&e->ANEOS_Fe85Si15);
     convert_units_SESAME(&e->ANEOS_Fe85Si15, us);
+    resample_table_SESAME(&e->ANEOS_Fe85Si15, SESAME_use_uniform_grid,
+                          SESAME_grid_factor);
   }
 }
 
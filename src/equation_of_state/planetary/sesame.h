@@ -33,9 +33,12 @@
 
 /* Local headers. */
 #include "adiabatic_index.h"
+#include "align.h"
 #include "common_io.h"
 #include "equation_of_state.h"
 #include "inline.h"
+#include "memuse_shared.h"
+#include "minmax.h"
 #include "physical_constants.h"
 #include "units.h"
 #include "utilities.h"
@@ -50,8 +53,21 @@ struct SESAME_params {
   int version_date, num_rho, num_T;
   float u_tiny, P_tiny, c_tiny, s_tiny;
   enum eos_planetary_material_id mat_id;
+
+  // Tables resampled onto uniform grids in log(rho) and log(u) or log(s)
+  int use_uniform_grid;
+  int grid_num_rho, grid_num_u, grid_num_s;
+  float grid_log_rho_min, grid_log_u_min, grid_log_s_min;
+  float grid_inv_dlog_rho, grid_inv_dlog_u, grid_inv_dlog_s;
+  float *grid_log_P_rho_u;
+  float *grid_log_c_rho_u;
+  float *grid_log_u_rho_s;
 };
 
+// Value flagging the nodes of the uniform grids where the table value is not
+// positive and which can hence not be interpolated in log
+#define SESAME_grid_invalid (-FLT_MAX)
+
 // Parameter values for each material
 INLINE static void set_SESAME_iron(struct SESAME_params *mat,
                                    enum eos_planetary_material_id mat_id) {
@@ -167,16 +183,30 @@ INLINE static void load_table_SESAME(struct SESAME_params *mat,
   mat->num_T--;
   float ignore;
 
-  // Allocate table memory
-  mat->table_log_rho = (float *)malloc(mat->num_rho * sizeof(float));
-  mat->table_log_u_rho_T =
-      (float *)malloc(mat->num_rho * mat->num_T * sizeof(float));
-  mat->table_P_rho_T =
-      (float *)malloc(mat->num_rho * mat->num_T * sizeof(float));
-  mat->table_c_rho_T =
-      (float *)malloc(mat->num_rho * mat->num_T * sizeof(float));
-  mat->table_log_s_rho_T =
-      (float *)malloc(mat->num_rho * mat->num_T * sizeof(float));
+  // Allocate table memory, shared by all the ranks of a node
+  const size_t num_rho_T = mat->num_rho * mat->num_T;
+  if (swift_shared_memalign("eos_table.SESAME", (void **)&mat->table_log_rho,
+                            SWIFT_STRUCT_ALIGNMENT,
+                            mat->num_rho * sizeof(float)) != 0 ||
+      swift_shared_memalign(
+          "eos_table.SESAME", (void **)&mat->table_log_u_rho_T,
+          SWIFT_STRUCT_ALIGNMENT, num_rho_T * sizeof(float)) != 0 ||
+      swift_shared_memalign("eos_table.SESAME", (void **)&mat->table_P_rho_T,
+                            SWIFT_STRUCT_ALIGNMENT,
+                            num_rho_T * sizeof(float)) != 0 ||
+      swift_shared_memalign("eos_table.SESAME", (void **)&mat->table_c_rho_T,
+                            SWIFT_STRUCT_ALIGNMENT,
+                            num_rho_T * sizeof(float)) != 0 ||
+      swift_shared_memalign(
+          "eos_table.SESAME", (void **)&mat->table_log_s_rho_T,
+          SWIFT_STRUCT_ALIGNMENT, num_rho_T * sizeof(float)) != 0)
+    error("Failed to allocate the SESAME EoS tables for %s", table_file);
+
+  // Only one rank per node reads the tables
+  if (!swift_shared_is_writer()) {
+    fclose(f);
+    return;
+  }
 
   // Densities (not log yet)
   for (int i_rho = -1; i_rho < mat->num_rho; i_rho++) {
@@ -221,6 +251,16 @@ INLINE static void load_table_SESAME(struct SESAME_params *mat,
 // Misc. modifications
 INLINE static void prepare_table_SESAME(struct SESAME_params *mat) {
 
+  // Only one rank per node modifies the tables, the others just need the
+  // tiny values
+  if (!swift_shared_is_writer()) {
+    swift_shared_bcast(&mat->u_tiny, sizeof(float));
+    swift_shared_bcast(&mat->P_tiny, sizeof(float));
+    swift_shared_bcast(&mat->c_tiny, sizeof(float));
+    swift_shared_bcast(&mat->s_tiny, sizeof(float));
+    return;
+  }
+
   // Convert densities to log(density)
   for (int i_rho = 0; i_rho < mat->num_rho; i_rho++) {
     mat->table_log_rho[i_rho] = logf(mat->table_log_rho[i_rho]);
@@ -276,6 +316,12 @@ INLINE static void prepare_table_SESAME(struct SESAME_params *mat) {
   mat->c_tiny *= 1e-3f;
   mat->s_tiny *= 1e-3f;
 
+  // Share the tiny values with the other ranks of the node
+  swift_shared_bcast(&mat->u_tiny, sizeof(float));
+  swift_shared_bcast(&mat->P_tiny, sizeof(float));
+  swift_shared_bcast(&mat->c_tiny, sizeof(float));
+  swift_shared_bcast(&mat->s_tiny, sizeof(float));
+
   // Convert sp. int. energies to log(sp. int. energy), same for sp. entropies
   for (int i_rho = 0; i_rho < mat->num_rho; i_rho++) {
     for (int i_T = 0; i_T < mat->num_T; i_T++) {
@@ -305,33 +351,40 @@ INLINE static void convert_units_SESAME(struct SESAME_params *mat,
   struct unit_system si;
   units_init_si(&si);
 
-  // Densities (log)
-  for (int i_rho = 0; i_rho < mat->num_rho; i_rho++) {
-    mat->table_log_rho[i_rho] +=
-        logf(units_cgs_conversion_factor(&si, UNIT_CONV_DENSITY) /
-             units_cgs_conversion_factor(us, UNIT_CONV_DENSITY));
-  }
+  // Only one rank per node converts the (shared) tables
+  if (swift_shared_is_writer()) {
 
-  // Sp. int. energies (log), pressures, sound speeds, and sp. entropies
-  for (int i_rho = 0; i_rho < mat->num_rho; i_rho++) {
-    for (int i_T = 0; i_T < mat->num_T; i_T++) {
-      mat->table_log_u_rho_T[i_rho * mat->num_T + i_T] += logf(
-          units_cgs_conversion_factor(&si, UNIT_CONV_ENERGY_PER_UNIT_MASS) /
-          units_cgs_conversion_factor(us, UNIT_CONV_ENERGY_PER_UNIT_MASS));
-      mat->table_P_rho_T[i_rho * mat->num_T + i_T] *=
-          units_cgs_conversion_factor(&si, UNIT_CONV_PRESSURE) /
-          units_cgs_conversion_factor(us, UNIT_CONV_PRESSURE);
-      mat->table_c_rho_T[i_rho * mat->num_T + i_T] *=
-          units_cgs_conversion_factor(&si, UNIT_CONV_SPEED) /
-          units_cgs_conversion_factor(us, UNIT_CONV_SPEED);
-      mat->table_log_s_rho_T[i_rho * mat->num_T + i_T] +=
-          logf(units_cgs_conversion_factor(
-                   &si, UNIT_CONV_PHYSICAL_ENTROPY_PER_UNIT_MASS) /
-               units_cgs_conversion_factor(
-                   us, UNIT_CONV_PHYSICAL_ENTROPY_PER_UNIT_MASS));
+    // Densities (log)
+    for (int i_rho = 0; i_rho < mat->num_rho; i_rho++) {
+      mat->table_log_rho[i_rho] +=
+          logf(units_cgs_conversion_factor(&si, UNIT_CONV_DENSITY) /
+               units_cgs_conversion_factor(us, UNIT_CONV_DENSITY));
+    }
+
+    // Sp. int. energies (log), pressures, sound speeds, and sp. entropies
+    for (int i_rho = 0; i_rho < mat->num_rho; i_rho++) {
+      for (int i_T = 0; i_T < mat->num_T; i_T++) {
+        mat->table_log_u_rho_T[i_rho * mat->num_T + i_T] += logf(
+            units_cgs_conversion_factor(&si, UNIT_CONV_ENERGY_PER_UNIT_MASS) /
+            units_cgs_conversion_factor(us, UNIT_CONV_ENERGY_PER_UNIT_MASS));
+        mat->table_P_rho_T[i_rho * mat->num_T + i_T] *=
+            units_cgs_conversion_factor(&si, UNIT_CONV_PRESSURE) /
+            units_cgs_conversion_factor(us, UNIT_CONV_PRESSURE);
+        mat->table_c_rho_T[i_rho * mat->num_T + i_T] *=
+            units_cgs_conversion_factor(&si, UNIT_CONV_SPEED) /
+            units_cgs_conversion_factor(us, UNIT_CONV_SPEED);
+        mat->table_log_s_rho_T[i_rho * mat->num_T + i_T] +=
+            logf(units_cgs_conversion_factor(
+                     &si, UNIT_CONV_PHYSICAL_ENTROPY_PER_UNIT_MASS) /
+                 units_cgs_conversion_factor(
+                     us, UNIT_CONV_PHYSICAL_ENTROPY_PER_UNIT_MASS));
+      }
     }
   }
 
+  // Make the tables visible to all the ranks
+  swift_shared_barrier();
+
   // Tiny values
   mat->u_tiny *=
       units_cgs_conversion_factor(&si, UNIT_CONV_ENERGY_PER_UNIT_MASS) /
@@ -346,6 +399,47 @@ INLINE static void convert_units_SESAME(struct SESAME_params *mat,
       units_cgs_conversion_factor(us, UNIT_CONV_PHYSICAL_ENTROPY_PER_UNIT_MASS);
 }
 
+/*
+    Bilinear interpolation in one of the uniform grids.
+
+    Returns 0 (and leaves the result untouched) if the point lies outside the
+    grid or if one of the surrounding nodes is flagged as invalid. The caller
+    then falls back to the interpolation in the original tables.
+*/
+INLINE static int SESAME_uniform_grid_interp(
+    const float *grid, const int num_x, const int num_y, const float x_min,
+    const float inv_dx, const float y_min, const float inv_dy, const float x,
+    const float y, float *result) {
+
+  // Position in units of the grid spacing
+  const float fx = (x - x_min) * inv_dx;
+  const float fy = (y - y_min) * inv_dy;
+
+  // Outside the grid? (Written such that NaNs also fail)
+  if (!(fx >= 0.f && fx < num_x - 1 && fy >= 0.f && fy < num_y - 1)) return 0;
+
+  const int ix = (int)fx;
+  const int iy = (int)fy;
+  const float wx = fx - ix;
+  const float wy = fy - iy;
+
+  // Grid values
+  const float *g = grid + ix * num_y + iy;
+  const float g_1 = g[0];
+  const float g_2 = g[1];
+  const float g_3 = g[num_y];
+  const float g_4 = g[num_y + 1];
+
+  if (g_1 == SESAME_grid_invalid || g_2 == SESAME_grid_invalid ||
+      g_3 == SESAME_grid_invalid || g_4 == SESAME_grid_invalid)
+    return 0;
+
+  *result = (1.f - wx) * ((1.f - wy) * g_1 + wy * g_2) +
+            wx * ((1.f - wy) * g_3 + wy * g_4);
+
+  return 1;
+}
+
 // gas_internal_energy_from_entropy
 INLINE static float SESAME_internal_energy_from_entropy(
     float density, float entropy, const struct SESAME_params *mat) {
@@ -356,6 +450,15 @@ INLINE static float SESAME_internal_energy_from_entropy(
     return 0.f;
   }
 
+  // Fast path: O(1) look-up in the uniform grid
+  if (mat->use_uniform_grid &&
+      SESAME_uniform_grid_interp(
+          mat->grid_log_u_rho_s, mat->grid_num_rho, mat->grid_num_s,
+          mat->grid_log_rho_min, mat->grid_inv_dlog_rho, mat->grid_log_s_min,
+          mat->grid_inv_dlog_s, logf(density), logf(entropy), &u)) {
+    return expf(u);
+  }
+
   int idx_rho, idx_s_1, idx_s_2;
   float intp_rho, intp_s_1, intp_s_2;
   const float log_rho = logf(density);
@@ -482,6 +585,15 @@ INLINE static float SESAME_pressure_from_internal_energy(
     return 0.f;
   }
 
+  // Fast path: O(1) look-up in the uniform grid
+  if (mat->use_uniform_grid &&
+      SESAME_uniform_grid_interp(
+          mat->grid_log_P_rho_u, mat->grid_num_rho, mat->grid_num_u,
+          mat->grid_log_rho_min, mat->grid_inv_dlog_rho, mat->grid_log_u_min,
+          mat->grid_inv_dlog_u, logf(density), logf(u), &P)) {
+    return expf(P);
+  }
+
   int idx_rho, idx_u_1, idx_u_2;
   float intp_rho, intp_u_1, intp_u_2;
   const float log_rho = logf(density);
@@ -607,6 +719,15 @@ INLINE static float SESAME_soundspeed_from_internal_energy(
     return 0.f;
   }
 
+  // Fast path: O(1) look-up in the uniform grid
+  if (mat->use_uniform_grid &&
+      SESAME_uniform_grid_interp(
+          mat->grid_log_c_rho_u, mat->grid_num_rho, mat->grid_num_u,
+          mat->grid_log_rho_min, mat->grid_inv_dlog_rho, mat->grid_log_u_min,
+          mat->grid_inv_dlog_u, logf(density), logf(u), &c)) {
+    return expf(c);
+  }
+
   int idx_rho, idx_u_1, idx_u_2;
   float intp_rho, intp_u_1, intp_u_2;
   const float log_rho = logf(density);
@@ -724,4 +845,145 @@ INLINE static float SESAME_soundspeed_from_pressure(
   return 0.f;
 }
 
+/*
+    Resample the (converted) tables onto uniform grids in log(rho) and log(u)
+    for P and c, and in log(rho) and log(s) for u.
+
+    The table index of a given value can then be computed directly instead of
+    with binary searches in each of the rows. Each node of the grids is
+    evaluated with the functions above using the original tables, so the
+    grids reproduce them away from the edges. Points outside the grids, near
+    the ends of the table rows, or next to nodes with non-positive values
+    still use the original tables.
+*/
+INLINE static void resample_table_SESAME(struct SESAME_params *mat,
+                                         const int use_uniform_grid,
+                                         const int grid_factor) {
+
+  mat->use_uniform_grid = 0;
+  mat->grid_log_P_rho_u = NULL;
+  mat->grid_log_c_rho_u = NULL;
+  mat->grid_log_u_rho_s = NULL;
+  if (!use_uniform_grid) return;
+
+  if (grid_factor < 1)
+    error("The SESAME uniform grid factor must be at least 1 (got %d)",
+          grid_factor);
+
+  // Extent of the tables
+  const int num_rho_T = mat->num_rho * mat->num_T;
+  float log_u_min = FLT_MAX, log_u_max = -FLT_MAX;
+  float log_s_min = FLT_MAX, log_s_max = -FLT_MAX;
+  for (int i = 0; i < num_rho_T; i++) {
+    log_u_min = fminf(log_u_min, mat->table_log_u_rho_T[i]);
+    log_u_max = fmaxf(log_u_max, mat->table_log_u_rho_T[i]);
+    log_s_min = fminf(log_s_min, mat->table_log_s_rho_T[i]);
+    log_s_max = fmaxf(log_s_max, mat->table_log_s_rho_T[i]);
+  }
+  const float log_rho_min = mat->table_log_rho[0];
+  const float log_rho_max = mat->table_log_rho[mat->num_rho - 1];
+
+  // Grid properties
+  mat->grid_num_rho = grid_factor * mat->num_rho;
+  mat->grid_num_u = grid_factor * mat->num_T;
+  mat->grid_num_s = grid_factor * mat->num_T;
+  mat->grid_log_rho_min = log_rho_min;
+  mat->grid_log_u_min = log_u_min;
+  mat->grid_log_s_min = log_s_min;
+  const float dlog_rho = (log_rho_max - log_rho_min) / (mat->grid_num_rho - 1);
+  const float dlog_u = (log_u_max - log_u_min) / (mat->grid_num_u - 1);
+  const float dlog_s = (log_s_max - log_s_min) / (mat->grid_num_s - 1);
+  if (!(dlog_rho > 0.f && dlog_u > 0.f && dlog_s > 0.f))
+    error("Cannot build uniform grids for the SESAME table of material %d",
+          mat->mat_id);
+  mat->grid_inv_dlog_rho = 1.f / dlog_rho;
+  mat->grid_inv_dlog_u = 1.f / dlog_u;
+  mat->grid_inv_dlog_s = 1.f / dlog_s;
+
+  // Allocate the grids, shared by all the ranks of a node
+  const size_t num_rho_u = (size_t)mat->grid_num_rho * mat->grid_num_u;
+  const size_t num_rho_s = (size_t)mat->grid_num_rho * mat->grid_num_s;
+  if (swift_shared_memalign("eos_table.SESAME",
+                            (void **)&mat->grid_log_P_rho_u,
+                            SWIFT_STRUCT_ALIGNMENT,
+                            num_rho_u * sizeof(float)) != 0 ||
+      swift_shared_memalign("eos_table.SESAME",
+                            (void **)&mat->grid_log_c_rho_u,
+                            SWIFT_STRUCT_ALIGNMENT,
+                            num_rho_u * sizeof(float)) != 0 ||
+      swift_shared_memalign("eos_table.SESAME",
+                            (void **)&mat->grid_log_u_rho_s,
+                            SWIFT_STRUCT_ALIGNMENT,
+                            num_rho_s * sizeof(float)) != 0)
+    error("Failed to allocate the SESAME EoS uniform grids");
+
+  // Only one rank per node fills the (shared) grids
+  if (swift_shared_is_writer()) {
+
+    for (int i = 0; i < mat->grid_num_rho; i++) {
+      const float log_rho = log_rho_min + i * dlog_rho;
+      const float rho = expf(log_rho);
+
+      // Table rows used to interpolate around this grid density
+      int row_min = find_value_in_monot_incr_array(
+          log_rho - dlog_rho, mat->table_log_rho, mat->num_rho);
+      int row_max = find_value_in_monot_incr_array(
+          log_rho + dlog_rho, mat->table_log_rho, mat->num_rho);
+      row_min = max(row_min, 0);
+      row_max = min(row_max + 1, mat->num_rho - 1);
+
+      // Range of u and s covered by all these rows. Outside of it, the
+      // original tables are clipped at the edge of a row and the results are
+      // not smooth enough to be resampled.
+      float row_log_u_min = -FLT_MAX, row_log_u_max = FLT_MAX;
+      float row_log_s_min = -FLT_MAX, row_log_s_max = FLT_MAX;
+      for (int i_rho = row_min; i_rho <= row_max; i_rho++) {
+        const float *log_u_row = mat->table_log_u_rho_T + i_rho * mat->num_T;
+        const float *log_s_row = mat->table_log_s_rho_T + i_rho * mat->num_T;
+        row_log_u_min = fmaxf(row_log_u_min, log_u_row[0]);
+        row_log_u_max = fminf(row_log_u_max, log_u_row[mat->num_T - 1]);
+        row_log_s_min = fmaxf(row_log_s_min, log_s_row[0]);
+        row_log_s_max = fminf(row_log_s_max, log_s_row[mat->num_T - 1]);
+      }
+
+      for (int j = 0; j < mat->grid_num_u; j++) {
+        const float log_u = log_u_min + j * dlog_u;
+        float *log_P = &mat->grid_log_P_rho_u[i * mat->grid_num_u + j];
+        float *log_c = &mat->grid_log_c_rho_u[i * mat->grid_num_u + j];
+
+        if (log_u < row_log_u_min || log_u > row_log_u_max) {
+          *log_P = SESAME_grid_invalid;
+          *log_c = SESAME_grid_invalid;
+          continue;
+        }
+
+        const float u = expf(log_u);
+        const float P = SESAME_pressure_from_internal_energy(rho, u, mat);
+        const float c = SESAME_soundspeed_from_internal_energy(rho, u, mat);
+        *log_P = (P > 0.f) ? logf(P) : SESAME_grid_invalid;
+        *log_c = (c > 0.f) ? logf(c) : SESAME_grid_invalid;
+      }
+
+      for (int j = 0; j < mat->grid_num_s; j++) {
+        const float log_s = log_s_min + j * dlog_s;
+        float *log_u = &mat->grid_log_u_rho_s[i * mat->grid_num_s + j];
+
+        if (log_s < row_log_s_min || log_s > row_log_s_max) {
+          *log_u = SESAME_grid_invalid;
+          continue;
+        }
+
+        const float u =
+            SESAME_internal_energy_from_entropy(rho, expf(log_s), mat);
+        *log_u = (u > 0.f) ? logf(u) : SESAME_grid_invalid;
+      }
+    }
+  }
+
+  // Make the grids visible to all the ranks
+  swift_shared_barrier();
+
+  mat->use_uniform_grid = 1;
+}
+
 #endif /* SWIFT_SESAME_EQUATION_OF_STATE_H */
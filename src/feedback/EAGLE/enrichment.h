@@ -249,6 +249,104 @@ INLINE static void determine_bin_yields(int* index_Z_low, int* index_Z_high,
   }
 }
 
+/**
+ * @brief Integrate the yields of an enrichment channel over the IMF between
+ * two masses.
+ *
+ * The IMF integration weights only depend on the mass range and are computed
+ * once. The interpolation in metallicity is linear, so each table is
+ * integrated at the two bracketing metallicities and the integrals are
+ * interpolated. The ejecta integrals are shared by all the elements.
+ *
+ * @param log10_min_mass log10 mass at the end of step
+ * @param log10_max_mass log10 mass at the beginning of step
+ * @param Z The total metallicity of the star (metal mass fraction).
+ * @param abundances The individual metal abundances (mass fractions) of the
+ * star.
+ * @param table The #yield_table of the channel.
+ * @param N_metals The number of metallicity bins of the channel's table.
+ * @param props Properties of the feedback model.
+ * @param metal_mass_released (return) The mass of each element released.
+ * @param metal_mass_released_total (return) The total metal mass released.
+ * @param mass_ejected (return) The total mass ejected.
+ */
+INLINE static void integrate_channel_yields(
+    const double log10_min_mass, const double log10_max_mass, const double Z,
+    const float* const abundances, const struct yield_table* table,
+    const int N_metals, const struct feedback_props* props,
+    double metal_mass_released[chemistry_element_count],
+    double* metal_mass_released_total, double* mass_ejected) {
+
+  /* Metal mass produced by the star */
+  const double* const total_yields = table->total_metals_IMF_resampled;
+
+  /* Individual elements produced by the star */
+  const double* const metal_yields = table->yield_IMF_resampled;
+
+  /* Elements already in the stars that are ejected */
+  const double* const ejecta = table->ejecta_IMF_resampled;
+
+  /* determine which IMF mass bins contribute to the integral and how */
+  double imf_weights[eagle_feedback_N_imf_bins];
+  int i_min, i_max;
+  imf_integration_weights(log10_min_mass, log10_max_mass, imf_weights, &i_min,
+                          &i_max, props);
+
+  /* determine which metallicity bin and offset this star belongs to */
+  int index_Z_lo = 0, index_Z_hi = 0;
+  float dZ = 0.f;
+  determine_bin_yields(&index_Z_lo, &index_Z_hi, &dZ, log10(Z),
+                       table->metallicity, N_metals);
+
+  const int lo_index_2d = row_major_index_2d(index_Z_lo, 0, N_metals,
+                                             eagle_feedback_N_imf_bins);
+  const int hi_index_2d = row_major_index_2d(index_Z_hi, 0, N_metals,
+                                             eagle_feedback_N_imf_bins);
+
+  const double ejecta_lo =
+      imf_weighted_sum(imf_weights, ejecta + lo_index_2d, i_min, i_max);
+  const double ejecta_hi =
+      imf_weighted_sum(imf_weights, ejecta + hi_index_2d, i_min, i_max);
+
+  /*******************************
+   * Compute metal mass produced *
+   *******************************/
+  for (int elem = 0; elem < chemistry_element_count; elem++) {
+
+    const int lo_index_3d =
+        row_major_index_3d(index_Z_lo, elem, 0, N_metals,
+                           chemistry_element_count, eagle_feedback_N_imf_bins);
+    const int hi_index_3d =
+        row_major_index_3d(index_Z_hi, elem, 0, N_metals,
+                           chemistry_element_count, eagle_feedback_N_imf_bins);
+
+    const double yield_lo =
+        imf_weighted_sum(imf_weights, metal_yields + lo_index_3d, i_min, i_max);
+    const double yield_hi =
+        imf_weighted_sum(imf_weights, metal_yields + hi_index_3d, i_min, i_max);
+
+    metal_mass_released[elem] =
+        (1.f - dZ) * (yield_lo + abundances[elem] * ejecta_lo) +
+        (0.f + dZ) * (yield_hi + abundances[elem] * ejecta_hi);
+  }
+
+  /*************************************
+   * Compute total metal mass produced *
+   *************************************/
+  const double total_lo =
+      imf_weighted_sum(imf_weights, total_yields + lo_index_2d, i_min, i_max);
+  const double total_hi =
+      imf_weighted_sum(imf_weights, total_yields + hi_index_2d, i_min, i_max);
+
+  *metal_mass_released_total = (1.f - dZ) * (total_lo + Z * ejecta_lo) +
+                               (0.f + dZ) * (total_hi + Z * ejecta_hi);
+
+  /************************************************
+   * Compute the total mass ejected from the star *
+   ************************************************/
+  *mass_ejected = (1.f - dZ) * ejecta_lo + dZ * ejecta_hi;
+}
+
 /**
  * @brief compute enrichment and feedback due to SNIa. To do this compute the
  * number of SNIa that occur during the timestep, multiply by constants read
@@ -343,18 +441,6 @@ INLINE static void evolve_SNII(
     const struct feedback_props* props,
     struct feedback_spart_data* const feedback_data) {
 
-  /* Pull out common arrays */
-
-  /* Metal mass produced by the star */
-  const double* const total_yields =
-      props->yield_SNII.total_metals_IMF_resampled;
-
-  /* Individual elements produced by the star */
-  const double* const metal_yields = props->yield_SNII.yield_IMF_resampled;
-
-  /* Elements already in the stars that are ejected */
-  const double* const ejecta = props->yield_SNII.ejecta_IMF_resampled;
-
   /* If mass at beginning of step is less than tabulated lower bound for IMF,
    * limit it.*/
   if (log10_min_mass < props->log10_SNII_min_mass_msun)
@@ -369,97 +455,13 @@ INLINE static void evolve_SNII(
    * step */
   if (log10_min_mass >= log10_max_mass) return;
 
-  /* determine which IMF mass bins contribute to the integral */
-  int low_imf_mass_bin_index, high_imf_mass_bin_index;
-  determine_imf_bins(log10_min_mass, log10_max_mass, &low_imf_mass_bin_index,
-                     &high_imf_mass_bin_index, props);
-
-  /* determine which metallicity bin and offset this star belongs to */
-  int index_Z_lo = 0, index_Z_hi = 0;
-  float dZ = 0.;
-  determine_bin_yields(&index_Z_lo, &index_Z_hi, &dZ, log10(Z),
-                       props->yield_SNII.metallicity,
-                       eagle_feedback_SNII_N_metals);
-
-  /* Allocate temporary array for calculating imf weights */
-  double stellar_yields[eagle_feedback_N_imf_bins];
-
-  /*******************************
-   * Compute metal mass produced *
-   *******************************/
+  /* Integrate the yields over the IMF */
   double metal_mass_released[chemistry_element_count];
-
-  /* Loop over all the elements */
-  for (int elem = 0; elem < chemistry_element_count; elem++) {
-
-    /* Loop over all the relevent IMF mass bins */
-    for (int mass_bin_index = low_imf_mass_bin_index;
-         mass_bin_index < high_imf_mass_bin_index + 1; mass_bin_index++) {
-
-      const int lo_index_3d = row_major_index_3d(
-          index_Z_lo, elem, mass_bin_index, eagle_feedback_SNII_N_metals,
-          chemistry_element_count, eagle_feedback_N_imf_bins);
-      const int hi_index_3d = row_major_index_3d(
-          index_Z_hi, elem, mass_bin_index, eagle_feedback_SNII_N_metals,
-          chemistry_element_count, eagle_feedback_N_imf_bins);
-
-      const int lo_index_2d = row_major_index_2d(index_Z_lo, mass_bin_index,
-                                                 eagle_feedback_SNII_N_metals,
-                                                 eagle_feedback_N_imf_bins);
-      const int hi_index_2d = row_major_index_2d(index_Z_hi, mass_bin_index,
-                                                 eagle_feedback_SNII_N_metals,
-                                                 eagle_feedback_N_imf_bins);
-      stellar_yields[mass_bin_index] =
-          (1.f - dZ) * (metal_yields[lo_index_3d] +
-                        abundances[elem] * ejecta[lo_index_2d]) +
-          (0.f + dZ) * (metal_yields[hi_index_3d] +
-                        abundances[elem] * ejecta[hi_index_2d]);
-    }
-    metal_mass_released[elem] = integrate_imf(
-        log10_min_mass, log10_max_mass, eagle_imf_integration_yield_weight,
-        stellar_yields, props);
-  }
-
-  /*************************************
-   * Compute total metal mass produced *
-   *************************************/
-  for (int mass_bin_index = low_imf_mass_bin_index;
-       mass_bin_index < high_imf_mass_bin_index + 1; mass_bin_index++) {
-
-    const int lo_index_2d = row_major_index_2d(index_Z_lo, mass_bin_index,
-                                               eagle_feedback_SNII_N_metals,
-                                               eagle_feedback_N_imf_bins);
-    const int hi_index_2d = row_major_index_2d(index_Z_hi, mass_bin_index,
-                                               eagle_feedback_SNII_N_metals,
-                                               eagle_feedback_N_imf_bins);
-
-    stellar_yields[mass_bin_index] =
-        (1.f - dZ) * (total_yields[lo_index_2d] + Z * ejecta[lo_index_2d]) +
-        (0.f + dZ) * (total_yields[hi_index_2d] + Z * ejecta[hi_index_2d]);
-  }
-  double metal_mass_released_total =
-      integrate_imf(log10_min_mass, log10_max_mass,
-                    eagle_imf_integration_yield_weight, stellar_yields, props);
-
-  /************************************************
-   * Compute the total mass ejected from the star *
-   ************************************************/
-  for (int mass_bin_index = low_imf_mass_bin_index;
-       mass_bin_index < high_imf_mass_bin_index + 1; mass_bin_index++) {
-
-    const int lo_index_2d = row_major_index_2d(index_Z_lo, mass_bin_index,
-                                               eagle_feedback_SNII_N_metals,
-                                               eagle_feedback_N_imf_bins);
-    const int hi_index_2d = row_major_index_2d(index_Z_hi, mass_bin_index,
-                                               eagle_feedback_SNII_N_metals,
-                                               eagle_feedback_N_imf_bins);
-
-    stellar_yields[mass_bin_index] =
-        (1 - dZ) * ejecta[lo_index_2d] + dZ * ejecta[hi_index_2d];
-  }
-  const double mass_ejected =
-      integrate_imf(log10_min_mass, log10_max_mass,
-                    eagle_imf_integration_yield_weight, stellar_yields, props);
+  double metal_mass_released_total, mass_ejected;
+  integrate_channel_yields(log10_min_mass, log10_max_mass, Z, abundances,
+                           &props->yield_SNII, eagle_feedback_SNII_N_metals,
+                           props, metal_mass_released,
+                           &metal_mass_released_total, &mass_ejected);
 
   /* Zero all negative values */
   for (int i = 0; i < chemistry_element_count; i++)
@@ -515,18 +517,6 @@ INLINE static void evolve_AGB(const double log10_min_mass,
                               const struct feedback_props* props,
                               struct feedback_spart_data* const feedback_data) {
 
-  /* Pull out common arrays */
-
-  /* Metal mass produced by the star */
-  const double* const total_yields =
-      props->yield_AGB.total_metals_IMF_resampled;
-
-  /* Individual elements produced by the star */
-  const double* const metal_yields = props->yield_AGB.yield_IMF_resampled;
-
-  /* Elements already in the stars that are ejected */
-  const double* const ejecta = props->yield_AGB.ejecta_IMF_resampled;
-
   /* If mass at end of step is greater than tabulated lower bound for IMF, limit
    * it.*/
   if (log10_max_mass > props->log10_SNII_min_mass_msun)
@@ -536,100 +526,13 @@ INLINE static void evolve_AGB(const double log10_min_mass,
    * step */
   if (log10_min_mass >= log10_max_mass) return;
 
-  /* determine which IMF mass bins contribute to the integral */
-  int low_imf_mass_bin_index, high_imf_mass_bin_index;
-  determine_imf_bins(log10_min_mass, log10_max_mass, &low_imf_mass_bin_index,
-                     &high_imf_mass_bin_index, props);
-
-  /* determine which metallicity bin and offset this star belongs to */
-  int index_Z_lo = 0, index_Z_hi = 0;
-  float dZ = 0.f;
-  determine_bin_yields(&index_Z_lo, &index_Z_hi, &dZ, log10(Z),
-                       props->yield_AGB.metallicity,
-                       eagle_feedback_AGB_N_metals);
-
-  /* Allocate temporary array for calculating imf weights */
-  double stellar_yields[eagle_feedback_N_imf_bins];
-
-  /*******************************
-   * Compute metal mass produced *
-   *******************************/
+  /* Integrate the yields over the IMF */
   double metal_mass_released[chemistry_element_count];
-
-  /* Loop over all the elements */
-  for (int elem = 0; elem < chemistry_element_count; elem++) {
-
-    /* Loop over all the relevent IMF mass bins */
-    for (int mass_bin_index = low_imf_mass_bin_index;
-         mass_bin_index < high_imf_mass_bin_index + 1; mass_bin_index++) {
-
-      const int lo_index_3d = row_major_index_3d(
-          index_Z_lo, elem, mass_bin_index, eagle_feedback_AGB_N_metals,
-          chemistry_element_count, eagle_feedback_N_imf_bins);
-      const int hi_index_3d = row_major_index_3d(
-          index_Z_hi, elem, mass_bin_index, eagle_feedback_AGB_N_metals,
-          chemistry_element_count, eagle_feedback_N_imf_bins);
-
-      const int lo_index_2d = row_major_index_2d(index_Z_lo, mass_bin_index,
-                                                 eagle_feedback_AGB_N_metals,
-                                                 eagle_feedback_N_imf_bins);
-      const int hi_index_2d = row_major_index_2d(index_Z_hi, mass_bin_index,
-                                                 eagle_feedback_AGB_N_metals,
-                                                 eagle_feedback_N_imf_bins);
-      stellar_yields[mass_bin_index] =
-          (1.f - dZ) * (metal_yields[lo_index_3d] +
-                        abundances[elem] * ejecta[lo_index_2d]) +
-          (0.f + dZ) * (metal_yields[hi_index_3d] +
-                        abundances[elem] * ejecta[hi_index_2d]);
-    }
-
-    metal_mass_released[elem] = integrate_imf(
-        log10_min_mass, log10_max_mass, eagle_imf_integration_yield_weight,
-        stellar_yields, props);
-  }
-
-  /*************************************
-   * Compute total metal mass produced *
-   *************************************/
-  for (int mass_bin_index = low_imf_mass_bin_index;
-       mass_bin_index < high_imf_mass_bin_index + 1; mass_bin_index++) {
-
-    const int lo_index_2d = row_major_index_2d(index_Z_lo, mass_bin_index,
-                                               eagle_feedback_AGB_N_metals,
-                                               eagle_feedback_N_imf_bins);
-    const int hi_index_2d = row_major_index_2d(index_Z_hi, mass_bin_index,
-                                               eagle_feedback_AGB_N_metals,
-                                               eagle_feedback_N_imf_bins);
-
-    stellar_yields[mass_bin_index] =
-        (1.f - dZ) * (total_yields[lo_index_2d] + Z * ejecta[lo_index_2d]) +
-        (0.f + dZ) * (total_yields[hi_index_2d] + Z * ejecta[hi_index_2d]);
-  }
-
-  double metal_mass_released_total =
-      integrate_imf(log10_min_mass, log10_max_mass,
-                    eagle_imf_integration_yield_weight, stellar_yields, props);
-
-  /************************************************
-   * Compute the total mass ejected from the star *
-   ************************************************/
-
-  for (int mass_bin_index = low_imf_mass_bin_index;
-       mass_bin_index < high_imf_mass_bin_index + 1; mass_bin_index++) {
-
-    const int lo_index_2d = row_major_index_2d(index_Z_lo, mass_bin_index,
-                                               eagle_feedback_AGB_N_metals,
-                                               eagle_feedback_N_imf_bins);
-    const int hi_index_2d = row_major_index_2d(index_Z_hi, mass_bin_index,
-                                               eagle_feedback_AGB_N_metals,
-                                               eagle_feedback_N_imf_bins);
-
-    stellar_yields[mass_bin_index] =
-        (1.f - dZ) * ejecta[lo_index_2d] + dZ * ejecta[hi_index_2d];
-  }
-  const double mass_ejected =
-      integrate_imf(log10_min_mass, log10_max_mass,
-                    eagle_imf_integration_yield_weight, stellar_yields, props);
+  double metal_mass_released_total, mass_ejected;
+  integrate_channel_yields(log10_min_mass, log10_max_mass, Z, abundances,
+                           &props->yield_AGB, eagle_feedback_AGB_N_metals,
+                           props, metal_mass_released,
+                           &metal_mass_released_total, &mass_ejected);
 
   /* Zero all negative values */
   for (int i = 0; i < chemistry_element_count; i++)
@@ -190,6 +190,93 @@ INLINE static double integrate_imf(
   return result * imf_log10_mass_bin_size * M_LN10;
 }
 
+/**
+ * @brief Compute the weights of the IMF-weighted integral of a tabulated
+ * quantity between two masses.
+ *
+ * The result of integrate_imf() in the eagle_imf_integration_yield_weight
+ * mode is a weighted sum of the yields in the IMF mass bins, with weights
+ * that only depend on the integration bounds. Computing them once allows
+ * many yield tables to be integrated over the same mass range with
+ * imf_weighted_sum().
+ *
+ * @param log10_min_mass log10 mass lower bound (in solar masses).
+ * @param log10_max_mass log10 mass upper bound (in solar masses).
+ * @param weights (return) The weights of the bins i_min to i_max.
+ * @param i_min (return) The first bin contributing to the integral.
+ * @param i_max (return) The last bin contributing to the integral.
+ * @param feedback_props the #feedback_props data structure.
+ */
+INLINE static void imf_integration_weights(
+    const double log10_min_mass, const double log10_max_mass,
+    double weights[eagle_feedback_N_imf_bins], int *i_min, int *i_max,
+    const struct feedback_props *feedback_props) {
+
+  /* Pull out some common terms */
+  const double *imf = feedback_props->imf;
+  const double *imf_mass_bin = feedback_props->imf_mass_bin;
+  const double *imf_mass_bin_log10 = feedback_props->imf_mass_bin_log10;
+
+  /* IMF mass bin spacing in log10 space. Assumes uniform spacing. */
+  const double imf_log10_mass_bin_size =
+      imf_mass_bin_log10[1] - imf_mass_bin_log10[0];
+
+  /* Determine bins to integrate over based on integration bounds */
+  determine_imf_bins(log10_min_mass, log10_max_mass, i_min, i_max,
+                     feedback_props);
+  const int lo = *i_min;
+  const int hi = *i_max;
+
+  /* Trapezoidal rule: the end bins only count for half */
+  for (int i = lo; i < hi + 1; i++) weights[i] = 1.;
+  weights[lo] -= 0.5;
+  weights[hi] -= 0.5;
+
+  /* Correct first bin */
+  const double first_bin_offset =
+      (log10_min_mass - imf_mass_bin_log10[lo]) / imf_log10_mass_bin_size;
+
+  if (first_bin_offset < 0.5) {
+    weights[lo] -= first_bin_offset;
+  } else {
+    weights[lo] -= 0.5;
+    weights[lo + 1] -= (first_bin_offset - 0.5);
+  }
+
+  /* Correct last bin */
+  const double last_bin_offset =
+      (log10_max_mass - imf_mass_bin_log10[hi - 1]) / imf_log10_mass_bin_size;
+
+  if (last_bin_offset < 0.5) {
+    weights[hi] -= 0.5;
+    weights[hi - 1] -= (0.5 - last_bin_offset);
+  } else {
+    weights[hi] -= (1.0 - last_bin_offset);
+  }
+
+  /* Fold in the IMF and the bin size (the IMF is tabulated in log10) */
+  for (int i = lo; i < hi + 1; i++)
+    weights[i] *= imf[i] * imf_mass_bin[i] * imf_log10_mass_bin_size * M_LN10;
+}
+
+/**
+ * @brief Integrate a tabulated quantity weighted by the IMF using the weights
+ * computed by imf_integration_weights().
+ *
+ * @param weights The IMF integration weights.
+ * @param values The quantity in each of the IMF mass bins.
+ * @param i_min The first bin contributing to the integral.
+ * @param i_max The last bin contributing to the integral.
+ */
+INLINE static double imf_weighted_sum(
+    const double weights[eagle_feedback_N_imf_bins],
+    const double *restrict values, const int i_min, const int i_max) {
+
+  double result = 0.;
+  for (int i = i_min; i < i_max + 1; i++) result += weights[i] * values[i];
+  return result;
+}
+
 /**
  * @brief Allocate space for IMF table and compute values to populate this
  * table.
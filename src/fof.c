@@ -2540,8 +2540,11 @@ void fof_search_foreign_cells(struct fof_props *props, const struct space *s) {
 
   tic = getticks();
 
-  /* Perform send and receive tasks. */
+  /* Perform send and receive tasks. The FOF needs the full #gpart. */
+  const int mpi_compact_gparts = e->sched.mpi_compact_gparts;
+  e->sched.mpi_compact_gparts = 0;
   engine_launch(e, "fof comms");
+  e->sched.mpi_compact_gparts = mpi_compact_gparts;
 
   if (verbose)
     message("MPI send/recv comms took: %.3f %s.",
@@ -73,6 +73,11 @@ struct gpart {
   char has_been_most_bound;
 #endif
 
+  /*! Background phase-space density at the initial momentum of a neutrino
+   * (only used when caching the momentum draw of the delta-f method). This
+   * sits in the padding at the end of the structure. */
+  float nu_initial_density;
+
 #ifdef SWIFT_DEBUG_CHECKS
 
   /* Time of the last drift */
@@ -114,4 +119,23 @@ struct gpart {
 #endif
 };
 
+/**
+ * @brief Compact version of the #gpart sent to other nodes for the gravity
+ * interactions.
+ */
+struct gpart_compact {
+
+  /*! Particle position relative to its top-level cell. */
+  float dx[3];
+
+  /*! Particle mass. */
+  float mass;
+
+  /*! Time-step length */
+  timebin_t time_bin;
+
+  /*! Type of the #gpart (DM, gas, star, ...) */
+  char type;
+};
+
 #endif /* SWIFT_DEFAULT_GRAVITY_PART_H */
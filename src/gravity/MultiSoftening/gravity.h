@@ -392,4 +392,43 @@ __attribute__((always_inline)) INLINE static void gravity_first_init_gpart(
   gravity_init_gpart(gp);
 }
 
+/**
+ * @brief Packs the properties of a #gpart needed by the gravity interactions
+ * on another node.
+ *
+ * @param gp The particle.
+ * @param pc The #gpart_compact to fill.
+ * @param loc The position of the top-level cell of the particle.
+ */
+__attribute__((always_inline)) INLINE static void gravity_pack_compact(
+    const struct gpart* gp, struct gpart_compact* pc, const double loc[3]) {
+
+  pc->dx[0] = (float)(gp->x[0] - loc[0]);
+  pc->dx[1] = (float)(gp->x[1] - loc[1]);
+  pc->dx[2] = (float)(gp->x[2] - loc[2]);
+  pc->mass = gp->mass;
+  pc->epsilon = gp->epsilon;
+  pc->time_bin = gp->time_bin;
+  pc->type = (char)gp->type;
+}
+
+/**
+ * @brief Unpacks the properties of a #gpart received from another node.
+ *
+ * @param gp The particle.
+ * @param pc The received #gpart_compact.
+ * @param loc The position of the top-level cell of the particle.
+ */
+__attribute__((always_inline)) INLINE static void gravity_unpack_compact(
+    struct gpart* gp, const struct gpart_compact* pc, const double loc[3]) {
+
+  gp->x[0] = loc[0] + pc->dx[0];
+  gp->x[1] = loc[1] + pc->dx[1];
+  gp->x[2] = loc[2] + pc->dx[2];
+  gp->mass = pc->mass;
+  gp->epsilon = pc->epsilon;
+  gp->time_bin = pc->time_bin;
+  gp->type = (enum part_type)pc->type;
+}
+
 #endif /* SWIFT_MULTI_SOFTENING_GRAVITY_H */
@@ -0,0 +1,286 @@
+/*******************************************************************************
+ * This file is part of SWIFT.
+ * Copyright (c) 2026 agent (agent@local)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+/**
+ *  @file memuse_shared.c
+ *  @brief Allocation of read-only tables shared between the MPI ranks of a
+ *  node.
+ *
+ *  Large physics tables (cooling rates, equations of state, ...) are
+ *  identical on all ranks. When running with many ranks per node, holding one
+ *  private copy per rank wastes a lot of memory. The functions here allocate
+ *  such tables in an MPI-3 shared-memory window created over the ranks of a
+ *  node. Only the first rank of the node (the writer) owns the memory, reads
+ *  the tables into it and reports the allocation to the memuse logger. The
+ *  other ranks simply map the same memory.
+ *
+ *  The memory is only meant to be written by the writer, between two calls to
+ *  swift_shared_barrier(), while none of the other ranks are reading it.
+ */
+
+/* Config parameters. */
+#include <config.h>
+
+/* Standard includes. */
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef WITH_MPI
+#include <mpi.h>
+#endif
+
+/* This object's header. */
+#include "memuse_shared.h"
+
+/* Local includes. */
+#include "error.h"
+#include "memuse.h"
+
+#ifdef WITH_MPI
+
+/*! Communicator grouping all the ranks of this node */
+static MPI_Comm node_comm = MPI_COMM_NULL;
+
+/*! Rank of this process within the node */
+static int node_rank = 0;
+
+/*! Number of ranks on this node */
+static int node_size = 1;
+
+/**
+ * @brief One shared allocation and the MPI window it lives in.
+ */
+struct shared_window {
+
+  /*! The (aligned) memory handed to the caller */
+  void *ptr;
+
+  /*! The MPI window containing the memory */
+  MPI_Win win;
+
+  /*! Next allocation in the list */
+  struct shared_window *next;
+};
+
+/*! List of all the current shared allocations. Only ever accessed from the
+ * main thread. */
+static struct shared_window *windows = NULL;
+
+/**
+ * @brief Construct the node communicator if not done already.
+ */
+static void swift_shared_init(void) {
+
+  if (node_comm != MPI_COMM_NULL) return;
+
+  if (MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, 0,
+                          MPI_INFO_NULL, &node_comm) != MPI_SUCCESS)
+    error("Failed to create the node communicator.");
+
+  MPI_Comm_rank(node_comm, &node_rank);
+  MPI_Comm_size(node_comm, &node_size);
+}
+
+#endif /* WITH_MPI */
+
+/**
+ * @brief Allocate memory shared by all the ranks of this node.
+ *
+ * Collective over the ranks of the node. The memory is only filled with
+ * meaningful data once the writer has written it and everyone went through
+ * swift_shared_barrier().
+ *
+ * @param label a symbolic label for the memory, i.e. "cooling-tables".
+ * @param memptr pointer to the allocated memory.
+ * @param alignment alignment boundary.
+ * @param size the quantity of bytes to allocate.
+ * @result zero on success, otherwise an error code.
+ */
+int swift_shared_memalign(const char *label, void **memptr, size_t alignment,
+                          size_t size) {
+
+#ifdef WITH_MPI
+  swift_shared_init();
+
+  /* Only the writer holds memory. We add some padding to be able to align the
+   * start of the array. */
+  const MPI_Aint local_size = (node_rank == 0) ? size + alignment : 0;
+
+  /* We do not need all the allocations of the node to be contiguous */
+  MPI_Info info;
+  MPI_Info_create(&info);
+  MPI_Info_set(info, "alloc_shared_noncontig", "true");
+
+  void *base = NULL;
+  struct shared_window *w =
+      (struct shared_window *)malloc(sizeof(struct shared_window));
+  if (w == NULL) error("Failed to allocate shared window descriptor.");
+
+  int res = MPI_Win_allocate_shared(local_size, /*disp_unit=*/1, info,
+                                    node_comm, &base, &w->win);
+  MPI_Info_free(&info);
+  if (res != MPI_SUCCESS) {
+    free(w);
+    memuse_log_allocation(label, NULL, -1, size);
+    return res;
+  }
+
+  /* Where is the writer's memory in our address space? */
+  MPI_Aint writer_size;
+  int writer_disp_unit;
+  res = MPI_Win_shared_query(w->win, 0, &writer_size, &writer_disp_unit, &base);
+  if (res != MPI_SUCCESS) error("Failed to query shared window.");
+
+  /* The offset required for alignment is decided by the writer, the memory
+   * may not be mapped at the same address on all the ranks. */
+  size_t offset = 0;
+  if (node_rank == 0)
+    offset = (alignment - ((uintptr_t)base % alignment)) % alignment;
+  MPI_Bcast(&offset, sizeof(size_t), MPI_BYTE, 0, node_comm);
+
+  w->ptr = (char *)base + offset;
+  w->next = windows;
+  windows = w;
+  *memptr = w->ptr;
+
+  /* Only the writer reports the memory. */
+  if (node_rank == 0) {
+    memuse_log_allocation(label, *memptr, 1, size);
+  }
+
+  return 0;
+#else
+  return swift_memalign(label, memptr, alignment, size);
+#endif
+}
+
+/**
+ * @brief Free memory allocated with swift_shared_memalign().
+ *
+ * Collective over the ranks of the node.
+ *
+ * @param label the label used for the allocation.
+ * @param ptr pointer to the memory.
+ */
+void swift_shared_free(const char *label, void *ptr) {
+
+#ifdef WITH_MPI
+  if (ptr == NULL) return;
+
+  struct shared_window **prev = &windows;
+  for (struct shared_window *w = windows; w != NULL; w = w->next) {
+    if (w->ptr == ptr) {
+
+      if (node_rank == 0) {
+        memuse_log_allocation(label, ptr, 0, 0);
+      }
+
+      /* Nothing to free if MPI has already been shut down */
+      int finalized = 0;
+      MPI_Finalized(&finalized);
+      if (!finalized) MPI_Win_free(&w->win);
+
+      *prev = w->next;
+      free(w);
+      return;
+    }
+    prev = &w->next;
+  }
+  error("Trying to free memory that was not allocated as shared (%s).", label);
+#else
+  swift_free(label, ptr);
+#endif
+}
+
+/**
+ * @brief Is this rank the one in charge of filling the shared tables?
+ */
+int swift_shared_is_writer(void) {
+
+#ifdef WITH_MPI
+  swift_shared_init();
+  return node_rank == 0;
+#else
+  return 1;
+#endif
+}
+
+/**
+ * @brief Synchronise all the ranks of the node.
+ *
+ * Must be called before the writer modifies shared memory that other ranks
+ * may still be reading, and after it is done writing.
+ */
+void swift_shared_barrier(void) {
+
+#ifdef WITH_MPI
+  swift_shared_init();
+
+  /* Make sure our own writes are complete before anyone reads them */
+  __sync_synchronize();
+  MPI_Barrier(node_comm);
+  __sync_synchronize();
+#endif
+}
+
+/**
+ * @brief Broadcast a small buffer from the writer to the other ranks of the
+ * node.
+ *
+ * Useful for scalars derived from the tables by the writer.
+ *
+ * @param buffer The data to broadcast.
+ * @param size The size of the data in bytes.
+ */
+void swift_shared_bcast(void *buffer, size_t size) {
+
+#ifdef WITH_MPI
+  swift_shared_init();
+  MPI_Bcast(buffer, (int)size, MPI_BYTE, 0, node_comm);
+#endif
+}
+
+/**
+ * @brief Number of ranks sharing the tables on this node.
+ */
+int swift_shared_node_size(void) {
+
+#ifdef WITH_MPI
+  swift_shared_init();
+  return node_size;
+#else
+  return 1;
+#endif
+}
+
+/**
+ * @brief Release the node communicator.
+ *
+ * Tables that are still allocated are released by MPI_Finalize().
+ */
+void swift_shared_clean(void) {
+
+#ifdef WITH_MPI
+  int finalized = 0;
+  MPI_Finalized(&finalized);
+  if (node_comm != MPI_COMM_NULL && !finalized) MPI_Comm_free(&node_comm);
+  node_comm = MPI_COMM_NULL;
+#endif
+}
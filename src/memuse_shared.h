@@ -0,0 +1,44 @@
+/*******************************************************************************
+ * This file is part of SWIFT.
+ * Copyright (c) 2026 agent (agent@local)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#ifndef SWIFT_MEMUSE_SHARED_H
+#define SWIFT_MEMUSE_SHARED_H
+
+/* Config parameters. */
+#include <config.h>
+
+/* Includes. */
+#include <stdlib.h>
+
+/* API.
+ *
+ * Allocation of read-only tables shared by all the MPI ranks running on the
+ * same node. Only one rank per node (the "writer") holds the memory and fills
+ * it. All the functions below are collective over the ranks of a node and
+ * must hence be called by all the ranks in the same order. Without MPI, they
+ * reduce to the usual allocation functions. */
+int swift_shared_memalign(const char *label, void **memptr, size_t alignment,
+                          size_t size);
+void swift_shared_free(const char *label, void *ptr);
+int swift_shared_is_writer(void);
+void swift_shared_barrier(void);
+void swift_shared_bcast(void *buffer, size_t size);
+int swift_shared_node_size(void);
+void swift_shared_clean(void);
+
+#endif /* SWIFT_MEMUSE_SHARED_H */
@@ -35,6 +35,9 @@
 /* Fast optimized logarithm */
 #include "../../log.h"
 
+/* min() and max() */
+#include "../../minmax.h"
+
 /* Cubic spline coefficients */
 struct spline {
   double a0, a1, a2, a3;
@@ -245,6 +248,9 @@ static int index_table_c[165] = {
 static struct anyrng anyrng = {118,           endpoints,     splines,      165,
                                index_table_a, index_table_b, index_table_c};
 
+/* Number of seeds transformed together in neutrino_seeds_to_fermi_dirac() */
+#define FERMI_DIRAC_CHUNK_SIZE 16
+
 /**
  * @brief Transform a 64-bit unsigned integer seed into a (dimensionless)
  * Fermi-Dirac momentum (units of kb*T), using cubic spline interpolation of
@@ -253,40 +259,85 @@ static struct anyrng anyrng = {118,           endpoints,     splines,      165,
  * @param seed Random seed to be transformed
  */
 double neutrino_seed_to_fermi_dirac(uint64_t seed) {
-  /* Scramble the bits with splitmix64 */
-  uint64_t A = seed;
-  A = A + 0x9E3779B97f4A7C15;
-  A = (A ^ (A >> 30)) * 0xBF58476D1CE4E5B9;
-  A = (A ^ (A >> 27)) * 0x94D049BB133111EB;
-  A = A ^ (A >> 31);
+  double p;
+  neutrino_seeds_to_fermi_dirac(&seed, &p, 1);
+  return p;
+}
 
-  /* Map the integer to the unit open interval (0, 1) */
-  const double u = ((double)A + 0.5) / ((double)UINT64_MAX + 1);
+/**
+ * @brief Transform an array of 64-bit unsigned integer seeds into
+ * (dimensionless) Fermi-Dirac momenta (units of kb*T).
+ *
+ * This is the same transformation as neutrino_seed_to_fermi_dirac(), but
+ * the seeds are processed in chunks with each stage (hashing, search of the
+ * enclosing interval, spline evaluation) written as a branch-free loop over
+ * the chunk, such that the compiler can vectorise it.
+ *
+ * @param seeds The random seeds to be transformed.
+ * @param p (return) The momenta.
+ * @param count The number of seeds.
+ */
+void neutrino_seeds_to_fermi_dirac(const uint64_t *restrict seeds,
+                                   double *restrict p, const int count) {
 
-  /* Use the hash table to find an enclosing interval */
   const int tablen = anyrng.tablelen;
-  int index, interval;
-  if (u < 0.025) {
-    index = (int)((optimized_log10f(u) + 14.5229) / 12.9208 * tablen);
-    interval = anyrng.index_table_a[index < tablen ? index : tablen - 1] + 1;
-  } else if (u < 0.975) {
-    index = (int)((u - 0.025) / 0.95 * tablen);
-    interval = anyrng.index_table_b[index < tablen ? index : tablen - 1] + 1;
-  } else {
-    index = (int)(-(optimized_log10f(1 - u) + 1.60206) / 6.39794 * tablen);
-    interval = anyrng.index_table_c[index < tablen ? index : tablen - 1] + 1;
-  }
 
-  /* Retrieve the endpoints and cubic spline coefficients of this interval */
-  const double Fl = anyrng.endpoints[interval];
-  const double Fr = anyrng.endpoints[interval + 1];
-  struct spline *iv = &anyrng.splines[interval];
+  for (int offset = 0; offset < count; offset += FERMI_DIRAC_CHUNK_SIZE) {
 
-  /* Evaluate F^-1(u) using the Hermite approximation of F in this interval */
-  const double u_tilde = (u - Fl) / (Fr - Fl);
-  const double u_tilde2 = u_tilde * u_tilde;
-  const double u_tilde3 = u_tilde2 * u_tilde;
-  return iv->a0 + iv->a1 * u_tilde + iv->a2 * u_tilde2 + iv->a3 * u_tilde3;
+    const int n = min(count - offset, FERMI_DIRAC_CHUNK_SIZE);
+    double u[FERMI_DIRAC_CHUNK_SIZE];
+    int interval[FERMI_DIRAC_CHUNK_SIZE];
+
+    for (int i = 0; i < n; i++) {
+      /* Scramble the bits with splitmix64 */
+      uint64_t A = seeds[offset + i];
+      A = A + 0x9E3779B97f4A7C15;
+      A = (A ^ (A >> 30)) * 0xBF58476D1CE4E5B9;
+      A = (A ^ (A >> 27)) * 0x94D049BB133111EB;
+      A = A ^ (A >> 31);
+
+      /* Map the integer to the unit open interval (0, 1) */
+      u[i] = ((double)A + 0.5) / ((double)UINT64_MAX + 1);
+    }
+
+    /* Use the hash tables to find an enclosing interval. We compute the
+     * index in all three tables and select the relevant one. */
+    for (int i = 0; i < n; i++) {
+      int index_a =
+          (int)((optimized_log10f(u[i]) + 14.5229) / 12.9208 * tablen);
+      int index_b = (int)((u[i] - 0.025) / 0.95 * tablen);
+      int index_c =
+          (int)(-(optimized_log10f(1 - u[i]) + 1.60206) / 6.39794 * tablen);
+      index_a = max(index_a, 0);
+      index_b = max(index_b, 0);
+      index_c = max(index_c, 0);
+      index_a = min(index_a, tablen - 1);
+      index_b = min(index_b, tablen - 1);
+      index_c = min(index_c, tablen - 1);
+
+      const int interval_a = anyrng.index_table_a[index_a];
+      const int interval_b = anyrng.index_table_b[index_b];
+      const int interval_c = anyrng.index_table_c[index_c];
+
+      interval[i] = (u[i] < 0.025   ? interval_a
+                     : u[i] < 0.975 ? interval_b
+                                    : interval_c) +
+                    1;
+    }
+
+    /* Evaluate F^-1(u) using the Hermite approximation of F in the intervals */
+    for (int i = 0; i < n; i++) {
+      const double Fl = anyrng.endpoints[interval[i]];
+      const double Fr = anyrng.endpoints[interval[i] + 1];
+      const struct spline *iv = &anyrng.splines[interval[i]];
+
+      const double u_tilde = (u[i] - Fl) / (Fr - Fl);
+      const double u_tilde2 = u_tilde * u_tilde;
+      const double u_tilde3 = u_tilde2 * u_tilde;
+      p[offset + i] =
+          iv->a0 + iv->a1 * u_tilde + iv->a2 * u_tilde2 + iv->a3 * u_tilde3;
+    }
+  }
 }
 
 /**
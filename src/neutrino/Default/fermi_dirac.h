@@ -66,6 +66,8 @@ INLINE static double neutrino_seed_to_degeneracy(const int N_nu,
 }
 
 double neutrino_seed_to_fermi_dirac(uint64_t seed);
+void neutrino_seeds_to_fermi_dirac(const uint64_t *restrict seeds,
+                                   double *restrict p, const int count);
 void neutrino_seed_to_direction(uint64_t seed, double n[3]);
 
 #endif /* SWIFT_DEFAULT_FERMI_DIRAC_H */
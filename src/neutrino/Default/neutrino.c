@@ -57,6 +57,7 @@ void gather_neutrino_consts(const struct space *s, struct neutrino_model *nm) {
                    s->e->cosmology->T_nu_0_eV);
   nm->inv_mass_factor = 1. / s->e->neutrino_mass_conversion_factor;
   nm->neutrino_seed = s->e->neutrino_properties->neutrino_seed;
+  nm->cache_momentum_draw = s->e->neutrino_properties->cache_momentum_draw;
 }
 
 /**
@@ -124,6 +125,81 @@ void gpart_neutrino_mass_weight(const struct gpart *gp,
   *weight = 1.0 - f / fi;
 }
 
+/**
+ * @brief Set the statistically weighted mass of a batch of neutrino particles
+ * using the delta-f method.
+ *
+ * The initial momenta of all the particles are drawn together. When caching
+ * the momentum draw, the background phase-space density at the initial
+ * momentum is stored in the particles the first time it is computed and
+ * only the current density is evaluated afterwards.
+ *
+ * @param gparts The neutrino #gpart to weight.
+ * @param count The number of particles (at most NEUTRINO_WEIGHT_BATCH_SIZE).
+ * @param nm Properties of the neutrino model
+ */
+void gpart_neutrino_weight_batch(struct gpart **gparts, const int count,
+                                 const struct neutrino_model *nm) {
+
+#ifdef SWIFT_DEBUG_CHECKS
+  if (count > NEUTRINO_WEIGHT_BATCH_SIZE)
+    error("Too many neutrinos in the batch (%d)", count);
+#endif
+
+  /* Gather the particles whose initial momentum must be drawn */
+  float fi[NEUTRINO_WEIGHT_BATCH_SIZE];
+  uint64_t seeds[NEUTRINO_WEIGHT_BATCH_SIZE];
+  int draw_index[NEUTRINO_WEIGHT_BATCH_SIZE];
+  int draw_count = 0;
+  for (int i = 0; i < count; i++) {
+    if (nm->cache_momentum_draw && gparts[i]->nu_initial_density > 0.f) {
+      fi[i] = gparts[i]->nu_initial_density;
+    } else {
+      seeds[draw_count] = gparts[i]->id_or_neg_offset + nm->neutrino_seed;
+      draw_index[draw_count] = i;
+      draw_count++;
+    }
+  }
+
+  /* Compute the initial dimensionless momenta from the seeds */
+  double pi[NEUTRINO_WEIGHT_BATCH_SIZE];
+  if (draw_count > 0) neutrino_seeds_to_fermi_dirac(seeds, pi, draw_count);
+
+  /* Compute the initial background phase-space densities */
+  for (int j = 0; j < draw_count; j++) {
+    const int i = draw_index[j];
+    fi[i] = fermi_dirac_density(pi[j]);
+    if (nm->cache_momentum_draw) gparts[i]->nu_initial_density = fi[i];
+  }
+
+  for (int i = 0; i < count; i++) {
+    struct gpart *gp = gparts[i];
+
+    /* Use a particle id dependent seed */
+    const long long seed = gp->id_or_neg_offset + nm->neutrino_seed;
+
+    /* The neutrino mass and degeneracy (we cycle based on the seed) */
+    const double m_eV = neutrino_seed_to_mass(nm->N_nu, nm->M_nu_eV, seed);
+    const double deg = neutrino_seed_to_degeneracy(nm->N_nu, nm->deg_nu, seed);
+    const double mass = deg * m_eV * nm->inv_mass_factor;
+
+    /* Compute the current dimensionless momentum */
+    const double p = neutrino_momentum(gp->v_full, m_eV, nm->fac);
+
+    /* Compute the current background phase-space density */
+    const double f = fermi_dirac_density(p);
+    const double weight = 1.0 - f / fi[i];
+
+    /* Set the statistically weighted mass */
+    gp->mass = mass * weight;
+
+    /* Prevent degeneracies */
+    if (gp->mass == 0.) {
+      gp->mass = FLT_MIN;
+    }
+  }
+}
+
 /**
  * @brief Compute diagnostics for the neutrino delta-f method, including
  * the mean squared weight.
@@ -32,6 +32,9 @@
 /* Riemann function zeta(3) */
 #define M_ZETA_3 1.2020569031595942853997
 
+/* Number of neutrinos weighted together in the kick */
+#define NEUTRINO_WEIGHT_BATCH_SIZE 32
+
 /**
  * @brief Shared information for delta-f neutrino weighting of a cell.
  */
@@ -43,6 +46,7 @@ struct neutrino_model {
   double fac;
   double inv_mass_factor;
   long long neutrino_seed;
+  char cache_momentum_draw;
 };
 
 void gather_neutrino_consts(const struct space *s, struct neutrino_model *nm);
@@ -52,6 +56,8 @@ void gpart_neutrino_weight_mesh_only(const struct gpart *gp,
 void gpart_neutrino_mass_weight(const struct gpart *gp,
                                 const struct neutrino_model *nm, double *mass,
                                 double *weight);
+void gpart_neutrino_weight_batch(struct gpart **gparts, const int count,
+                                 const struct neutrino_model *nm);
 
 /* Compute the ratio of macro particle mass in internal mass units to
  * the mass of one microscopic neutrino in eV.
@@ -101,6 +107,9 @@ INLINE static double neutrino_mass_factor(
 __attribute__((always_inline)) INLINE static void gravity_first_init_neutrino(
     struct gpart *gp, const struct engine *e) {
 
+  /* Nothing cached yet */
+  gp->nu_initial_density = 0.f;
+
   /* Do we need to do anything? */
   if (!e->neutrino_properties->generate_ics) return;
 
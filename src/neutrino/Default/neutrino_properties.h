@@ -43,6 +43,9 @@ struct neutrino_props {
 
   /* Whether to use the linear respose method */
   char use_linear_response;
+
+  /* Whether to cache the initial phase-space density of the particles */
+  char cache_momentum_draw;
 };
 
 /**
@@ -73,6 +76,8 @@ INLINE static void neutrino_props_init(struct neutrino_props *np,
       parser_get_opt_param_longlong(params, "Neutrino:neutrino_seed", 0);
   np->use_linear_response =
       parser_get_opt_param_int(params, "Neutrino:use_linear_response", 0);
+  np->cache_momentum_draw =
+      parser_get_opt_param_int(params, "Neutrino:cache_momentum_draw", 0);
 
   int number_of_models = 0;
   number_of_models += np->use_delta_f;
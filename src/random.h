@@ -72,6 +72,7 @@ enum random_number_type {
   random_number_mosaic_schechter = 562448657LL,
   random_number_mosaic_poisson = 384160001LL,
   random_number_powerspectrum_split = 126247697LL,
+  random_number_synthetic_ics = 2147483647LL,
 };
 
 #ifndef __APPLE__
@@ -290,30 +290,58 @@ void restart_write_blocks(void *ptr, size_t size, size_t nblocks, FILE *stream,
 }
 
 /**
- * @brief check if the stop file exists in the given directory and optionally
+ * @brief check if a file exists in the given directory and optionally
  *        remove it if found.
  *
  * @param dir the directory of restart files.
- * @param cleanup remove the file if found. Should only do this from one rank
- *                once all ranks have tested this file.
+ * @param name the name of the file.
+ * @param cleanup remove the file if found.
  *
  * @result 1 if the file was found.
  */
-int restart_stop_now(const char *dir, int cleanup) {
+static int restart_file_found(const char *dir, const char *name, int cleanup) {
   struct stat buf;
   char filename[FNAMELEN];
   strcpy(filename, dir);
-  strcat(filename, "/stop");
+  strcat(filename, "/");
+  strcat(filename, name);
   if (stat(filename, &buf) == 0) {
     if (cleanup && unlink(filename) != 0) {
       /* May not be fatal, so press on. */
-      message("Failed to delete restart stop file (%s)", strerror(errno));
+      message("Failed to delete file %s (%s)", filename, strerror(errno));
     }
     return 1;
   }
   return 0;
 }
 
+/**
+ * @brief check if the stop file exists in the given directory and optionally
+ *        remove it if found.
+ *
+ * @param dir the directory of restart files.
+ * @param cleanup remove the file if found. Should only do this from one rank
+ *                once all ranks have tested this file.
+ *
+ * @result 1 if the file was found.
+ */
+int restart_stop_now(const char *dir, int cleanup) {
+  return restart_file_found(dir, "stop", cleanup);
+}
+
+/**
+ * @brief check if the file requesting a dump of the task trace exists in the
+ *        given directory and optionally remove it if found.
+ *
+ * @param dir the directory of restart files.
+ * @param cleanup remove the file if found.
+ *
+ * @result 1 if the file was found.
+ */
+int restart_dump_tasks_now(const char *dir, int cleanup) {
+  return restart_file_found(dir, "dump_tasks", cleanup);
+}
+
 /**
  * @brief check if a file with the given name exists and rename to
  *        {filename}.prev. Used to move old restart files before overwriting.
@@ -37,6 +37,7 @@ void restart_write_blocks(void *ptr, size_t size, size_t nblocks, FILE *stream,
                           const char *label, const char *errstr);
 
 int restart_stop_now(const char *dir, int cleanup);
+int restart_dump_tasks_now(const char *dir, int cleanup);
 
 void restart_save_previous(const char *filename);
 void restart_remove_previous(const char *filename);
@@ -530,6 +530,40 @@ __attribute__((always_inline)) INLINE static void rt_tchem(
                         dt);
 }
 
+/**
+ * @brief Do the thermochemistry on a batch of particles.
+ *
+ * This function wraps around rt_do_thermochemistry_batch function.
+ *
+ * @param parts The particles to work on.
+ * @param xparts The particles' extended data.
+ * @param dt The time-step of each particle.
+ * @param count The number of particles (at most #RT_TCHEM_BATCH_SIZE).
+ * @param rt_props RT properties struct
+ * @param cosmo The current cosmological model.
+ * @param hydro_props The #hydro_props.
+ * @param phys_const The physical constants in internal units.
+ * @param us The internal system of units.
+ */
+__attribute__((always_inline)) INLINE static void rt_tchem_batch(
+    struct part** restrict parts, struct xpart** restrict xparts,
+    const double* dt, const int count, struct rt_props* rt_props,
+    const struct cosmology* restrict cosmo,
+    const struct hydro_props* hydro_props,
+    const struct phys_const* restrict phys_const,
+    const struct unit_system* restrict us) {
+
+#ifdef SWIFT_RT_DEBUG_CHECKS
+  for (int i = 0; i < count; i++) {
+    rt_debug_sequence_check(parts[i], 4, __func__);
+    parts[i]->rt_data.debug_thermochem_done += 1;
+  }
+#endif
+
+  rt_do_thermochemistry_batch(parts, xparts, dt, count, rt_props, cosmo,
+                              hydro_props, phys_const, us);
+}
+
 /**
  * @brief Extra operations done during the kick. This needs to be
  * done before the particle mass is updated in the hydro_kick_extra.
@@ -27,6 +27,11 @@
 /* need to rework (and check) code if changed */
 #define FIELD_SIZE 1
 
+/*! Maximal number of particles handed over to grackle in a single call by
+ * rt_tchem_batch(). Defining this tells the runners to use the batched
+ * thermochemistry. */
+#define RT_TCHEM_BATCH_SIZE 32
+
 /**
  * @file src/rt/GEAR/rt_grackle_utils.h
  * @brief Utility and helper functions related to using grackle.
@@ -276,6 +281,134 @@ __attribute__((always_inline)) INLINE static void rt_clean_grackle_fields(
   free(grackle_fields->RT_heating_rate);
 }
 
+/**
+ * @brief Storage for the grackle fields of a batch of particles.
+ *
+ * Lives on the stack of the caller such that no allocation is needed for
+ * each call to grackle.
+ */
+struct rt_grackle_batch_fields {
+
+  int dimension[3];
+  int start[3];
+  int end[3];
+
+  gr_float density[RT_TCHEM_BATCH_SIZE];
+  gr_float internal_energy[RT_TCHEM_BATCH_SIZE];
+
+  gr_float HI_density[RT_TCHEM_BATCH_SIZE];
+  gr_float HII_density[RT_TCHEM_BATCH_SIZE];
+  gr_float HeI_density[RT_TCHEM_BATCH_SIZE];
+  gr_float HeII_density[RT_TCHEM_BATCH_SIZE];
+  gr_float HeIII_density[RT_TCHEM_BATCH_SIZE];
+  gr_float e_density[RT_TCHEM_BATCH_SIZE];
+
+  gr_float RT_heating_rate[RT_TCHEM_BATCH_SIZE];
+  gr_float RT_HI_ionization_rate[RT_TCHEM_BATCH_SIZE];
+  gr_float RT_HeI_ionization_rate[RT_TCHEM_BATCH_SIZE];
+  gr_float RT_HeII_ionization_rate[RT_TCHEM_BATCH_SIZE];
+  gr_float RT_H2_dissociation_rate[RT_TCHEM_BATCH_SIZE];
+};
+
+/**
+ * @brief copy the (gas) data of a particle into slot i of a batch of grackle
+ * fields.
+ *
+ * @param batch the #rt_grackle_batch_fields to fill
+ * @param i index of the particle in the batch
+ * @param density particle density
+ * @param internal_energy particle internal_energy
+ * @param species_densities array of species densities of particle (HI, HII,
+ *HeI, HeII, HeIII, e-)
+ * @param iact_rates array of interaction rates (heating, 3 ioniziation, H2
+ *dissociation)
+ **/
+__attribute__((always_inline)) INLINE static void
+rt_set_grackle_batch_particle(struct rt_grackle_batch_fields *batch,
+                              const int i, gr_float density,
+                              gr_float internal_energy,
+                              const gr_float species_densities[6],
+                              const gr_float iact_rates[5]) {
+
+  batch->density[i] = density;
+  batch->internal_energy[i] = internal_energy;
+
+  batch->HI_density[i] = species_densities[0];
+  batch->HII_density[i] = species_densities[1];
+  batch->HeI_density[i] = species_densities[2];
+  batch->HeII_density[i] = species_densities[3];
+  batch->HeIII_density[i] = species_densities[4];
+  /* e_density = electron density*mh/me = n_e * m_h */
+  batch->e_density[i] = species_densities[5];
+
+  batch->RT_heating_rate[i] = iact_rates[0];
+  batch->RT_HI_ionization_rate[i] = iact_rates[1];
+  batch->RT_HeI_ionization_rate[i] = iact_rates[2];
+  batch->RT_HeII_ionization_rate[i] = iact_rates[3];
+  batch->RT_H2_dissociation_rate[i] = iact_rates[4];
+}
+
+/**
+ * @brief point a grackle field struct to the first count particles of a
+ * batch. Grackle sees them as a 1D grid of count cells.
+ *
+ * @param grackle_fields (return) grackle field to set up
+ * @param batch the #rt_grackle_batch_fields holding the data
+ * @param count number of particles in the batch
+ **/
+__attribute__((always_inline)) INLINE static void rt_get_grackle_batch_fields(
+    grackle_field_data *grackle_fields, struct rt_grackle_batch_fields *batch,
+    const int count) {
+
+  batch->dimension[0] = count;
+  batch->dimension[1] = 0;
+  batch->dimension[2] = 0;
+  batch->start[0] = 0;
+  batch->start[1] = 0;
+  batch->start[2] = 0;
+  batch->end[0] = count - 1;
+  batch->end[1] = 0;
+  batch->end[2] = 0;
+
+  grackle_fields->grid_dx = 0.;
+  grackle_fields->grid_rank = 3;
+  grackle_fields->grid_dimension = batch->dimension;
+  grackle_fields->grid_start = batch->start;
+  grackle_fields->grid_end = batch->end;
+
+  grackle_fields->density = batch->density;
+  grackle_fields->internal_energy = batch->internal_energy;
+  grackle_fields->x_velocity = NULL;
+  grackle_fields->y_velocity = NULL;
+  grackle_fields->z_velocity = NULL;
+  /* for primordial_chemistry >= 1 */
+  grackle_fields->HI_density = batch->HI_density;
+  grackle_fields->HII_density = batch->HII_density;
+  grackle_fields->HeI_density = batch->HeI_density;
+  grackle_fields->HeII_density = batch->HeII_density;
+  grackle_fields->HeIII_density = batch->HeIII_density;
+  grackle_fields->e_density = batch->e_density;
+  /* for primordial_chemistry >= 2 */
+  grackle_fields->HM_density = NULL;
+  grackle_fields->H2I_density = NULL;
+  grackle_fields->H2II_density = NULL;
+  /* for primordial_chemistry >= 3 */
+  grackle_fields->DI_density = NULL;
+  grackle_fields->DII_density = NULL;
+  grackle_fields->HDI_density = NULL;
+  /* for metal_cooling = 1 */
+  grackle_fields->metal_density = NULL;
+
+  grackle_fields->volumetric_heating_rate = NULL;
+  grackle_fields->specific_heating_rate = NULL;
+
+  grackle_fields->RT_HI_ionization_rate = batch->RT_HI_ionization_rate;
+  grackle_fields->RT_HeI_ionization_rate = batch->RT_HeI_ionization_rate;
+  grackle_fields->RT_HeII_ionization_rate = batch->RT_HeII_ionization_rate;
+  grackle_fields->RT_H2_dissociation_rate = batch->RT_H2_dissociation_rate;
+  grackle_fields->RT_heating_rate = batch->RT_heating_rate;
+}
+
 /**
  * @brief Write out all available grackle field data for a given index
  * and setup to a file.
@@ -42,62 +42,67 @@
 /**
  * @brief Interpolate the minimal and maximal eigenvalues from
  * the lookup table given the reduced flux f and angle w.r.t.
- * the surface theta.
+ * the surface theta, for the left and right states at once.
  *
- * @param f reduced flux |F|/(c E)
- * @param theta angle between flux and surface
- * @param lambda_min minimal eigenvalue
- * @param lambda_max maximal eigenvalue
+ * @param f reduced flux |F|/(c E) of the left and right states
+ * @param theta angle between flux and surface of the left and right states
+ * @param lambda_min (return) minimal eigenvalue of the left and right states
+ * @param lambda_max (return) maximal eigenvalue of the left and right states
  */
 
 __attribute__((always_inline)) INLINE static void
-rt_riemann_interpolate_eigenvals(float f, float theta, float *lambda_min,
-                                 float *lambda_max) {
-
-  /* find lower table indices for f and theta */
-  int f_ind = floor(RT_RIEMANN_HLL_ONE_OVER_DF * f);
-  if (f_ind >= RT_RIEMANN_HLL_NPOINTS - 1) f_ind = RT_RIEMANN_HLL_NPOINTS - 2;
-  int theta_ind = floor(RT_RIEMANN_HLL_ONE_OVER_DTHETA * theta);
-  if (theta_ind >= RT_RIEMANN_HLL_NPOINTS - 1)
-    theta_ind = RT_RIEMANN_HLL_NPOINTS - 2;
-
-  /* Grab the data */
-  const float Q11min = rt_riemann_HLL_eigenvals[f_ind][theta_ind][0];
-  const float Q12min = rt_riemann_HLL_eigenvals[f_ind][theta_ind + 1][0];
-  const float Q21min = rt_riemann_HLL_eigenvals[f_ind + 1][theta_ind][0];
-  const float Q22min = rt_riemann_HLL_eigenvals[f_ind + 1][theta_ind + 1][0];
-  const float Q11max = rt_riemann_HLL_eigenvals[f_ind][theta_ind][1];
-  const float Q12max = rt_riemann_HLL_eigenvals[f_ind][theta_ind + 1][1];
-  const float Q21max = rt_riemann_HLL_eigenvals[f_ind + 1][theta_ind][1];
-  const float Q22max = rt_riemann_HLL_eigenvals[f_ind + 1][theta_ind + 1][1];
-
-  /* (f - f1)/(f2 - f1)  =  (f - f_ind * Delta f)/Delta f */
-  const float df1 = f * RT_RIEMANN_HLL_ONE_OVER_DF - (float)f_ind;
-  /* (f2 - f)/(f2 - f1)  =  ((f_ind + 1) * Delta f - f)/Delta f */
-  const float df2 = 1.f - df1;
-
-  /* linear interpolation in f direction */
-  const float fmid1_min = df2 * Q11min + df1 * Q21min;
-  const float fmid2_min = df2 * Q12min + df1 * Q22min;
-  const float fmid1_max = df2 * Q11max + df1 * Q21max;
-  const float fmid2_max = df2 * Q12max + df1 * Q22max;
-
-  /* Now second interpolation in theta direction */
-  /* (theta - theta1)/(theta2 - theta1) */
-  const float dtheta1 =
-      theta * RT_RIEMANN_HLL_ONE_OVER_DTHETA - (float)theta_ind;
-  /* (theta2 - theta)/(theta2 - theta1) */
-  const float dtheta2 = 1.f - dtheta1;
-
-  /* Make sure -1 < eigenvalue < 1 */
-  float lmin = dtheta2 * fmid1_min + dtheta1 * fmid2_min;
-  lmin = max(lmin, -1.f);
-  lmin = min(lmin, 1.f);
-  *lambda_min = lmin;
-  float lmax = dtheta2 * fmid1_max + dtheta1 * fmid2_max;
-  lmax = max(lmax, -1.f);
-  lmax = min(lmax, 1.f);
-  *lambda_max = lmax;
+rt_riemann_interpolate_eigenvals(const float f[2], const float theta[2],
+                                 float lambda_min[2], float lambda_max[2]) {
+
+  for (int s = 0; s < 2; s++) {
+
+    /* find lower table indices for f and theta */
+    int f_ind = floor(RT_RIEMANN_HLL_ONE_OVER_DF * f[s]);
+    if (f_ind >= RT_RIEMANN_HLL_NPOINTS - 1)
+      f_ind = RT_RIEMANN_HLL_NPOINTS - 2;
+    int theta_ind = floor(RT_RIEMANN_HLL_ONE_OVER_DTHETA * theta[s]);
+    if (theta_ind >= RT_RIEMANN_HLL_NPOINTS - 1)
+      theta_ind = RT_RIEMANN_HLL_NPOINTS - 2;
+
+    /* Grab the data: {min, max} at theta_ind and theta_ind + 1 for the two
+     * f rows around f */
+    const float Q1[4] = {
+        rt_riemann_HLL_eigenvals[f_ind][theta_ind][0],
+        rt_riemann_HLL_eigenvals[f_ind][theta_ind][1],
+        rt_riemann_HLL_eigenvals[f_ind][theta_ind + 1][0],
+        rt_riemann_HLL_eigenvals[f_ind][theta_ind + 1][1]};
+    const float Q2[4] = {
+        rt_riemann_HLL_eigenvals[f_ind + 1][theta_ind][0],
+        rt_riemann_HLL_eigenvals[f_ind + 1][theta_ind][1],
+        rt_riemann_HLL_eigenvals[f_ind + 1][theta_ind + 1][0],
+        rt_riemann_HLL_eigenvals[f_ind + 1][theta_ind + 1][1]};
+
+    /* (f - f1)/(f2 - f1)  =  (f - f_ind * Delta f)/Delta f */
+    const float df1 = f[s] * RT_RIEMANN_HLL_ONE_OVER_DF - (float)f_ind;
+    /* (f2 - f)/(f2 - f1)  =  ((f_ind + 1) * Delta f - f)/Delta f */
+    const float df2 = 1.f - df1;
+
+    /* linear interpolation in f direction */
+    float fmid[4];
+    for (int k = 0; k < 4; k++) fmid[k] = df2 * Q1[k] + df1 * Q2[k];
+
+    /* Now second interpolation in theta direction */
+    /* (theta - theta1)/(theta2 - theta1) */
+    const float dtheta1 =
+        theta[s] * RT_RIEMANN_HLL_ONE_OVER_DTHETA - (float)theta_ind;
+    /* (theta2 - theta)/(theta2 - theta1) */
+    const float dtheta2 = 1.f - dtheta1;
+
+    /* Make sure -1 < eigenvalue < 1 */
+    float lmin = dtheta2 * fmid[0] + dtheta1 * fmid[2];
+    lmin = max(lmin, -1.f);
+    lmin = min(lmin, 1.f);
+    lambda_min[s] = lmin;
+    float lmax = dtheta2 * fmid[1] + dtheta1 * fmid[3];
+    lmax = max(lmax, -1.f);
+    lmax = min(lmax, 1.f);
+    lambda_max[s] = lmax;
+  }
 }
 
 /**
@@ -125,49 +130,35 @@ __attribute__((always_inline)) INLINE static void rt_riemann_solve_for_flux(
   const float c_red = rt_params.reduced_speed_of_light;
   const float c_red_inv = rt_params.reduced_speed_of_light_inverse;
 
-  float fL = 0.f;
-  float thetaL = 0.f;
-
-  if (UL[0] > 0.f) {
-    fL = FLnorm / UL[0] * c_red_inv;
-    fL = min(fL, 1.f);
-  }
-
-  if (FLnorm > 0.f) {
-    /* cos theta = F * n / (|F| |n|) */
-    const float FLdotn =
-        UL[1] * n_unit[0] + UL[2] * n_unit[1] + UL[3] * n_unit[2];
-    float costhetaL = min(FLdotn / FLnorm, 1.f);
-    costhetaL = max(costhetaL, -1.f);
-    thetaL = acosf(costhetaL);
-  }
-
-  float fR = 0.f;
-  float thetaR = 0.f;
-
-  if (UR[0] > 0.f) {
-    fR = FRnorm / UR[0] * c_red_inv;
-    fR = min(fR, 1.f);
-  }
-
-  if (FRnorm > 0.f) {
-    const float FRdotn =
-        UR[1] * n_unit[0] + UR[2] * n_unit[1] + UR[3] * n_unit[2];
-    float costhetaR = min(FRdotn / FRnorm, 1.f);
-    costhetaR = max(costhetaR, -1.f);
-    thetaR = acosf(costhetaR);
+  const float *U[2] = {UL, UR};
+  const float Fnorm[2] = {FLnorm, FRnorm};
+  float f[2] = {0.f, 0.f};
+  float theta[2] = {0.f, 0.f};
+
+  for (int s = 0; s < 2; s++) {
+
+    if (U[s][0] > 0.f) {
+      f[s] = Fnorm[s] / U[s][0] * c_red_inv;
+      f[s] = min(f[s], 1.f);
+    }
+
+    if (Fnorm[s] > 0.f) {
+      /* cos theta = F * n / (|F| |n|) */
+      const float Fdotn =
+          U[s][1] * n_unit[0] + U[s][2] * n_unit[1] + U[s][3] * n_unit[2];
+      float costheta = min(Fdotn / Fnorm[s], 1.f);
+      costheta = max(costheta, -1.f);
+      theta[s] = acosf(costheta);
+    }
   }
 
   /* interpolate eigenvalues in lookup table */
-  float lambdaLmin = 0;
-  float lambdaLmax = 0;
-  rt_riemann_interpolate_eigenvals(fL, thetaL, &lambdaLmin, &lambdaLmax);
-  float lambdaRmin = 0;
-  float lambdaRmax = 0;
-  rt_riemann_interpolate_eigenvals(fR, thetaR, &lambdaRmin, &lambdaRmax);
+  float lambda_min[2];
+  float lambda_max[2];
+  rt_riemann_interpolate_eigenvals(f, theta, lambda_min, lambda_max);
 
-  const float lminus = min3(lambdaLmin, lambdaRmin, 0.f);
-  const float lplus = max3(lambdaLmax, lambdaRmax, 0.f);
+  const float lminus = min3(lambda_min[0], lambda_min[1], 0.f);
+  const float lplus = max3(lambda_max[0], lambda_max[1], 0.f);
 
   /* Sanity check: This should give the same results as GLF solver */
   /* const float lminus = -1.f; */
@@ -184,41 +175,22 @@ __attribute__((always_inline)) INLINE static void rt_riemann_solve_for_flux(
   /* Project the (hyperbolic) flux along the surface,
    * reduce the problem to 1D with 4 quantities*/
   float fluxL[4];
-  fluxL[0] = hyperFluxL[0][0] * n_unit[0] + hyperFluxL[0][1] * n_unit[1] +
-             hyperFluxL[0][2] * n_unit[2];
-  fluxL[1] = hyperFluxL[1][0] * n_unit[0] + hyperFluxL[1][1] * n_unit[1] +
-             hyperFluxL[1][2] * n_unit[2];
-  fluxL[2] = hyperFluxL[2][0] * n_unit[0] + hyperFluxL[2][1] * n_unit[1] +
-             hyperFluxL[2][2] * n_unit[2];
-  fluxL[3] = hyperFluxL[3][0] * n_unit[0] + hyperFluxL[3][1] * n_unit[1] +
-             hyperFluxL[3][2] * n_unit[2];
-
   float fluxR[4];
-  fluxR[0] = hyperFluxR[0][0] * n_unit[0] + hyperFluxR[0][1] * n_unit[1] +
-             hyperFluxR[0][2] * n_unit[2];
-  fluxR[1] = hyperFluxR[1][0] * n_unit[0] + hyperFluxR[1][1] * n_unit[1] +
-             hyperFluxR[1][2] * n_unit[2];
-  fluxR[2] = hyperFluxR[2][0] * n_unit[0] + hyperFluxR[2][1] * n_unit[1] +
-             hyperFluxR[2][2] * n_unit[2];
-  fluxR[3] = hyperFluxR[3][0] * n_unit[0] + hyperFluxR[3][1] * n_unit[1] +
-             hyperFluxR[3][2] * n_unit[2];
+  for (int k = 0; k < 4; k++) {
+    fluxL[k] = hyperFluxL[k][0] * n_unit[0] + hyperFluxL[k][1] * n_unit[1] +
+               hyperFluxL[k][2] * n_unit[2];
+    fluxR[k] = hyperFluxR[k][0] * n_unit[0] + hyperFluxR[k][1] * n_unit[1] +
+               hyperFluxR[k][2] * n_unit[2];
+  }
 
   const float one_over_dl = 1.f / (lplus - lminus);
   /* Remember that the eigenvalues are in units of c */
   const float lprod = lplus * lminus * c_red;
 
-  flux_half[0] =
-      (lplus * fluxL[0] - lminus * fluxR[0] + lprod * (UR[0] - UL[0])) *
-      one_over_dl;
-  flux_half[1] =
-      (lplus * fluxL[1] - lminus * fluxR[1] + lprod * (UR[1] - UL[1])) *
-      one_over_dl;
-  flux_half[2] =
-      (lplus * fluxL[2] - lminus * fluxR[2] + lprod * (UR[2] - UL[2])) *
-      one_over_dl;
-  flux_half[3] =
-      (lplus * fluxL[3] - lminus * fluxR[3] + lprod * (UR[3] - UL[3])) *
-      one_over_dl;
+  for (int k = 0; k < 4; k++)
+    flux_half[k] =
+        (lplus * fluxL[k] - lminus * fluxR[k] + lprod * (UR[k] - UL[k])) *
+        one_over_dl;
 }
 
 #endif /* SWIFT_GEAR_RT_RIEMANN_HLL_H */
@@ -83,7 +83,8 @@ __attribute__((always_inline)) INLINE static void rt_tchem_first_init_part(
 }
 
 /**
- * @brief Main function for the thermochemistry step.
+ * @brief Gather the quantities grackle needs for the thermochemistry of a
+ * particle.
  *
  * @param p Particle to work on.
  * @param xp Pointer to the particle' extended data.
@@ -92,62 +93,65 @@ __attribute__((always_inline)) INLINE static void rt_tchem_first_init_part(
  * @param hydro_props The #hydro_props.
  * @param phys_const The physical constants in internal units.
  * @param us The internal system of units.
- * @param dt The time-step of this particle.
+ * @param density (return) The physical density of the particle.
+ * @param internal_energy (return) The physical internal energy.
+ * @param species_densities (return) The species densities (HI, HII, HeI,
+ * HeII, HeIII, e-).
+ * @param iact_rates (return) The interaction rates (heating, 3 ionization,
+ * H2 dissociation).
  */
-__attribute__((always_inline)) INLINE static void rt_do_thermochemistry(
-    struct part* restrict p, struct xpart* restrict xp,
-    struct rt_props* rt_props, const struct cosmology* restrict cosmo,
+__attribute__((always_inline)) INLINE static void rt_tchem_prepare_particle(
+    const struct part* restrict p, const struct xpart* restrict xp,
+    const struct rt_props* rt_props, const struct cosmology* restrict cosmo,
     const struct hydro_props* hydro_props,
     const struct phys_const* restrict phys_const,
-    const struct unit_system* restrict us, const double dt) {
-  /* Note: Can't pass rt_props as const struct because of grackle
-   * accessinging its properties there */
-
-  /* Nothing to do here? */
-  if (rt_props->skip_thermochemistry) return;
-  if (dt == 0.) return;
+    const struct unit_system* restrict us, gr_float* density,
+    gr_float* internal_energy, gr_float species_densities[6],
+    gr_float iact_rates[5]) {
 
-  /* This is where the fun begins */
-  /* ---------------------------- */
-
-  /* initialize data so it'll be in scope */
-  grackle_field_data particle_grackle_data;
-
-  gr_float density = hydro_get_physical_density(p, cosmo);
+  *density = hydro_get_physical_density(p, cosmo);
   const float u_minimal = hydro_props->minimal_internal_energy;
-  gr_float internal_energy =
+  *internal_energy =
       max(hydro_get_physical_internal_energy(p, xp, cosmo), u_minimal);
 
-  gr_float species_densities[6];
-  rt_tchem_get_species_densities(p, density, species_densities);
+  rt_tchem_get_species_densities(p, *density, species_densities);
 
   float radiation_energy_density[RT_NGROUPS];
   rt_part_get_radiation_energy_density(p, radiation_energy_density);
 
-  gr_float iact_rates[5];
   rt_get_interaction_rates_for_grackle(
       iact_rates, radiation_energy_density, species_densities,
       rt_props->average_photon_energy, rt_props->energy_weighted_cross_sections,
       rt_props->number_weighted_cross_sections, phys_const, us);
+}
 
-  /* Put all the data into a grackle field struct */
-  rt_get_grackle_particle_fields(&particle_grackle_data, density,
-                                 internal_energy, species_densities,
-                                 iact_rates);
-
-  /* solve chemistry */
-  /* Note: `grackle_rates` is a global variable defined by grackle itself.
-   * Using a manually allocd and initialized variable here fails with MPI
-   * for some reason. */
-  if (local_solve_chemistry(&rt_props->grackle_chemistry_data, &grackle_rates,
-                            &rt_props->grackle_units, &particle_grackle_data,
-                            dt) == 0)
-    error("Error in solve_chemistry.");
+/**
+ * @brief Copy the results of grackle back to a particle and remove the
+ * absorbed radiation.
+ *
+ * @param p Particle to work on.
+ * @param rt_props RT properties struct
+ * @param hydro_props The #hydro_props.
+ * @param phys_const The physical constants in internal units.
+ * @param us The internal system of units.
+ * @param dt The time-step of this particle.
+ * @param density The physical density of the particle.
+ * @param species_densities The species densities before the step.
+ * @param batch The grackle fields after the call to grackle.
+ * @param i The index of the particle in the batch.
+ */
+__attribute__((always_inline)) INLINE static void rt_tchem_finalise_particle(
+    struct part* restrict p, const struct rt_props* rt_props,
+    const struct hydro_props* hydro_props,
+    const struct phys_const* restrict phys_const,
+    const struct unit_system* restrict us, const double dt,
+    const gr_float density, gr_float species_densities[6],
+    const struct rt_grackle_batch_fields* batch, const int i) {
 
-  /* copy updated grackle data to particle */
   /* update particle internal energy. Grackle had access by reference
    * to internal_energy */
-  internal_energy = particle_grackle_data.internal_energy[0];
+  const gr_float internal_energy = batch->internal_energy[i];
+  const float u_minimal = hydro_props->minimal_internal_energy;
   const float u_new = max(internal_energy, u_minimal);
 
   /* If we're good, update the particle data from grackle results */
@@ -155,16 +159,12 @@ __attribute__((always_inline)) INLINE static void rt_do_thermochemistry(
 
   /* Update mass fractions */
   const gr_float one_over_rho = 1. / density;
-  p->rt_data.tchem.mass_fraction_HI =
-      particle_grackle_data.HI_density[0] * one_over_rho;
-  p->rt_data.tchem.mass_fraction_HII =
-      particle_grackle_data.HII_density[0] * one_over_rho;
-  p->rt_data.tchem.mass_fraction_HeI =
-      particle_grackle_data.HeI_density[0] * one_over_rho;
-  p->rt_data.tchem.mass_fraction_HeII =
-      particle_grackle_data.HeII_density[0] * one_over_rho;
+  p->rt_data.tchem.mass_fraction_HI = batch->HI_density[i] * one_over_rho;
+  p->rt_data.tchem.mass_fraction_HII = batch->HII_density[i] * one_over_rho;
+  p->rt_data.tchem.mass_fraction_HeI = batch->HeI_density[i] * one_over_rho;
+  p->rt_data.tchem.mass_fraction_HeII = batch->HeII_density[i] * one_over_rho;
   p->rt_data.tchem.mass_fraction_HeIII =
-      particle_grackle_data.HeIII_density[0] * one_over_rho;
+      batch->HeIII_density[i] * one_over_rho;
 
   rt_check_unphysical_mass_fractions(p);
 
@@ -176,12 +176,12 @@ __attribute__((always_inline)) INLINE static void rt_do_thermochemistry(
       rt_props->number_weighted_cross_sections, phys_const, us);
 
   gr_float species_densities_new[6];
-  species_densities_new[0] = particle_grackle_data.HI_density[0];
-  species_densities_new[1] = particle_grackle_data.HII_density[0];
-  species_densities_new[2] = particle_grackle_data.HeI_density[0];
-  species_densities_new[3] = particle_grackle_data.HeII_density[0];
-  species_densities_new[4] = particle_grackle_data.HeIII_density[0];
-  species_densities_new[5] = particle_grackle_data.e_density[0];
+  species_densities_new[0] = batch->HI_density[i];
+  species_densities_new[1] = batch->HII_density[i];
+  species_densities_new[2] = batch->HeI_density[i];
+  species_densities_new[3] = batch->HeII_density[i];
+  species_densities_new[4] = batch->HeIII_density[i];
+  species_densities_new[5] = batch->e_density[i];
   double absorption_rates_new[RT_NGROUPS];
   rt_get_absorption_rates(absorption_rates_new, species_densities_new,
                           rt_props->average_photon_energy,
@@ -195,17 +195,132 @@ __attribute__((always_inline)) INLINE static void rt_do_thermochemistry(
     f = min(1., f);
     f = max(0., f);
     p->rt_data.radiation[g].energy_density *= (1. - f);
-    for (int i = 0; i < 3; i++) {
-      p->rt_data.radiation[g].flux[i] *= (1. - f);
+    for (int k = 0; k < 3; k++) {
+      p->rt_data.radiation[g].flux[k] *= (1. - f);
     }
 
     rt_check_unphysical_state(&p->rt_data.radiation[g].energy_density,
                               p->rt_data.radiation[g].flux, E_old,
                               /*callloc=*/2);
   }
+}
 
-  /* Clean up after yourself. */
-  rt_clean_grackle_fields(&particle_grackle_data);
+/**
+ * @brief Main function for the thermochemistry step of a batch of particles.
+ *
+ * Grackle integrates all the cells of a field with a single time-step, so the
+ * particles are handed over in groups sharing the same time-step. Grackle
+ * treats each cell of the field independently, hence the result for a given
+ * particle does not depend on the other members of its group.
+ *
+ * @param parts The particles to work on.
+ * @param xparts The particles' extended data.
+ * @param dt The time-step of each particle.
+ * @param count The number of particles (at most #RT_TCHEM_BATCH_SIZE).
+ * @param rt_props RT properties struct
+ * @param cosmo The current cosmological model.
+ * @param hydro_props The #hydro_props.
+ * @param phys_const The physical constants in internal units.
+ * @param us The internal system of units.
+ */
+__attribute__((always_inline)) INLINE static void rt_do_thermochemistry_batch(
+    struct part** restrict parts, struct xpart** restrict xparts,
+    const double* dt, const int count, struct rt_props* rt_props,
+    const struct cosmology* restrict cosmo,
+    const struct hydro_props* hydro_props,
+    const struct phys_const* restrict phys_const,
+    const struct unit_system* restrict us) {
+  /* Note: Can't pass rt_props as const struct because of grackle
+   * accessinging its properties there */
+
+#ifdef SWIFT_DEBUG_CHECKS
+  if (count > RT_TCHEM_BATCH_SIZE)
+    error("Batch of %d particles is larger than RT_TCHEM_BATCH_SIZE", count);
+#endif
+
+  /* Nothing to do here? */
+  if (rt_props->skip_thermochemistry) return;
+
+  /* This is where the fun begins */
+  /* ---------------------------- */
+
+  struct rt_grackle_batch_fields batch;
+  gr_float density[RT_TCHEM_BATCH_SIZE];
+  gr_float species_densities[RT_TCHEM_BATCH_SIZE][6];
+  int index[RT_TCHEM_BATCH_SIZE];
+  char done[RT_TCHEM_BATCH_SIZE];
+
+  for (int i = 0; i < count; i++) done[i] = (dt[i] == 0.);
+
+  for (int first = 0; first < count; first++) {
+
+    if (done[first]) continue;
+
+    /* Collect all the particles with the same time-step as this one */
+    const double dt_group = dt[first];
+    int n = 0;
+    for (int i = first; i < count; i++) {
+
+      if (done[i] || dt[i] != dt_group) continue;
+      done[i] = 1;
+      index[n] = i;
+
+      gr_float internal_energy;
+      gr_float iact_rates[5];
+      rt_tchem_prepare_particle(parts[i], xparts[i], rt_props, cosmo,
+                                hydro_props, phys_const, us, &density[n],
+                                &internal_energy, species_densities[n],
+                                iact_rates);
+
+      rt_set_grackle_batch_particle(&batch, n, density[n], internal_energy,
+                                    species_densities[n], iact_rates);
+      n++;
+    }
+
+    /* Put all the data into a grackle field struct */
+    grackle_field_data grackle_data;
+    rt_get_grackle_batch_fields(&grackle_data, &batch, n);
+
+    /* solve chemistry */
+    /* Note: `grackle_rates` is a global variable defined by grackle itself.
+     * Using a manually allocd and initialized variable here fails with MPI
+     * for some reason. */
+    if (local_solve_chemistry(&rt_props->grackle_chemistry_data,
+                              &grackle_rates, &rt_props->grackle_units,
+                              &grackle_data, dt_group) == 0)
+      error("Error in solve_chemistry.");
+
+    /* copy updated grackle data to the particles */
+    for (int k = 0; k < n; k++)
+      rt_tchem_finalise_particle(parts[index[k]], rt_props, hydro_props,
+                                 phys_const, us, dt_group, density[k],
+                                 species_densities[k], &batch, k);
+  }
+}
+
+/**
+ * @brief Main function for the thermochemistry step.
+ *
+ * @param p Particle to work on.
+ * @param xp Pointer to the particle' extended data.
+ * @param rt_props RT properties struct
+ * @param cosmo The current cosmological model.
+ * @param hydro_props The #hydro_props.
+ * @param phys_const The physical constants in internal units.
+ * @param us The internal system of units.
+ * @param dt The time-step of this particle.
+ */
+__attribute__((always_inline)) INLINE static void rt_do_thermochemistry(
+    struct part* restrict p, struct xpart* restrict xp,
+    struct rt_props* rt_props, const struct cosmology* restrict cosmo,
+    const struct hydro_props* hydro_props,
+    const struct phys_const* restrict phys_const,
+    const struct unit_system* restrict us, const double dt) {
+
+  struct part* parts[1] = {p};
+  struct xpart* xparts[1] = {xp};
+  rt_do_thermochemistry_batch(parts, xparts, &dt, /*count=*/1, rt_props,
+                              cosmo, hydro_props, phys_const, us);
 }
 
 /**
@@ -29,6 +29,7 @@
 /* Local headers. */
 #include "cache.h"
 #include "gravity_cache.h"
+#include "task_trace.h"
 
 struct cell;
 struct engine;
@@ -75,6 +76,16 @@ struct runner {
   /*! Time this runner was active during the last engine_launch. */
   ticks active_time;
 
+  /*! Nr of hydro cell pairs reached by the pair loops during the last
+   * engine_launch. */
+  long long hydro_pair_count;
+
+  /*! Nr of those pairs skipped as none of their particles were in range. */
+  long long hydro_pair_culled;
+
+  /*! The last tasks run by this runner. */
+  struct task_trace trace;
+
 #ifdef WITH_VECTORIZATION
 
   /*! The particle cache of cell ci. */
@@ -152,7 +163,6 @@ void runner_do_pack_limiter(struct runner *r, struct cell *c, void **buffer,
                             const int timer);
 void runner_do_unpack_limiter(struct runner *r, struct cell *c, void *buffer,
                               const int timer);
-void runner_do_neutrino_weighting(struct runner *r, struct cell *c, int timer);
 void runner_do_rt_advance_cell_time(struct runner *r, struct cell *c,
                                     int timer);
 void runner_do_collect_rt_times(struct runner *r, struct cell *c,
@@ -56,8 +56,6 @@ void runner_do_gas_swallow(struct runner *r, struct cell *c, int timer) {
   const struct black_holes_props *props = e->black_holes_properties;
   const int use_nibbling = props->use_nibbling;
 
-  struct bpart *bparts = s->bparts;
-  const size_t nr_bpart = s->nr_bparts;
 #ifdef WITH_MPI
   struct bpart *bparts_foreign = s->bparts_foreign;
   const size_t nr_bparts_foreign = s->nr_bparts_foreign;
@@ -79,6 +77,8 @@ void runner_do_gas_swallow(struct runner *r, struct cell *c, int timer) {
     return;
   }
 
+  TIMER_TIC;
+
   /* Loop over the progeny ? */
   if (c->split) {
     for (int k = 0; k < 8; k++) {
@@ -128,53 +128,47 @@ void runner_do_gas_swallow(struct runner *r, struct cell *c, int timer) {
         int found = 0;
 
         /* Let's look for the hungry black hole in the local list */
-        for (size_t i = 0; i < nr_bpart; ++i) {
-
-          /* Get a handle on the bpart. */
-          struct bpart *bp = &bparts[i];
+        struct bpart *bp = space_find_local_bpart(s, BH_id);
 
-          if (bp->id == BH_id) {
+        if (bp != NULL) {
 
-            /* Lock the space as we are going to work directly on the bpart list
-             */
-            lock_lock(&s->lock);
+          /* Lock the space as we are going to work directly on the bpart list
+           */
+          lock_lock(&s->lock);
 
-            /* Swallow the gas particle (i.e. update the BH properties) */
-            black_holes_swallow_part(bp, p, xp, e->cosmology);
+          /* Swallow the gas particle (i.e. update the BH properties) */
+          black_holes_swallow_part(bp, p, xp, e->cosmology);
 
-            /* Release the space as we are done updating the bpart */
-            if (lock_unlock(&s->lock) != 0)
-              error("Failed to unlock the space.");
+          /* Release the space as we are done updating the bpart */
+          if (lock_unlock(&s->lock) != 0) error("Failed to unlock the space.");
 
-            /* If the gas particle is local, remove it */
-            if (c->nodeID == e->nodeID) {
+          /* If the gas particle is local, remove it */
+          if (c->nodeID == e->nodeID) {
 
-              message("BH %lld removing gas particle %lld", bp->id, p->id);
+            message("BH %lld removing gas particle %lld", bp->id, p->id);
 
-              lock_lock(&e->s->lock);
+            lock_lock(&e->s->lock);
 
-              /* Re-check that the particle has not been removed
-               * by another thread before we do the deed. */
-              if (!part_is_inhibited(p, e)) {
+            /* Re-check that the particle has not been removed
+             * by another thread before we do the deed. */
+            if (!part_is_inhibited(p, e)) {
 
-                /* Finally, remove the gas particle from the system
-                 * Recall that the gpart associated with it is also removed
-                 * at the same time. */
-                cell_remove_part(e, c, p, xp);
-              }
-
-              if (lock_unlock(&e->s->lock) != 0)
-                error("Failed to unlock the space!");
+              /* Finally, remove the gas particle from the system
+               * Recall that the gpart associated with it is also removed
+               * at the same time. */
+              cell_remove_part(e, c, p, xp);
             }
 
-            /* In any case, prevent the particle from being re-swallowed */
-            black_holes_mark_part_as_swallowed(&p->black_holes_data);
-
-            found = 1;
-            break;
+            if (lock_unlock(&e->s->lock) != 0)
+              error("Failed to unlock the space!");
           }
 
-        } /* Loop over local BHs */
+          /* In any case, prevent the particle from being re-swallowed */
+          black_holes_mark_part_as_swallowed(&p->black_holes_data);
+
+          found = 1;
+
+        } /* Found a local BH */
 
 #ifdef WITH_MPI
 
@@ -187,12 +181,12 @@ void runner_do_gas_swallow(struct runner *r, struct cell *c, int timer) {
           for (size_t i = 0; i < nr_bparts_foreign; ++i) {
 
             /* Get a handle on the bpart. */
-            struct bpart *bp = &bparts_foreign[i];
+            struct bpart *bp_foreign = &bparts_foreign[i];
 
-            if (bp->id == BH_id) {
+            if (bp_foreign->id == BH_id) {
 
               message("BH %lld removing gas particle %lld (foreign BH case)",
-                      bp->id, p->id);
+                      bp_foreign->id, p->id);
 
               lock_lock(&e->s->lock);
 
@@ -223,6 +217,8 @@ void runner_do_gas_swallow(struct runner *r, struct cell *c, int timer) {
       } /* Part was flagged for swallowing */
     }   /* Loop over the parts */
   }     /* Cell is not split */
+
+  if (timer) TIMER_TOC(timer_do_gas_swallow);
 }
 
 /**
@@ -292,8 +288,6 @@ void runner_do_bh_swallow(struct runner *r, struct cell *c, int timer) {
   const struct black_holes_props *props = e->black_holes_properties;
   const int use_nibbling = props->use_nibbling;
 
-  struct bpart *bparts = s->bparts;
-  const size_t nr_bpart = s->nr_bparts;
 #ifdef WITH_MPI
   struct bpart *bparts_foreign = s->bparts_foreign;
   const size_t nr_bparts_foreign = s->nr_bparts_foreign;
@@ -310,6 +304,8 @@ void runner_do_bh_swallow(struct runner *r, struct cell *c, int timer) {
     return;
   }
 
+  TIMER_TIC;
+
   /* Loop over the progeny ? */
   if (c->split) {
     for (int k = 0; k < 8; k++) {
@@ -361,58 +357,51 @@ void runner_do_bh_swallow(struct runner *r, struct cell *c, int timer) {
         int found = 0;
 
         /* Let's look for the hungry black hole in the local list */
-        for (size_t i = 0; i < nr_bpart; ++i) {
-
-          /* Get a handle on the bpart. */
-          struct bpart *bp = &bparts[i];
+        struct bpart *bp = space_find_local_bpart(s, BH_id);
 
-          if (bp->id == BH_id) {
+        /* Is the swallowing BH itself flagged for swallowing by
+           another BH? */
+        if (bp != NULL &&
+            black_holes_get_bpart_swallow_id(&bp->merger_data) != -1) {
 
-            /* Is the swallowing BH itself flagged for swallowing by
-               another BH? */
-            if (black_holes_get_bpart_swallow_id(&bp->merger_data) != -1) {
+          /* Pretend it was found and abort */
+          black_holes_mark_bpart_as_not_swallowed(&cell_bp->merger_data);
+          found = 1;
 
-              /* Pretend it was found and abort */
-              black_holes_mark_bpart_as_not_swallowed(&cell_bp->merger_data);
-              found = 1;
-              break;
-            }
+        } else if (bp != NULL) {
 
-            /* Lock the space as we are going to work directly on the
-             * space's bpart list */
-            lock_lock(&s->lock);
+          /* Lock the space as we are going to work directly on the
+           * space's bpart list */
+          lock_lock(&s->lock);
 
-            /* Swallow the BH particle (i.e. update the swallowing BH
-             * properties with the properties of cell_bp) */
-            black_holes_swallow_bpart(bp, cell_bp, e->cosmology, e->time,
-                                      with_cosmology, props,
-                                      e->physical_constants);
+          /* Swallow the BH particle (i.e. update the swallowing BH
+           * properties with the properties of cell_bp) */
+          black_holes_swallow_bpart(bp, cell_bp, e->cosmology, e->time,
+                                    with_cosmology, props,
+                                    e->physical_constants);
 
-            /* Release the space as we are done updating the bpart */
-            if (lock_unlock(&s->lock) != 0)
-              error("Failed to unlock the space.");
+          /* Release the space as we are done updating the bpart */
+          if (lock_unlock(&s->lock) != 0) error("Failed to unlock the space.");
 
-            message("BH %lld swallowing BH particle %lld", bp->id, cell_bp->id);
+          message("BH %lld swallowing BH particle %lld", bp->id, cell_bp->id);
 
-            /* If the BH particle is local, remove it */
-            if (c->nodeID == e->nodeID) {
+          /* If the BH particle is local, remove it */
+          if (c->nodeID == e->nodeID) {
 
-              message("BH %lld removing BH particle %lld", bp->id, cell_bp->id);
+            message("BH %lld removing BH particle %lld", bp->id, cell_bp->id);
 
-              /* Finally, remove the BH particle from the system
-               * Recall that the gpart associated with it is also removed
-               * at the same time. */
-              cell_remove_bpart(e, c, cell_bp);
-            }
+            /* Finally, remove the BH particle from the system
+             * Recall that the gpart associated with it is also removed
+             * at the same time. */
+            cell_remove_bpart(e, c, cell_bp);
+          }
 
-            /* In any case, prevent the particle from being re-swallowed */
-            black_holes_mark_bpart_as_merged(&cell_bp->merger_data);
+          /* In any case, prevent the particle from being re-swallowed */
+          black_holes_mark_bpart_as_merged(&cell_bp->merger_data);
 
-            found = 1;
-            break;
-          }
+          found = 1;
 
-        } /* Loop over local BHs */
+        } /* Found a local BH */
 
 #ifdef WITH_MPI
 
@@ -425,13 +414,14 @@ void runner_do_bh_swallow(struct runner *r, struct cell *c, int timer) {
           for (size_t i = 0; i < nr_bparts_foreign; ++i) {
 
             /* Get a handle on the bpart. */
-            struct bpart *bp = &bparts_foreign[i];
+            struct bpart *bp_foreign = &bparts_foreign[i];
 
-            if (bp->id == BH_id) {
+            if (bp_foreign->id == BH_id) {
 
               /* Is the swallowing BH itself flagged for swallowing by
                  another BH? */
-              if (black_holes_get_bpart_swallow_id(&bp->merger_data) != -1) {
+              if (black_holes_get_bpart_swallow_id(&bp_foreign->merger_data) !=
+                  -1) {
 
                 /* Pretend it was found and abort */
                 black_holes_mark_bpart_as_not_swallowed(&cell_bp->merger_data);
@@ -440,7 +430,7 @@ void runner_do_bh_swallow(struct runner *r, struct cell *c, int timer) {
               }
 
               message("BH %lld removing BH particle %lld (foreign BH case)",
-                      bp->id, cell_bp->id);
+                      bp_foreign->id, cell_bp->id);
 
               /* Finally, remove the gas particle from the system */
               cell_remove_bpart(e, c, cell_bp);
@@ -462,6 +452,8 @@ void runner_do_bh_swallow(struct runner *r, struct cell *c, int timer) {
       } /* Part was flagged for swallowing */
     }   /* Loop over the parts */
   }     /* Cell is not split */
+
+  if (timer) TIMER_TOC(timer_do_bh_swallow);
 }
 
 /**
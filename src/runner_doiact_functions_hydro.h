@@ -1337,6 +1337,15 @@ void DOPAIR1_BRANCH(struct runner *r, struct cell *ci, struct cell *cj) {
       cj->hydro.dx_max_sort_old > space_maxreldx * cj->dmin)
     error("Interacting unsorted cells.");
 
+#ifdef CELL_PAIR_IN_RANGE
+  /* Can any active particle be in range of the other cell? */
+  r->hydro_pair_count++;
+  if (!CELL_PAIR_IN_RANGE(ci, cj, shift, /*symmetric=*/0, e->ti_current)) {
+    r->hydro_pair_culled++;
+    return;
+  }
+#endif
+
 #ifdef SWIFT_DEBUG_CHECKS
   /* Pick-out the sorted lists. */
   const struct sort_entry *restrict sort_i = cell_get_hydro_sorts(ci, sid);
@@ -1972,6 +1981,15 @@ void DOPAIR2_BRANCH(struct runner *r, struct cell *ci, struct cell *cj) {
       cj->hydro.dx_max_sort_old > space_maxreldx * cj->dmin)
     error("Interacting unsorted cells.");
 
+#ifdef CELL_PAIR_IN_RANGE
+  /* Can any active particle be in range of the other cell? */
+  r->hydro_pair_count++;
+  if (!CELL_PAIR_IN_RANGE(ci, cj, shift, /*symmetric=*/1, e->ti_current)) {
+    r->hydro_pair_culled++;
+    return;
+  }
+#endif
+
 #ifdef SWIFT_DEBUG_CHECKS
   /* Pick-out the sorted lists. */
   const struct sort_entry *restrict sort_i = cell_get_hydro_sorts(ci, sid);
@@ -2507,6 +2525,15 @@ void DOSUB_PAIR1(struct runner *r, struct cell *ci, struct cell *cj,
   double shift[3];
   const int sid = space_getsid(s, &ci, &cj, shift);
 
+#ifdef CELL_PAIR_IN_RANGE
+  /* Can any particles be in range? If not, skip the whole sub-tree. */
+  if (!CELL_PAIR_IN_RANGE(ci, cj, shift, /*symmetric=*/0, e->ti_current)) {
+    r->hydro_pair_count++;
+    r->hydro_pair_culled++;
+    return;
+  }
+#endif
+
   /* Recurse? */
   if (cell_can_recurse_in_pair_hydro_task(ci) &&
       cell_can_recurse_in_pair_hydro_task(cj)) {
@@ -2613,6 +2640,15 @@ void DOSUB_PAIR2(struct runner *r, struct cell *ci, struct cell *cj,
   double shift[3];
   const int sid = space_getsid(s, &ci, &cj, shift);
 
+#ifdef CELL_PAIR_IN_RANGE
+  /* Can any particles be in range? If not, skip the whole sub-tree. */
+  if (!CELL_PAIR_IN_RANGE(ci, cj, shift, /*symmetric=*/1, e->ti_current)) {
+    r->hydro_pair_count++;
+    r->hydro_pair_culled++;
+    return;
+  }
+#endif
+
   /* Recurse? */
   if (cell_can_recurse_in_pair_hydro_task(ci) &&
       cell_can_recurse_in_pair_hydro_task(cj)) {
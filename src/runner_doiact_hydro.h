@@ -135,6 +135,7 @@
 #define PART_IS_ACTIVE part_is_active
 #define CELL_IS_ACTIVE cell_is_active_hydro
 #define CELL_ARE_PART_DRIFTED cell_are_part_drifted
+#define CELL_PAIR_IN_RANGE cell_hydro_pair_in_range
 /* when running with RT subcycling, we can have RT active
  * particles in a normal swift step that aren't drifted to
  * the current time, so we don't do those checks there. */
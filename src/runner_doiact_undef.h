@@ -38,4 +38,5 @@
 #undef PART_IS_ACTIVE
 #undef CELL_IS_ACTIVE
 #undef CELL_ARE_PART_DRIFTED
+#undef CELL_PAIR_IN_RANGE
 #undef DO_DRIFT_DEBUG_CHECKS
@@ -980,7 +980,7 @@ void runner_do_black_holes_swallow_ghost(struct runner *r, struct cell *c,
     }
   }
 
-  if (timer) TIMER_TOC(timer_do_black_holes_ghost);
+  if (timer) TIMER_TOC(timer_do_black_holes_swallow_ghost);
 }
 
 /**
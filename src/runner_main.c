@@ -484,10 +484,11 @@ void *runner_main(void *data) {
             free(t->buff);
           } else if (t->subtype == task_subtype_part_swallow) {
             free(t->buff);
-          } else if (t->subtype == task_subtype_bpart_merger) {
-            free(t->buff);
           } else if (t->subtype == task_subtype_limiter) {
             free(t->buff);
+          } else if (t->subtype == task_subtype_gpart &&
+                     e->sched.mpi_compact_gparts) {
+            free(t->buff);
           }
           break;
         case task_type_recv:
@@ -509,16 +510,16 @@ void *runner_main(void *data) {
           } else if (t->subtype == task_subtype_rt_transport) {
             runner_do_recv_part(r, ci, -1, 1);
           } else if (t->subtype == task_subtype_part_swallow) {
-            cell_unpack_part_swallow(ci,
-                                     (struct black_holes_part_data *)t->buff);
-            free(t->buff);
-          } else if (t->subtype == task_subtype_bpart_merger) {
-            cell_unpack_bpart_swallow(ci,
-                                      (struct black_holes_bpart_data *)t->buff);
+            cell_unpack_bh_swallow(ci, t->buff);
             free(t->buff);
           } else if (t->subtype == task_subtype_limiter) {
             /* Nothing to do here. Unpacking done in a separate task */
           } else if (t->subtype == task_subtype_gpart) {
+            if (e->sched.mpi_compact_gparts) {
+              cell_unpack_gparts_compact(
+                  ci, (struct gpart_compact *)t->buff, e->ti_current);
+              free(t->buff);
+            }
             runner_do_recv_gpart(r, ci, 1);
           } else if (t->subtype == task_subtype_spart_density) {
             runner_do_recv_spart(r, ci, 1, 1);
@@ -578,9 +579,6 @@ void *runner_main(void *data) {
         case task_type_fof_pair:
           runner_do_fof_pair(r, t->ci, t->cj, 1);
           break;
-        case task_type_neutrino_weight:
-          runner_do_neutrino_weighting(r, ci, 1);
-          break;
         case task_type_rt_ghost1:
           runner_do_rt_ghost1(r, t->ci, 1);
           break;
@@ -596,7 +594,9 @@ void *runner_main(void *data) {
         default:
           error("Unknown/invalid task type (%d).", t->type);
       }
-      r->active_time += (getticks() - task_beg);
+      const ticks task_end = getticks();
+      r->active_time += (task_end - task_beg);
+      task_trace_record(&r->trace, t, task_beg, task_end);
 
 /* Mark that we have run this task on these cells */
 #ifdef SWIFT_DEBUG_CHECKS
@@ -147,8 +147,25 @@ void runner_do_cooling(struct runner *r, struct cell *c, int timer) {
       if (c->progeny[k] != NULL) runner_do_cooling(r, c->progeny[k], 0);
   } else {
 
+#ifdef COOLING_BATCH_SIZE
+    /* The active particles waiting to be cooled together */
+    struct part *batch_parts[COOLING_BATCH_SIZE];
+    struct xpart *batch_xparts[COOLING_BATCH_SIZE];
+    float batch_dt_cool[COOLING_BATCH_SIZE];
+    float batch_dt_therm[COOLING_BATCH_SIZE];
+    int batch_count = 0;
+#endif
+
+    /* Only visit the particles on an active time-bin if they are indexed */
+    const struct cell_bin_index_entry *bin_index = NULL;
+    const int nr_indexed = cell_get_active_bin_index_parts(
+        c, e->s->bin_index_epoch, e->max_active_bin, &bin_index);
+    const int nr_loop = (nr_indexed >= 0) ? nr_indexed : count;
+
     /* Loop over the parts in this cell. */
-    for (int i = 0; i < count; i++) {
+    for (int n = 0; n < nr_loop; n++) {
+
+      const int i = (bin_index != NULL) ? bin_index[n].offset : n;
 
       /* Get a direct pointer on the part. */
       struct part *restrict p = &parts[i];
@@ -173,12 +190,38 @@ void runner_do_cooling(struct runner *r, struct cell *c, int timer) {
           dt_therm = get_timestep(p->time_bin, time_base);
         }
 
+#ifdef COOLING_BATCH_SIZE
+        /* Add to the batch and cool it once it is full */
+        batch_parts[batch_count] = p;
+        batch_xparts[batch_count] = xp;
+        batch_dt_cool[batch_count] = dt_cool;
+        batch_dt_therm[batch_count] = dt_therm;
+        batch_count++;
+
+        if (batch_count == COOLING_BATCH_SIZE) {
+          cooling_cool_part_batch(constants, us, cosmo, hydro_props,
+                                  entropy_floor_props, cooling_func,
+                                  batch_parts, batch_xparts, batch_dt_cool,
+                                  batch_dt_therm, batch_count, time);
+          batch_count = 0;
+        }
+#else
         /* Let's cool ! */
         cooling_cool_part(constants, us, cosmo, hydro_props,
                           entropy_floor_props, cooling_func, p, xp, dt_cool,
                           dt_therm, time);
+#endif
       }
     }
+
+#ifdef COOLING_BATCH_SIZE
+    /* Cool the leftovers */
+    if (batch_count > 0)
+      cooling_cool_part_batch(constants, us, cosmo, hydro_props,
+                              entropy_floor_props, cooling_func, batch_parts,
+                              batch_xparts, batch_dt_cool, batch_dt_therm,
+                              batch_count, time);
+#endif
   }
 
   if (timer) TIMER_TOC(timer_do_cooling);
@@ -634,8 +677,16 @@ void runner_do_end_hydro_force(struct runner *r, struct cell *c, int timer) {
     const int count = c->hydro.count;
     struct part *restrict parts = c->hydro.parts;
 
+    /* Only visit the particles on an active time-bin if they are indexed */
+    const struct cell_bin_index_entry *bin_index = NULL;
+    const int nr_indexed = cell_get_active_bin_index_parts(
+        c, e->s->bin_index_epoch, e->max_active_bin, &bin_index);
+    const int nr_loop = (nr_indexed >= 0) ? nr_indexed : count;
+
     /* Loop over the gas particles in this cell. */
-    for (int k = 0; k < count; k++) {
+    for (int i = 0; i < nr_loop; i++) {
+
+      const int k = (bin_index != NULL) ? bin_index[i].offset : i;
 
       /* Get a handle on the part. */
       struct part *restrict p = &parts[k];
@@ -1035,6 +1086,14 @@ void runner_do_rt_tchem(struct runner *r, struct cell *c, int timer) {
     struct part *restrict parts = c->hydro.parts;
     struct xpart *restrict xparts = c->hydro.xparts;
 
+#ifdef RT_TCHEM_BATCH_SIZE
+    /* The active particles waiting for their thermochemistry */
+    struct part *batch_parts[RT_TCHEM_BATCH_SIZE];
+    struct xpart *batch_xparts[RT_TCHEM_BATCH_SIZE];
+    double batch_dt[RT_TCHEM_BATCH_SIZE];
+    int batch_count = 0;
+#endif
+
     /* Loop over the gas particles in this cell. */
     for (int k = 0; k < count; k++) {
 
@@ -1071,9 +1130,30 @@ void runner_do_rt_tchem(struct runner *r, struct cell *c, int timer) {
 
       rt_finalise_transport(p, dt, cosmo);
 
+#ifdef RT_TCHEM_BATCH_SIZE
+      /* Add to the batch and do its thermochemistry once it is full */
+      batch_parts[batch_count] = p;
+      batch_xparts[batch_count] = xp;
+      batch_dt[batch_count] = dt;
+      batch_count++;
+
+      if (batch_count == RT_TCHEM_BATCH_SIZE) {
+        rt_tchem_batch(batch_parts, batch_xparts, batch_dt, batch_count,
+                       rt_props, cosmo, hydro_props, phys_const, us);
+        batch_count = 0;
+      }
+#else
       /* And finally do thermochemistry */
       rt_tchem(p, xp, rt_props, cosmo, hydro_props, phys_const, us, dt);
+#endif
     }
+
+#ifdef RT_TCHEM_BATCH_SIZE
+    /* Deal with the leftovers */
+    if (batch_count > 0)
+      rt_tchem_batch(batch_parts, batch_xparts, batch_dt, batch_count,
+                     rt_props, cosmo, hydro_props, phys_const, us);
+#endif
   }
 
   if (timer) TIMER_TOC(timer_do_rt_tchem);
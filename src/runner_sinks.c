@@ -522,8 +522,6 @@ void runner_do_sinks_gas_swallow(struct runner *r, struct cell *c, int timer) {
   struct engine *e = r->e;
   struct space *s = e->s;
 
-  struct sink *sinks = s->sinks;
-  const size_t nr_sink = s->nr_sinks;
 #ifdef WITH_MPI
   error("MPI is not implemented yet for sink particles.");
 #endif
@@ -580,53 +578,47 @@ void runner_do_sinks_gas_swallow(struct runner *r, struct cell *c, int timer) {
         int found = 0;
 
         /* Let's look for the hungry sink in the local list */
-        for (size_t i = 0; i < nr_sink; ++i) {
+        struct sink *sp = space_find_local_sink(s, sink_id);
 
-          /* Get a handle on the bpart. */
-          struct sink *sp = &sinks[i];
+        if (sp != NULL) {
 
-          if (sp->id == sink_id) {
+          /* Lock the space as we are going to work directly on the spart list
+           */
+          lock_lock(&s->lock);
 
-            /* Lock the space as we are going to work directly on the spart list
-             */
-            lock_lock(&s->lock);
+          /* Swallow the gas particle (i.e. update the sink properties) */
+          sink_swallow_part(sp, p, xp, e->cosmology);
 
-            /* Swallow the gas particle (i.e. update the sink properties) */
-            sink_swallow_part(sp, p, xp, e->cosmology);
+          /* Release the space as we are done updating the spart */
+          if (lock_unlock(&s->lock) != 0) error("Failed to unlock the space.");
 
-            /* Release the space as we are done updating the spart */
-            if (lock_unlock(&s->lock) != 0)
-              error("Failed to unlock the space.");
+          /* If the gas particle is local, remove it */
+          if (c->nodeID == e->nodeID) {
 
-            /* If the gas particle is local, remove it */
-            if (c->nodeID == e->nodeID) {
+            message("sink %lld removing gas particle %lld", sp->id, p->id);
 
-              message("sink %lld removing gas particle %lld", sp->id, p->id);
+            lock_lock(&e->s->lock);
 
-              lock_lock(&e->s->lock);
+            /* Re-check that the particle has not been removed
+             * by another thread before we do the deed. */
+            if (!part_is_inhibited(p, e)) {
 
-              /* Re-check that the particle has not been removed
-               * by another thread before we do the deed. */
-              if (!part_is_inhibited(p, e)) {
-
-                /* Finally, remove the gas particle from the system
-                 * Recall that the gpart associated with it is also removed
-                 * at the same time. */
-                cell_remove_part(e, c, p, xp);
-              }
-
-              if (lock_unlock(&e->s->lock) != 0)
-                error("Failed to unlock the space!");
+              /* Finally, remove the gas particle from the system
+               * Recall that the gpart associated with it is also removed
+               * at the same time. */
+              cell_remove_part(e, c, p, xp);
             }
 
-            /* In any case, prevent the particle from being re-swallowed */
-            sink_mark_part_as_swallowed(&p->sink_data);
-
-            found = 1;
-            break;
+            if (lock_unlock(&e->s->lock) != 0)
+              error("Failed to unlock the space!");
           }
 
-        } /* Loop over local sinks */
+          /* In any case, prevent the particle from being re-swallowed */
+          sink_mark_part_as_swallowed(&p->sink_data);
+
+          found = 1;
+
+        } /* Found a local sink */
 
 #ifdef WITH_MPI
         error("MPI is not implemented yet for sink particles.");
@@ -708,8 +700,6 @@ void runner_do_sinks_sink_swallow(struct runner *r, struct cell *c, int timer) {
   struct engine *e = r->e;
   struct space *s = e->s;
 
-  struct sink *sinks = s->sinks;
-  const size_t nr_sink = s->nr_sinks;
 #ifdef WITH_MPI
   error("MPI is not implemented yet for sink particles.");
 #endif
@@ -766,58 +756,50 @@ void runner_do_sinks_sink_swallow(struct runner *r, struct cell *c, int timer) {
         int found = 0;
 
         /* Let's look for the hungry sink in the local list */
-        for (size_t i = 0; i < nr_sink; ++i) {
+        struct sink *sp = space_find_local_sink(s, sink_id);
 
-          /* Get a handle on the bpart. */
-          struct sink *sp = &sinks[i];
+        /* Is the swallowing sink itself flagged for swallowing by
+           another sink? */
+        if (sp != NULL && sink_get_sink_swallow_id(&sp->merger_data) != -1) {
 
-          if (sp->id == sink_id) {
+          /* Pretend it was found and abort */
+          sink_mark_sink_as_not_swallowed(&cell_sp->merger_data);
+          found = 1;
 
-            /* Is the swallowing sink itself flagged for swallowing by
-               another sink? */
-            if (sink_get_sink_swallow_id(&sp->merger_data) != -1) {
+        } else if (sp != NULL) {
 
-              /* Pretend it was found and abort */
-              sink_mark_sink_as_not_swallowed(&cell_sp->merger_data);
-              found = 1;
-              break;
-            }
-
-            /* Lock the space as we are going to work directly on the
-             * space's bpart list */
-            lock_lock(&s->lock);
+          /* Lock the space as we are going to work directly on the
+           * space's bpart list */
+          lock_lock(&s->lock);
 
-            /* Swallow the sink particle (i.e. update the swallowing sink
-             * properties with the properties of cell_sp) */
-            sink_swallow_sink(sp, cell_sp, e->cosmology);
+          /* Swallow the sink particle (i.e. update the swallowing sink
+           * properties with the properties of cell_sp) */
+          sink_swallow_sink(sp, cell_sp, e->cosmology);
 
-            /* Release the space as we are done updating the spart */
-            if (lock_unlock(&s->lock) != 0)
-              error("Failed to unlock the space.");
+          /* Release the space as we are done updating the spart */
+          if (lock_unlock(&s->lock) != 0) error("Failed to unlock the space.");
 
-            // message("sink %lld swallowing sink particle %lld", sp->id,
-            // cell_sp->id);
+          // message("sink %lld swallowing sink particle %lld", sp->id,
+          // cell_sp->id);
 
-            /* If the sink particle is local, remove it */
-            if (c->nodeID == e->nodeID) {
+          /* If the sink particle is local, remove it */
+          if (c->nodeID == e->nodeID) {
 
-              message("sink %lld removing sink particle %lld", sp->id,
-                      cell_sp->id);
+            message("sink %lld removing sink particle %lld", sp->id,
+                    cell_sp->id);
 
-              /* Finally, remove the sink particle from the system
-               * Recall that the gpart associated with it is also removed
-               * at the same time. */
-              cell_remove_sink(e, c, cell_sp);
-            }
+            /* Finally, remove the sink particle from the system
+             * Recall that the gpart associated with it is also removed
+             * at the same time. */
+            cell_remove_sink(e, c, cell_sp);
+          }
 
-            /* In any case, prevent the particle from being re-swallowed */
-            sink_mark_sink_as_merged(&cell_sp->merger_data);
+          /* In any case, prevent the particle from being re-swallowed */
+          sink_mark_sink_as_merged(&cell_sp->merger_data);
 
-            found = 1;
-            break;
-          }
+          found = 1;
 
-        } /* Loop over local sinks */
+        } /* Found a local sink */
 
 #ifdef WITH_MPI
         error("MPI is not implemented yet for sink particles.");
@@ -33,6 +33,7 @@
 #include "feedback.h"
 #include "kick.h"
 #include "multipole.h"
+#include "neutrino.h"
 #include "timers.h"
 #include "timestep.h"
 #include "timestep_limiter.h"
@@ -92,6 +93,7 @@ void runner_do_kick1(struct runner *r, struct cell *c, const int timer) {
   const struct entropy_floor_properties *entropy_floor = e->entropy_floor;
   const int periodic = e->s->periodic;
   const int with_cosmology = (e->policy & engine_policy_cosmology);
+  const int with_neutrino_weighting = e->neutrino_properties->use_delta_f;
   struct part *restrict parts = c->hydro.parts;
   struct xpart *restrict xparts = c->hydro.xparts;
   struct gpart *restrict gparts = c->grav.parts;
@@ -114,6 +116,9 @@ void runner_do_kick1(struct runner *r, struct cell *c, const int timer) {
       !cell_is_starting_black_holes(c, e))
     return;
 
+  if (with_neutrino_weighting && !with_cosmology)
+    error("Phase space weighting without cosmology not implemented.");
+
   /* Recurse? */
   if (c->split) {
     for (int k = 0; k < 8; k++)
@@ -137,8 +142,16 @@ void runner_do_kick1(struct runner *r, struct cell *c, const int timer) {
           ti_begin_mesh, ti_end_mesh, time_base, with_cosmology, cosmo);
     }
 
+    /* Only visit the particles on an active time-bin if they are indexed */
+    const struct cell_bin_index_entry *bin_index = NULL;
+    const int nr_indexed = cell_get_active_bin_index_parts(
+        c, e->s->bin_index_epoch, e->max_active_bin, &bin_index);
+    const int nr_loop = (nr_indexed >= 0) ? nr_indexed : count;
+
     /* Loop over the parts in this cell. */
-    for (int k = 0; k < count; k++) {
+    for (int i = 0; i < nr_loop; i++) {
+
+      const int k = (bin_index != NULL) ? bin_index[i].offset : i;
 
       /* Get a handle on the part. */
       struct part *restrict p = &parts[k];
@@ -191,8 +204,22 @@ void runner_do_kick1(struct runner *r, struct cell *c, const int timer) {
       }
     }
 
+    /* Neutrinos kicked here are weighted using the delta-f method */
+    struct neutrino_model nu_model;
+    if (with_neutrino_weighting) gather_neutrino_consts(e->s, &nu_model);
+    struct gpart *nu_batch[NEUTRINO_WEIGHT_BATCH_SIZE];
+    int nu_batch_count = 0;
+
+    /* Only visit the particles on an active time-bin if they are indexed */
+    const struct cell_bin_index_entry *gbin_index = NULL;
+    const int nr_gindexed = cell_get_active_bin_index_gparts(
+        c, e->s->bin_index_epoch, e->max_active_bin, &gbin_index);
+    const int nr_gloop = (nr_gindexed >= 0) ? nr_gindexed : gcount;
+
     /* Loop over the gparts in this cell. */
-    for (int k = 0; k < gcount; k++) {
+    for (int i = 0; i < nr_gloop; i++) {
+
+      const int k = (gbin_index != NULL) ? gbin_index[i].offset : i;
 
       /* Get a handle on the part. */
       struct gpart *restrict gp = &gparts[k];
@@ -235,9 +262,22 @@ void runner_do_kick1(struct runner *r, struct cell *c, const int timer) {
         /* Do the kick */
         kick_gpart(gp, dt_kick_grav, ti_begin, ti_end, dt_kick_mesh_grav,
                    ti_begin_mesh, ti_end_mesh);
+
+        /* Update the weight of the neutrinos with their new velocity */
+        if (with_neutrino_weighting && gp->type == swift_type_neutrino) {
+          nu_batch[nu_batch_count++] = gp;
+          if (nu_batch_count == NEUTRINO_WEIGHT_BATCH_SIZE) {
+            gpart_neutrino_weight_batch(nu_batch, nu_batch_count, &nu_model);
+            nu_batch_count = 0;
+          }
+        }
       }
     }
 
+    /* Weight the remaining neutrinos */
+    if (nu_batch_count > 0)
+      gpart_neutrino_weight_batch(nu_batch, nu_batch_count, &nu_model);
+
     /* Loop over the stars particles in this cell. */
     for (int k = 0; k < scount; k++) {
 
@@ -409,8 +449,16 @@ void runner_do_kick2(struct runner *r, struct cell *c, const int timer) {
           ti_begin_mesh, ti_end_mesh, time_base, with_cosmology, cosmo);
     }
 
+    /* Only visit the particles on an active time-bin if they are indexed */
+    const struct cell_bin_index_entry *bin_index = NULL;
+    const int nr_indexed = cell_get_active_bin_index_parts(
+        c, e->s->bin_index_epoch, e->max_active_bin, &bin_index);
+    const int nr_loop = (nr_indexed >= 0) ? nr_indexed : count;
+
     /* Loop over the particles in this cell. */
-    for (int k = 0; k < count; k++) {
+    for (int i = 0; i < nr_loop; i++) {
+
+      const int k = (bin_index != NULL) ? bin_index[i].offset : i;
 
       /* Get a handle on the part. */
       struct part *restrict p = &parts[k];
@@ -463,8 +511,16 @@ void runner_do_kick2(struct runner *r, struct cell *c, const int timer) {
       }
     }
 
+    /* Only visit the particles on an active time-bin if they are indexed */
+    const struct cell_bin_index_entry *gbin_index = NULL;
+    const int nr_gindexed = cell_get_active_bin_index_gparts(
+        c, e->s->bin_index_epoch, e->max_active_bin, &gbin_index);
+    const int nr_gloop = (nr_gindexed >= 0) ? nr_gindexed : gcount;
+
     /* Loop over the g-particles in this cell. */
-    for (int k = 0; k < gcount; k++) {
+    for (int i = 0; i < nr_gloop; i++) {
+
+      const int k = (gbin_index != NULL) ? gbin_index[i].offset : i;
 
       /* Get a handle on the part. */
       struct gpart *restrict gp = &gparts[k];
@@ -1117,6 +1173,10 @@ void runner_do_timestep(struct runner *r, struct cell *c, const int timer) {
       }
     }
 
+    /* Index the particles by their new time-bin for the next active loops */
+    cell_build_bin_index_parts(c, e->s);
+    cell_build_bin_index_gparts(c, e->s);
+
   } else {
 
     /* Loop over the progeny. */
@@ -1380,6 +1440,9 @@ void runner_do_limiter(struct runner *r, struct cell *c, int force,
     /* ti_gravity_end_min = c->grav.ti_end_min; */
     /* ti_gravity_beg_max = c->grav.ti_beg_max; */
 
+    /* Number of particles whose time-bin changed */
+    int limited = 0;
+
     /* Loop over the gas particles in this cell. */
     for (int k = 0; k < count; k++) {
 
@@ -1415,6 +1478,7 @@ void runner_do_limiter(struct runner *r, struct cell *c, int force,
 
         /* Apply the limiter and get the new end of time-step */
         const integertime_t ti_end_new = timestep_limit_part(p, xp, e);
+        limited++;
         const timebin_t new_bin = p->time_bin;
         const integertime_t ti_beg_new =
             ti_end_new - get_integer_timestep(new_bin);
@@ -1454,6 +1518,9 @@ void runner_do_limiter(struct runner *r, struct cell *c, int force,
     c->hydro.ti_beg_max = max(c->hydro.ti_beg_max, ti_hydro_beg_max);
     /* c->grav.ti_end_min = min(c->grav.ti_end_min, ti_gravity_end_min); */
     /* c->grav.ti_beg_max = max(c->grav.ti_beg_max, ti_gravity_beg_max); */
+
+    /* The time-bin index must follow the woken-up particles */
+    if (limited) cell_build_bin_index_parts(c, e->s);
   }
 
   /* Clear the limiter flags. */
@@ -1537,6 +1604,9 @@ void runner_do_sync(struct runner *r, struct cell *c, int force,
     /* ti_gravity_end_min = c->grav.ti_end_min; */
     /* ti_gravity_beg_max = c->grav.ti_beg_max; */
 
+    /* Number of particles whose time-bin changed */
+    int synchronized = 0;
+
     /* Loop over the gas particles in this cell. */
     for (int k = 0; k < count; k++) {
 
@@ -1556,6 +1626,7 @@ void runner_do_sync(struct runner *r, struct cell *c, int force,
 
         /* Finish this particle's time-step */
         timestep_process_sync_part(p, xp, e, cosmo);
+        synchronized++;
 
         /* Get new time-step */
         integertime_t ti_new_step = get_part_timestep(p, xp, e);
@@ -1625,6 +1696,9 @@ void runner_do_sync(struct runner *r, struct cell *c, int force,
     c->hydro.ti_beg_max = max(c->hydro.ti_beg_max, ti_hydro_beg_max);
     /* c->grav.ti_end_min = min(c->grav.ti_end_min, ti_gravity_end_min); */
     /* c->grav.ti_beg_max = max(c->grav.ti_beg_max, ti_gravity_beg_max); */
+
+    /* The time-bin index must follow the synchronized particles */
+    if (synchronized) cell_build_bin_index_parts(c, e->s);
   }
 
   /* Clear the sync flags. */
@@ -1730,6 +1804,8 @@ void runner_do_collect_rt_times(struct runner *r, struct cell *c,
   const struct engine *e = r->e;
   size_t rt_updated = 0;
 
+  TIMER_TIC;
+
   if (e->ti_current == e->ti_current_subcycle)
     error("called collect_rt_times during a main step");
 
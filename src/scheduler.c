@@ -2452,6 +2452,8 @@ void scheduler_enqueue(struct scheduler *s, struct task *t) {
       t->cj->subtasks_executed[t->subtype]++;
     }
 #endif
+    /* Record when the task was done (for the critical path analysis). */
+    t->tic = t->toc = getticks();
     t->skip = 1;
     for (int j = 0; j < t->nr_unlock_tasks; j++) {
       struct task *t2 = t->unlock_tasks[j];
@@ -2525,13 +2527,7 @@ void scheduler_enqueue(struct scheduler *s, struct task *t) {
 
         } else if (t->subtype == task_subtype_part_swallow) {
 
-          count = size =
-              t->ci->hydro.count * sizeof(struct black_holes_part_data);
-          buff = t->buff = malloc(count);
-
-        } else if (t->subtype == task_subtype_bpart_merger) {
-          count = size =
-              sizeof(struct black_holes_bpart_data) * t->ci->black_holes.count;
+          count = size = cell_bh_swallow_buffer_size(t->ci);
           buff = t->buff = malloc(count);
 
         } else if (t->subtype == task_subtype_xv ||
@@ -2555,6 +2551,12 @@ void scheduler_enqueue(struct scheduler *s, struct task *t) {
           t->buff = buff;
           task_get_unique_dependent(t)->buff = buff;
 
+        } else if (t->subtype == task_subtype_gpart &&
+                   s->mpi_compact_gparts) {
+
+          count = size = t->ci->grav.count * sizeof(struct gpart_compact);
+          buff = t->buff = malloc(size);
+
         } else if (t->subtype == task_subtype_gpart) {
 
           count = t->ci->grav.count;
@@ -2628,18 +2630,9 @@ void scheduler_enqueue(struct scheduler *s, struct task *t) {
 
         } else if (t->subtype == task_subtype_part_swallow) {
 
-          size = count =
-              t->ci->hydro.count * sizeof(struct black_holes_part_data);
-          buff = t->buff = malloc(size);
-          cell_pack_part_swallow(t->ci, (struct black_holes_part_data *)buff);
-
-        } else if (t->subtype == task_subtype_bpart_merger) {
-
-          size = count =
-              sizeof(struct black_holes_bpart_data) * t->ci->black_holes.count;
+          size = count = cell_bh_swallow_buffer_size(t->ci);
           buff = t->buff = malloc(size);
-          cell_pack_bpart_swallow(t->ci,
-                                  (struct black_holes_bpart_data *)t->buff);
+          cell_pack_bh_swallow(t->ci, buff);
 
         } else if (t->subtype == task_subtype_xv ||
                    t->subtype == task_subtype_rho ||
@@ -2659,6 +2652,13 @@ void scheduler_enqueue(struct scheduler *s, struct task *t) {
           type = MPI_BYTE;
           buff = t->buff;
 
+        } else if (t->subtype == task_subtype_gpart &&
+                   s->mpi_compact_gparts) {
+
+          size = count = t->ci->grav.count * sizeof(struct gpart_compact);
+          buff = t->buff = malloc(size);
+          cell_pack_gparts_compact(t->ci, (struct gpart_compact *)buff);
+
         } else if (t->subtype == task_subtype_gpart) {
 
           count = t->ci->grav.count;
@@ -3140,6 +3140,63 @@ void scheduler_report_task_times_mapper(void *map_data, int num_elements,
   }
 }
 
+/**
+ * @brief Display a histogram of the run times of the tasks.
+ *
+ * The run time of the last execution of each task is binned in powers of two
+ * of thousandths of the clock unit (i.e. micro-seconds when it is ms). For
+ * each bin we report the number of tasks, the number of those that are
+ * interactions (self, pair and their sub-variants) and the fraction of the
+ * total task time they account for.
+ *
+ * @param s The #scheduler.
+ */
+void scheduler_report_task_time_histogram(const struct scheduler *s) {
+
+  int counts[scheduler_task_time_histogram_bins] = {0};
+  int counts_interactions[scheduler_task_time_histogram_bins] = {0};
+  double times[scheduler_task_time_histogram_bins] = {0.};
+  double total_time = 0.;
+
+  for (int k = 0; k < s->nr_tasks; k++) {
+    const struct task *t = &s->tasks[k];
+    if (t->implicit || t->toc <= t->tic) continue;
+
+    /* Run time in thousandths of the clock unit (normally micro-seconds). */
+    const double dt = clocks_from_ticks(t->toc - t->tic) * 1e3;
+
+    int bin = dt < 1. ? 0 : 1 + (int)log2(dt);
+    if (bin >= scheduler_task_time_histogram_bins)
+      bin = scheduler_task_time_histogram_bins - 1;
+
+    counts[bin]++;
+    if (t->type == task_type_self || t->type == task_type_pair ||
+        t->type == task_type_sub_self || t->type == task_type_sub_pair)
+      counts_interactions[bin]++;
+    times[bin] += dt;
+    total_time += dt;
+  }
+
+  if (total_time == 0.) return;
+
+  message("*** Task run-time histogram (last run of each task):");
+  char header[32];
+  snprintf(header, sizeof(header), "run time [1e-3 %s]", clocks_getunit());
+  message("*** %20s: %10s %12s %8s", header, "tasks", "interactions", "time");
+  for (int i = 0; i < scheduler_task_time_histogram_bins; ++i) {
+    if (counts[i] == 0) continue;
+    const double low = i == 0 ? 0. : (double)(1LL << (i - 1));
+    const double high = (double)(1LL << i);
+    char range[32];
+    if (i == scheduler_task_time_histogram_bins - 1)
+      snprintf(range, sizeof(range), ">= %.0f", low);
+    else
+      snprintf(range, sizeof(range), "[%.0f, %.0f)", low, high);
+    message("*** %20s: %10d %12d %7.2f%%", range, counts[i],
+            counts_interactions[i], times[i] / total_time * 100.);
+  }
+}
+
 /**
  * @brief Display the time spent in the different task categories.
  *
@@ -3184,3 +3241,53 @@ void scheduler_report_task_times(const struct scheduler *s,
   message("took %.3f %s.", clocks_from_ticks(getticks() - tic),
           clocks_getunit());
 }
+
+/**
+ * @brief Compute the critical path through the tasks that ran since a given
+ * time.
+ *
+ * The tasks are visited in topological order and each of them is given the
+ * length of the longest chain of dependent tasks ending with it, using their
+ * measured run times. This is the time the tasks would have taken with an
+ * unlimited number of threads and no waiting on other ranks. Tasks that did
+ * not run break the chains, implicit tasks pass them on at no cost.
+ *
+ * @param s The #scheduler.
+ * @param tic_start The time at which the tasks were launched.
+ *
+ * @return The length of the critical path.
+ */
+ticks scheduler_critical_path(const struct scheduler *s,
+                              const ticks tic_start) {
+
+  const int nr_tasks = s->nr_tasks;
+  const int *tid = s->tasks_ind;
+  const struct task *tasks = s->tasks;
+
+  /* Length of the longest chain ending with (or leading to) each task. */
+  ticks *chain =
+      (ticks *)swift_malloc("critical_path", nr_tasks * sizeof(ticks));
+  if (chain == NULL) error("Failed to allocate the critical path lengths.");
+  bzero(chain, nr_tasks * sizeof(ticks));
+
+  ticks critical_path = 0;
+
+  for (int k = 0; k < nr_tasks; k++) {
+    const int ind = tid[k];
+    const struct task *t = &tasks[ind];
+
+    /* Did the task run? */
+    if (t->tic < tic_start || t->toc < t->tic) continue;
+
+    chain[ind] += t->toc - t->tic;
+    if (chain[ind] > critical_path) critical_path = chain[ind];
+
+    for (int j = 0; j < t->nr_unlock_tasks; j++) {
+      const int ind_unlock = t->unlock_tasks[j] - tasks;
+      if (chain[ind_unlock] < chain[ind]) chain[ind_unlock] = chain[ind];
+    }
+  }
+
+  swift_free("critical_path", chain);
+  return critical_path;
+}
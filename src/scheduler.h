@@ -45,6 +45,7 @@
 #define scheduler_dosub 1
 #define scheduler_maxsteal 10
 #define scheduler_maxtries 2
+#define scheduler_task_time_histogram_bins 24
 #define scheduler_doforcesplit            \
   0 /* Beware: switching this on can/will \
        break engine_addlink as it assumes \
@@ -106,6 +107,9 @@ struct scheduler {
    * MPI. */
   size_t mpi_message_limit;
 
+  /* Send the #gpart of the gravity tasks as #gpart_compact? */
+  int mpi_compact_gparts;
+
   /* Total ticks spent running the tasks */
   ticks total_ticks;
 
@@ -289,7 +293,10 @@ void scheduler_write_cell_dependencies(struct scheduler *s, int verbose,
                                        int step);
 void scheduler_write_task_level(const struct scheduler *s, int step);
 void scheduler_dump_queues(struct engine *e);
+void scheduler_report_task_time_histogram(const struct scheduler *s);
 void scheduler_report_task_times(const struct scheduler *s,
                                  const int nr_threads);
+ticks scheduler_critical_path(const struct scheduler *s,
+                              const ticks tic_start);
 
 #endif /* SWIFT_SCHEDULER_H */
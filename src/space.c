@@ -437,6 +437,9 @@ void space_map_cells_pre(struct space *s, int full,
  * If there are cells in the buffer, use the one at the end of the linked list.
  * If we have no cells, allocate a new chunk of memory and pick one from there.
  *
+ * Each thread only ever takes cells from (and returns cells to) its own
+ * buffer, so no lock is needed.
+ *
  * @param s The #space.
  * @param nr_cells Number of #cell to pick up.
  * @param cells Array of @c nr_cells #cell pointers in which to store the
@@ -489,7 +492,6 @@ void space_getcells(struct space *s, int nr_cells, struct cell **cells,
     }
   }
 
-  /* Unlock the space. */
   atomic_add(&s->tot_cells, nr_cells);
 
   /* Init some things in the cell we just got. */
@@ -502,16 +504,7 @@ void space_getcells(struct space *s, int nr_cells, struct cell **cells,
     cells[j]->grav.multipole = temp;
     cells[j]->nodeID = -1;
     cells[j]->tpid = tpid;
-    if (lock_init(&cells[j]->hydro.lock) != 0 ||
-        lock_init(&cells[j]->grav.plock) != 0 ||
-        lock_init(&cells[j]->grav.mlock) != 0 ||
-        lock_init(&cells[j]->stars.lock) != 0 ||
-        lock_init(&cells[j]->sinks.lock) != 0 ||
-        lock_init(&cells[j]->sinks.sink_formation_lock) != 0 ||
-        lock_init(&cells[j]->black_holes.lock) != 0 ||
-        lock_init(&cells[j]->stars.star_formation_lock) != 0 ||
-        lock_init(&cells[j]->grav.star_formation_lock) != 0)
-      error("Failed to initialize cell spinlocks.");
+    cell_init_locks(cells[j]);
   }
 }
 
@@ -1203,6 +1196,43 @@ void space_init(struct space *s, struct swift_params *params,
   space_extra_sinks = parser_get_opt_param_int(
       params, "Scheduler:cell_extra_sinks", space_extra_sinks_default);
 
+  s->incremental_rebuild =
+      parser_get_opt_param_int(params, "Scheduler:incremental_rebuild", 0);
+  if (s->incremental_rebuild && (star_formation || with_sink))
+    error(
+        "Incremental rebuilds are not compatible with star formation or sinks "
+        "as the extra particles are re-ordered at every rebuild. Set "
+        "'Scheduler:incremental_rebuild' to 0.");
+
+  s->linearise_cell_tree =
+      parser_get_opt_param_int(params, "Scheduler:linearise_cell_tree", 0);
+
+  s->auto_tune_split =
+      parser_get_opt_param_int(params, "Scheduler:auto_tune_split", 0);
+  s->auto_tune_tasks_per_thread = parser_get_opt_param_int(
+      params, "Scheduler:auto_tune_tasks_per_thread",
+      space_auto_tune_tasks_per_thread_default);
+  if (s->auto_tune_tasks_per_thread <= 0)
+    error("Scheduler:auto_tune_tasks_per_thread must be positive.");
+
+  s->active_particle_index =
+      parser_get_opt_param_int(params, "Scheduler:active_particle_index", 0);
+
+  s->adaptive_extras =
+      parser_get_opt_param_int(params, "Scheduler:adaptive_extras", 0);
+  s->extras_growth_factor = parser_get_opt_param_float(
+      params, "Scheduler:extras_growth_factor",
+      space_extras_growth_factor_default);
+  if (s->extras_growth_factor < 1.f)
+    error("Scheduler:extras_growth_factor must be at least 1.");
+#ifdef WITH_MPI
+  if (s->adaptive_extras && nr_nodes > 1)
+    error(
+        "Adaptive extra particles are not compatible with MPI runs as the "
+        "foreign star buffers assume 'Scheduler:cell_extra_sparts' slots per "
+        "cell. Set 'Scheduler:adaptive_extras' to 0.");
+#endif
+
   engine_max_parts_per_ghost =
       parser_get_opt_param_int(params, "Scheduler:engine_max_parts_per_ghost",
                                engine_max_parts_per_ghost_default);
@@ -2352,6 +2382,18 @@ void space_clean(struct space *s) {
   swift_free("cells_with_particles_top", s->cells_with_particles_top);
   swift_free("local_cells_with_particles_top",
              s->local_cells_with_particles_top);
+  if (s->cells_top_split_size != NULL)
+    swift_free("cells_top_split_size", s->cells_top_split_size);
+  if (s->cells_top_extras_usage != NULL)
+    swift_free("cells_top_extras_usage", s->cells_top_extras_usage);
+  if (s->cells_top_extras_count != NULL)
+    swift_free("cells_top_extras_count", s->cells_top_extras_count);
+  if (s->part_bin_index != NULL)
+    swift_free("part_bin_index", s->part_bin_index);
+  if (s->gpart_bin_index != NULL)
+    swift_free("gpart_bin_index", s->gpart_bin_index);
+  id_index_clean(&s->bparts_id_index);
+  id_index_clean(&s->sinks_id_index);
   swift_free("parts", s->parts);
   swift_free("xparts", s->xparts);
   swift_free("gparts", s->gparts);
@@ -2521,6 +2563,18 @@ void space_struct_restore(struct space *s, FILE *stream) {
   s->local_cells_with_tasks_top = NULL;
   s->cells_with_particles_top = NULL;
   s->local_cells_with_particles_top = NULL;
+  s->cells_top_split_size = NULL;
+  s->cells_top_extras_usage = NULL;
+  s->cells_top_extras_count = NULL;
+  s->cells_top_extras_count_valid = 0;
+  s->part_bin_index = NULL;
+  s->gpart_bin_index = NULL;
+  s->bin_index_epoch = 0;
+  s->bparts_id_index.entries = NULL;
+  s->bparts_id_index.size = 0;
+  s->sinks_id_index.entries = NULL;
+  s->sinks_id_index.size = 0;
+  bzero(&s->extras_usage_reported, sizeof(struct space_extras_usage));
   s->nr_local_cells_with_tasks = 0;
   s->nr_cells_with_particles = 0;
 #ifdef WITH_MPI
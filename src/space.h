@@ -34,15 +34,18 @@
 #include "lock.h"
 #include "parser.h"
 #include "part.h"
+#include "space_id_index.h"
 #include "space_unique_id.h"
 #include "velociraptor_struct.h"
 
 /* Avoid cyclic inclusions */
 struct cell;
+struct cell_bin_index_entry;
 struct cosmology;
 struct gravity_props;
 struct star_formation;
 struct hydro_props;
+struct scheduler;
 
 /* Some constants. */
 #define space_cellallocchunk 1000
@@ -62,6 +65,10 @@ struct hydro_props;
 #define space_subsize_self_grav_default 32000
 #define space_subdepth_diff_grav_default 4
 #define space_max_top_level_cells_default 12
+#define space_auto_tune_tasks_per_thread_default 100
+#define space_auto_tune_min_split_size 16
+#define space_auto_tune_max_split_factor 8
+#define space_extras_growth_factor_default 2.f
 #define space_stretch 1.10f
 #define space_maxreldx 0.1f
 
@@ -87,6 +94,29 @@ extern int space_extra_sinks;
 extern double engine_redistribute_alloc_margin;
 extern double engine_foreign_alloc_margin;
 
+/**
+ * @brief Use of the extra particle slots of a top-level cell since the last
+ * rebuild.
+ */
+struct space_extras_usage {
+
+  /*! Number of extra #gpart, #spart and #sink slots handed out */
+  int gparts_used, sparts_used, sinks_used;
+
+  /*! Number of requests that found no free slot left */
+  int gparts_failed, sparts_failed, sinks_failed;
+};
+
+/**
+ * @brief Number of extra particle slots of each type placed in a top-level
+ * cell by space_allocate_extras().
+ */
+struct space_extras_count {
+
+  /*! Number of extra #part, #gpart, #spart, #bpart and #sink slots */
+  int parts, gparts, sparts, bparts, sinks;
+};
+
 /**
  * @brief The space in which the cells and particles reside.
  */
@@ -137,6 +167,60 @@ struct space {
   /*! Maximal depth reached by the tree */
   int maxdepth;
 
+  /*! Are we keeping the cell tree across rebuilds? */
+  int incremental_rebuild;
+
+  /*! Number of cells whose progeny were re-used during the last split */
+  int nr_cells_reused;
+
+  /*! Are we re-ordering the cells in memory to follow the tree walks? */
+  int linearise_cell_tree;
+
+  /*! Are we tuning the split size of each top-level cell from task times? */
+  int auto_tune_split;
+
+  /*! Number of interaction tasks per thread the tuning aims for */
+  int auto_tune_tasks_per_thread;
+
+  /*! Split size of each top-level cell (NULL if not tuning) */
+  int *cells_top_split_size;
+
+  /*! Are we sizing the extra slots of each top-level cell from their use? */
+  int adaptive_extras;
+
+  /*! Number of extra slots given at rebuild per slot used since the last */
+  float extras_growth_factor;
+
+  /*! Use of the extra slots of each top-level cell (NULL without creation) */
+  struct space_extras_usage *cells_top_extras_usage;
+
+  /*! Total use of the extra slots at the time of the last report */
+  struct space_extras_usage extras_usage_reported;
+
+  /*! Number of extra slots in each top-level cell (NULL without creation) */
+  struct space_extras_count *cells_top_extras_count;
+
+  /*! Do the counts above describe where the extra particles currently are? */
+  int cells_top_extras_count_valid;
+
+  /*! Are we keeping an index of the particles of each leaf by time-bin? */
+  int active_particle_index;
+
+  /*! Counter identifying the valid time-bin indices (0 if not indexing) */
+  int bin_index_epoch;
+
+  /*! Time-bin index entries of all the #part (NULL if not indexing) */
+  struct cell_bin_index_entry *part_bin_index;
+
+  /*! Time-bin index entries of all the #gpart (NULL if not indexing) */
+  struct cell_bin_index_entry *gpart_bin_index;
+
+  /*! Index from the ID of the local #bpart to their offset in the array */
+  struct id_index bparts_id_index;
+
+  /*! Index from the ID of the #sink to their offset in the array */
+  struct id_index sinks_id_index;
+
   /*! Number of top-level cells. */
   int nr_cells;
 
@@ -361,6 +445,9 @@ void space_bparts_sort(struct bpart *bparts, int *ind, int *counts,
                        int num_bins, ptrdiff_t bparts_offset);
 void space_sinks_sort(struct sink *sinks, int *ind, int *counts, int num_bins,
                       ptrdiff_t sinks_offset);
+int *space_sort_stable_indices(int *ind, const int *counts, int num_bins,
+                               size_t N);
+void space_sort_restore_indices(int *ind, const int *counts, int num_bins);
 void space_getcells(struct space *s, int nr_cells, struct cell **cells,
                     const short int tid);
 void space_init(struct space *s, struct swift_params *params,
@@ -385,14 +472,21 @@ void space_map_parts_xparts(struct space *s,
 void space_map_cells_post(struct space *s, int full,
                           void (*fun)(struct cell *c, void *data), void *data);
 void space_rebuild(struct space *s, int repartitioned, int verbose);
-void space_recycle(struct space *s, struct cell *c);
+void space_recycle(struct space *s, struct cell *c, const short int tpid);
 void space_recycle_list(struct space *s, struct cell *cell_list_begin,
                         struct cell *cell_list_end,
                         struct gravity_tensors *multipole_list_begin,
-                        struct gravity_tensors *multipole_list_end);
+                        struct gravity_tensors *multipole_list_end,
+                        const short int tpid);
+void space_recycle_progeny(struct space *s, struct cell *c,
+                           const short int tpid);
+void space_reuse_cell(struct space *s, struct cell *c, const short int tpid);
 void space_regrid(struct space *s, int verbose);
 void space_allocate_extras(struct space *s, int verbose);
+void space_report_extras_usage(struct space *s);
 void space_split(struct space *s, int verbose);
+void space_tune_split_sizes(struct space *s, const struct scheduler *sched,
+                             int nr_threads, int verbose);
 void space_reorder_extras(struct space *s, int verbose);
 void space_list_useful_top_level_cells(struct space *s);
 void space_parts_get_cell_index(struct space *s, int *ind, int *cell_counts,
@@ -448,6 +542,7 @@ void space_check_cosmology(struct space *s, const struct cosmology *cosmo,
 void space_reset_task_counters(struct space *s);
 void space_clean(struct space *s);
 void space_free_cells(struct space *s);
+void space_free_cells_keep_tree(struct space *s);
 
 void space_free_foreign_parts(struct space *s, const int clear_cell_pointers);
 
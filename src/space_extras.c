@@ -30,8 +30,151 @@
 #include "engine.h"
 
 /* Some standard headers. */
+#include <math.h>
 #include <string.h>
 
+/**
+ * @brief Number of extra slots of a given type a top-level cell used and
+ * failed to get since the last rebuild.
+ *
+ * @param u The #space_extras_usage of the cell.
+ * @param type The particle type.
+ * @param used (return) The number of slots handed out.
+ * @param failed (return) The number of requests that found no slot.
+ */
+static void space_extras_usage_get(const struct space_extras_usage *u,
+                                   const enum part_type type, int *used,
+                                   int *failed) {
+  switch (type) {
+    case swift_type_dark_matter:
+      *used = u->gparts_used;
+      *failed = u->gparts_failed;
+      break;
+    case swift_type_stars:
+      *used = u->sparts_used;
+      *failed = u->sparts_failed;
+      break;
+    case swift_type_sink:
+      *used = u->sinks_used;
+      *failed = u->sinks_failed;
+      break;
+    default:
+      *used = 0;
+      *failed = 0;
+  }
+}
+
+/**
+ * @brief Number of extra slots of a given type placed in a top-level cell.
+ *
+ * @param c The #space_extras_count of the cell.
+ * @param type The particle type.
+ */
+static int *space_extras_count_get(struct space_extras_count *c,
+                                   const enum part_type type) {
+  switch (type) {
+    case swift_type_gas:
+      return &c->parts;
+    case swift_type_dark_matter:
+      return &c->gparts;
+    case swift_type_stars:
+      return &c->sparts;
+    case swift_type_black_hole:
+      return &c->bparts;
+    case swift_type_sink:
+      return &c->sinks;
+    default:
+      error("Invalid particle type (%d).", type);
+      return NULL;
+  }
+}
+
+/**
+ * @brief Record how many extra slots of a given type were placed in each
+ * top-level cell, for space_rebuild() to find them again.
+ *
+ * @param s The #space.
+ * @param local_cells The indices of the local top-level cells.
+ * @param nr_local_cells The number of local top-level cells.
+ * @param type The particle type.
+ * @param extra_in_cell The number of slots placed in each local cell.
+ */
+static void space_extras_count_set(struct space *s, const int *local_cells,
+                                   const size_t nr_local_cells,
+                                   const enum part_type type,
+                                   const int *extra_in_cell) {
+
+  if (s->cells_top_extras_count == NULL) return;
+
+  for (int k = 0; k < s->nr_cells; ++k)
+    *space_extras_count_get(&s->cells_top_extras_count[k], type) = 0;
+  for (size_t k = 0; k < nr_local_cells; ++k)
+    *space_extras_count_get(&s->cells_top_extras_count[local_cells[k]],
+                            type) = extra_in_cell[k];
+}
+
+/**
+ * @brief Decide how many extra slots of a given type each local top-level
+ * cell gets at this rebuild.
+ *
+ * Without adaptive extras every cell gets the fixed number. Otherwise, a cell
+ * gets #space extras_growth_factor times the slots it used or asked for since
+ * the last rebuild, and never less than the fixed number. Slots left over from
+ * a previous burst are spread over all the cells so that the total never
+ * shrinks. Types without any fixed slots get none.
+ *
+ * @param s The #space.
+ * @param local_cells The indices of the local top-level cells.
+ * @param nr_local_cells The number of local top-level cells.
+ * @param type The particle type.
+ * @param num_extra The fixed number of extra slots per cell for this type.
+ * @param nr_extra The number of unused extra slots currently in the space.
+ * @param extra_in_cell (return) The number of slots for each local cell.
+ * @param redistribute (return) Were any slots used since the last rebuild?
+ *
+ * @return The total number of extra slots for this type.
+ */
+static size_t space_extras_per_cell(const struct space *s,
+                                    const int *local_cells,
+                                    const size_t nr_local_cells,
+                                    const enum part_type type,
+                                    const int num_extra, const size_t nr_extra,
+                                    int *extra_in_cell, int *redistribute) {
+
+  size_t total = 0;
+  *redistribute = 0;
+
+  /* Nothing to size if this type never gets any slots */
+  if (num_extra == 0) {
+    bzero(extra_in_cell, nr_local_cells * sizeof(int));
+    return 0;
+  }
+
+  for (size_t k = 0; k < nr_local_cells; ++k) {
+
+    int used = 0, failed = 0;
+    if (s->adaptive_extras && s->cells_top_extras_usage != NULL)
+      space_extras_usage_get(&s->cells_top_extras_usage[local_cells[k]], type,
+                             &used, &failed);
+
+    const int demand = (int)ceilf(s->extras_growth_factor * (used + failed));
+    extra_in_cell[k] = max(num_extra, demand);
+    total += extra_in_cell[k];
+    if (used + failed > 0) *redistribute = 1;
+  }
+
+  /* Spread the slots we are not going to need any more */
+  if (s->adaptive_extras && total < nr_extra && nr_local_cells > 0) {
+    const size_t surplus = nr_extra - total;
+    for (size_t k = 0; k < nr_local_cells; ++k)
+      extra_in_cell[k] += surplus / nr_local_cells +
+                          (k < surplus % nr_local_cells ? 1 : 0);
+    total = nr_extra;
+  }
+
+  return total;
+}
+
 /**
  * @brief Allocate memory for the extra particles used for on-the-fly creation.
  *
@@ -94,12 +237,44 @@ void space_allocate_extras(struct space *s, int verbose) {
     }
   }
 
+  /* Number of extra particles we want in each cell for each type */
+  int *extra_parts_in_cell = (int *)malloc(sizeof(int) * 5 * nr_local_cells);
+  if (extra_parts_in_cell == NULL)
+    error("Failed to allocate the number of extra particles per cell");
+  int *extra_gparts_in_cell = extra_parts_in_cell + nr_local_cells;
+  int *extra_sparts_in_cell = extra_gparts_in_cell + nr_local_cells;
+  int *extra_bparts_in_cell = extra_sparts_in_cell + nr_local_cells;
+  int *extra_sinks_in_cell = extra_bparts_in_cell + nr_local_cells;
+
   /* Number of extra particles we want for each type */
-  const size_t expected_num_extra_parts = nr_local_cells * space_extra_parts;
-  const size_t expected_num_extra_gparts = nr_local_cells * space_extra_gparts;
-  const size_t expected_num_extra_sparts = nr_local_cells * space_extra_sparts;
-  const size_t expected_num_extra_bparts = nr_local_cells * space_extra_bparts;
-  const size_t expected_num_extra_sinks = nr_local_cells * space_extra_sinks;
+  int redistribute_parts, redistribute_gparts, redistribute_sparts,
+      redistribute_bparts, redistribute_sinks;
+  const size_t expected_num_extra_parts = space_extras_per_cell(
+      s, local_cells, nr_local_cells, swift_type_gas, space_extra_parts,
+      s->nr_extra_parts, extra_parts_in_cell, &redistribute_parts);
+  const size_t expected_num_extra_gparts = space_extras_per_cell(
+      s, local_cells, nr_local_cells, swift_type_dark_matter,
+      space_extra_gparts, s->nr_extra_gparts, extra_gparts_in_cell,
+      &redistribute_gparts);
+  const size_t expected_num_extra_sparts = space_extras_per_cell(
+      s, local_cells, nr_local_cells, swift_type_stars, space_extra_sparts,
+      s->nr_extra_sparts, extra_sparts_in_cell, &redistribute_sparts);
+  const size_t expected_num_extra_bparts = space_extras_per_cell(
+      s, local_cells, nr_local_cells, swift_type_black_hole, space_extra_bparts,
+      s->nr_extra_bparts, extra_bparts_in_cell, &redistribute_bparts);
+  const size_t expected_num_extra_sinks = space_extras_per_cell(
+      s, local_cells, nr_local_cells, swift_type_sink, space_extra_sinks,
+      s->nr_extra_sinks, extra_sinks_in_cell, &redistribute_sinks);
+
+  /* If we do not know where the current extra particles are (e.g. after a
+   * change of the top-level grid), place them all again. */
+  if (!s->cells_top_extras_count_valid) {
+    redistribute_parts = 1;
+    redistribute_gparts = 1;
+    redistribute_sparts = 1;
+    redistribute_bparts = 1;
+    redistribute_sinks = 1;
+  }
 
   if (verbose) {
     message("Currently have %zd/%zd/%zd/%zd/%zd real particles.",
@@ -139,7 +314,8 @@ void space_allocate_extras(struct space *s, int verbose) {
 
   /* Do we have enough space for the extra gparts (i.e. we haven't used up any)
    * ? */
-  if (nr_actual_gparts + expected_num_extra_gparts > nr_gparts) {
+  if (nr_actual_gparts + expected_num_extra_gparts > nr_gparts ||
+      redistribute_gparts) {
 
     /* Ok... need to put some more in the game */
 
@@ -182,17 +358,23 @@ void space_allocate_extras(struct space *s, int verbose) {
 
     /* Put the spare particles in their correct cell */
     size_t local_cell_id = 0;
-    int current_cell = local_cells[local_cell_id];
     int count_in_cell = 0;
     size_t count_extra_gparts = 0;
     for (size_t i = 0; i < nr_actual_gparts + expected_num_extra_gparts; ++i) {
 
+      if (s->gparts[i].time_bin == time_bin_not_created) {
+
+        /* Move to the next cell that still wants some extra particles */
+        while (count_in_cell == extra_gparts_in_cell[local_cell_id]) {
+          ++local_cell_id;
+          count_in_cell = 0;
+
 #ifdef SWIFT_DEBUG_CHECKS
-      if (current_cell == s->nr_cells)
-        error("Cell counter beyond the maximal nr. cells.");
+          if (local_cell_id == nr_local_cells)
+            error("Cell counter beyond the number of local cells.");
 #endif
-
-      if (s->gparts[i].time_bin == time_bin_not_created) {
+        }
+        const int current_cell = local_cells[local_cell_id];
 
         /* We want the extra particles to be at the centre of their cell */
         s->gparts[i].x[0] = cells[current_cell].loc[0] + half_cell_width[0];
@@ -201,17 +383,6 @@ void space_allocate_extras(struct space *s, int verbose) {
         ++count_in_cell;
         count_extra_gparts++;
       }
-
-      /* Once we have reached the number of extra gpart per cell, we move to the
-       * next */
-      if (count_in_cell == space_extra_gparts) {
-        ++local_cell_id;
-
-        if (local_cell_id == nr_local_cells) break;
-
-        current_cell = local_cells[local_cell_id];
-        count_in_cell = 0;
-      }
     }
 
 #ifdef SWIFT_DEBUG_CHECKS
@@ -223,11 +394,14 @@ void space_allocate_extras(struct space *s, int verbose) {
     /* Update the counters */
     s->nr_gparts = nr_actual_gparts + expected_num_extra_gparts;
     s->nr_extra_gparts = expected_num_extra_gparts;
+    space_extras_count_set(s, local_cells, nr_local_cells,
+                           swift_type_dark_matter, extra_gparts_in_cell);
   }
 
   /* Do we have enough space for the extra parts (i.e. we haven't used up any) ?
    */
-  if (nr_actual_parts + expected_num_extra_parts > nr_parts) {
+  if (nr_actual_parts + expected_num_extra_parts > nr_parts ||
+      redistribute_parts) {
 
     /* Ok... need to put some more in the game */
 
@@ -274,17 +448,23 @@ void space_allocate_extras(struct space *s, int verbose) {
 
     /* Put the spare particles in their correct cell */
     size_t local_cell_id = 0;
-    int current_cell = local_cells[local_cell_id];
     int count_in_cell = 0;
     size_t count_extra_parts = 0;
     for (size_t i = 0; i < nr_actual_parts + expected_num_extra_parts; ++i) {
 
+      if (s->parts[i].time_bin == time_bin_not_created) {
+
+        /* Move to the next cell that still wants some extra particles */
+        while (count_in_cell == extra_parts_in_cell[local_cell_id]) {
+          ++local_cell_id;
+          count_in_cell = 0;
+
 #ifdef SWIFT_DEBUG_CHECKS
-      if (current_cell == s->nr_cells)
-        error("Cell counter beyond the maximal nr. cells.");
+          if (local_cell_id == nr_local_cells)
+            error("Cell counter beyond the number of local cells.");
 #endif
-
-      if (s->parts[i].time_bin == time_bin_not_created) {
+        }
+        const int current_cell = local_cells[local_cell_id];
 
         /* We want the extra particles to be at the centre of their cell */
         s->parts[i].x[0] = cells[current_cell].loc[0] + half_cell_width[0];
@@ -293,17 +473,6 @@ void space_allocate_extras(struct space *s, int verbose) {
         ++count_in_cell;
         count_extra_parts++;
       }
-
-      /* Once we have reached the number of extra part per cell, we move to the
-       * next */
-      if (count_in_cell == space_extra_parts) {
-        ++local_cell_id;
-
-        if (local_cell_id == nr_local_cells) break;
-
-        current_cell = local_cells[local_cell_id];
-        count_in_cell = 0;
-      }
     }
 
 #ifdef SWIFT_DEBUG_CHECKS
@@ -315,11 +484,14 @@ void space_allocate_extras(struct space *s, int verbose) {
     /* Update the counters */
     s->nr_parts = nr_actual_parts + expected_num_extra_parts;
     s->nr_extra_parts = expected_num_extra_parts;
+    space_extras_count_set(s, local_cells, nr_local_cells, swift_type_gas,
+                           extra_parts_in_cell);
   }
 
   /* Do we have enough space for the extra sinks (i.e. we haven't used up any)
    * ? */
-  if (nr_actual_sinks + expected_num_extra_sinks > nr_sinks) {
+  if (nr_actual_sinks + expected_num_extra_sinks > nr_sinks ||
+      redistribute_sinks) {
     /* Ok... need to put some more in the game */
 
     /* Do we need to reallocate? */
@@ -355,17 +527,23 @@ void space_allocate_extras(struct space *s, int verbose) {
 
     /* Put the spare particles in their correct cell */
     size_t local_cell_id = 0;
-    int current_cell = local_cells[local_cell_id];
     int count_in_cell = 0;
     size_t count_extra_sinks = 0;
     for (size_t i = 0; i < nr_actual_sinks + expected_num_extra_sinks; ++i) {
 
+      if (s->sinks[i].time_bin == time_bin_not_created) {
+
+        /* Move to the next cell that still wants some extra particles */
+        while (count_in_cell == extra_sinks_in_cell[local_cell_id]) {
+          ++local_cell_id;
+          count_in_cell = 0;
+
 #ifdef SWIFT_DEBUG_CHECKS
-      if (current_cell == s->nr_cells)
-        error("Cell counter beyond the maximal nr. cells.");
+          if (local_cell_id == nr_local_cells)
+            error("Cell counter beyond the number of local cells.");
 #endif
-
-      if (s->sinks[i].time_bin == time_bin_not_created) {
+        }
+        const int current_cell = local_cells[local_cell_id];
 
         /* We want the extra particles to be at the centre of their cell */
         s->sinks[i].x[0] = cells[current_cell].loc[0] + half_cell_width[0];
@@ -374,17 +552,6 @@ void space_allocate_extras(struct space *s, int verbose) {
         ++count_in_cell;
         count_extra_sinks++;
       }
-
-      /* Once we have reached the number of extra sink per cell, we move to the
-       * next */
-      if (count_in_cell == space_extra_sinks) {
-        ++local_cell_id;
-
-        if (local_cell_id == nr_local_cells) break;
-
-        current_cell = local_cells[local_cell_id];
-        count_in_cell = 0;
-      }
     }
 
 #ifdef SWIFT_DEBUG_CHECKS
@@ -396,11 +563,14 @@ void space_allocate_extras(struct space *s, int verbose) {
     /* Update the counters */
     s->nr_sinks = nr_actual_sinks + expected_num_extra_sinks;
     s->nr_extra_sinks = expected_num_extra_sinks;
+    space_extras_count_set(s, local_cells, nr_local_cells, swift_type_sink,
+                           extra_sinks_in_cell);
   }
 
   /* Do we have enough space for the extra sparts (i.e. we haven't used up any)
    * ? */
-  if (nr_actual_sparts + expected_num_extra_sparts > nr_sparts) {
+  if (nr_actual_sparts + expected_num_extra_sparts > nr_sparts ||
+      redistribute_sparts) {
 
     /* Ok... need to put some more in the game */
 
@@ -437,17 +607,23 @@ void space_allocate_extras(struct space *s, int verbose) {
 
     /* Put the spare particles in their correct cell */
     size_t local_cell_id = 0;
-    int current_cell = local_cells[local_cell_id];
     int count_in_cell = 0;
     size_t count_extra_sparts = 0;
     for (size_t i = 0; i < nr_actual_sparts + expected_num_extra_sparts; ++i) {
 
+      if (s->sparts[i].time_bin == time_bin_not_created) {
+
+        /* Move to the next cell that still wants some extra particles */
+        while (count_in_cell == extra_sparts_in_cell[local_cell_id]) {
+          ++local_cell_id;
+          count_in_cell = 0;
+
 #ifdef SWIFT_DEBUG_CHECKS
-      if (current_cell == s->nr_cells)
-        error("Cell counter beyond the maximal nr. cells.");
+          if (local_cell_id == nr_local_cells)
+            error("Cell counter beyond the number of local cells.");
 #endif
-
-      if (s->sparts[i].time_bin == time_bin_not_created) {
+        }
+        const int current_cell = local_cells[local_cell_id];
 
         /* We want the extra particles to be at the centre of their cell */
         s->sparts[i].x[0] = cells[current_cell].loc[0] + half_cell_width[0];
@@ -456,17 +632,6 @@ void space_allocate_extras(struct space *s, int verbose) {
         ++count_in_cell;
         count_extra_sparts++;
       }
-
-      /* Once we have reached the number of extra spart per cell, we move to the
-       * next */
-      if (count_in_cell == space_extra_sparts) {
-        ++local_cell_id;
-
-        if (local_cell_id == nr_local_cells) break;
-
-        current_cell = local_cells[local_cell_id];
-        count_in_cell = 0;
-      }
     }
 
 #ifdef SWIFT_DEBUG_CHECKS
@@ -478,11 +643,14 @@ void space_allocate_extras(struct space *s, int verbose) {
     /* Update the counters */
     s->nr_sparts = nr_actual_sparts + expected_num_extra_sparts;
     s->nr_extra_sparts = expected_num_extra_sparts;
+    space_extras_count_set(s, local_cells, nr_local_cells, swift_type_stars,
+                           extra_sparts_in_cell);
   }
 
   /* Do we have enough space for the extra bparts (i.e. we haven't used up any)
    * ? */
-  if (nr_actual_bparts + expected_num_extra_bparts > nr_bparts) {
+  if (nr_actual_bparts + expected_num_extra_bparts > nr_bparts ||
+      redistribute_bparts) {
 
     /* Ok... need to put some more in the game */
 
@@ -519,17 +687,23 @@ void space_allocate_extras(struct space *s, int verbose) {
 
     /* Put the spare particles in their correct cell */
     size_t local_cell_id = 0;
-    int current_cell = local_cells[local_cell_id];
     int count_in_cell = 0;
     size_t count_extra_bparts = 0;
     for (size_t i = 0; i < nr_actual_bparts + expected_num_extra_bparts; ++i) {
 
+      if (s->bparts[i].time_bin == time_bin_not_created) {
+
+        /* Move to the next cell that still wants some extra particles */
+        while (count_in_cell == extra_bparts_in_cell[local_cell_id]) {
+          ++local_cell_id;
+          count_in_cell = 0;
+
 #ifdef SWIFT_DEBUG_CHECKS
-      if (current_cell == s->nr_cells)
-        error("Cell counter beyond the maximal nr. cells.");
+          if (local_cell_id == nr_local_cells)
+            error("Cell counter beyond the number of local cells.");
 #endif
-
-      if (s->bparts[i].time_bin == time_bin_not_created) {
+        }
+        const int current_cell = local_cells[local_cell_id];
 
         /* We want the extra particles to be at the centre of their cell */
         s->bparts[i].x[0] = cells[current_cell].loc[0] + half_cell_width[0];
@@ -538,17 +712,6 @@ void space_allocate_extras(struct space *s, int verbose) {
         ++count_in_cell;
         count_extra_bparts++;
       }
-
-      /* Once we have reached the number of extra bpart per cell, we move to the
-       * next */
-      if (count_in_cell == space_extra_bparts) {
-        ++local_cell_id;
-
-        if (local_cell_id == nr_local_cells) break;
-
-        current_cell = local_cells[local_cell_id];
-        count_in_cell = 0;
-      }
     }
 
 #ifdef SWIFT_DEBUG_CHECKS
@@ -560,6 +723,8 @@ void space_allocate_extras(struct space *s, int verbose) {
     /* Update the counters */
     s->nr_bparts = nr_actual_bparts + expected_num_extra_bparts;
     s->nr_extra_bparts = expected_num_extra_bparts;
+    space_extras_count_set(s, local_cells, nr_local_cells,
+                           swift_type_black_hole, extra_bparts_in_cell);
   }
 
 #ifdef SWIFT_DEBUG_CHECKS
@@ -571,6 +736,70 @@ void space_allocate_extras(struct space *s, int verbose) {
                       verbose);
 #endif
 
+  s->cells_top_extras_count_valid = 1;
+
+  /* Start counting the use of the slots afresh */
+  if (s->cells_top_extras_usage != NULL) {
+    bzero(s->cells_top_extras_usage,
+          s->nr_cells * sizeof(struct space_extras_usage));
+    bzero(&s->extras_usage_reported, sizeof(struct space_extras_usage));
+  }
+
   /* Free the list of local cells */
   free(local_cells);
+  free(extra_parts_in_cell);
+}
+
+/**
+ * @brief Report the use of the extra particle slots of the local top-level
+ * cells, both over the last step and since the last rebuild.
+ *
+ * @param s The #space.
+ */
+void space_report_extras_usage(struct space *s) {
+
+  if (s->cells_top_extras_usage == NULL) return;
+
+  /* Add up the use over the local cells and find the ones that are full */
+  struct space_extras_usage total;
+  bzero(&total, sizeof(struct space_extras_usage));
+  int full_gparts = 0, full_sparts = 0, full_sinks = 0;
+  for (int k = 0; k < s->nr_local_cells; ++k) {
+    const int cid = s->local_cells_top[k];
+    const struct cell *c = &s->cells_top[cid];
+    const struct space_extras_usage *u = &s->cells_top_extras_usage[cid];
+
+    total.gparts_used += u->gparts_used;
+    total.sparts_used += u->sparts_used;
+    total.sinks_used += u->sinks_used;
+    total.gparts_failed += u->gparts_failed;
+    total.sparts_failed += u->sparts_failed;
+    total.sinks_failed += u->sinks_failed;
+
+    if (c->grav.count_total > 0 && c->grav.count == c->grav.count_total)
+      full_gparts++;
+    if (c->stars.count_total > 0 && c->stars.count == c->stars.count_total)
+      full_sparts++;
+    if (c->sinks.count_total > 0 && c->sinks.count == c->sinks.count_total)
+      full_sinks++;
+  }
+
+  const struct space_extras_usage *r = &s->extras_usage_reported;
+  message(
+      "Extra gparts: %d used this step, %d since rebuild, %d refused, %zd "
+      "left, %d/%d cells full.",
+      total.gparts_used - r->gparts_used, total.gparts_used,
+      total.gparts_failed, s->nr_extra_gparts, full_gparts, s->nr_local_cells);
+  message(
+      "Extra sparts: %d used this step, %d since rebuild, %d refused, %zd "
+      "left, %d/%d cells full.",
+      total.sparts_used - r->sparts_used, total.sparts_used,
+      total.sparts_failed, s->nr_extra_sparts, full_sparts, s->nr_local_cells);
+  message(
+      "Extra sinks: %d used this step, %d since rebuild, %d refused, %zd "
+      "left, %d/%d cells full.",
+      total.sinks_used - r->sinks_used, total.sinks_used, total.sinks_failed,
+      s->nr_extra_sinks, full_sinks, s->nr_local_cells);
+
+  s->extras_usage_reported = total;
 }
@@ -0,0 +1,305 @@
+/*******************************************************************************
+ * This file is part of SWIFT.
+ * Copyright (c) 2026 agent (agent@local)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+/* Config parameters. */
+#include <config.h>
+
+/* This object's header. */
+#include "space_id_index.h"
+
+/* Local headers. */
+#include "atomic.h"
+#include "error.h"
+#include "memuse.h"
+#include "part.h"
+#include "space.h"
+#include "threadpool.h"
+#include "timeline.h"
+
+/**
+ * @brief Data passed to the mappers filling an #id_index.
+ */
+struct id_index_build_data {
+
+  /*! The index to fill */
+  struct id_index *index;
+
+  /*! Start of the particle array */
+  const void *base;
+};
+
+/**
+ * @brief Allocate an empty #id_index able to hold a given number of particles.
+ *
+ * The table is kept at most half full so that the probe sequences stay short.
+ *
+ * @param index The #id_index.
+ * @param capacity The largest number of particles that will be inserted.
+ */
+void id_index_init(struct id_index *index, size_t capacity) {
+
+  index->entries = NULL;
+  index->size = 0;
+  if (capacity == 0) return;
+
+  size_t size = 16;
+  while (size < 2 * capacity) size *= 2;
+
+  index->entries = (struct id_index_entry *)swift_malloc(
+      "id_index", size * sizeof(struct id_index_entry));
+  if (index->entries == NULL) error("Failed to allocate the ID index.");
+
+  for (size_t k = 0; k < size; k++) {
+    index->entries[k].id = id_index_empty_key;
+    index->entries[k].offset = -1;
+  }
+  index->size = size;
+}
+
+/**
+ * @brief Free the memory of an #id_index.
+ *
+ * @param index The #id_index.
+ */
+void id_index_clean(struct id_index *index) {
+
+  if (index->entries != NULL) swift_free("id_index", index->entries);
+  index->entries = NULL;
+  index->size = 0;
+}
+
+/**
+ * @brief Add a particle to an #id_index.
+ *
+ * Thread-safe. If the ID is already in the index, the particle with the
+ * smallest offset is kept, as a linear search through the array would do.
+ *
+ * @param index The #id_index.
+ * @param id The ID of the particle.
+ * @param offset The offset of the particle in its array.
+ */
+void id_index_insert(struct id_index *index, const long long id,
+                     const long long offset) {
+
+#ifdef SWIFT_DEBUG_CHECKS
+  if (id == id_index_empty_key) error("Cannot index particle ID %lld.", id);
+  if (offset < 0) error("Negative offset for particle ID %lld.", id);
+#endif
+
+  size_t k = id_index_hash(id, index->size);
+  for (size_t probe = 0; probe < index->size; probe++) {
+
+    struct id_index_entry *entry = &index->entries[k];
+    const long long old_id = atomic_cas(&entry->id, id_index_empty_key, id);
+
+    /* Claimed a free slot or found the same ID? Write the offset, keeping the
+     * smallest one if the ID is duplicated. */
+    if (old_id == id_index_empty_key || old_id == id) {
+      long long old_offset = entry->offset;
+      while (old_offset < 0 || offset < old_offset) {
+        const long long seen = atomic_cas(&entry->offset, old_offset, offset);
+        if (seen == old_offset) break;
+        old_offset = seen;
+      }
+      return;
+    }
+
+    k = (k + 1) & (index->size - 1);
+  }
+
+  error("ID index of size %zd is full.", index->size);
+}
+
+/**
+ * @brief Change the offset of a particle already in an #id_index.
+ *
+ * Used when particles are shifted in their array. Thread-safe, but lookups
+ * racing with the update may return the old offset.
+ *
+ * @param index The #id_index.
+ * @param id The ID of the particle.
+ * @param offset The new offset of the particle in its array.
+ */
+void id_index_update(struct id_index *index, const long long id,
+                     const long long offset) {
+
+  if (index->size == 0) return;
+
+  size_t k = id_index_hash(id, index->size);
+  for (size_t probe = 0; probe < index->size; probe++) {
+
+    struct id_index_entry *entry = &index->entries[k];
+    if (entry->id == id) {
+      atomic_swap(&entry->offset, offset);
+      return;
+    }
+    if (entry->id == id_index_empty_key) return;
+
+    k = (k + 1) & (index->size - 1);
+  }
+}
+
+/**
+ * @brief Mapper function adding #bpart to an #id_index.
+ */
+static void id_index_build_bparts_mapper(void *map_data, int num_elements,
+                                         void *extra_data) {
+
+  const struct bpart *bparts = (const struct bpart *)map_data;
+  const struct id_index_build_data *data =
+      (const struct id_index_build_data *)extra_data;
+  const struct bpart *base = (const struct bpart *)data->base;
+
+  for (int k = 0; k < num_elements; k++) {
+    if (bparts[k].time_bin == time_bin_not_created) continue;
+    id_index_insert(data->index, bparts[k].id, &bparts[k] - base);
+  }
+}
+
+/**
+ * @brief Mapper function adding #sink to an #id_index.
+ */
+static void id_index_build_sinks_mapper(void *map_data, int num_elements,
+                                        void *extra_data) {
+
+  const struct sink *sinks = (const struct sink *)map_data;
+  const struct id_index_build_data *data =
+      (const struct id_index_build_data *)extra_data;
+  const struct sink *base = (const struct sink *)data->base;
+
+  for (int k = 0; k < num_elements; k++) {
+    if (sinks[k].time_bin == time_bin_not_created) continue;
+    id_index_insert(data->index, sinks[k].id, &sinks[k] - base);
+  }
+}
+
+/**
+ * @brief (Re-)build the #id_index of an array of #bpart.
+ *
+ * The index holds all the slots of the array so that it does not need to grow
+ * when the extra particles get used.
+ *
+ * @param index The #id_index.
+ * @param bparts The #bpart array.
+ * @param nr_bparts The number of #bpart in the array (including the extras).
+ * @param tp The #threadpool.
+ */
+void id_index_build_bparts(struct id_index *index, const struct bpart *bparts,
+                           const size_t nr_bparts, struct threadpool *tp) {
+
+  id_index_clean(index);
+  id_index_init(index, nr_bparts);
+  if (nr_bparts == 0) return;
+
+  struct id_index_build_data data = {index, bparts};
+  threadpool_map(tp, id_index_build_bparts_mapper, (void *)bparts, nr_bparts,
+                 sizeof(struct bpart), threadpool_auto_chunk_size, &data);
+}
+
+/**
+ * @brief (Re-)build the #id_index of an array of #sink.
+ *
+ * The index holds all the slots of the array so that the sinks created
+ * during a step can be added to it.
+ *
+ * @param index The #id_index.
+ * @param sinks The #sink array.
+ * @param nr_sinks The number of #sink in the array (including the extras).
+ * @param tp The #threadpool.
+ */
+void id_index_build_sinks(struct id_index *index, const struct sink *sinks,
+                          const size_t nr_sinks, struct threadpool *tp) {
+
+  id_index_clean(index);
+  id_index_init(index, nr_sinks);
+  if (nr_sinks == 0) return;
+
+  struct id_index_build_data data = {index, sinks};
+  threadpool_map(tp, id_index_build_sinks_mapper, (void *)sinks, nr_sinks,
+                 sizeof(struct sink), threadpool_auto_chunk_size, &data);
+}
+
+/**
+ * @brief Find a local #bpart from its ID.
+ *
+ * Uses the ID index of the space. The particle found is checked against the
+ * ID and we fall back to a search through the whole array should it not match.
+ *
+ * @param s The #space.
+ * @param id The ID of the #bpart.
+ *
+ * @return The #bpart or NULL if there is no local #bpart with that ID.
+ */
+struct bpart *space_find_local_bpart(const struct space *s,
+                                     const long long id) {
+
+  const long long offset = id_index_find(&s->bparts_id_index, id);
+
+  if (offset >= 0 && (size_t)offset < s->nr_bparts &&
+      s->bparts[offset].id == id)
+    return &s->bparts[offset];
+
+#ifndef SWIFT_DEBUG_CHECKS
+  if (offset < 0) return NULL;
+#endif
+
+  for (size_t i = 0; i < s->nr_bparts; ++i) {
+    if (s->bparts[i].id == id) {
+#ifdef SWIFT_DEBUG_CHECKS
+      if (offset < 0) error("BH %lld is missing from the ID index.", id);
+#endif
+      return &s->bparts[i];
+    }
+  }
+  return NULL;
+}
+
+/**
+ * @brief Find a local #sink from its ID.
+ *
+ * Uses the ID index of the space. The particle found is checked against the
+ * ID and we fall back to a search through the whole array should it not match,
+ * which can happen if the sink is being shifted by the creation of another one.
+ *
+ * @param s The #space.
+ * @param id The ID of the #sink.
+ *
+ * @return The #sink or NULL if there is no local #sink with that ID.
+ */
+struct sink *space_find_local_sink(const struct space *s, const long long id) {
+
+  const long long offset = id_index_find(&s->sinks_id_index, id);
+
+  if (offset >= 0 && (size_t)offset < s->nr_sinks && s->sinks[offset].id == id)
+    return &s->sinks[offset];
+
+#ifndef SWIFT_DEBUG_CHECKS
+  if (offset < 0) return NULL;
+#endif
+
+  for (size_t i = 0; i < s->nr_sinks; ++i) {
+    if (s->sinks[i].id == id) {
+#ifdef SWIFT_DEBUG_CHECKS
+      if (offset < 0) error("Sink %lld is missing from the ID index.", id);
+#endif
+      return &s->sinks[i];
+    }
+  }
+  return NULL;
+}
@@ -0,0 +1,136 @@
+/*******************************************************************************
+ * This file is part of SWIFT.
+ * Copyright (c) 2026 agent (agent@local)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+#ifndef SWIFT_SPACE_ID_INDEX_H
+#define SWIFT_SPACE_ID_INDEX_H
+
+/* Config parameters. */
+#include <config.h>
+
+/* Standard headers. */
+#include <limits.h>
+#include <stddef.h>
+
+/* Local includes */
+#include "inline.h"
+
+/* Predefine the structures */
+struct bpart;
+struct sink;
+struct space;
+struct threadpool;
+
+/*! Key of the empty slots of an #id_index */
+#define id_index_empty_key LLONG_MIN
+
+/**
+ * @brief Slot of an #id_index.
+ */
+struct id_index_entry {
+
+  /*! ID of the particle (#id_index_empty_key if the slot is free) */
+  long long id;
+
+  /*! Offset of the particle in its array (-1 until it has been written) */
+  long long offset;
+};
+
+/**
+ * @brief Index from the ID of a particle to its offset in its array.
+ *
+ * Open-addressing hash table with linear probing. Slots are claimed with an
+ * atomic compare-and-swap on the ID so that many threads can insert at the
+ * same time, and lookups can run concurrently with insertions.
+ */
+struct id_index {
+
+  /*! The slots of the table */
+  struct id_index_entry *entries;
+
+  /*! Number of slots (a power of 2, 0 if the index is empty) */
+  size_t size;
+};
+
+/**
+ * @brief Hash a particle ID onto the slots of an #id_index.
+ *
+ * This is the finalizer of the splitmix64 generator, which mixes
+ * consecutive IDs over the whole table.
+ *
+ * @param id The particle ID.
+ * @param size The number of slots of the table (a power of 2).
+ */
+__attribute__((always_inline)) INLINE static size_t id_index_hash(
+    const long long id, const size_t size) {
+
+  unsigned long long z = (unsigned long long)id;
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  z = z ^ (z >> 31);
+  return (size_t)(z & (size - 1));
+}
+
+/**
+ * @brief Find the offset of a particle in its array from its ID.
+ *
+ * Safe to call while other threads are inserting into the index.
+ *
+ * @param index The #id_index.
+ * @param id The particle ID.
+ *
+ * @return The offset of the particle or -1 if it is not in the index.
+ */
+__attribute__((always_inline)) INLINE static long long id_index_find(
+    const struct id_index *index, const long long id) {
+
+  if (index->size == 0) return -1;
+
+  size_t k = id_index_hash(id, index->size);
+  for (size_t probe = 0; probe < index->size; probe++) {
+
+    volatile const struct id_index_entry *entry = &index->entries[k];
+    const long long slot_id = entry->id;
+
+    if (slot_id == id) {
+
+      /* The slot may have been claimed but its offset not written yet */
+      long long offset;
+      while ((offset = entry->offset) < 0)
+        ;
+      return offset;
+    }
+    if (slot_id == id_index_empty_key) return -1;
+
+    k = (k + 1) & (index->size - 1);
+  }
+  return -1;
+}
+
+void id_index_init(struct id_index *index, size_t capacity);
+void id_index_clean(struct id_index *index);
+void id_index_insert(struct id_index *index, long long id, long long offset);
+void id_index_update(struct id_index *index, long long id, long long offset);
+void id_index_build_bparts(struct id_index *index, const struct bpart *bparts,
+                           size_t nr_bparts, struct threadpool *tp);
+void id_index_build_sinks(struct id_index *index, const struct sink *sinks,
+                          size_t nr_sinks, struct threadpool *tp);
+struct bpart *space_find_local_bpart(const struct space *s, long long id);
+struct sink *space_find_local_sink(const struct space *s, long long id);
+
+#endif  // SWIFT_SPACE_ID_INDEX_H
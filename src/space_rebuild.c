@@ -39,6 +39,60 @@ extern unsigned long long last_cell_id;
 extern unsigned long long last_leaf_cell_id;
 #endif
 
+/**
+ * @brief Number of extra particle slots of each type that
+ * space_allocate_extras() placed in a top-level cell.
+ *
+ * @param s The #space.
+ * @param cid The index of the top-level cell.
+ */
+static const struct space_extras_count *space_rebuild_extras_in_cell(
+    const struct space *s, const int cid) {
+
+  static const struct space_extras_count no_extras = {0, 0, 0, 0, 0};
+  return s->cells_top_extras_count != NULL ? &s->cells_top_extras_count[cid]
+                                           : &no_extras;
+}
+
+/**
+ * @brief (Re-)allocate the time-bin indices of the particles of the leaves.
+ *
+ * The particles have been moved, so all the indices built since the last
+ * rebuild are invalidated. They are re-built by the time-step tasks.
+ *
+ * The #gpart are only indexed when no particles are created, as creating a
+ * #gpart shifts the #gpart of the neighbouring leaves in memory.
+ *
+ * @param s The #space.
+ */
+static void space_allocate_bin_index(struct space *s) {
+
+  if (s->part_bin_index != NULL)
+    swift_free("part_bin_index", s->part_bin_index);
+  if (s->gpart_bin_index != NULL)
+    swift_free("gpart_bin_index", s->gpart_bin_index);
+  s->part_bin_index = NULL;
+  s->gpart_bin_index = NULL;
+
+  if (s->size_parts > 0) {
+    s->part_bin_index = (struct cell_bin_index_entry *)swift_malloc(
+        "part_bin_index", s->size_parts * sizeof(struct cell_bin_index_entry));
+    if (s->part_bin_index == NULL)
+      error("Failed to allocate the time-bin index of the parts.");
+  }
+
+  if (s->size_gparts > 0 && !s->with_star_formation && !s->with_sink) {
+    s->gpart_bin_index = (struct cell_bin_index_entry *)swift_malloc(
+        "gpart_bin_index",
+        s->size_gparts * sizeof(struct cell_bin_index_entry));
+    if (s->gpart_bin_index == NULL)
+      error("Failed to allocate the time-bin index of the gparts.");
+  }
+
+  /* Invalidate the indices of all the cells */
+  s->bin_index_epoch++;
+}
+
 /**
  * @brief Re-build the top-level cells as well as the whole hierarchy.
  *
@@ -613,9 +667,19 @@ void space_rebuild(struct space *s, int repartitioned, int verbose) {
 #endif /* WITH_MPI */
 
   /* Sort the parts according to their cells. */
-  if (nr_parts > 0)
-    space_parts_sort(s->parts, s->xparts, h_index, cell_part_counts,
-                     s->nr_cells, 0);
+  if (nr_parts > 0) {
+    if (s->incremental_rebuild) {
+      int *unit_counts = space_sort_stable_indices(h_index, cell_part_counts,
+                                                   s->nr_cells, nr_parts);
+      space_parts_sort(s->parts, s->xparts, h_index, unit_counts,
+                       (int)nr_parts, 0);
+      swift_free("stable_counts", unit_counts);
+      space_sort_restore_indices(h_index, cell_part_counts, s->nr_cells);
+    } else {
+      space_parts_sort(s->parts, s->xparts, h_index, cell_part_counts,
+                       s->nr_cells, 0);
+    }
+  }
 
 #ifdef SWIFT_DEBUG_CHECKS
   /* Verify that the part have been sorted correctly. */
@@ -644,8 +708,17 @@ void space_rebuild(struct space *s, int repartitioned, int verbose) {
 #endif /* SWIFT_DEBUG_CHECKS */
 
   /* Sort the sparts according to their cells. */
-  if (nr_sparts > 0)
-    space_sparts_sort(s->sparts, s_index, cell_spart_counts, s->nr_cells, 0);
+  if (nr_sparts > 0) {
+    if (s->incremental_rebuild) {
+      int *unit_counts = space_sort_stable_indices(
+          s_index, cell_spart_counts, s->nr_cells, nr_sparts);
+      space_sparts_sort(s->sparts, s_index, unit_counts, (int)nr_sparts, 0);
+      swift_free("stable_counts", unit_counts);
+      space_sort_restore_indices(s_index, cell_spart_counts, s->nr_cells);
+    } else {
+      space_sparts_sort(s->sparts, s_index, cell_spart_counts, s->nr_cells, 0);
+    }
+  }
 
 #ifdef SWIFT_DEBUG_CHECKS
   /* Verify that the spart have been sorted correctly. */
@@ -674,8 +747,17 @@ void space_rebuild(struct space *s, int repartitioned, int verbose) {
 #endif /* SWIFT_DEBUG_CHECKS */
 
   /* Sort the bparts according to their cells. */
-  if (nr_bparts > 0)
-    space_bparts_sort(s->bparts, b_index, cell_bpart_counts, s->nr_cells, 0);
+  if (nr_bparts > 0) {
+    if (s->incremental_rebuild) {
+      int *unit_counts = space_sort_stable_indices(
+          b_index, cell_bpart_counts, s->nr_cells, nr_bparts);
+      space_bparts_sort(s->bparts, b_index, unit_counts, (int)nr_bparts, 0);
+      swift_free("stable_counts", unit_counts);
+      space_sort_restore_indices(b_index, cell_bpart_counts, s->nr_cells);
+    } else {
+      space_bparts_sort(s->bparts, b_index, cell_bpart_counts, s->nr_cells, 0);
+    }
+  }
 
 #ifdef SWIFT_DEBUG_CHECKS
   /* Verify that the bpart have been sorted correctly. */
@@ -704,8 +786,17 @@ void space_rebuild(struct space *s, int repartitioned, int verbose) {
 #endif /* SWIFT_DEBUG_CHECKS */
 
   /* Sort the sink according to their cells. */
-  if (nr_sinks > 0)
-    space_sinks_sort(s->sinks, sink_index, cell_sink_counts, s->nr_cells, 0);
+  if (nr_sinks > 0) {
+    if (s->incremental_rebuild) {
+      int *unit_counts = space_sort_stable_indices(
+          sink_index, cell_sink_counts, s->nr_cells, nr_sinks);
+      space_sinks_sort(s->sinks, sink_index, unit_counts, (int)nr_sinks, 0);
+      swift_free("stable_counts", unit_counts);
+      space_sort_restore_indices(sink_index, cell_sink_counts, s->nr_cells);
+    } else {
+      space_sinks_sort(s->sinks, sink_index, cell_sink_counts, s->nr_cells, 0);
+    }
+  }
 
 #ifdef SWIFT_DEBUG_CHECKS
   /* Verify that the sink have been sorted correctly. */
@@ -734,49 +825,53 @@ void space_rebuild(struct space *s, int repartitioned, int verbose) {
 #endif /* SWIFT_DEBUG_CHECKS */
 
   /* Extract the cell counts from the sorted indices. Deduct the extra
-   * particles. */
+   * particles placed in each cell. */
   size_t last_index = 0;
   h_index[nr_parts] = s->nr_cells;  // sentinel.
   for (size_t k = 0; k < nr_parts; k++) {
     if (h_index[k] < h_index[k + 1]) {
-      cells_top[h_index[k]].hydro.count =
-          k - last_index + 1 - space_extra_parts;
+      const int cid = h_index[k];
+      cells_top[cid].hydro.count =
+          k - last_index + 1 - space_rebuild_extras_in_cell(s, cid)->parts;
       last_index = k + 1;
     }
   }
 
   /* Extract the cell counts from the sorted indices. Deduct the extra
-   * particles. */
+   * particles placed in each cell. */
   size_t last_sindex = 0;
   s_index[nr_sparts] = s->nr_cells;  // sentinel.
   for (size_t k = 0; k < nr_sparts; k++) {
     if (s_index[k] < s_index[k + 1]) {
-      cells_top[s_index[k]].stars.count =
-          k - last_sindex + 1 - space_extra_sparts;
+      const int cid = s_index[k];
+      cells_top[cid].stars.count =
+          k - last_sindex + 1 - space_rebuild_extras_in_cell(s, cid)->sparts;
       last_sindex = k + 1;
     }
   }
 
   /* Extract the cell counts from the sorted indices. Deduct the extra
-   * particles. */
+   * particles placed in each cell. */
   size_t last_bindex = 0;
   b_index[nr_bparts] = s->nr_cells;  // sentinel.
   for (size_t k = 0; k < nr_bparts; k++) {
     if (b_index[k] < b_index[k + 1]) {
-      cells_top[b_index[k]].black_holes.count =
-          k - last_bindex + 1 - space_extra_bparts;
+      const int cid = b_index[k];
+      cells_top[cid].black_holes.count =
+          k - last_bindex + 1 - space_rebuild_extras_in_cell(s, cid)->bparts;
       last_bindex = k + 1;
     }
   }
 
   /* Extract the cell counts from the sorted indices. Deduct the extra
-   * particles. */
+   * particles placed in each cell. */
   size_t last_sink_index = 0;
   sink_index[nr_sinks] = s->nr_cells;  // sentinel.
   for (size_t k = 0; k < nr_sinks; k++) {
     if (sink_index[k] < sink_index[k + 1]) {
-      cells_top[sink_index[k]].sinks.count =
-          k - last_sink_index + 1 - space_extra_sinks;
+      const int cid = sink_index[k];
+      cells_top[cid].sinks.count =
+          k - last_sink_index + 1 - space_rebuild_extras_in_cell(s, cid)->sinks;
       last_sink_index = k + 1;
     }
   }
@@ -836,9 +931,19 @@ void space_rebuild(struct space *s, int repartitioned, int verbose) {
   s->nr_inhibited_sinks = 0;
 
   /* Sort the gparts according to their cells. */
-  if (nr_gparts > 0)
-    space_gparts_sort(s->gparts, s->parts, s->sinks, s->sparts, s->bparts,
-                      g_index, cell_gpart_counts, s->nr_cells);
+  if (nr_gparts > 0) {
+    if (s->incremental_rebuild) {
+      int *unit_counts = space_sort_stable_indices(g_index, cell_gpart_counts,
+                                                   s->nr_cells, nr_gparts);
+      space_gparts_sort(s->gparts, s->parts, s->sinks, s->sparts, s->bparts,
+                        g_index, unit_counts, (int)nr_gparts);
+      swift_free("stable_counts", unit_counts);
+      space_sort_restore_indices(g_index, cell_gpart_counts, s->nr_cells);
+    } else {
+      space_gparts_sort(s->gparts, s->parts, s->sinks, s->sparts, s->bparts,
+                        g_index, cell_gpart_counts, s->nr_cells);
+    }
+  }
 
 #ifdef SWIFT_DEBUG_CHECKS
   /* Verify that the gpart have been sorted correctly. */
@@ -867,13 +972,14 @@ void space_rebuild(struct space *s, int repartitioned, int verbose) {
 #endif /* SWIFT_DEBUG_CHECKS */
 
   /* Extract the cell counts from the sorted indices. Deduct the extra
-   * particles. */
+   * particles placed in each cell. */
   size_t last_gindex = 0;
   g_index[nr_gparts] = s->nr_cells;
   for (size_t k = 0; k < nr_gparts; k++) {
     if (g_index[k] < g_index[k + 1]) {
-      cells_top[g_index[k]].grav.count =
-          k - last_gindex + 1 - space_extra_gparts;
+      const int cid = g_index[k];
+      cells_top[cid].grav.count =
+          k - last_gindex + 1 - space_rebuild_extras_in_cell(s, cid)->gparts;
       last_gindex = k + 1;
     }
   }
@@ -933,11 +1039,13 @@ void space_rebuild(struct space *s, int repartitioned, int verbose) {
       c->stars.parts_rebuild = c->stars.parts;
       c->grav.parts_rebuild = c->grav.parts;
 
-      c->hydro.count_total = c->hydro.count + space_extra_parts;
-      c->grav.count_total = c->grav.count + space_extra_gparts;
-      c->stars.count_total = c->stars.count + space_extra_sparts;
-      c->sinks.count_total = c->sinks.count + space_extra_sinks;
-      c->black_holes.count_total = c->black_holes.count + space_extra_bparts;
+      const struct space_extras_count *extras =
+          space_rebuild_extras_in_cell(s, k);
+      c->hydro.count_total = c->hydro.count + extras->parts;
+      c->grav.count_total = c->grav.count + extras->gparts;
+      c->stars.count_total = c->stars.count + extras->sparts;
+      c->sinks.count_total = c->sinks.count + extras->sinks;
+      c->black_holes.count_total = c->black_holes.count + extras->bparts;
 
       finger = &finger[c->hydro.count_total];
       xfinger = &xfinger[c->hydro.count_total];
@@ -957,6 +1065,13 @@ void space_rebuild(struct space *s, int repartitioned, int verbose) {
       s->local_cells_with_particles_top[s->nr_local_cells_with_particles] = k;
       s->nr_local_cells_with_particles++;
     }
+
+    /* Any tree kept from the last rebuild that will not be split again is
+     * returned to the pool. We are outside of any threadpool mapper here so
+     * use the buffer of the first thread. */
+    else if (s->incremental_rebuild) {
+      space_recycle_progeny(s, c, /*tpid=*/0);
+    }
   }
 
   if (verbose) {
@@ -986,6 +1101,19 @@ void space_rebuild(struct space *s, int repartitioned, int verbose) {
   /* Clean up any stray sort indices in the cell buffer. */
   space_free_buff_sort_indices(s);
 
+  /* The particles have moved, start new time-bin indices. */
+  if (s->active_particle_index) space_allocate_bin_index(s);
+
+  /* The black holes and sinks have moved, re-index them by ID. */
+  const ticks tic4 = getticks();
+  id_index_build_bparts(&s->bparts_id_index, s->bparts, s->nr_bparts,
+                        &s->e->threadpool);
+  id_index_build_sinks(&s->sinks_id_index, s->sinks, s->nr_sinks,
+                       &s->e->threadpool);
+  if (verbose && (s->nr_bparts > 0 || s->nr_sinks > 0))
+    message("Indexing the black holes and sinks by ID took %.3f %s.",
+            clocks_from_ticks(getticks() - tic4), clocks_getunit());
+
   if (verbose)
     message("took %.3f %s.", clocks_from_ticks(getticks() - tic),
             clocks_getunit());
@@ -208,6 +208,15 @@ void space_regrid(struct space *s, int verbose) {
                  s->local_cells_with_particles_top);
       swift_free("cells_top", s->cells_top);
       swift_free("multipoles_top", s->multipoles_top);
+      if (s->cells_top_split_size != NULL)
+        swift_free("cells_top_split_size", s->cells_top_split_size);
+      s->cells_top_split_size = NULL;
+      if (s->cells_top_extras_usage != NULL)
+        swift_free("cells_top_extras_usage", s->cells_top_extras_usage);
+      s->cells_top_extras_usage = NULL;
+      if (s->cells_top_extras_count != NULL)
+        swift_free("cells_top_extras_count", s->cells_top_extras_count);
+      s->cells_top_extras_count = NULL;
     }
 
     /* Also free the task arrays, these will be regenerated and we can use the
@@ -268,6 +277,39 @@ void space_regrid(struct space *s, int verbose) {
           "particles.");
     bzero(s->local_cells_with_particles_top, s->nr_cells * sizeof(int));
 
+    /* Allocate the tuned split sizes (0 means the global value) */
+    if (s->auto_tune_split) {
+      if (swift_memalign("cells_top_split_size",
+                         (void **)&s->cells_top_split_size,
+                         SWIFT_STRUCT_ALIGNMENT,
+                         s->nr_cells * sizeof(int)) != 0)
+        error("Failed to allocate the split sizes of the top-level cells.");
+      bzero(s->cells_top_split_size, s->nr_cells * sizeof(int));
+    }
+
+    /* Allocate the record of the extra slots' use */
+    if (s->with_star_formation || s->with_sink) {
+      if (swift_memalign("cells_top_extras_usage",
+                         (void **)&s->cells_top_extras_usage,
+                         SWIFT_STRUCT_ALIGNMENT,
+                         s->nr_cells * sizeof(struct space_extras_usage)) != 0)
+        error("Failed to allocate the extras usage of the top-level cells.");
+      bzero(s->cells_top_extras_usage,
+            s->nr_cells * sizeof(struct space_extras_usage));
+      bzero(&s->extras_usage_reported, sizeof(struct space_extras_usage));
+
+      /* The extra particles will all have to be re-distributed over the new
+       * cells. */
+      if (swift_memalign("cells_top_extras_count",
+                         (void **)&s->cells_top_extras_count,
+                         SWIFT_STRUCT_ALIGNMENT,
+                         s->nr_cells * sizeof(struct space_extras_count)) != 0)
+        error("Failed to allocate the extras count of the top-level cells.");
+      bzero(s->cells_top_extras_count,
+            s->nr_cells * sizeof(struct space_extras_count));
+      s->cells_top_extras_count_valid = 0;
+    }
+
     /* Set the cells' locks */
     for (int k = 0; k < s->nr_cells; k++) {
       if (lock_init(&s->cells_top[k].hydro.lock) != 0)
@@ -391,8 +433,12 @@ void space_regrid(struct space *s, int verbose) {
   }      /* re-build upper-level cells? */
   else { /* Otherwise, just clean up the cells. */
 
-    /* Free the old cells, if they were allocated. */
-    space_free_cells(s);
+    /* Free the old cells, if they were allocated. When rebuilding
+     * incrementally, the trees are kept for space_split() to re-use. */
+    if (s->incremental_rebuild)
+      space_free_cells_keep_tree(s);
+    else
+      space_free_cells(s);
   }
 
   if (verbose)
@@ -351,3 +351,68 @@ void space_gparts_sort(struct gpart *gparts, struct part *parts,
 
   swift_free("gparts_offsets", offsets);
 }
+
+/**
+ * @brief Turn per-bin indices into the destinations of a stable sort.
+ *
+ * Each entry of @c ind is replaced by the position the element occupies once
+ * the array is sorted by bin while preserving the relative order of the
+ * elements within a bin. Calling any of the space_*_sort() functions with
+ * these destinations and the returned unit counts (@c N bins of one element)
+ * then performs a stable sort. Elements that do not change bin keep their
+ * order, which lets the cell tree built on top of them be re-used.
+ *
+ * @param ind The bin indices, overwritten with the destinations.
+ * @param counts Number of elements per bin.
+ * @param num_bins Total number of bins (length of counts).
+ * @param N The number of elements.
+ * @return An array of @c N ones to be passed as counts to the sort and freed
+ * with swift_free("stable_counts", ...) afterwards.
+ */
+int *space_sort_stable_indices(int *ind, const int *counts, int num_bins,
+                               size_t N) {
+
+  size_t *offsets = NULL;
+  if (swift_memalign("stable_offsets", (void **)&offsets,
+                     SWIFT_STRUCT_ALIGNMENT,
+                     sizeof(size_t) * (num_bins + 1)) != 0)
+    error("Failed to allocate temporary cell offsets array.");
+
+  offsets[0] = 0;
+  for (int k = 1; k <= num_bins; k++)
+    offsets[k] = offsets[k - 1] + counts[k - 1];
+
+#ifdef SWIFT_DEBUG_CHECKS
+  if (offsets[num_bins] != N) error("Bin counts do not add up.");
+#endif
+
+  /* The destination of an element is its bin's next free slot. */
+  for (size_t k = 0; k < N; k++) ind[k] = offsets[ind[k]]++;
+
+  swift_free("stable_offsets", offsets);
+
+  int *unit_counts = NULL;
+  if (swift_memalign("stable_counts", (void **)&unit_counts,
+                     SWIFT_STRUCT_ALIGNMENT, sizeof(int) * N) != 0)
+    error("Failed to allocate temporary unit counts array.");
+  for (size_t k = 0; k < N; k++) unit_counts[k] = 1;
+
+  return unit_counts;
+}
+
+/**
+ * @brief Restore the bin indices of an array sorted with the destinations
+ * returned by space_sort_stable_indices().
+ *
+ * @param ind The indices to restore.
+ * @param counts Number of elements per bin.
+ * @param num_bins Total number of bins (length of counts).
+ */
+void space_sort_restore_indices(int *ind, const int *counts, int num_bins) {
+
+  size_t offset = 0;
+  for (int k = 0; k < num_bins; k++) {
+    for (int j = 0; j < counts[k]; j++) ind[offset + j] = k;
+    offset += counts[k];
+  }
+}
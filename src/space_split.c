@@ -34,6 +34,118 @@
 #include "star_formation_logger.h"
 #include "threadpool.h"
 
+/**
+ * @brief Checks whether the particles of a cell are still partitioned the way
+ * its progeny from the previous rebuild expect them to be.
+ *
+ * This is the case if the particles of the cell are split between the
+ * progeny in the same proportions as before, and if each of the particles in
+ * the range of a progeny lies in that progeny's octant. The particles can
+ * then stay where they are and cell_split() can be skipped.
+ *
+ * @param c The #cell, with its progeny kept from the previous rebuild.
+ * @param buff The positions of the #part in the cell.
+ * @param sbuff The positions of the #spart in the cell.
+ * @param bbuff The positions of the #bpart in the cell.
+ * @param gbuff The positions of the #gpart in the cell.
+ * @param sink_buff The positions of the #sink in the cell.
+ * @param counts (return) The number of particles of each type in each
+ * progeny.
+ * @return 1 if the progeny can be re-used as-is, 0 otherwise.
+ */
+static int space_split_progeny_still_valid(
+    const struct cell *c, const struct cell_buff *restrict buff,
+    const struct cell_buff *restrict sbuff,
+    const struct cell_buff *restrict bbuff,
+    const struct cell_buff *restrict gbuff,
+    const struct cell_buff *restrict sink_buff, int counts[8][5]) {
+
+  const double pivot[3] = {c->loc[0] + c->width[0] / 2,
+                           c->loc[1] + c->width[1] / 2,
+                           c->loc[2] + c->width[2] / 2};
+  const struct cell_buff *buffs[5] = {buff, sbuff, bbuff, gbuff, sink_buff};
+  const int totals[5] = {c->hydro.count, c->stars.count,
+                         c->black_holes.count, c->grav.count,
+                         c->sinks.count};
+
+  /* What did the progeny hold at the last rebuild? */
+  for (int k = 0; k < 8; k++) {
+    const struct cell *cp = c->progeny[k];
+    counts[k][0] = cp != NULL ? cp->hydro.count : 0;
+    counts[k][1] = cp != NULL ? cp->stars.count : 0;
+    counts[k][2] = cp != NULL ? cp->black_holes.count : 0;
+    counts[k][3] = cp != NULL ? cp->grav.count : 0;
+    counts[k][4] = cp != NULL ? cp->sinks.count : 0;
+  }
+
+  for (int type = 0; type < 5; type++) {
+
+    /* Same number of particles overall? */
+    int offset = 0;
+    for (int k = 0; k < 8; k++) offset += counts[k][type];
+    if (offset != totals[type]) return 0;
+    if (totals[type] == 0) continue;
+
+    /* Is every particle still in the octant of its progeny? Use the same
+     * test as cell_split(). */
+    offset = 0;
+    for (int k = 0; k < 8; k++) {
+      const struct cell_buff *b = &buffs[type][offset];
+      for (int i = 0; i < counts[k][type]; i++) {
+        const int bid = (b[i].x[0] >= pivot[0]) * 4 +
+                        (b[i].x[1] >= pivot[1]) * 2 + (b[i].x[2] >= pivot[2]);
+        if (bid != k) return 0;
+      }
+      offset += counts[k][type];
+    }
+  }
+
+  return 1;
+}
+
+/**
+ * @brief Hook the progeny of a cell up to its particles without moving them.
+ *
+ * This is the counterpart of the last step of cell_split() for cells whose
+ * particles passed space_split_progeny_still_valid().
+ *
+ * @param c The #cell.
+ * @param counts The number of particles of each type in each progeny.
+ */
+static void space_split_progeny_set_counts(struct cell *c,
+                                           const int counts[8][5]) {
+
+  int offset[5] = {0, 0, 0, 0, 0};
+  for (int k = 0; k < 8; k++) {
+    struct cell *cp = c->progeny[k];
+
+    cp->hydro.count = counts[k][0];
+    cp->hydro.count_total = cp->hydro.count;
+    cp->hydro.parts = &c->hydro.parts[offset[0]];
+    cp->hydro.xparts = &c->hydro.xparts[offset[0]];
+
+    cp->stars.count = counts[k][1];
+    cp->stars.count_total = cp->stars.count;
+    cp->stars.parts = &c->stars.parts[offset[1]];
+    cp->stars.parts_rebuild = cp->stars.parts;
+
+    cp->black_holes.count = counts[k][2];
+    cp->black_holes.count_total = cp->black_holes.count;
+    cp->black_holes.parts = &c->black_holes.parts[offset[2]];
+
+    cp->grav.count = counts[k][3];
+    cp->grav.count_total = cp->grav.count;
+    cp->grav.parts = &c->grav.parts[offset[3]];
+    cp->grav.parts_rebuild = cp->grav.parts;
+
+    cp->sinks.count = counts[k][4];
+    cp->sinks.count_total = cp->sinks.count;
+    cp->sinks.parts = &c->sinks.parts[offset[4]];
+
+    for (int type = 0; type < 5; type++) offset[type] += counts[k][type];
+  }
+}
+
 /**
  * @brief Recursively split a cell.
  *
@@ -74,6 +186,8 @@ void space_split_recursive(struct space *s, struct cell *c,
   float black_holes_h_max_active = 0.f;
   float sinks_h_max = 0.f;
   float sinks_h_max_active = 0.f;
+  double bbox_min[3], bbox_max[3];
+  double active_bbox_min[3], active_bbox_max[3];
   integertime_t ti_hydro_end_min = max_nr_timesteps, ti_hydro_end_max = 0,
                 ti_hydro_beg_max = 0;
   integertime_t ti_rt_end_min = max_nr_timesteps, ti_rt_beg_max = 0;
@@ -95,6 +209,9 @@ void space_split_recursive(struct space *s, struct cell *c,
   struct engine *e = s->e;
   const integertime_t ti_current = e->ti_current;
 
+  cell_bbox_init(bbox_min, bbox_max);
+  cell_bbox_init(active_bbox_min, active_bbox_max);
+
   /* Set the top level cell tpid. Doing it here ensures top level cells
    * have the same tpid as their progeny. */
   if (depth == 0) c->tpid = tpid;
@@ -195,16 +312,40 @@ void space_split_recursive(struct space *s, struct cell *c,
         space_cell_maxdepth);
   }
 
+  /* Do we still have the progeny from the previous rebuild? */
+  int kept_progeny = 0;
+  for (int k = 0; k < 8; k++) kept_progeny |= (c->progeny[k] != NULL);
+
+  /* Split size of this region (possibly tuned from the task times) */
+  const int tuned_split_size =
+      s->cells_top_split_size != NULL
+          ? s->cells_top_split_size[c->top - s->cells_top]
+          : 0;
+  const int split_size =
+      tuned_split_size > 0 ? tuned_split_size : space_splitsize;
+
   /* Split or let it be? */
-  if ((with_self_gravity && gcount > space_splitsize) ||
-      (!with_self_gravity &&
-       (count > space_splitsize || scount > space_splitsize))) {
+  if ((with_self_gravity && gcount > split_size) ||
+      (!with_self_gravity && (count > split_size || scount > split_size))) {
 
     /* No longer just a leaf. */
     c->split = 1;
 
-    /* Create the cell's progeny. */
-    space_getcells(s, 8, c->progeny, tpid);
+    /* Can the particles stay where the previous rebuild put them? */
+    int counts[8][5];
+    const int reuse =
+        kept_progeny &&
+        space_split_progeny_still_valid(c, buff, sbuff, bbuff, gbuff,
+                                        sink_buff, counts);
+
+    /* Create the cell's progeny, re-using the cells we already have. Their
+     * own trees are checked when we recurse into them. */
+    for (int k = 0; k < 8; k++) {
+      if (c->progeny[k] == NULL)
+        space_getcells(s, 1, &c->progeny[k], tpid);
+      else
+        space_reuse_cell(s, c->progeny[k], tpid);
+    }
     for (int k = 0; k < 8; k++) {
       struct cell *cp = c->progeny[k];
       cp->hydro.count = 0;
@@ -265,10 +406,15 @@ void space_split_recursive(struct space *s, struct cell *c,
 #endif
     }
 
-    /* Split the cell's particle data. */
-    cell_split(c, c->hydro.parts - s->parts, c->stars.parts - s->sparts,
-               c->black_holes.parts - s->bparts, c->sinks.parts - s->sinks,
-               buff, sbuff, bbuff, gbuff, sink_buff);
+    /* Split the cell's particle data, unless it is already in order. */
+    if (reuse) {
+      space_split_progeny_set_counts(c, counts);
+      atomic_inc(&s->nr_cells_reused);
+    } else {
+      cell_split(c, c->hydro.parts - s->parts, c->stars.parts - s->sparts,
+                 c->black_holes.parts - s->bparts, c->sinks.parts - s->sinks,
+                 buff, sbuff, bbuff, gbuff, sink_buff);
+    }
 
     /* Buffers for the progenitors */
     struct cell_buff *progeny_buff = buff, *progeny_gbuff = gbuff,
@@ -284,7 +430,8 @@ void space_split_recursive(struct space *s, struct cell *c,
       if (cp->hydro.count == 0 && cp->grav.count == 0 && cp->stars.count == 0 &&
           cp->black_holes.count == 0 && cp->sinks.count == 0) {
 
-        space_recycle(s, cp);
+        space_recycle_progeny(s, cp, tpid);
+        space_recycle(s, cp, tpid);
         c->progeny[k] = NULL;
 
       } else {
@@ -303,6 +450,10 @@ void space_split_recursive(struct space *s, struct cell *c,
         /* Update the cell-wide properties */
         h_max = max(h_max, cp->hydro.h_max);
         h_max_active = max(h_max_active, cp->hydro.h_max_active);
+        cell_bbox_merge(bbox_min, bbox_max, cp->hydro.bbox_min,
+                        cp->hydro.bbox_max);
+        cell_bbox_merge(active_bbox_min, active_bbox_max,
+                        cp->hydro.active_bbox_min, cp->hydro.active_bbox_max);
         stars_h_max = max(stars_h_max, cp->stars.h_max);
         stars_h_max_active = max(stars_h_max_active, cp->stars.h_max_active);
         black_holes_h_max = max(black_holes_h_max, cp->black_holes.h_max);
@@ -448,6 +599,7 @@ void space_split_recursive(struct space *s, struct cell *c,
   else {
 
     /* Clear the progeny. */
+    if (kept_progeny) space_recycle_progeny(s, c, tpid);
     bzero(c->progeny, sizeof(struct cell *) * 8);
     c->split = 0;
     maxdepth = c->depth;
@@ -497,9 +649,12 @@ void space_split_recursive(struct space *s, struct cell *c,
       ti_rt_min_step_size = min(ti_rt_min_step_size, ti_rt_step);
 
       h_max = max(h_max, parts[k].h);
+      cell_bbox_add(bbox_min, bbox_max, parts[k].x);
 
-      if (part_is_active(&parts[k], e))
+      if (part_is_active(&parts[k], e)) {
         h_max_active = max(h_max_active, parts[k].h);
+        cell_bbox_add(active_bbox_min, active_bbox_max, parts[k].x);
+      }
 
       /* Collect SFR from the particles after rebuilt */
       star_formation_logger_log_inactive_part(&parts[k], &xparts[k],
@@ -654,6 +809,8 @@ void space_split_recursive(struct space *s, struct cell *c,
   /* Set the values for this cell. */
   c->hydro.h_max = h_max;
   c->hydro.h_max_active = h_max_active;
+  cell_hydro_set_bbox(c, bbox_min, bbox_max, active_bbox_min, active_bbox_max,
+                      ti_current);
   c->hydro.ti_end_min = ti_hydro_end_min;
   c->hydro.ti_beg_max = ti_hydro_beg_max;
   c->rt.ti_rt_end_min = ti_rt_end_min;
@@ -691,6 +848,179 @@ void space_split_recursive(struct space *s, struct cell *c,
   }
 }
 
+/*! Address of a cell or multipole along with its rank in the tree walk. */
+struct space_linear_entry {
+  char *address;
+  int index;
+};
+
+/**
+ * @brief Sort #space_linear_entry by increasing address.
+ */
+static int space_linear_entry_cmp(const void *a, const void *b) {
+  const char *pa = ((const struct space_linear_entry *)a)->address;
+  const char *pb = ((const struct space_linear_entry *)b)->address;
+  return (pa > pb) - (pa < pb);
+}
+
+/**
+ * @brief Count the sub-cells of a tree.
+ *
+ * @param c The #cell.
+ */
+static int space_linearise_count(const struct cell *c) {
+
+  int count = 0;
+  for (int k = 0; k < 8; k++)
+    if (c->progeny[k] != NULL)
+      count += 1 + space_linearise_count(c->progeny[k]);
+  return count;
+}
+
+/**
+ * @brief Record the sub-cells of a tree in depth-first (pre-)order.
+ *
+ * @param c The #cell to walk.
+ * @param parent_index Rank of @c c in the walk (-1 for the top-level cell).
+ * @param cells (return) The cells in the order they were visited.
+ * @param parents (return) The rank of the parent of each cell.
+ * @param slots (return) The progeny slot of each cell in its parent.
+ * @param count (return) The number of cells recorded so far.
+ */
+static void space_linearise_collect(struct cell *c, const int parent_index,
+                                    struct cell **cells, int *parents,
+                                    char *slots, int *count) {
+
+  for (int k = 0; k < 8; k++) {
+    struct cell *cp = c->progeny[k];
+    if (cp == NULL) continue;
+
+    const int index = (*count)++;
+    cells[index] = cp;
+    parents[index] = parent_index;
+    slots[index] = k;
+    space_linearise_collect(cp, index, cells, parents, slots, count);
+  }
+}
+
+/**
+ * @brief Move the elements of an array of scattered slots so that element
+ * @c i ends up in the @c i-th lowest address.
+ *
+ * @param sorted The slots sorted by address, each with the rank of the
+ * element it currently holds.
+ * @param inverse Scratch space of @c n ints.
+ * @param n The number of elements.
+ * @param size The size of an element.
+ * @param temp Scratch space for one element.
+ */
+static void space_linearise_permute(const struct space_linear_entry *sorted,
+                                    int *inverse, const int n,
+                                    const size_t size, void *temp) {
+
+  /* Where does the element of a given rank currently live? */
+  for (int j = 0; j < n; j++) inverse[sorted[j].index] = j;
+
+  /* Follow the cycles of the permutation with a single spare element. Slots
+   * that have been filled are flagged by a negative inverse. */
+  for (int start = 0; start < n; start++) {
+    if (inverse[start] < 0 || inverse[start] == start) continue;
+
+    memcpy(temp, sorted[start].address, size);
+    int current = start;
+    while (inverse[current] != start) {
+      const int from = inverse[current];
+      memcpy(sorted[current].address, sorted[from].address, size);
+      inverse[current] = -1;
+      current = from;
+    }
+    memcpy(sorted[current].address, temp, size);
+    inverse[current] = -1;
+  }
+}
+
+/**
+ * @brief Re-order the memory of the sub-cells (and their multipoles) of a
+ * tree such that a depth-first walk visits increasing addresses.
+ *
+ * The cells and multipoles are not moved out of the memory they were taken
+ * from, we only swap the contents of the slots the tree already uses. The
+ * tree must not yet be referenced from outside (e.g. by tasks or proxies).
+ *
+ * @param s The #space.
+ * @param c The top-level #cell.
+ */
+static void space_linearise_tree(struct space *s, struct cell *c) {
+
+  const int n = space_linearise_count(c);
+  if (n == 0) return;
+
+  struct cell **cells = (struct cell **)malloc(n * sizeof(struct cell *));
+  int *parents = (int *)malloc(n * sizeof(int));
+  char *slots = (char *)malloc(n * sizeof(char));
+  int *inverse = (int *)malloc(n * sizeof(int));
+  struct space_linear_entry *sorted = (struct space_linear_entry *)malloc(
+      n * sizeof(struct space_linear_entry));
+  if (cells == NULL || parents == NULL || slots == NULL || inverse == NULL ||
+      sorted == NULL)
+    error("Failed to allocate memory to linearise the cell tree.");
+
+  int count = 0;
+  space_linearise_collect(c, -1, cells, parents, slots, &count);
+#ifdef SWIFT_DEBUG_CHECKS
+  if (count != n) error("Inconsistent number of cells in the tree.");
+#endif
+
+  /* Move the cells' contents into address order. */
+  for (int i = 0; i < n; i++) {
+    sorted[i].address = (char *)cells[i];
+    sorted[i].index = i;
+  }
+  qsort(sorted, n, sizeof(struct space_linear_entry), space_linear_entry_cmp);
+
+  struct cell *temp_cell = NULL;
+  if (swift_memalign("temp_cell", (void **)&temp_cell, cell_align,
+                     sizeof(struct cell)) != 0)
+    error("Failed to allocate a temporary cell.");
+  space_linearise_permute(sorted, inverse, n, sizeof(struct cell), temp_cell);
+  swift_free("temp_cell", temp_cell);
+
+  /* Re-connect the tree. The cell of rank i now lives at sorted[i]. */
+  for (int i = 0; i < n; i++) cells[i] = (struct cell *)sorted[i].address;
+  for (int i = 0; i < n; i++) {
+    struct cell *parent = parents[i] < 0 ? c : cells[parents[i]];
+    cells[i]->parent = parent;
+    parent->progeny[(int)slots[i]] = cells[i];
+  }
+
+  /* Same thing for the multipoles, which travelled with their cells. */
+  if (s->with_self_gravity) {
+    for (int i = 0; i < n; i++) {
+      sorted[i].address = (char *)cells[i]->grav.multipole;
+      sorted[i].index = i;
+    }
+    qsort(sorted, n, sizeof(struct space_linear_entry),
+          space_linear_entry_cmp);
+
+    struct gravity_tensors *temp_mpole = NULL;
+    if (swift_memalign("temp_mpole", (void **)&temp_mpole, multipole_align,
+                       sizeof(struct gravity_tensors)) != 0)
+      error("Failed to allocate a temporary multipole.");
+    space_linearise_permute(sorted, inverse, n, sizeof(struct gravity_tensors),
+                            temp_mpole);
+    swift_free("temp_mpole", temp_mpole);
+
+    for (int i = 0; i < n; i++)
+      cells[i]->grav.multipole = (struct gravity_tensors *)sorted[i].address;
+  }
+
+  free(cells);
+  free(parents);
+  free(slots);
+  free(inverse);
+  free(sorted);
+}
+
 /**
  * @brief #threadpool mapper function to split cells if they contain
  *        too many particles.
@@ -719,6 +1049,9 @@ void space_split_mapper(void *map_data, int num_cells, void *extra_data) {
     struct cell *c = &cells_top[local_cells_with_particles[ind]];
     space_split_recursive(s, c, NULL, NULL, NULL, NULL, NULL, tpid);
 
+    /* Lay the tree out in memory in the order it is walked. */
+    if (s->linearise_cell_tree) space_linearise_tree(s, c);
+
     if (s->with_self_gravity) {
       min_a_grav =
           min(min_a_grav, c->grav.multipole->m_pole.min_old_a_grav_norm);
@@ -746,6 +1079,89 @@ void space_split_mapper(void *map_data, int num_cells, void *extra_data) {
     atomic_max_f(&s->max_mpole_power[n], max_mpole_power[n]);
 }
 
+/**
+ * @brief Adjust the split size of each local top-level cell based on the
+ * time taken by the interaction tasks since the last rebuild.
+ *
+ * We aim for the longest interaction task of any region to take about
+ * 1/auto_tune_tasks_per_thread of the work of a thread. The split size of
+ * regions whose longest task is more than twice that is halved and that of
+ * regions whose longest task is less than half of it is doubled. This is
+ * done at every rebuild so the sizes converge over a few rebuilds. The
+ * gravity caches of the runners are sized for the largest split size this
+ * can produce.
+ *
+ * @param s The #space.
+ * @param sched The #scheduler holding the tasks of the previous steps.
+ * @param nr_threads The number of threads running tasks.
+ * @param verbose Are we talkative?
+ */
+void space_tune_split_sizes(struct space *s, const struct scheduler *sched,
+                            int nr_threads, int verbose) {
+
+  if (s->cells_top_split_size == NULL || sched->nr_tasks == 0) return;
+
+  const ticks tic = getticks();
+
+  /* Longest interaction task touching each top-level cell. */
+  ticks *max_ticks = (ticks *)calloc(s->nr_cells, sizeof(ticks));
+  if (max_ticks == NULL) error("Failed to allocate the task time buffer.");
+
+  ticks total_ticks = 0;
+  for (int k = 0; k < sched->nr_tasks; k++) {
+    const struct task *t = &sched->tasks[k];
+    if (t->implicit || t->toc <= t->tic) continue;
+
+    const ticks dt = t->toc - t->tic;
+    total_ticks += dt;
+
+    if (t->type != task_type_self && t->type != task_type_pair &&
+        t->type != task_type_sub_self && t->type != task_type_sub_pair)
+      continue;
+
+    const int cid_i = t->ci->top - s->cells_top;
+    max_ticks[cid_i] = max(max_ticks[cid_i], dt);
+    if (t->cj != NULL) {
+      const int cid_j = t->cj->top - s->cells_top;
+      max_ticks[cid_j] = max(max_ticks[cid_j], dt);
+    }
+  }
+
+  const ticks target =
+      total_ticks / ((ticks)nr_threads * s->auto_tune_tasks_per_thread);
+  const int max_split_size = space_auto_tune_max_split_factor * space_splitsize;
+
+  int num_refined = 0, num_coarsened = 0;
+  for (int k = 0; k < s->nr_local_cells; k++) {
+    const int cid = s->local_cells_top[k];
+    int *split_size = &s->cells_top_split_size[cid];
+
+    if (max_ticks[cid] == 0) continue;
+    if (*split_size == 0) *split_size = space_splitsize;
+
+    if (max_ticks[cid] > 2 * target &&
+        *split_size > space_auto_tune_min_split_size) {
+      *split_size = max(*split_size / 2, space_auto_tune_min_split_size);
+      num_refined++;
+    } else if (max_ticks[cid] < target / 2 && *split_size < max_split_size) {
+      *split_size = min(*split_size * 2, max_split_size);
+      num_coarsened++;
+    }
+  }
+
+  free(max_ticks);
+
+  if (verbose) {
+    message(
+        "Target interaction task time: %.3f %s. Refined %d and coarsened %d "
+        "top-level cells.",
+        clocks_from_ticks(target), clocks_getunit(), num_refined,
+        num_coarsened);
+    message("took %.3f %s.", clocks_from_ticks(getticks() - tic),
+            clocks_getunit());
+  }
+}
+
 /**
  * @brief Split particles between cells of a hierarchy.
  *
@@ -762,12 +1178,17 @@ void space_split(struct space *s, int verbose) {
   s->min_a_grav = FLT_MAX;
   s->max_softening = 0.f;
   bzero(s->max_mpole_power, (SELF_GRAVITY_MULTIPOLE_ORDER + 1) * sizeof(float));
+  s->nr_cells_reused = 0;
 
   threadpool_map(&s->e->threadpool, space_split_mapper,
                  s->local_cells_with_particles_top,
                  s->nr_local_cells_with_particles, sizeof(int),
                  threadpool_auto_chunk_size, s);
 
+  if (verbose && s->incremental_rebuild)
+    message("Re-used the progeny of %d out of %d cells.", s->nr_cells_reused,
+            s->tot_cells);
+
   if (verbose)
     message("took %.3f %s.", clocks_from_ticks(getticks() - tic),
             clocks_getunit());
@@ -58,6 +58,7 @@
 #include "lock.h"
 #include "map.h"
 #include "memuse.h"
+#include "memuse_shared.h"
 #include "mesh_gravity.h"
 #include "minmax.h"
 #include "mpiuse.h"
@@ -92,7 +93,9 @@
 #include "star_formation_logger.h"
 #include "stars.h"
 #include "stars_io.h"
+#include "synthetic_ics.h"
 #include "task.h"
+#include "task_trace.h"
 #include "threadpool.h"
 #include "timeline.h"
 #include "timers.h"
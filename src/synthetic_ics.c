@@ -0,0 +1,566 @@
+/*******************************************************************************
+ * This file is part of SWIFT.
+ * Copyright (c) 2026 agent (agent@local)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+/* Config parameters. */
+#include <config.h>
+
+/* This object's header. */
+#include "synthetic_ics.h"
+
+/* Standard headers. */
+#include <math.h>
+#include <string.h>
+
+/* Local headers. */
+#include "common_io.h"
+#include "cosmology.h"
+#include "error.h"
+#include "hydro.h"
+#include "hydro_properties.h"
+#include "memuse.h"
+#include "minmax.h"
+#include "parser.h"
+#include "part.h"
+#include "periodic.h"
+#include "random.h"
+#include "threadpool.h"
+
+/*! Displacement of the lattice points in the glass-like distribution, in units
+ * of the inter-particle separation */
+#define synthetic_ics_glass_displacement 0.25
+
+/*! Shortest wavelength of the displacement field, in units of the
+ * inter-particle separation */
+#define synthetic_ics_min_wavelength 4.
+
+/* Indices of the random numbers drawn for each particle, mode or clump. */
+enum synthetic_ics_random_index {
+  synthetic_ics_random_glass = 0,       /* 3 numbers */
+  synthetic_ics_random_in_clump = 3,    /* 1 number */
+  synthetic_ics_random_which_clump = 4, /* 1 number */
+  synthetic_ics_random_clump = 5,       /* 6 numbers */
+  synthetic_ics_random_mode = 16,       /* 4 numbers */
+  synthetic_ics_random_centre = 32,     /* 3 numbers */
+};
+
+/**
+ * @brief A plane wave of the displacement field.
+ */
+struct synthetic_ics_mode {
+
+  /*! Wave vector */
+  double k[3];
+
+  /*! Amplitude along each axis */
+  double amplitude[3];
+
+  /*! Phase */
+  double phase;
+};
+
+/**
+ * @brief Data passed to the mappers generating the particles.
+ */
+struct synthetic_ics_data {
+
+  /*! The properties of the ICs */
+  const struct synthetic_ics *ics;
+
+  /*! The plane waves of the displacement field */
+  const struct synthetic_ics_mode *modes;
+
+  /*! The centres of the clumps */
+  const double (*centres)[3];
+
+  /*! The arrays to fill */
+  struct part *parts;
+  struct gpart *gparts;
+
+  /*! Global index of the first particle of this rank */
+  long long first;
+
+  /*! Offset added to the lattice index to get the particle ID */
+  long long id_offset;
+
+  /*! Position of the particles in their lattice cell in units of the
+   * inter-particle separation */
+  double lattice_offset;
+
+  /*! Distance between the lattice points */
+  double spacing;
+
+  /*! Mass of the particles */
+  double mass;
+
+  /*! Ratio of velocity to displacement */
+  double velocity_factor;
+
+  /*! Resolution parameter of the gas */
+  double eta;
+
+  /*! Internal energy per unit mass of the gas */
+  double u;
+};
+
+/**
+ * @brief Initialise the synthetic ICs from the parameter file.
+ *
+ * @param ics The #synthetic_ics to initialise.
+ * @param params The parsed parameter file.
+ * @param cosmo The #cosmology.
+ * @param with_cosmology Are we running a cosmological simulation?
+ * @param with_hydro Are we running with hydrodynamics?
+ */
+void synthetic_ics_init(struct synthetic_ics *ics, struct swift_params *params,
+                        const struct cosmology *cosmo, const int with_cosmology,
+                        const int with_hydro) {
+
+  ics->box_size = parser_get_param_double(params, "SyntheticICs:box_size");
+  ics->particles_per_dim =
+      parser_get_param_longlong(params, "SyntheticICs:particles_per_dim");
+
+  char distribution[PARSER_MAX_LINE_SIZE];
+  parser_get_opt_param_string(params, "SyntheticICs:distribution", distribution,
+                              "glass");
+  if (strcmp(distribution, "lattice") == 0)
+    ics->distribution = synthetic_ics_lattice;
+  else if (strcmp(distribution, "glass") == 0)
+    ics->distribution = synthetic_ics_glass;
+  else
+    error(
+        "Invalid value for SyntheticICs:distribution ('%s'), must be 'lattice' "
+        "or 'glass'.",
+        distribution);
+
+  /* By default, use the cosmic mean densities */
+  const double default_gas_density =
+      with_cosmology ? cosmo->Omega_b * cosmo->critical_density_0 : 1.;
+  const double default_dm_density =
+      with_cosmology ? cosmo->Omega_cdm * cosmo->critical_density_0 : 1.;
+  ics->gas_density = parser_get_opt_param_double(
+      params, "SyntheticICs:gas_density", default_gas_density);
+  ics->dm_density = parser_get_opt_param_double(
+      params, "SyntheticICs:dm_density", default_dm_density);
+  ics->gas_internal_energy = parser_get_opt_param_double(
+      params, "SyntheticICs:gas_internal_energy", 0.);
+
+  ics->perturbation_amplitude = parser_get_opt_param_double(
+      params, "SyntheticICs:perturbation_amplitude", 0.);
+  ics->perturbation_modes =
+      parser_get_opt_param_int(params, "SyntheticICs:perturbation_modes", 32);
+
+  ics->clump_fraction =
+      parser_get_opt_param_double(params, "SyntheticICs:clump_fraction", 0.);
+  ics->num_clumps =
+      parser_get_opt_param_int(params, "SyntheticICs:num_clumps", 8);
+  ics->clump_radius =
+      parser_get_opt_param_double(params, "SyntheticICs:clump_radius", 0.02);
+
+  ics->seed = parser_get_opt_param_longlong(params, "SyntheticICs:seed", 1);
+
+  /* Some sanity checks */
+  if (ics->box_size <= 0.)
+    error("SyntheticICs:box_size must be positive (%e).", ics->box_size);
+  if (ics->particles_per_dim <= 0)
+    error("SyntheticICs:particles_per_dim must be positive (%lld).",
+          ics->particles_per_dim);
+  if (ics->gas_density <= 0. || ics->dm_density <= 0.)
+    error("The densities of the synthetic ICs must be positive.");
+  if (ics->perturbation_amplitude < 0. || ics->perturbation_modes < 0)
+    error("The perturbations of the synthetic ICs must be positive.");
+  if (ics->clump_fraction < 0. || ics->clump_fraction > 1.)
+    error("SyntheticICs:clump_fraction must be in [0, 1] (%e).",
+          ics->clump_fraction);
+  if (ics->clump_fraction > 0. &&
+      (ics->num_clumps <= 0 || ics->clump_radius <= 0.))
+    error("Clumps need a positive number and radius.");
+  if (with_hydro && ics->gas_internal_energy < 0.)
+    error("SyntheticICs:gas_internal_energy must be positive (%e).",
+          ics->gas_internal_energy);
+}
+
+/**
+ * @brief Print the properties of the synthetic ICs.
+ *
+ * @param ics The #synthetic_ics.
+ */
+void synthetic_ics_print(const struct synthetic_ics *ics) {
+
+  message("Generating synthetic ICs: %lld^3 particles per type in a box of %e.",
+          ics->particles_per_dim, ics->box_size);
+  message("Distribution: %s, displacement: %.3f x separation (%d modes).",
+          ics->distribution == synthetic_ics_glass ? "glass" : "lattice",
+          ics->perturbation_amplitude, ics->perturbation_modes);
+  if (ics->clump_fraction > 0.)
+    message("Clumps: %.2f%% of the particles in %d clumps of radius %e.",
+            100. * ics->clump_fraction, ics->num_clumps,
+            ics->clump_radius * ics->box_size);
+}
+
+/**
+ * @brief Draw a random number in [0, 1[ for a particle, mode or clump.
+ *
+ * The numbers only depend on the ID, the index and the seed, so the ICs do
+ * not depend on the number of ranks or threads used to generate them.
+ *
+ * @param ics The #synthetic_ics.
+ * @param id The ID of the object.
+ * @param index The index of the number for this object.
+ */
+static double synthetic_ics_random(const struct synthetic_ics *ics,
+                                   const long long id, const int index) {
+  return random_unit_interval_part_ID_and_index(
+      id, index, (integertime_t)ics->seed, random_number_synthetic_ics);
+}
+
+/**
+ * @brief Draw a number from a normal distribution for a particle.
+ *
+ * @param ics The #synthetic_ics.
+ * @param id The ID of the particle.
+ * @param index The index of the first of the two uniform numbers used.
+ */
+static double synthetic_ics_gaussian(const struct synthetic_ics *ics,
+                                     const long long id, const int index) {
+  const double u1 = 1. - synthetic_ics_random(ics, id, index);
+  const double u2 = synthetic_ics_random(ics, id, index + 1);
+  return sqrt(-2. * log(u1)) * cos(2. * M_PI * u2);
+}
+
+/**
+ * @brief Compute the position, velocity and local number density of a
+ * particle.
+ *
+ * @param data The #synthetic_ics_data of the particles' type.
+ * @param index The index of the particle on the global lattice.
+ * @param x (return) The position.
+ * @param v (return) The velocity.
+ *
+ * @return The expected number density of particles of that type around it.
+ */
+static double synthetic_ics_particle(const struct synthetic_ics_data *data,
+                                     const long long index, double x[3],
+                                     float v[3]) {
+
+  const struct synthetic_ics *ics = data->ics;
+  const long long n = ics->particles_per_dim;
+  const long long id = index + data->id_offset;
+  const double L = ics->box_size;
+  const double spacing = data->spacing;
+
+  /* Start from the lattice */
+  const long long ind[3] = {index / (n * n), (index / n) % n, index % n};
+  double q[3];
+  for (int k = 0; k < 3; k++) {
+    q[k] = (ind[k] + data->lattice_offset) * spacing;
+    if (ics->distribution == synthetic_ics_glass) {
+      const double r =
+          synthetic_ics_random(ics, id, synthetic_ics_random_glass + k);
+      q[k] += synthetic_ics_glass_displacement * spacing * (2. * r - 1.);
+    }
+  }
+
+  /* Displace the particle following the plane waves */
+  double psi[3] = {0., 0., 0.};
+  for (int m = 0; m < ics->perturbation_modes; m++) {
+    const struct synthetic_ics_mode *mode = &data->modes[m];
+    const double s = sin(mode->k[0] * q[0] + mode->k[1] * q[1] +
+                         mode->k[2] * q[2] + mode->phase);
+    for (int k = 0; k < 3; k++) psi[k] += mode->amplitude[k] * s;
+  }
+  for (int k = 0; k < 3; k++) {
+    x[k] = q[k] + psi[k];
+    v[k] = data->velocity_factor * psi[k];
+  }
+
+  /* Mean number density of the particles */
+  const double n_mean = 1. / (spacing * spacing * spacing);
+  double density = n_mean * (1. - ics->clump_fraction);
+
+  /* Move some of the particles into a clump */
+  if (ics->clump_fraction > 0.) {
+
+    const double sigma = ics->clump_radius * L;
+    const double n_clump = ics->clump_fraction * n * n * n / ics->num_clumps;
+    const double norm = n_clump / (pow(2. * M_PI, 1.5) * sigma * sigma * sigma);
+
+    if (synthetic_ics_random(ics, id, synthetic_ics_random_in_clump) <
+        ics->clump_fraction) {
+
+      const double r =
+          synthetic_ics_random(ics, id, synthetic_ics_random_which_clump);
+      const int c = min((int)(r * ics->num_clumps), ics->num_clumps - 1);
+
+      double r2 = 0.;
+      for (int k = 0; k < 3; k++) {
+        const double dx =
+            sigma *
+            synthetic_ics_gaussian(ics, id, synthetic_ics_random_clump + 2 * k);
+        x[k] = data->centres[c][k] + dx;
+        r2 += dx * dx;
+      }
+      density += norm * exp(-0.5 * r2 / (sigma * sigma));
+    }
+  }
+
+  /* Wrap the particle back into the box */
+  for (int k = 0; k < 3; k++) x[k] = box_wrap(x[k], 0., L);
+
+  return density;
+}
+
+/**
+ * @brief Mapper function generating gas particles.
+ *
+ * @param map_data The #part to fill.
+ * @param num_elements The number of particles to fill.
+ * @param extra_data The #synthetic_ics_data.
+ */
+static void synthetic_ics_gas_mapper(void *map_data, int num_elements,
+                                     void *extra_data) {
+
+  const struct synthetic_ics_data *data =
+      (const struct synthetic_ics_data *)extra_data;
+  struct part *parts = (struct part *)map_data;
+  const size_t offset = parts - data->parts;
+
+  for (int i = 0; i < num_elements; i++) {
+    struct part *p = &parts[i];
+    const long long index = data->first + offset + i;
+
+    const double density = synthetic_ics_particle(data, index, p->x, p->v);
+
+    p->id = index + data->id_offset;
+    p->h = data->eta * cbrt(1. / density);
+    hydro_set_mass(p, data->mass);
+    hydro_set_init_internal_energy(p, data->u);
+  }
+}
+
+/**
+ * @brief Mapper function generating dark matter particles.
+ *
+ * @param map_data The #gpart to fill.
+ * @param num_elements The number of particles to fill.
+ * @param extra_data The #synthetic_ics_data.
+ */
+static void synthetic_ics_dm_mapper(void *map_data, int num_elements,
+                                    void *extra_data) {
+
+  const struct synthetic_ics_data *data =
+      (const struct synthetic_ics_data *)extra_data;
+  struct gpart *gparts = (struct gpart *)map_data;
+  const size_t offset = gparts - data->gparts;
+
+  for (int i = 0; i < num_elements; i++) {
+    struct gpart *gp = &gparts[i];
+    const long long index = data->first + offset + i;
+
+    synthetic_ics_particle(data, index, gp->x, gp->v_full);
+
+    gp->id_or_neg_offset = index + data->id_offset;
+    gp->mass = data->mass;
+  }
+}
+
+/**
+ * @brief Generate this rank's share of the synthetic ICs.
+ *
+ * Each rank generates a contiguous range of the lattice, i.e. a slab of the
+ * box, directly into its particle arrays. The particles are then distributed
+ * amongst the ranks by the usual decomposition. The arrays are laid out as if
+ * they had been read by read_ic_single(): the dark matter #gpart first, then
+ * the ones of the gas.
+ *
+ * Gas particles are generated if running with hydrodynamics, dark matter ones
+ * if running with gravity. The gas particles sit between the dark matter
+ * ones, at the centre of the lattice cells. The velocities are the ones of
+ * the Zel'dovich growing mode in cosmological runs and zero otherwise.
+ *
+ * @param ics The #synthetic_ics.
+ * @param hydro_props The #hydro_props.
+ * @param cosmo The #cosmology.
+ * @param dim (output) The dimensions of the box.
+ * @param parts (output) The array of #part.
+ * @param gparts (output) The array of #gpart.
+ * @param Ngas (output) The number of #part generated on this rank.
+ * @param Ngparts (output) The number of #gpart generated on this rank.
+ * @param flag_entropy (output) 1 if the ICs contained entropy instead of
+ * internal energy (never the case here).
+ * @param with_hydro Are we running with hydrodynamics?
+ * @param with_gravity Are we running with gravity?
+ * @param with_cosmology Are we running a cosmological simulation?
+ * @param nodeID This rank's ID.
+ * @param nr_nodes The number of ranks.
+ * @param nr_threads The number of threads to use.
+ * @param dry_run Only allocate the arrays?
+ */
+void synthetic_ics_generate(const struct synthetic_ics *ics,
+                            const struct hydro_props *hydro_props,
+                            const struct cosmology *cosmo, double dim[3],
+                            struct part **parts, struct gpart **gparts,
+                            size_t *Ngas, size_t *Ngparts, int *flag_entropy,
+                            const int with_hydro, const int with_gravity,
+                            const int with_cosmology, const int nodeID,
+                            const int nr_nodes, const int nr_threads,
+                            const int dry_run) {
+
+  if (!with_hydro && !with_gravity)
+    error("Synthetic ICs need hydrodynamics or gravity to be switched on.");
+  if (with_hydro && ics->gas_internal_energy == 0. &&
+      hydro_props->initial_internal_energy == 0.)
+    error(
+        "Synthetic ICs with gas need SyntheticICs:gas_internal_energy or "
+        "SPH:initial_temperature.");
+
+  const long long n = ics->particles_per_dim;
+  const long long N = n * n * n;
+  const double L = ics->box_size;
+  const double spacing = L / n;
+  dim[0] = dim[1] = dim[2] = L;
+  *flag_entropy = 0;
+
+  /* Our share of the lattice */
+  const long long first = N * nodeID / nr_nodes;
+  const long long last = N * (nodeID + 1) / nr_nodes;
+  const size_t count = last - first;
+  const size_t Ndm = with_gravity ? count : 0;
+  *Ngas = with_hydro ? count : 0;
+  *Ngparts = with_gravity ? Ndm + *Ngas : 0;
+
+  /* Allocate memory to store the particles */
+  *parts = NULL;
+  *gparts = NULL;
+  if (with_hydro) {
+    if (swift_memalign("parts", (void **)parts, part_align,
+                       *Ngas * sizeof(struct part)) != 0)
+      error("Error while allocating memory for SPH particles");
+    bzero(*parts, *Ngas * sizeof(struct part));
+  }
+  if (with_gravity) {
+    if (swift_memalign("gparts", (void **)gparts, gpart_align,
+                       *Ngparts * sizeof(struct gpart)) != 0)
+      error("Error while allocating memory for gravity particles");
+    bzero(*gparts, *Ngparts * sizeof(struct gpart));
+  }
+  if (dry_run) return;
+
+  /* Draw the plane waves, with more power on large scales. Each rank draws
+   * the same ones. */
+  const int num_modes = ics->perturbation_modes;
+  struct synthetic_ics_mode *modes = NULL;
+  if (num_modes > 0) {
+    modes = (struct synthetic_ics_mode *)malloc(
+        num_modes * sizeof(struct synthetic_ics_mode));
+    if (modes == NULL) error("Failed to allocate the displacement modes.");
+  }
+  const int n_max = max(1, (int)(n / synthetic_ics_min_wavelength));
+  double norm2 = 0.;
+  for (int m = 0; m < num_modes; m++) {
+    struct synthetic_ics_mode *mode = &modes[m];
+    int nk[3] = {0, 0, 0};
+    for (int attempt = 0; nk[0] == 0 && nk[1] == 0 && nk[2] == 0; attempt++)
+      for (int k = 0; k < 3; k++)
+        nk[k] = (int)floor(
+                    (2 * n_max + 1) *
+                    synthetic_ics_random(ics, m + attempt * num_modes,
+                                         synthetic_ics_random_mode + k)) -
+                n_max;
+    const double nk_norm = sqrt(nk[0] * nk[0] + nk[1] * nk[1] + nk[2] * nk[2]);
+    for (int k = 0; k < 3; k++) {
+      mode->k[k] = 2. * M_PI * nk[k] / L;
+      mode->amplitude[k] = nk[k] / (nk_norm * nk_norm);
+    }
+    mode->phase = 2. * M_PI *
+                  synthetic_ics_random(ics, m, synthetic_ics_random_mode + 3);
+    norm2 += 0.5 / (nk_norm * nk_norm);
+  }
+
+  /* Normalise the displacements to the requested rms value */
+  const double amplitude =
+      num_modes > 0 ? ics->perturbation_amplitude * spacing / sqrt(norm2) : 0.;
+  for (int m = 0; m < num_modes; m++)
+    for (int k = 0; k < 3; k++) modes[m].amplitude[k] *= amplitude;
+
+  /* Draw the centres of the clumps */
+  double(*centres)[3] = NULL;
+  if (ics->clump_fraction > 0.) {
+    centres = (double(*)[3])malloc(ics->num_clumps * 3 * sizeof(double));
+    if (centres == NULL) error("Failed to allocate the clump centres.");
+    for (int c = 0; c < ics->num_clumps; c++)
+      for (int k = 0; k < 3; k++)
+        centres[c][k] =
+            L * synthetic_ics_random(ics, c, synthetic_ics_random_centre + k);
+  }
+
+  /* Growing-mode velocities: v_pec = a H f(a) psi with f ~ Omega_m(a)^0.55 */
+  double velocity_factor = 0.;
+  if (with_cosmology) {
+    const double Omega_m_a = (cosmo->Omega_cdm + cosmo->Omega_b) *
+                             cosmo->H0 * cosmo->H0 /
+                             (cosmo->a * cosmo->a * cosmo->a * cosmo->H *
+                              cosmo->H);
+    velocity_factor = cosmo->a * cosmo->H * pow(Omega_m_a, 0.55);
+  }
+
+  struct synthetic_ics_data data;
+  data.ics = ics;
+  data.modes = modes;
+  data.centres = (const double(*)[3])centres;
+  data.first = first;
+  data.spacing = spacing;
+  data.velocity_factor = velocity_factor;
+
+  /* Let's initialise a bit of thread parallelism here */
+  struct threadpool tp;
+  threadpool_init(&tp, nr_threads);
+
+  /* The dark matter sits on the lattice points */
+  if (with_gravity) {
+    data.gparts = *gparts;
+    data.parts = NULL;
+    data.id_offset = N + 1;
+    data.lattice_offset = 0.;
+    data.mass = ics->dm_density * spacing * spacing * spacing;
+    threadpool_map(&tp, synthetic_ics_dm_mapper, *gparts, Ndm,
+                   sizeof(struct gpart), threadpool_auto_chunk_size, &data);
+    io_prepare_dm_gparts(&tp, *gparts, Ndm);
+  }
+
+  /* The gas at the centre of the lattice cells */
+  if (with_hydro) {
+    data.parts = *parts;
+    data.gparts = NULL;
+    data.id_offset = 1;
+    data.lattice_offset = 0.5;
+    data.mass = ics->gas_density * spacing * spacing * spacing;
+    data.eta = hydro_props->eta_neighbours;
+    data.u = ics->gas_internal_energy;
+    threadpool_map(&tp, synthetic_ics_gas_mapper, *parts, *Ngas,
+                   sizeof(struct part), threadpool_auto_chunk_size, &data);
+
+    /* Duplicate the hydro particles into gparts */
+    if (with_gravity)
+      io_duplicate_hydro_gparts(&tp, *parts, *gparts, *Ngas, Ndm);
+  }
+
+  threadpool_clean(&tp);
+  free(modes);
+  free(centres);
+}
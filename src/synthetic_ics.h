@@ -0,0 +1,103 @@
+/*******************************************************************************
+ * This file is part of SWIFT.
+ * Copyright (c) 2026 agent (agent@local)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#ifndef SWIFT_SYNTHETIC_ICS_H
+#define SWIFT_SYNTHETIC_ICS_H
+
+/* Config parameters. */
+#include <config.h>
+
+/* Standard headers. */
+#include <stddef.h>
+
+/* Predefine the structures */
+struct cosmology;
+struct gpart;
+struct hydro_props;
+struct part;
+struct swift_params;
+
+/**
+ * @brief The particle distributions the synthetic ICs can start from.
+ */
+enum synthetic_ics_distribution {
+  synthetic_ics_lattice,
+  synthetic_ics_glass,
+};
+
+/**
+ * @brief Properties of initial conditions generated in memory instead of read
+ * from a file.
+ *
+ * The gas and dark matter particles are put on two interleaved cubic lattices
+ * (optionally randomly displaced to mimic a glass), moved by a Zel'dovich-like
+ * displacement field made of random plane waves and optionally gathered into
+ * Gaussian clumps.
+ */
+struct synthetic_ics {
+
+  /*! Side-length of the (cubic, periodic) box */
+  double box_size;
+
+  /*! Nr of particles of each type along each axis */
+  long long particles_per_dim;
+
+  /*! Un-perturbed distribution of the particles */
+  enum synthetic_ics_distribution distribution;
+
+  /*! Mean (comoving) densities of the gas and of the dark matter */
+  double gas_density, dm_density;
+
+  /*! Internal energy per unit mass of the gas */
+  double gas_internal_energy;
+
+  /*! RMS displacement in units of the inter-particle separation */
+  double perturbation_amplitude;
+
+  /*! Nr of plane waves making up the displacement field */
+  int perturbation_modes;
+
+  /*! Fraction of the particles gathered into clumps */
+  double clump_fraction;
+
+  /*! Nr of clumps */
+  int num_clumps;
+
+  /*! Gaussian radius of the clumps in units of the box size */
+  double clump_radius;
+
+  /*! Seed of the random numbers */
+  long long seed;
+};
+
+/* Function prototypes. */
+void synthetic_ics_init(struct synthetic_ics *ics, struct swift_params *params,
+                        const struct cosmology *cosmo, const int with_cosmology,
+                        const int with_hydro);
+void synthetic_ics_print(const struct synthetic_ics *ics);
+void synthetic_ics_generate(const struct synthetic_ics *ics,
+                            const struct hydro_props *hydro_props,
+                            const struct cosmology *cosmo, double dim[3],
+                            struct part **parts, struct gpart **gparts,
+                            size_t *Ngas, size_t *Ngparts, int *flag_entropy,
+                            const int with_hydro, const int with_gravity,
+                            const int with_cosmology, const int nodeID,
+                            const int nr_nodes, const int nr_threads,
+                            const int dry_run);
+
+#endif /* SWIFT_SYNTHETIC_ICS_H */
@@ -110,7 +110,6 @@ const char *taskID_names[task_type_count] = {
     "bh_swallow_ghost3",
     "fof_self",
     "fof_pair",
-    "neutrino_weight",
     "sink_in",
     "sink_ghost1",
     "sink_ghost2",
@@ -140,7 +139,6 @@ const char *subtaskID_names[task_subtype_count] = {
     "xv",
     "rho",
     "part_swallow",
-    "bpart_merger",
     "gpart",
     "multipole",
     "spart_density",
@@ -1792,9 +1790,6 @@ enum task_categories task_get_category(const struct task *t) {
     case task_type_rt_advance_cell_time:
       return task_category_rt;
 
-    case task_type_neutrino_weight:
-      return task_category_neutrino;
-
     case task_type_self:
     case task_type_pair:
     case task_type_sub_self:
@@ -103,7 +103,6 @@ enum task_types {
   task_type_bh_swallow_ghost3, /* Implicit */
   task_type_fof_self,
   task_type_fof_pair,
-  task_type_neutrino_weight,
   task_type_sink_in,     /* Implicit */
   task_type_sink_ghost1, /* Implicit */
   task_type_sink_ghost2, /* Implicit */
@@ -136,7 +135,6 @@ enum task_subtypes {
   task_subtype_xv,
   task_subtype_rho,
   task_subtype_part_swallow,
-  task_subtype_bpart_merger,
   task_subtype_gpart,
   task_subtype_multipole,
   task_subtype_spart_density,
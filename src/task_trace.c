@@ -0,0 +1,304 @@
+/*******************************************************************************
+ * This file is part of SWIFT.
+ * Copyright (c) 2026 agent (agent@local)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+/* Config parameters. */
+#include <config.h>
+
+/* This object's header. */
+#include "task_trace.h"
+
+/* Standard headers. */
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+
+/* MPI headers. */
+#ifdef WITH_MPI
+#include <mpi.h>
+#endif
+
+/* Local headers. */
+#include "cell.h"
+#include "clocks.h"
+#include "engine.h"
+#include "error.h"
+#include "memuse.h"
+#include "restart.h"
+#include "task.h"
+
+/*! Set by the signal handler when a dump of the task trace is requested. */
+static volatile sig_atomic_t task_trace_signalled = 0;
+
+/**
+ * @brief Allocate the ring buffer of a #task_trace.
+ *
+ * @param trace The #task_trace.
+ * @param size The minimal number of tasks to remember (0 to switch the
+ * tracing off). Rounded up to a power of two.
+ */
+void task_trace_init(struct task_trace *trace, size_t size) {
+
+  trace->entries = NULL;
+  trace->size = 0;
+  trace->count = 0;
+  if (size == 0) return;
+
+  size_t pow2 = 1;
+  while (pow2 < size) pow2 *= 2;
+
+  trace->entries = (struct task_trace_entry *)swift_malloc(
+      "task_trace", pow2 * sizeof(struct task_trace_entry));
+  if (trace->entries == NULL) error("Failed to allocate the task trace.");
+  bzero(trace->entries, pow2 * sizeof(struct task_trace_entry));
+  trace->size = pow2;
+}
+
+/**
+ * @brief Free the memory of a #task_trace.
+ *
+ * @param trace The #task_trace.
+ */
+void task_trace_clean(struct task_trace *trace) {
+
+  if (trace->entries != NULL) swift_free("task_trace", trace->entries);
+  trace->entries = NULL;
+  trace->size = 0;
+  trace->count = 0;
+}
+
+/**
+ * @brief Record a task in a #task_trace.
+ *
+ * @param trace The #task_trace of the runner that ran the task.
+ * @param t The #task.
+ * @param tic When the task started.
+ * @param toc When the task ended.
+ */
+void task_trace_record(struct task_trace *trace, const struct task *t,
+                       const ticks tic, const ticks toc) {
+
+  if (trace->size == 0) return;
+
+  struct task_trace_entry *entry =
+      &trace->entries[trace->count & (trace->size - 1)];
+  const struct cell *ci = t->ci;
+  const struct cell *cj = t->cj;
+
+  entry->tic = tic;
+  entry->toc = toc;
+  entry->flags = t->flags;
+  entry->ci_hydro_count = (ci != NULL) ? ci->hydro.count : 0;
+  entry->cj_hydro_count = (cj != NULL) ? cj->hydro.count : 0;
+  entry->ci_grav_count = (ci != NULL) ? ci->grav.count : 0;
+  entry->cj_grav_count = (cj != NULL) ? cj->grav.count : 0;
+  entry->type = t->type;
+  entry->subtype = t->subtype;
+  entry->single = (cj == NULL);
+
+  trace->count++;
+}
+
+/**
+ * @brief Signal handler requesting a dump of the task trace.
+ */
+static void task_trace_signal_handler(int sig) { task_trace_signalled = 1; }
+
+/**
+ * @brief Dump the task trace at the end of the current step when the process
+ * receives SIGUSR1.
+ */
+void task_trace_init_signal(void) {
+
+  struct sigaction action;
+  bzero(&action, sizeof(struct sigaction));
+  action.sa_handler = task_trace_signal_handler;
+  sigemptyset(&action.sa_mask);
+  action.sa_flags = SA_RESTART;
+  if (sigaction(SIGUSR1, &action, NULL) != 0)
+    error("Failed to install the SIGUSR1 handler (%s).", strerror(errno));
+}
+
+/**
+ * @brief Has this rank been asked to dump the task trace of the current step?
+ *
+ * That is the case if the process received SIGUSR1 or, on rank 0, if the
+ * "dump_tasks" file exists in the restart directory. As for the "stop" file,
+ * the latter is only checked every Restarts:stop_steps steps. The answer is
+ * combined over the ranks by the end-of-step reduction.
+ *
+ * @param e The #engine.
+ */
+int task_trace_dump_requested(const struct engine *e) {
+
+  if (e->task_trace_size == 0) return 0;
+  if (task_trace_signalled) return 1;
+  return e->nodeID == 0 && e->step % e->restart_stop_steps == 0 &&
+         restart_dump_tasks_now(e->restart_dir, 0);
+}
+
+/**
+ * @brief Dump the task trace of the step that just finished if the
+ * end-of-step reduction found that one was requested or that the step was
+ * slower than the threshold.
+ *
+ * Must be called by all the ranks.
+ *
+ * @param e The #engine.
+ */
+void task_trace_dump_if_requested(struct engine *e) {
+
+  if (!e->task_trace_dump) return;
+
+  task_trace_signalled = 0;
+  e->task_trace_dump = 0;
+  if (e->nodeID == 0) restart_dump_tasks_now(e->restart_dir, 1);
+  task_trace_dump(e, e->step);
+}
+
+/**
+ * @brief Write the tasks of the last step recorded by the runners of this
+ * rank.
+ *
+ * Tasks that fell out of the ring buffers are lost, which is reported.
+ *
+ * @param e The #engine.
+ * @param file The file to write to.
+ * @param rank_prefix Start the lines with the rank (MPI format)?
+ *
+ * @return The number of tasks written.
+ */
+static size_t task_trace_write(const struct engine *e, FILE *file,
+                               const int rank_prefix) {
+
+  size_t written = 0;
+  int truncated = 0;
+
+  for (int k = 0; k < e->nr_threads; k++) {
+    const struct runner *r = &e->runners[k];
+    const struct task_trace *trace = &r->trace;
+    if (trace->count == 0) continue;
+
+    const size_t first =
+        trace->count > trace->size ? trace->count - trace->size : 0;
+    for (size_t n = first; n < trace->count; n++) {
+      const struct task_trace_entry *entry =
+          &trace->entries[n & (trace->size - 1)];
+      if (entry->tic < e->tic_step) continue;
+      if (n == first && first > 0) truncated = 1;
+
+      if (rank_prefix) fprintf(file, " %03d", e->nodeID);
+      fprintf(file, " %i %i %i %i %lli %lli %i %i %i %i", r->cpuid,
+              entry->type, entry->subtype, entry->single,
+              (long long int)entry->tic, (long long int)entry->toc,
+              entry->ci_hydro_count, entry->cj_hydro_count,
+              entry->ci_grav_count, entry->cj_grav_count);
+      if (rank_prefix) fprintf(file, " %lli", entry->flags);
+      fprintf(file, " -1\n");
+      written++;
+    }
+  }
+
+  if (truncated)
+    message(
+        "WARNING: The step ran more tasks than the trace can hold. Only the "
+        "last ones were kept (increase Scheduler:task_trace_size).");
+
+  return written;
+}
+
+/**
+ * @brief Dump the tasks of the last step recorded by the runners into a file
+ * readable by the scripts of tools/task_plots.
+ *
+ * Uses the format of task_dump_all(). The information is written to the file
+ * "task_trace-stepn.dat" where n is the given step value, or
+ * "task_trace_MPI-stepn.dat" if we are running under MPI, in which case all
+ * the ranks write one after the other into the same file.
+ *
+ * @param e The #engine.
+ * @param step The current step.
+ */
+void task_trace_dump(struct engine *e, int step) {
+
+  const ticks tic = getticks();
+
+  /* Need this to convert ticks to seconds. */
+  const unsigned long long cpufreq = clocks_get_cpufreq();
+
+  char dumpfile[40];
+  FILE *file_trace;
+  size_t written = 0;
+
+#ifdef WITH_MPI
+  /* Make sure output file is empty, only on one rank. */
+  snprintf(dumpfile, sizeof(dumpfile), "task_trace_MPI-step%d.dat", step);
+  if (engine_rank == 0) {
+    file_trace = fopen(dumpfile, "w");
+    if (file_trace == NULL)
+      error("Could not create/erase file '%s'.", dumpfile);
+    fclose(file_trace);
+  }
+  MPI_Barrier(MPI_COMM_WORLD);
+
+  /* Each rank appends its tasks in turn */
+  for (int i = 0; i < e->nr_nodes; i++) {
+
+    if (i == engine_rank) {
+
+      file_trace = fopen(dumpfile, "a");
+      if (file_trace == NULL)
+        error("Could not open file '%s' for writing.", dumpfile);
+
+      /* Add some information to help with the plots and conversion of ticks to
+       * seconds. */
+      fprintf(file_trace, " %03d 0 0 0 0 %lld %lld %lld %lld %lld 0 0 %lld\n",
+              engine_rank, (long long int)e->tic_step,
+              (long long int)e->toc_step, e->updates, e->g_updates,
+              e->s_updates, cpufreq);
+      written = task_trace_write(e, file_trace, /*rank_prefix=*/1);
+      fclose(file_trace);
+    }
+
+    MPI_Barrier(MPI_COMM_WORLD);
+  }
+
+#else
+  snprintf(dumpfile, sizeof(dumpfile), "task_trace-step%d.dat", step);
+  file_trace = fopen(dumpfile, "w");
+  if (file_trace == NULL) error("Could not create file '%s'.", dumpfile);
+
+  /* Add some information to help with the plots and conversion of ticks to
+   * seconds. */
+  fprintf(file_trace, " %d %d %d %d %lld %lld %lld %lld %lld %d %lld\n", -2,
+          -1, -1, 1, (unsigned long long)e->tic_step,
+          (unsigned long long)e->toc_step, e->updates, e->g_updates,
+          e->s_updates, 0, cpufreq);
+  written = task_trace_write(e, file_trace, /*rank_prefix=*/0);
+  fclose(file_trace);
+#endif
+
+  if (e->nodeID == 0)
+    message("Step %d took %.3f %s. Wrote the trace of its tasks to '%s'.", step,
+            e->wallclock_time, clocks_getunit(), dumpfile);
+
+  if (e->verbose)
+    message("Wrote %zd tasks, took %.3f %s.", written,
+            clocks_from_ticks(getticks() - tic), clocks_getunit());
+}
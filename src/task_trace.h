@@ -0,0 +1,90 @@
+/*******************************************************************************
+ * This file is part of SWIFT.
+ * Copyright (c) 2026 agent (agent@local)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+#ifndef SWIFT_TASK_TRACE_H
+#define SWIFT_TASK_TRACE_H
+
+/* Config parameters. */
+#include <config.h>
+
+/* Standard headers. */
+#include <stddef.h>
+
+/* Local includes. */
+#include "cycle.h"
+
+/* Predefine the structures */
+struct engine;
+struct task;
+
+/*! Default number of tasks remembered by each runner. */
+#define task_trace_size_default 8192
+
+/**
+ * @brief What we remember about a task that ran.
+ */
+struct task_trace_entry {
+
+  /*! Start and end time of the task */
+  ticks tic, toc;
+
+  /*! The flags of the task */
+  long long flags;
+
+  /*! Nr of #part in the cells of the task */
+  int ci_hydro_count, cj_hydro_count;
+
+  /*! Nr of #gpart in the cells of the task */
+  int ci_grav_count, cj_grav_count;
+
+  /*! Type and sub-type of the task */
+  unsigned char type, subtype;
+
+  /*! Does the task only act on one cell? */
+  char single;
+};
+
+/**
+ * @brief Ring buffer of the last tasks run by a runner.
+ *
+ * Only the runner owning the buffer writes to it, so no locking is needed.
+ * The buffer is read between steps, when the runners are idle.
+ */
+struct task_trace {
+
+  /*! The entries (NULL if the tracing is switched off) */
+  struct task_trace_entry *entries;
+
+  /*! Nr of entries, a power of two */
+  size_t size;
+
+  /*! Nr of tasks recorded so far */
+  size_t count;
+};
+
+/* Function prototypes. */
+void task_trace_init(struct task_trace *trace, size_t size);
+void task_trace_clean(struct task_trace *trace);
+void task_trace_record(struct task_trace *trace, const struct task *t,
+                       const ticks tic, const ticks toc);
+void task_trace_init_signal(void);
+int task_trace_dump_requested(const struct engine *e);
+void task_trace_dump_if_requested(struct engine *e);
+void task_trace_dump(struct engine *e, int step);
+
+#endif /* SWIFT_TASK_TRACE_H */
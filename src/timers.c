@@ -26,14 +26,24 @@
 #include "timers.h"
 
 /* Some standard headers. */
+#include <math.h>
 #include <stdio.h>
+#include <strings.h>
 
 /* Local includes. */
+#include "align.h"
 #include "clocks.h"
 #include "error.h"
+#include "memuse.h"
 
-/* The timers. */
-ticks timers[timer_count];
+/* The timers of the current thread. */
+__thread struct timers_thread *timers_local = NULL;
+
+/* The timers of all the threads that used them so far. */
+static struct timers_thread *timers_threads = NULL;
+
+/* Number of threads in the list. */
+static int timers_nr_threads = 0;
 
 /* Timer names. */
 const char* timers_names[timer_count] = {
@@ -109,6 +119,9 @@ const char* timers_names[timer_count] = {
     "do_extra_ghost",
     "do_stars_ghost",
     "do_black_holes_ghost",
+    "do_black_holes_swallow_ghost",
+    "do_gas_swallow",
+    "do_bh_swallow",
     "dorecv_part",
     "dorecv_gpart",
     "dorecv_spart",
@@ -142,35 +155,170 @@ const char* timers_names[timer_count] = {
     "rt_tchem",
     "rt_advance_cell_time",
     "rt_collect_times",
+    "do_sync",
 };
 
 /* File to store the timers */
 static FILE* timers_file;
 
+/* File to store the per-step timer statistics as JSON lines */
+static FILE* timers_json_file;
+
+/**
+ * @brief Allocate the timers of the calling thread and add them to the list
+ * of all the threads' timers.
+ *
+ * Called by #timers_toc() the first time a thread uses a timer.
+ *
+ * @return The timers of the calling thread.
+ */
+struct timers_thread* timers_register_thread(void) {
+
+  struct timers_thread* local = NULL;
+  if (swift_memalign("timers", (void**)&local, SWIFT_CACHE_ALIGNMENT,
+                     sizeof(struct timers_thread)) != 0)
+    error("Failed to allocate the timers of a thread.");
+  bzero(local, sizeof(struct timers_thread));
+
+  /* Push to the front of the list */
+  struct timers_thread* head;
+  do {
+    head = timers_threads;
+    local->next = head;
+  } while (atomic_cas(&timers_threads, head, local) != head);
+  atomic_inc(&timers_nr_threads);
+
+  timers_local = local;
+  return local;
+}
+
 /**
  * @brief Re-set all the timers.
  *
+ * Must not be called while other threads are timing something.
  */
 void timers_reset_all(void) {
 
-  for (int k = 0; k < timer_count; k++) timers[k] = 0;
+  for (struct timers_thread* t = timers_threads; t != NULL; t = t->next)
+    bzero(t->entries, sizeof(t->entries));
+}
+
+/**
+ * @brief Combine the statistics of a timer over all the threads.
+ *
+ * @param k The timer.
+ * @param merged (return) The combined statistics.
+ * @param hist (return) The combined histogram of the call durations.
+ */
+static void timers_merge(const int k, struct timers_entry* merged,
+                         unsigned long long hist[timers_hist_bins]) {
+
+  bzero(merged, sizeof(struct timers_entry));
+  bzero(hist, timers_hist_bins * sizeof(unsigned long long));
+
+  for (struct timers_thread* t = timers_threads; t != NULL; t = t->next) {
+    const struct timers_entry* entry = &t->entries[k];
+    if (entry->calls == 0) continue;
+
+    if (merged->calls == 0 || entry->min < merged->min)
+      merged->min = entry->min;
+    if (entry->max > merged->max) merged->max = entry->max;
+    merged->total += entry->total;
+    merged->calls += entry->calls;
+    for (int b = 0; b < timers_hist_bins; b++) hist[b] += entry->hist[b];
+  }
 }
 
 /**
- * @brief Outputs all the timers to the timers dump file.
+ * @brief Estimate a percentile of the call durations of a timer from its
+ * histogram.
+ *
+ * The durations are assumed to be uniformly distributed within each bin. The
+ * result is accurate to the width of a bin, i.e. ~20%.
+ *
+ * @param merged The statistics of the timer.
+ * @param hist The histogram of the call durations.
+ * @param q The percentile, as a fraction in [0, 1].
+ *
+ * @return The percentile in ticks.
+ */
+static double timers_percentile(const struct timers_entry* merged,
+                                const unsigned long long hist[timers_hist_bins],
+                                const double q) {
+
+  const double target = q * merged->calls;
+  double count = 0.;
+  for (int b = 0; b < timers_hist_bins; b++) {
+    if (hist[b] == 0) continue;
+
+    if (count + hist[b] >= target) {
+
+      /* Edges of the bin (see timers_hist_bin()) */
+      double lower, upper;
+      if (b < timers_hist_sub_bins) {
+        lower = b;
+        upper = b + 1;
+      } else {
+        const int shift = b / timers_hist_sub_bins - 1;
+        const int sub = b % timers_hist_sub_bins;
+        lower = ldexp(timers_hist_sub_bins + sub, shift);
+        upper = ldexp(timers_hist_sub_bins + sub + 1, shift);
+      }
+
+      const double value = lower + (target - count) / hist[b] * (upper - lower);
+      return fmin(fmax(value, merged->min), merged->max);
+    }
+    count += hist[b];
+  }
+  return merged->max;
+}
+
+/**
+ * @brief Outputs all the timers to the timers dump files.
+ *
+ * The timers of all the threads are combined. The text file gets the total
+ * time spent in each timer, the JSON file one line per step with the number
+ * of calls, the total, min, max and percentiles of the call durations of
+ * every timer used in this step.
  *
  * @param step The current step.
  */
 void timers_print(int step) {
+
+  struct timers_entry merged;
+  unsigned long long hist[timers_hist_bins];
+
   fprintf(timers_file, "%d\t", step);
-  for (int k = 0; k < timer_count; k++)
-    fprintf(timers_file, "%25.3f ", clocks_from_ticks(timers[k]));
+  fprintf(timers_json_file,
+          "{\"step\": %d, \"threads\": %d, \"unit\": \"%s\", \"timers\": {",
+          step, timers_nr_threads, clocks_getunit());
+
+  int first = 1;
+  for (int k = 0; k < timer_count; k++) {
+    timers_merge(k, &merged, hist);
+    fprintf(timers_file, "%25.3f ", clocks_from_ticks(merged.total));
+
+    if (merged.calls == 0) continue;
+    fprintf(timers_json_file,
+            "%s\"%s\": {\"calls\": %lld, \"total\": %.6g, \"min\": %.6g, "
+            "\"max\": %.6g, \"p50\": %.6g, \"p90\": %.6g, \"p99\": %.6g}",
+            first ? "" : ", ", timers_names[k], merged.calls,
+            clocks_from_ticks(merged.total), clocks_from_ticks(merged.min),
+            clocks_from_ticks(merged.max),
+            clocks_from_ticks(timers_percentile(&merged, hist, 0.5)),
+            clocks_from_ticks(timers_percentile(&merged, hist, 0.9)),
+            clocks_from_ticks(timers_percentile(&merged, hist, 0.99)));
+    first = 0;
+  }
+
   fprintf(timers_file, "\n");
   fflush(timers_file);
+  fprintf(timers_json_file, "}}\n");
+  fflush(timers_json_file);
 }
 
 /**
- * @brief Opens the file to contain the timers info and print a header
+ * @brief Opens the files to contain the timers info and print a header
  *
  * @param rank The MPI rank of the file.
  */
@@ -185,9 +333,16 @@ void timers_open_file(int rank) {
   for (int k = 0; k < timer_count; k++)
     fprintf(timers_file, "%25s ", timers_names[k]);
   fprintf(timers_file, "\n");
+
+  sprintf(buff, "timers_%d.jsonl", rank);
+  timers_json_file = fopen(buff, "w");
+  if (timers_json_file == NULL) error("Could not create file '%s'.", buff);
 }
 
 /**
- * @brief Close the file containing the timer info.
+ * @brief Close the files containing the timer info.
  */
-void timers_close_file(void) { fclose(timers_file); }
+void timers_close_file(void) {
+  fclose(timers_file);
+  fclose(timers_json_file);
+}
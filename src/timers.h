@@ -29,6 +29,7 @@
 #include "atomic.h"
 #include "cycle.h"
 #include "inline.h"
+#include "intrinsics.h"
 
 /**
  * @brief The timers themselves.
@@ -109,6 +110,9 @@ enum {
   timer_do_extra_ghost,
   timer_do_stars_ghost,
   timer_do_black_holes_ghost,
+  timer_do_black_holes_swallow_ghost,
+  timer_do_gas_swallow,
+  timer_do_bh_swallow,
   timer_dorecv_part,
   timer_dorecv_gpart,
   timer_dorecv_spart,
@@ -142,15 +146,82 @@ enum {
   timer_do_rt_tchem,
   timer_do_rt_advance_cell_time,
   timer_do_rt_collect_times,
+  timer_do_sync,
   timer_count,
 };
 
-/* The timers. */
-extern ticks timers[timer_count];
+/*! Number of histogram bins per power of two of the timer durations. */
+#define timers_hist_sub_bins_log2 2
+#define timers_hist_sub_bins (1 << timers_hist_sub_bins_log2)
+
+/*! Total number of histogram bins, enough for any 64-bit duration. */
+#define timers_hist_bins (64 * timers_hist_sub_bins)
+
+/**
+ * @brief The statistics gathered by one timer in one thread.
+ */
+struct timers_entry {
+
+  /*! Total time spent in this timer. */
+  ticks total;
+
+  /*! Shortest call. */
+  ticks min;
+
+  /*! Longest call. */
+  ticks max;
+
+  /*! Number of calls. */
+  long long calls;
+
+  /*! Histogram of the call durations, used for the percentiles. */
+  unsigned int hist[timers_hist_bins];
+};
+
+/**
+ * @brief The timers of one thread.
+ *
+ * Each thread only ever writes to its own copy. The copies are chained
+ * together so that they can be reset and merged by the main thread between
+ * steps.
+ */
+struct timers_thread {
+
+  /*! The timers themselves. */
+  struct timers_entry entries[timer_count];
+
+  /*! Next thread in the list of all the threads' timers. */
+  struct timers_thread *next;
+};
+
+/* The timers of the current thread. */
+extern __thread struct timers_thread *timers_local;
 
 /* The timer names. */
 extern const char *timers_names[];
 
+struct timers_thread *timers_register_thread(void);
+
+/**
+ * @brief Histogram bin of a duration.
+ *
+ * Durations smaller than #timers_hist_sub_bins ticks get their own bin, the
+ * others are binned logarithmically with #timers_hist_sub_bins bins per power
+ * of two.
+ *
+ * @param d The duration.
+ */
+__attribute__((always_inline, const)) INLINE static int timers_hist_bin(
+    const ticks d) {
+
+  if (d < timers_hist_sub_bins) return (int)d;
+
+  const int msb = 63 - intrinsics_clzll(d);
+  const int shift = msb - timers_hist_sub_bins_log2;
+  const int sub = (int)(d >> shift) - timers_hist_sub_bins;
+  return (shift + 1) * timers_hist_sub_bins + sub;
+}
+
 /* Define the timer macros. */
 #ifdef SWIFT_USE_TIMERS
 #define TIMER_TIC const ticks tic = getticks();
@@ -159,7 +230,16 @@ extern const char *timers_names[];
 #define TIMER_TOC2(t) timers_toc(t, tic2)
 INLINE static ticks timers_toc(unsigned int t, ticks tic) {
   const ticks d = (getticks() - tic);
-  atomic_add(&timers[t], d);
+
+  struct timers_thread *local = timers_local;
+  if (local == NULL) local = timers_register_thread();
+
+  struct timers_entry *entry = &local->entries[t];
+  entry->total += d;
+  if (entry->calls == 0 || d < entry->min) entry->min = d;
+  if (d > entry->max) entry->max = d;
+  entry->calls++;
+  entry->hist[timers_hist_bin(d)]++;
   return d;
 }
 #else
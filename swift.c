@@ -1005,10 +1005,16 @@ int main(int argc, char *argv[]) {
     }
 
     /* Read particles and space information from ICs */
+    const int synthetic_ICs =
+        parser_get_opt_param_int(params, "InitialConditions:synthetic", 0);
     char ICfileName[200] = "";
-    parser_get_param_string(params, "InitialConditions:file_name", ICfileName);
+    if (!synthetic_ICs)
+      parser_get_param_string(params, "InitialConditions:file_name",
+                              ICfileName);
     const int periodic =
-        parser_get_param_int(params, "InitialConditions:periodic");
+        synthetic_ICs
+            ? parser_get_opt_param_int(params, "InitialConditions:periodic", 1)
+            : parser_get_param_int(params, "InitialConditions:periodic");
     const int replicate =
         parser_get_opt_param_int(params, "InitialConditions:replicate", 1);
     clean_smoothing_length_values = parser_get_opt_param_int(
@@ -1175,8 +1181,16 @@ int main(int argc, char *argv[]) {
       bzero(&pow_data, sizeof(struct power_spectrum_data));
     }
 
+    /* Initialise the generator of synthetic ICs */
+    struct synthetic_ics synthetic_ics_props;
+    if (synthetic_ICs)
+      synthetic_ics_init(&synthetic_ics_props, params, &cosmo, with_cosmology,
+                         with_hydro);
+
     /* Be verbose about what happens next */
-    if (myrank == 0) message("Reading ICs from file '%s'", ICfileName);
+    if (myrank == 0 && synthetic_ICs) synthetic_ics_print(&synthetic_ics_props);
+    if (myrank == 0 && !synthetic_ICs)
+      message("Reading ICs from file '%s'", ICfileName);
     if (myrank == 0 && cleanup_h)
       message("Cleaning up h-factors (h=%f)", cosmo.h);
     if (myrank == 0 && cleanup_sqrt_a)
@@ -1192,39 +1206,48 @@ int main(int argc, char *argv[]) {
     ic_info_init(&ics_metadata, params);
 
     if (myrank == 0) clocks_gettime(&tic);
+    if (synthetic_ICs) {
+      synthetic_ics_generate(&synthetic_ics_props, &hydro_properties, &cosmo,
+                             dim, &parts, &gparts, &Ngas, &Ngpart,
+                             &flag_entropy_ICs, with_hydro, with_gravity,
+                             with_cosmology, myrank, nr_nodes, nr_threads,
+                             dry_run);
+    } else {
 #if defined(HAVE_HDF5)
 #if defined(WITH_MPI)
 #if defined(HAVE_PARALLEL_HDF5)
-    read_ic_parallel(ICfileName, &us, dim, &parts, &gparts, &sinks, &sparts,
+      read_ic_parallel(ICfileName, &us, dim, &parts, &gparts, &sinks, &sparts,
+                       &bparts, &Ngas, &Ngpart, &Ngpart_background, &Nnupart,
+                       &Nsink, &Nspart, &Nbpart, &flag_entropy_ICs, with_hydro,
+                       with_gravity, with_sinks, with_stars, with_black_holes,
+                       with_cosmology, cleanup_h, cleanup_sqrt_a, cosmo.h,
+                       cosmo.a, myrank, nr_nodes, MPI_COMM_WORLD, MPI_INFO_NULL,
+                       nr_threads, dry_run, remap_ids, &ics_metadata);
+#else
+      read_ic_serial(ICfileName, &us, dim, &parts, &gparts, &sinks, &sparts,
                      &bparts, &Ngas, &Ngpart, &Ngpart_background, &Nnupart,
                      &Nsink, &Nspart, &Nbpart, &flag_entropy_ICs, with_hydro,
                      with_gravity, with_sinks, with_stars, with_black_holes,
                      with_cosmology, cleanup_h, cleanup_sqrt_a, cosmo.h,
                      cosmo.a, myrank, nr_nodes, MPI_COMM_WORLD, MPI_INFO_NULL,
                      nr_threads, dry_run, remap_ids, &ics_metadata);
-#else
-    read_ic_serial(ICfileName, &us, dim, &parts, &gparts, &sinks, &sparts,
-                   &bparts, &Ngas, &Ngpart, &Ngpart_background, &Nnupart,
-                   &Nsink, &Nspart, &Nbpart, &flag_entropy_ICs, with_hydro,
-                   with_gravity, with_sinks, with_stars, with_black_holes,
-                   with_cosmology, cleanup_h, cleanup_sqrt_a, cosmo.h, cosmo.a,
-                   myrank, nr_nodes, MPI_COMM_WORLD, MPI_INFO_NULL, nr_threads,
-                   dry_run, remap_ids, &ics_metadata);
 #endif
 #else
-    read_ic_single(ICfileName, &us, dim, &parts, &gparts, &sinks, &sparts,
-                   &bparts, &Ngas, &Ngpart, &Ngpart_background, &Nnupart,
-                   &Nsink, &Nspart, &Nbpart, &flag_entropy_ICs, with_hydro,
-                   with_gravity, with_sinks, with_stars, with_black_holes,
-                   with_cosmology, cleanup_h, cleanup_sqrt_a, cosmo.h, cosmo.a,
-                   nr_threads, dry_run, remap_ids, &ics_metadata);
+      read_ic_single(ICfileName, &us, dim, &parts, &gparts, &sinks, &sparts,
+                     &bparts, &Ngas, &Ngpart, &Ngpart_background, &Nnupart,
+                     &Nsink, &Nspart, &Nbpart, &flag_entropy_ICs, with_hydro,
+                     with_gravity, with_sinks, with_stars, with_black_holes,
+                     with_cosmology, cleanup_h, cleanup_sqrt_a, cosmo.h,
+                     cosmo.a, nr_threads, dry_run, remap_ids, &ics_metadata);
 #endif
 #endif
+    }
 
     if (myrank == 0) {
       clocks_gettime(&toc);
-      message("Reading initial conditions took %.3f %s.",
-              clocks_diff(&tic, &toc), clocks_getunit());
+      message("%s initial conditions took %.3f %s.",
+              synthetic_ICs ? "Generating" : "Reading", clocks_diff(&tic, &toc),
+              clocks_getunit());
       fflush(stdout);
     }
 
@@ -1583,7 +1606,7 @@ int main(int argc, char *argv[]) {
       if (with_power)
         calc_all_power_spectra(e.power_data, e.s, &e.threadpool, e.verbose);
 
-      engine_dump_snapshot(&e);
+      engine_dump_snapshot(&e, engine_drift_types_all);
     }
 
     /* Dump initial state statistics, if not working with an output list */
@@ -1675,6 +1698,9 @@ int main(int argc, char *argv[]) {
     /* Print the timers. */
     if (with_verbose_timers) timers_print(e.step);
 
+    /* Dump the last tasks if the step was slow or if we were asked to. */
+    task_trace_dump_if_requested(&e);
+
     /* Shall we write some check-point files?
      * Note that this was already done by engine_step() if force_stop is set */
     if (e.restart_onexit && e.step - 1 == nsteps && !force_stop)
@@ -1760,11 +1786,12 @@ int main(int argc, char *argv[]) {
 
     fprintf(e.file_timesteps,
             "  %6d %14e %12.7f %12.7f %14e %4d %4d %12lld %12lld %12lld %12lld"
-            " %12lld %21.3f %6d %17.3f\n",
+            " %12lld %21.3f %6d %17.3f %19.3f %19.3f %19.3f %19.3f\n",
             e.step, e.time, e.cosmology->a, e.cosmology->z, e.time_step,
             e.min_active_bin, e.max_active_bin, e.updates, e.g_updates,
             e.s_updates, e.sink_updates, e.b_updates, e.wallclock_time,
-            e.step_props, dead_time);
+            e.step_props, dead_time, e.global_critical_path, e.global_work,
+            e.global_idle_max, e.global_mpi_wait);
     fflush(e.file_timesteps);
 
     /* Print information to the SFH logger */
@@ -1774,6 +1801,9 @@ int main(int argc, char *argv[]) {
     }
   }
 
+  /* Where did the time go? */
+  engine_report_phase_times(&e);
+
   /* Write final output. */
   if (!force_stop && nsteps == -2) {
 
@@ -1826,7 +1856,7 @@ int main(int argc, char *argv[]) {
           !e.stf_this_timestep)
         velociraptor_invoke(&e, /*linked_with_snap=*/1);
 #endif
-      engine_dump_snapshot(&e);
+      engine_dump_snapshot(&e, engine_drift_types_all);
 #ifdef HAVE_VELOCIRAPTOR
       if (with_structure_finding && e.snapshot_invoke_stf &&
           e.s->gpart_group_data)
@@ -1880,6 +1910,7 @@ int main(int argc, char *argv[]) {
   if (with_power) power_clean(e.power_data);
   extra_io_clean(e.io_extra_props);
   engine_clean(&e, /*fof=*/0, restart);
+  swift_shared_clean();
   free(params);
   if (restart) free(refparams);
   free(output_options);
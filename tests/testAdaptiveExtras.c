@@ -0,0 +1,255 @@
+/*******************************************************************************
+ * This file is part of SWIFT.
+ * Copyright (C) 2026 agent (agent@local)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+/* Config parameters. */
+#include <config.h>
+
+/* System includes. */
+#include <fenv.h>
+
+/* Local headers. */
+#include "swift.h"
+
+#define NUM_PARTS 20000
+#define NUM_ROUNDS 4
+#define NUM_THREADS 4
+#define NUM_EXTRA 20
+#define BOX_SIZE 1.
+
+/**
+ * @brief Is a position inside a #cell?
+ */
+int in_cell(const struct cell *c, const double x[3]) {
+  return x[0] >= c->loc[0] && x[0] <= c->loc[0] + c->width[0] &&
+         x[1] >= c->loc[1] && x[1] <= c->loc[1] + c->width[1] &&
+         x[2] >= c->loc[2] && x[2] <= c->loc[2] + c->width[2];
+}
+
+/**
+ * @brief Find the first leaf below a #cell.
+ */
+struct cell *first_leaf(struct cell *c) {
+  while (c->split) {
+    int k = 0;
+    while (c->progeny[k] == NULL) k++;
+    c = c->progeny[k];
+  }
+  return c;
+}
+
+/**
+ * @brief Check that the real and extra particles of each top-level cell are
+ * where the cell says they are.
+ *
+ * @param s The #space.
+ * @param nr_real_sparts The number of #spart created so far.
+ * @param nr_real_gparts The number of real #gpart.
+ */
+void check_cells(const struct space *s, const size_t nr_real_sparts,
+                 const size_t nr_real_gparts) {
+
+  size_t count_sparts = 0, count_total_sparts = 0;
+  size_t count_gparts = 0, count_total_gparts = 0;
+
+  for (int k = 0; k < s->nr_cells; k++) {
+    const struct cell *c = &s->cells_top[k];
+
+    for (int i = 0; i < c->stars.count_total; i++) {
+      const struct spart *sp = &c->stars.parts[i];
+      const int extra = (sp->time_bin == time_bin_not_created);
+      if (i < c->stars.count && (extra || !in_cell(c, sp->x)))
+        error("Cell %d: spart %d is not a real one of this cell.", k, i);
+      if (i >= c->stars.count && !extra)
+        error("Cell %d: spart %d is not an extra one.", k, i);
+    }
+
+    for (int i = 0; i < c->grav.count_total; i++) {
+      const struct gpart *gp = &c->grav.parts[i];
+      const int extra = (gp->time_bin == time_bin_not_created);
+      if (i < c->grav.count && (extra || !in_cell(c, gp->x)))
+        error("Cell %d: gpart %d is not a real one of this cell.", k, i);
+      if (i >= c->grav.count && !extra)
+        error("Cell %d: gpart %d is not an extra one.", k, i);
+    }
+
+    count_sparts += c->stars.count;
+    count_total_sparts += c->stars.count_total;
+    count_gparts += c->grav.count;
+    count_total_gparts += c->grav.count_total;
+  }
+
+  if (count_sparts != nr_real_sparts)
+    error("Wrong number of real sparts (%zd vs. %zd).", count_sparts,
+          nr_real_sparts);
+  if (count_total_sparts != s->nr_sparts)
+    error("Cells do not cover all the sparts (%zd vs. %zd).",
+          count_total_sparts, s->nr_sparts);
+  if (count_gparts != nr_real_gparts)
+    error("Wrong number of real gparts (%zd vs. %zd).", count_gparts,
+          nr_real_gparts);
+  if (count_total_gparts != s->nr_gparts)
+    error("Cells do not cover all the gparts (%zd vs. %zd).",
+          count_total_gparts, s->nr_gparts);
+}
+
+int main(int argc, char *argv[]) {
+
+  /* Initialize CPU frequency, this also starts time. */
+  unsigned long long cpufreq = 0;
+  clocks_set_cpufreq(cpufreq);
+
+/* Choke on FPEs */
+#ifdef HAVE_FE_ENABLE_EXCEPT
+  feenableexcept(FE_DIVBYZERO | FE_INVALID | FE_OVERFLOW);
+#endif
+
+  /* Get some randomness going */
+  const int seed = time(NULL);
+  message("Seed = %d", seed);
+  srand(seed);
+
+  /* A uniform distribution of dark matter */
+  struct gpart *gparts = NULL;
+  if (swift_memalign("gparts", (void **)&gparts, gpart_align,
+                     NUM_PARTS * sizeof(struct gpart)) != 0)
+    error("Failed to allocate the gparts.");
+  bzero(gparts, NUM_PARTS * sizeof(struct gpart));
+  for (int i = 0; i < NUM_PARTS; i++) {
+    for (int k = 0; k < 3; k++)
+      gparts[i].x[k] = random_uniform(0., 1.) * BOX_SIZE;
+    gparts[i].mass = 1.f;
+    gparts[i].epsilon = 1e-3;
+    gparts[i].id_or_neg_offset = i + 1;
+    gparts[i].type = swift_type_dark_matter;
+    gparts[i].time_bin = 1;
+  }
+
+  struct swift_params params;
+  parser_init("", &params);
+  parser_set_param(&params, "Scheduler:max_top_level_cells:4");
+  parser_set_param(&params, "Scheduler:cell_split_size:100");
+  parser_set_param(&params, "Scheduler:cell_extra_sparts:20");
+  parser_set_param(&params, "Scheduler:cell_extra_gparts:200");
+  parser_set_param(&params, "Scheduler:adaptive_extras:1");
+
+  struct cosmology cosmo;
+  cosmology_init_no_cosmo(&cosmo);
+
+  struct gravity_props grav_props;
+  bzero(&grav_props, sizeof(struct gravity_props));
+
+  /* A space with star formation */
+  struct space s;
+  double dim[3] = {BOX_SIZE, BOX_SIZE, BOX_SIZE};
+  bzero(&s, sizeof(struct space));
+  space_init(&s, &params, &cosmo, dim, /*hydro_properties=*/NULL,
+             /*parts=*/NULL, gparts, /*sinks=*/NULL, /*sparts=*/NULL,
+             /*bparts=*/NULL, /*Npart=*/0, NUM_PARTS, /*Nsink=*/0,
+             /*Nspart=*/0, /*Nbpart=*/0, /*Nnupart=*/0, /*periodic=*/0,
+             /*replicate=*/1, /*remap_ids=*/0, /*generate_gas_in_ics=*/0,
+             /*hydro=*/0, /*gravity=*/1, /*star_formation=*/1,
+             /*with_sink=*/0, /*with_DM=*/1, /*with_DM_background=*/0,
+             /*neutrinos=*/0, /*verbose=*/0, /*dry_run=*/0, /*nr_nodes=*/1);
+
+  /* A minimal engine for the space to use */
+  struct engine e;
+  bzero(&e, sizeof(struct engine));
+  e.nodeID = 0;
+  e.nr_nodes = 1;
+  e.ti_current = 0;
+  e.min_active_bin = 1;
+  e.gravity_properties = &grav_props;
+  e.s = &s;
+  s.e = &e;
+  threadpool_init(&e.threadpool, NUM_THREADS);
+
+  /* Cells per thread buffer, as in engine_config() */
+  s.cells_sub =
+      (struct cell **)calloc(NUM_THREADS + 1, sizeof(struct cell *));
+  s.multipoles_sub = (struct gravity_tensors **)calloc(
+      NUM_THREADS + 1, sizeof(struct gravity_tensors *));
+
+  space_rebuild(&s, /*repartitioned=*/0, /*verbose=*/0);
+  space_split(&s, /*verbose=*/0);
+  check_cells(&s, 0, NUM_PARTS);
+
+  size_t nr_real_sparts = 0, nr_real_gparts = NUM_PARTS;
+  long long next_id = 1;
+  int *demand = (int *)malloc(s.nr_cells * sizeof(int));
+  if (demand == NULL) error("Failed to allocate the demand of the cells.");
+
+  for (int n = 0; n < NUM_ROUNDS; n++) {
+
+    /* Form stars in a few cells until they run out of slots */
+    for (int k = 0; k < s.nr_cells; k++) {
+      demand[k] = 0;
+      if ((k + n) % 5 != 0) continue;
+
+      struct cell *leaf = first_leaf(&s.cells_top[k]);
+      while (1) {
+        struct spart *sp = cell_add_spart(&e, leaf);
+        if (sp == NULL) break;
+        struct gpart *gp = cell_add_gpart(&e, leaf);
+        if (gp == NULL) error("Cell %d ran out of gparts before sparts.", k);
+
+        /* Link them up as cell_spawn_new_spart_from_part() does */
+        sp->id = next_id++;
+        sp->mass = 1.f;
+        sp->gpart = gp;
+        gp->type = swift_type_stars;
+        gp->id_or_neg_offset = -(sp - s.sparts);
+        gp->mass = sp->mass;
+        gp->epsilon = 1e-3;
+        nr_real_sparts++;
+        nr_real_gparts++;
+        demand[k]++;
+      }
+
+      /* The last request failed */
+      demand[k]++;
+    }
+
+    space_rebuild(&s, /*repartitioned=*/0, /*verbose=*/0);
+    space_split(&s, /*verbose=*/0);
+    check_cells(&s, nr_real_sparts, nr_real_gparts);
+
+    /* The cells that ran out must have been given more slots */
+    int nr_grown = 0;
+    for (int k = 0; k < s.nr_cells; k++) {
+      const struct cell *c = &s.cells_top[k];
+      const int nr_extra = c->stars.count_total - c->stars.count;
+      if (nr_extra < NUM_EXTRA)
+        error("Cell %d has only %d extra sparts.", k, nr_extra);
+      if (demand[k] > 0 &&
+          nr_extra < (int)ceilf(s.extras_growth_factor * demand[k]))
+        error("Cell %d used %d slots but only got %d.", k, demand[k],
+              nr_extra);
+      if (nr_extra > NUM_EXTRA) nr_grown++;
+    }
+
+    message("Round %d: %zd stars, %zd extra sparts, %d cells grown.", n,
+            nr_real_sparts, s.nr_extra_sparts, nr_grown);
+  }
+
+  free(demand);
+  space_clean(&s);
+  threadpool_clean(&e.threadpool);
+
+  return 0;
+}
@@ -0,0 +1,157 @@
+/*******************************************************************************
+ * This file is part of SWIFT.
+ * Copyright (C) 2026 agent (agent@local)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+/* Config parameters. */
+#include <config.h>
+
+/* System includes. */
+#include <fenv.h>
+
+/* Local headers. */
+#include "swift.h"
+
+#define NUM_TRIALS 10000
+#define NUM_PARTS 20
+#define BOX_SIZE 10.
+
+/**
+ * @brief Fill a cell with particles in a random sub-region of its volume and
+ * compute its bounding boxes.
+ *
+ * @param c The #cell.
+ * @param x The positions of the particles.
+ * @param h The smoothing lengths of the particles.
+ * @param active Are the particles active?
+ * @param loc The lower corner of the cell.
+ * @param ti_current The current time.
+ */
+void fill_cell(struct cell *c, double x[NUM_PARTS][3], float h[NUM_PARTS],
+               int active[NUM_PARTS], const double loc[3],
+               const integertime_t ti_current) {
+
+  double corner[3];
+  for (int k = 0; k < 3; k++)
+    corner[k] = loc[k] + 0.6 * random_uniform(0., 1.);
+
+  double bbox_min[3], bbox_max[3];
+  double active_bbox_min[3], active_bbox_max[3];
+  cell_bbox_init(bbox_min, bbox_max);
+  cell_bbox_init(active_bbox_min, active_bbox_max);
+  c->hydro.h_max = 0.f;
+  c->hydro.h_max_active = 0.f;
+
+  for (int i = 0; i < NUM_PARTS; i++) {
+    for (int k = 0; k < 3; k++)
+      x[i][k] = corner[k] + 0.4 * random_uniform(0., 1.);
+    h[i] = random_uniform(0.01, 0.3);
+    active[i] = (rand() % 4 == 0);
+
+    c->hydro.h_max = max(c->hydro.h_max, h[i]);
+    cell_bbox_add(bbox_min, bbox_max, x[i]);
+    if (active[i]) {
+      c->hydro.h_max_active = max(c->hydro.h_max_active, h[i]);
+      cell_bbox_add(active_bbox_min, active_bbox_max, x[i]);
+    }
+  }
+
+  cell_hydro_set_bbox(c, bbox_min, bbox_max, active_bbox_min, active_bbox_max,
+                      ti_current);
+}
+
+int main(int argc, char *argv[]) {
+
+  /* Initialize CPU frequency, this also starts time. */
+  unsigned long long cpufreq = 0;
+  clocks_set_cpufreq(cpufreq);
+
+/* Choke on FPEs */
+#ifdef HAVE_FE_ENABLE_EXCEPT
+  feenableexcept(FE_DIVBYZERO | FE_INVALID | FE_OVERFLOW);
+#endif
+
+  /* Get some randomness going */
+  const int seed = time(NULL);
+  message("Seed = %d", seed);
+  srand(seed);
+
+  const integertime_t ti_current = 8;
+
+  struct cell ci, cj;
+  bzero(&ci, sizeof(struct cell));
+  bzero(&cj, sizeof(struct cell));
+  ci.nodeID = engine_rank;
+  cj.nodeID = engine_rank;
+
+  double xi[NUM_PARTS][3], xj[NUM_PARTS][3];
+  float hi[NUM_PARTS], hj[NUM_PARTS];
+  int ai[NUM_PARTS], aj[NUM_PARTS];
+
+  int culled[2] = {0, 0};
+
+  for (int n = 0; n < NUM_TRIALS; n++) {
+
+    /* Neighbours along x, possibly across the periodic boundary */
+    const int periodic = n % 2;
+    const double loc_i[3] = {0., 0., 0.};
+    const double loc_j[3] = {periodic ? BOX_SIZE - 1. : 1., 0., 0.};
+    const double shift[3] = {periodic ? BOX_SIZE : 0., 0., 0.};
+
+    fill_cell(&ci, xi, hi, ai, loc_i, ti_current);
+    fill_cell(&cj, xj, hj, aj, loc_j, ti_current);
+
+    for (int symmetric = 0; symmetric < 2; symmetric++) {
+
+      /* Brute-force search for an interaction */
+      int interact = 0;
+      for (int i = 0; i < NUM_PARTS; i++) {
+        for (int j = 0; j < NUM_PARTS; j++) {
+          float r2 = 0.f;
+          for (int k = 0; k < 3; k++) {
+            const float dx = xi[i][k] + shift[k] - xj[j][k];
+            r2 += dx * dx;
+          }
+          const float h_pair = max(hi[i], hj[j]);
+          const float Hi = kernel_gamma * (symmetric ? h_pair : hi[i]);
+          const float Hj = kernel_gamma * (symmetric ? h_pair : hj[j]);
+          if ((ai[i] && r2 < Hi * Hi) || (aj[j] && r2 < Hj * Hj)) interact = 1;
+        }
+      }
+
+      const int in_range =
+          cell_hydro_pair_in_range(&ci, &cj, shift, symmetric, ti_current);
+
+      if (interact && !in_range)
+        error("Pair culled despite interacting particles (trial %d).", n);
+      if (!in_range) culled[symmetric]++;
+    }
+  }
+
+  message("Culled %d/%d non-symmetric and %d/%d symmetric pairs.", culled[0],
+          NUM_TRIALS, culled[1], NUM_TRIALS);
+  if (culled[0] == 0 || culled[1] == 0) error("No pair was ever culled!");
+
+  /* Out-of-date boxes cannot be used to cull */
+  ci.hydro.ti_bbox = ti_current - 1;
+  const double no_shift[3] = {0., 0., 0.};
+  if (!cell_hydro_pair_in_range(&ci, &cj, no_shift, 0, ti_current))
+    error("Pair culled with out-of-date bounding boxes.");
+
+  message("Done.");
+  return 0;
+}
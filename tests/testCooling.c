@@ -23,6 +23,9 @@
 
 #if defined(CHEMISTRY_EAGLE) && defined(COOLING_EAGLE) && defined(GADGET2_SPH)
 
+#include "cooling/EAGLE/cooling_rates.h"
+#include "cooling/EAGLE/cooling_tables.h"
+
 /*
  * @brief Assign particle density and entropy corresponding to the
  * hydrogen number density and internal energy specified.
@@ -91,6 +94,10 @@ int main(int argc, char **argv) {
   const int n_subcycle = 1000;
   const float integration_tolerance = 0.2;
 
+  /* Tolerance used to compare the solution obtained with the tables
+   * collapsed to the current redshift to the full one */
+  const float collapsed_tolerance = 1e-3;
+
   /* Read the parameter file */
   if (params == NULL) error("Error allocating memory for the parameter file.");
   message("Reading runtime parameters from file '%s'", parametersFileName);
@@ -187,7 +194,8 @@ int main(int argc, char **argv) {
           p.entropy_dt = 0;
           cooling_cool_part(&phys_const, &us, &cosmo, &hydro_properties,
                             &floor_props, &cooling, &p, &xp,
-                            dt_cool / n_subcycle, dt_therm / n_subcycle);
+                            dt_cool / n_subcycle, dt_therm / n_subcycle,
+                            /*time=*/0.);
           xp.entropy_full += p.entropy_dt * dt_therm / n_subcycle;
         }
         du_dt_check = hydro_get_physical_internal_energy_dt(&p, &cosmo);
@@ -198,10 +206,49 @@ int main(int argc, char **argv) {
                        u_cgs, ti_current);
 
         /* compute implicit solution */
+        struct part p_batch = p, p_collapsed = p;
+        struct xpart xp_batch = xp, xp_collapsed = xp;
         cooling_cool_part(&phys_const, &us, &cosmo, &hydro_properties,
-                          &floor_props, &cooling, &p, &xp, dt_cool, dt_therm);
+                          &floor_props, &cooling, &p, &xp, dt_cool, dt_therm,
+                          /*time=*/0.);
         du_dt_implicit = hydro_get_physical_internal_energy_dt(&p, &cosmo);
 
+#ifdef COOLING_BATCH_SIZE
+        /* The batched solver must give exactly the same answer */
+        struct part *batch_parts[1] = {&p_batch};
+        struct xpart *batch_xparts[1] = {&xp_batch};
+        cooling_cool_part_batch(&phys_const, &us, &cosmo, &hydro_properties,
+                                &floor_props, &cooling, batch_parts,
+                                batch_xparts, &dt_cool, &dt_therm,
+                                /*count=*/1, /*time=*/0.);
+        if (hydro_get_physical_internal_energy_dt(&p_batch, &cosmo) !=
+            du_dt_implicit)
+          error(
+              "Batched solution does not match. z %.5e nh_cgs %.5e u_cgs %.5e",
+              cosmo.z, nh_cgs, u_cgs);
+#endif
+
+        /* The fast mode using the tables collapsed to the current redshift
+         * must agree with the full interpolation */
+        cooling.use_collapsed_tables = 1;
+        allocate_collapsed_cooling_tables(&cooling);
+        collapse_cooling_tables(&cooling, cosmo.z);
+        cooling_cool_part(&phys_const, &us, &cosmo, &hydro_properties,
+                          &floor_props, &cooling, &p_collapsed, &xp_collapsed,
+                          dt_cool, dt_therm, /*time=*/0.);
+        free_collapsed_cooling_tables(&cooling);
+        cooling.use_collapsed_tables = 0;
+        const double du_dt_collapsed =
+            hydro_get_physical_internal_energy_dt(&p_collapsed, &cosmo);
+
+        if (fabs((du_dt_collapsed - du_dt_implicit) / du_dt_implicit) >
+                collapsed_tolerance ||
+            (du_dt_implicit == 0.0 && du_dt_collapsed != 0.0))
+          error(
+              "Collapsed tables solution does not match. z %.5e nh_cgs %.5e "
+              "u_cgs %.5e du_dt full %.5e collapsed %.5e",
+              cosmo.z, nh_cgs, u_cgs, du_dt_implicit, du_dt_collapsed);
+
         /* check if the two solutions are consistent */
         if (fabs((du_dt_implicit - du_dt_check) / du_dt_check) >
                 integration_tolerance ||
@@ -87,6 +87,91 @@
  */
 
 #ifdef EOS_PLANETARY
+
+/**
+ * @brief Compare the uniform-grid look-up of a SESAME-style table with the
+ * interpolation in the original table.
+ *
+ * The table is a synthetic ideal-gas-like material built in memory, so that
+ * no table file is needed.
+ */
+void test_SESAME_uniform_grid(void) {
+
+  struct SESAME_params mat;
+  bzero(&mat, sizeof(struct SESAME_params));
+  mat.num_rho = 64;
+  mat.num_T = 64;
+  const int num = mat.num_rho * mat.num_T;
+  mat.table_log_rho = (float *)malloc(mat.num_rho * sizeof(float));
+  mat.table_log_u_rho_T = (float *)malloc(num * sizeof(float));
+  mat.table_P_rho_T = (float *)malloc(num * sizeof(float));
+  mat.table_c_rho_T = (float *)malloc(num * sizeof(float));
+  mat.table_log_s_rho_T = (float *)malloc(num * sizeof(float));
+
+  // Table in the format produced by prepare_table_SESAME()
+  const double gamma = 5. / 3., c_v = 1e3, s_0 = 1e5;
+  for (int i = 0; i < mat.num_rho; i++) {
+    const double rho = 1e-2 * pow(1e4, i / (mat.num_rho - 1.));
+    mat.table_log_rho[i] = log(rho);
+
+    for (int j = 0; j < mat.num_T; j++) {
+      const double T = 1e2 * pow(1e4, j / (mat.num_T - 1.));
+      const double u = c_v * T;
+      mat.table_log_u_rho_T[i * mat.num_T + j] = log(u);
+      mat.table_P_rho_T[i * mat.num_T + j] = (gamma - 1.) * rho * u;
+      mat.table_c_rho_T[i * mat.num_T + j] = sqrt(gamma * (gamma - 1.) * u);
+      mat.table_log_s_rho_T[i * mat.num_T + j] =
+          log(s_0 + c_v * log(T / pow(rho, gamma - 1.)));
+    }
+  }
+
+  // Reference values from the original tables
+  const int num_test = 1000;
+  float rho[num_test], u[num_test], s[num_test];
+  float P_ref[num_test], c_ref[num_test], u_s_ref[num_test];
+  for (int k = 0; k < num_test; k++) {
+    rho[k] = 1e-2f * powf(1e4f, 0.01f + 0.98f * random_uniform(0., 1.));
+    const float T = 1e2f * powf(1e4f, 0.01f + 0.98f * random_uniform(0., 1.));
+    u[k] = c_v * T;
+    s[k] = s_0 + c_v * logf(T / powf(rho[k], gamma - 1.f));
+
+    P_ref[k] = SESAME_pressure_from_internal_energy(rho[k], u[k], &mat);
+    c_ref[k] = SESAME_soundspeed_from_internal_energy(rho[k], u[k], &mat);
+    u_s_ref[k] = SESAME_internal_energy_from_entropy(rho[k], s[k], &mat);
+  }
+
+  // Same with the uniform grids
+  resample_table_SESAME(&mat, /*use_uniform_grid=*/1, /*grid_factor=*/2);
+
+  double max_diff_P = 0., max_diff_c = 0., max_diff_u = 0.;
+  for (int k = 0; k < num_test; k++) {
+    const float P = SESAME_pressure_from_internal_energy(rho[k], u[k], &mat);
+    const float c = SESAME_soundspeed_from_internal_energy(rho[k], u[k], &mat);
+    const float u_s = SESAME_internal_energy_from_entropy(rho[k], s[k], &mat);
+
+    max_diff_P = max(max_diff_P, fabs(P - P_ref[k]) / P_ref[k]);
+    max_diff_c = max(max_diff_c, fabs(c - c_ref[k]) / c_ref[k]);
+    max_diff_u = max(max_diff_u, fabs(u_s - u_s_ref[k]) / u_s_ref[k]);
+  }
+
+  message("Uniform grid vs. table: max rel. diff. P=%e c=%e u(s)=%e",
+          max_diff_P, max_diff_c, max_diff_u);
+
+  const double tolerance = 1e-2;
+  if (max_diff_P > tolerance || max_diff_c > tolerance ||
+      max_diff_u > tolerance)
+    error("The SESAME uniform grids do not match the original tables!");
+
+  free(mat.table_log_rho);
+  free(mat.table_log_u_rho_T);
+  free(mat.table_P_rho_T);
+  free(mat.table_c_rho_T);
+  free(mat.table_log_s_rho_T);
+  swift_shared_free("eos_table.SESAME", mat.grid_log_P_rho_u);
+  swift_shared_free("eos_table.SESAME", mat.grid_log_c_rho_u);
+  swift_shared_free("eos_table.SESAME", mat.grid_log_u_rho_s);
+}
+
 int main(int argc, char *argv[]) {
   float rho, u, log_rho, log_u, P, c;
   struct unit_system us;
@@ -259,6 +344,9 @@ int main(int argc, char *argv[]) {
   // Initialise the EOS materials
   eos_init(&eos, phys_const, &us, params);
 
+  // Check the fast look-up of the SESAME-style tables
+  test_SESAME_uniform_grid();
+
   // Manual debug testing
   if (1) {
     printf("\n ### MANUAL DEBUG TESTING ### \n");
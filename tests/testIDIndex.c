@@ -0,0 +1,102 @@
+/*******************************************************************************
+ * This file is part of SWIFT.
+ * Copyright (C) 2026 agent (agent@local)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+/* Config parameters. */
+#include <config.h>
+
+/* System includes. */
+#include <fenv.h>
+
+/* Local headers. */
+#include "swift.h"
+
+#define NUM_BPARTS (1000 * 1000)
+#define NUM_THREADS 16
+
+int main(int argc, char *argv[]) {
+
+  /* Initialize CPU frequency, this also starts time. */
+  unsigned long long cpufreq = 0;
+  clocks_set_cpufreq(cpufreq);
+
+/* Choke on FPEs */
+#ifdef HAVE_FE_ENABLE_EXCEPT
+  feenableexcept(FE_DIVBYZERO | FE_INVALID | FE_OVERFLOW);
+#endif
+
+  /* Get some randomness going */
+  const int seed = time(NULL);
+  message("Seed = %d", seed);
+  srand(seed);
+
+  struct threadpool tp;
+  threadpool_init(&tp, NUM_THREADS);
+
+  /* Black holes with scattered IDs and a few empty slots at the end */
+  struct bpart *bparts =
+      (struct bpart *)calloc(NUM_BPARTS, sizeof(struct bpart));
+  if (bparts == NULL) error("Failed to allocate the bparts.");
+  for (int k = 0; k < NUM_BPARTS; k++) {
+    bparts[k].id = 7LL * k + (rand() % 7);
+    bparts[k].time_bin = 0;
+  }
+  for (int k = NUM_BPARTS - 100; k < NUM_BPARTS; k++) {
+    bparts[k].id = -42;
+    bparts[k].time_bin = time_bin_not_created;
+  }
+
+  message("Building the ID index with %d threads...", NUM_THREADS);
+  struct id_index index = {NULL, 0};
+  const ticks tic = getticks();
+  id_index_build_bparts(&index, bparts, NUM_BPARTS, &tp);
+  message("Took %.3f %s.", clocks_from_ticks(getticks() - tic),
+          clocks_getunit());
+
+  message("Retrieving the particles...");
+  for (int k = 0; k < NUM_BPARTS - 100; k++) {
+    const long long offset = id_index_find(&index, bparts[k].id);
+    if (offset != k)
+      error("Particle %lld found at offset %lld instead of %d.", bparts[k].id,
+            offset, k);
+  }
+
+  /* The not-created slots and absent IDs are not found */
+  if (id_index_find(&index, -42) != -1) error("Found an empty slot!");
+  if (id_index_find(&index, 7LL * NUM_BPARTS + 7) != -1)
+    error("Found an absent ID!");
+
+  /* Moving a particle */
+  id_index_update(&index, bparts[12].id, 13);
+  if (id_index_find(&index, bparts[12].id) != 13)
+    error("Offset not updated.");
+
+  /* A duplicated ID keeps the first particle */
+  id_index_insert(&index, bparts[20].id, 30);
+  id_index_insert(&index, bparts[20].id, 5);
+  if (id_index_find(&index, bparts[20].id) != 5)
+    error("Duplicated ID not resolved to the first particle.");
+
+  message("Done.");
+
+  /* Be clean */
+  id_index_clean(&index);
+  threadpool_clean(&tp);
+  free(bparts);
+  return 0;
+}
@@ -0,0 +1,225 @@
+/*******************************************************************************
+ * This file is part of SWIFT.
+ * Copyright (C) 2026 agent (agent@local)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+/* Config parameters. */
+#include <config.h>
+
+/* System includes. */
+#include <fenv.h>
+
+/* Local headers. */
+#include "swift.h"
+
+#define NUM_PARTS 50000
+#define NUM_REBUILDS 5
+#define NUM_THREADS 4
+#define BOX_SIZE 1.
+#define MAX_DISPLACEMENT 2e-3
+#define TOLERANCE 1e-4
+
+/**
+ * @brief Construct a gravity-only #space around a copy of some #gpart.
+ *
+ * @param s The #space to construct.
+ * @param e The #engine the space is attached to.
+ * @param cosmo The (non-)cosmological model.
+ * @param gparts The particles to copy into the space.
+ * @param incremental Keep the cell trees across rebuilds?
+ */
+void make_space(struct space *s, struct engine *e,
+                const struct cosmology *cosmo, const struct gpart *gparts,
+                const int incremental) {
+
+  struct gpart *gparts_copy = NULL;
+  if (swift_memalign("gparts", (void **)&gparts_copy, gpart_align,
+                     NUM_PARTS * sizeof(struct gpart)) != 0)
+    error("Failed to allocate the gparts.");
+  memcpy(gparts_copy, gparts, NUM_PARTS * sizeof(struct gpart));
+
+  struct swift_params params;
+  parser_init("", &params);
+  parser_set_param(&params, "Scheduler:max_top_level_cells:4");
+  parser_set_param(&params, "Scheduler:cell_split_size:50");
+  parser_set_param(&params, incremental ? "Scheduler:incremental_rebuild:1"
+                                        : "Scheduler:incremental_rebuild:0");
+
+  double dim[3] = {BOX_SIZE, BOX_SIZE, BOX_SIZE};
+  bzero(s, sizeof(struct space));
+  space_init(s, &params, cosmo, dim, /*hydro_properties=*/NULL,
+             /*parts=*/NULL, gparts_copy, /*sinks=*/NULL, /*sparts=*/NULL,
+             /*bparts=*/NULL, /*Npart=*/0, NUM_PARTS, /*Nsink=*/0,
+             /*Nspart=*/0, /*Nbpart=*/0, /*Nnupart=*/0, /*periodic=*/0,
+             /*replicate=*/1, /*remap_ids=*/0, /*generate_gas_in_ics=*/0,
+             /*hydro=*/0, /*gravity=*/1, /*star_formation=*/0,
+             /*with_sink=*/0, /*with_DM=*/1, /*with_DM_background=*/0,
+             /*neutrinos=*/0, /*verbose=*/0, /*dry_run=*/0, /*nr_nodes=*/1);
+  s->e = e;
+
+  /* Cells per thread buffer, as in engine_config() */
+  s->cells_sub =
+      (struct cell **)calloc(NUM_THREADS + 1, sizeof(struct cell *));
+  s->multipoles_sub = (struct gravity_tensors **)calloc(
+      NUM_THREADS + 1, sizeof(struct gravity_tensors *));
+}
+
+/**
+ * @brief Check that two cell trees have the same structure, particle counts
+ * and multipoles.
+ *
+ * @param ci The #cell of the incrementally re-built tree.
+ * @param cj The #cell of the tree re-built from scratch.
+ */
+void compare_cells(const struct cell *ci, const struct cell *cj) {
+
+  if (ci->depth != cj->depth || ci->loc[0] != cj->loc[0] ||
+      ci->loc[1] != cj->loc[1] || ci->loc[2] != cj->loc[2])
+    error("Cells at different places (depth %d vs. %d).", ci->depth,
+          cj->depth);
+
+  if (ci->grav.count != cj->grav.count)
+    error("Different number of gparts at depth %d: %d vs. %d.", ci->depth,
+          ci->grav.count, cj->grav.count);
+
+  if (ci->split != cj->split)
+    error("Different split status at depth %d (count=%d).", ci->depth,
+          ci->grav.count);
+
+  if (ci->grav.count > 0 &&
+      !gravity_multipole_equal(ci->grav.multipole, cj->grav.multipole,
+                               TOLERANCE))
+    error("Different multipoles at depth %d (count=%d).", ci->depth,
+          ci->grav.count);
+
+  if (!ci->split) return;
+
+  for (int k = 0; k < 8; k++) {
+    if ((ci->progeny[k] == NULL) != (cj->progeny[k] == NULL))
+      error("Different progeny at depth %d.", ci->depth);
+    if (ci->progeny[k] != NULL) compare_cells(ci->progeny[k], cj->progeny[k]);
+  }
+}
+
+int main(int argc, char *argv[]) {
+
+  /* Initialize CPU frequency, this also starts time. */
+  unsigned long long cpufreq = 0;
+  clocks_set_cpufreq(cpufreq);
+
+/* Choke on FPEs */
+#ifdef HAVE_FE_ENABLE_EXCEPT
+  feenableexcept(FE_DIVBYZERO | FE_INVALID | FE_OVERFLOW);
+#endif
+
+  /* Get some randomness going */
+  const int seed = time(NULL);
+  message("Seed = %d", seed);
+  srand(seed);
+
+  /* Half the particles in a uniform background, half in a small clump to get
+   * some deep trees. */
+  struct gpart *gparts = NULL;
+  if (swift_memalign("gparts", (void **)&gparts, gpart_align,
+                     NUM_PARTS * sizeof(struct gpart)) != 0)
+    error("Failed to allocate the gparts.");
+  bzero(gparts, NUM_PARTS * sizeof(struct gpart));
+  for (int i = 0; i < NUM_PARTS; i++) {
+    for (int k = 0; k < 3; k++) {
+      gparts[i].x[k] = (i % 2) ? random_uniform(0.1, 0.9) * BOX_SIZE
+                               : random_uniform(0.3, 0.4) * BOX_SIZE;
+      gparts[i].v_full[k] = random_uniform(-1., 1.);
+    }
+    gparts[i].mass = random_uniform(0.5, 1.5);
+    gparts[i].epsilon = 1e-3;
+    gparts[i].id_or_neg_offset = i + 1;
+    gparts[i].type = swift_type_dark_matter;
+    gparts[i].time_bin = 1;
+  }
+
+  struct cosmology cosmo;
+  cosmology_init_no_cosmo(&cosmo);
+
+  struct gravity_props grav_props;
+  bzero(&grav_props, sizeof(struct gravity_props));
+
+  /* A minimal engine for the spaces to use */
+  struct engine e;
+  bzero(&e, sizeof(struct engine));
+  e.nodeID = 0;
+  e.nr_nodes = 1;
+  e.ti_current = 0;
+  e.gravity_properties = &grav_props;
+  threadpool_init(&e.threadpool, NUM_THREADS);
+
+  /* The space whose tree we keep across rebuilds */
+  struct space s_inc;
+  make_space(&s_inc, &e, &cosmo, gparts, /*incremental=*/1);
+  space_rebuild(&s_inc, /*repartitioned=*/0, /*verbose=*/0);
+  space_split(&s_inc, /*verbose=*/0);
+
+  int nr_cells_reused = 0;
+  for (int n = 0; n < NUM_REBUILDS; n++) {
+
+    /* Drift the particles a little, moving a few of them across octants */
+    for (size_t i = 0; i < s_inc.nr_gparts; i++) {
+      struct gpart *gp = &s_inc.gparts[i];
+      for (int k = 0; k < 3; k++) {
+        const double x = gp->x[k] + MAX_DISPLACEMENT * BOX_SIZE * gp->v_full[k];
+        if (x > 0. && x < BOX_SIZE) gp->x[k] = x;
+      }
+    }
+
+    /* Re-build the space from scratch from the same particles */
+    struct space s_full;
+    make_space(&s_full, &e, &cosmo, s_inc.gparts, /*incremental=*/0);
+    space_rebuild(&s_full, /*repartitioned=*/0, /*verbose=*/0);
+    space_split(&s_full, /*verbose=*/0);
+
+    /* And re-build the space whose tree we kept */
+    space_rebuild(&s_inc, /*repartitioned=*/0, /*verbose=*/0);
+    space_split(&s_inc, /*verbose=*/0);
+    nr_cells_reused += s_inc.nr_cells_reused;
+
+    /* Compare the two trees */
+    if (s_inc.nr_cells != s_full.nr_cells)
+      error("Different number of top-level cells: %d vs. %d.", s_inc.nr_cells,
+            s_full.nr_cells);
+    if (s_inc.tot_cells != s_full.tot_cells)
+      error("Different total number of cells: %d vs. %d.", s_inc.tot_cells,
+            s_full.tot_cells);
+    if (s_inc.maxdepth != s_full.maxdepth)
+      error("Different maximal depth: %d vs. %d.", s_inc.maxdepth,
+            s_full.maxdepth);
+    for (int k = 0; k < s_inc.nr_cells; k++)
+      compare_cells(&s_inc.cells_top[k], &s_full.cells_top[k]);
+
+    message("Rebuild %d: %d cells, %d of them re-used.", n, s_inc.tot_cells,
+            s_inc.nr_cells_reused);
+
+    space_clean(&s_full);
+  }
+
+  /* Make sure we actually tested the re-use of the trees */
+  if (nr_cells_reused == 0) error("No cell was re-used.");
+
+  space_clean(&s_inc);
+  threadpool_clean(&e.threadpool);
+  swift_free("gparts", gparts);
+
+  return 0;
+}
@@ -0,0 +1,1162 @@
+/*******************************************************************************
+ * This file is part of SWIFT.
+ * Copyright (C) 2026 agent (agent@local)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ ******************************************************************************/
+
+/* Config parameters. */
+#include <config.h>
+
+/* Some standard headers. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/* Local headers. */
+#include "runner_doiact_grav.h"
+#include "swift.h"
+
+#define NODE_ID 0
+
+/* The cells fill a periodic box of CELLS_PER_DIM^3 cells of unit width, so
+ * that every pair of cells is a pair of neighbours. */
+#define CELLS_PER_DIM 3
+#define NUM_CELLS (CELLS_PER_DIM * CELLS_PER_DIM * CELLS_PER_DIM)
+#define NUM_PAIRS (NUM_CELLS * (NUM_CELLS - 1) / 2)
+
+/* Maximal number of entries in the comma-separated lists of options */
+#define MAX_LIST 16
+
+/* Nr of multipoles (per side) and of calls per repeat of the M2L and M2P
+ * kernels */
+#define NUM_MPOLES 512
+#define NUM_MPOLE_CALLS (1 << 16)
+
+/* Ratio of star and black hole particles to gas particles */
+#define STARS_RATIO 8
+#define BLACK_HOLES_RATIO 64
+
+/* Width of the clumps of the "clustered" distribution (in cell widths) and
+ * fraction of the particles they hold */
+#define CLUMP_SIGMA 0.1
+#define CLUMP_FRACTION 0.5
+
+enum distribution { dist_uniform, dist_glass, dist_clustered, dist_count };
+
+const char *distribution_names[dist_count] = {"uniform", "glass", "clustered"};
+
+/* What an interaction of each kernel is. */
+enum interaction_type {
+  interaction_density, /* Active i with r_ij < H_i */
+  interaction_force,   /* Active i with r_ij < max(H_i, H_j) */
+  interaction_stars,   /* Active star i with gas j at r_ij < H_i */
+  interaction_bh,      /* Active black hole i with gas j at r_ij < H_i */
+  interaction_grav,    /* Active i with any j */
+  interaction_mpole,   /* One call of the kernel */
+  interaction_count
+};
+
+typedef void (*self_function)(struct runner *r, struct cell *c);
+typedef void (*pair_function)(struct runner *r, struct cell *ci,
+                              struct cell *cj);
+typedef void (*reset_function)(struct cell *c, const struct engine *e);
+
+/**
+ * @brief A kernel to benchmark.
+ */
+struct kernel {
+
+  /*! Name used in the output and to select the kernel */
+  const char *name;
+
+  /*! The function to call on each cell (self kernels) */
+  self_function self;
+
+  /*! The function to call on each pair of cells (pair kernels) */
+  pair_function pair;
+
+  /*! Untimed reset of the particles before each repeat (or NULL) */
+  reset_function reset;
+
+  /*! What counts as one interaction */
+  enum interaction_type interaction;
+};
+
+/**
+ * @brief The timings of one kernel.
+ */
+struct kernel_timing {
+
+  /*! Nr of calls per repeat */
+  long long calls;
+
+  /*! Total time over the repeats */
+  ticks total;
+
+  /*! Fastest repeat */
+  ticks best;
+};
+
+/* Just a forward declaration... */
+void runner_dopair1_branch_density(struct runner *r, struct cell *ci,
+                                   struct cell *cj);
+void runner_doself1_branch_density(struct runner *r, struct cell *ci);
+#ifdef EXTRA_HYDRO_LOOP
+void runner_dopair1_branch_gradient(struct runner *r, struct cell *ci,
+                                    struct cell *cj);
+void runner_doself1_branch_gradient(struct runner *r, struct cell *ci);
+#endif /* EXTRA_HYDRO LOOP */
+void runner_dopair2_branch_force(struct runner *r, struct cell *ci,
+                                 struct cell *cj);
+void runner_doself2_branch_force(struct runner *r, struct cell *ci);
+void runner_dopair1_branch_limiter(struct runner *r, struct cell *ci,
+                                   struct cell *cj);
+void runner_doself1_branch_limiter(struct runner *r, struct cell *ci);
+void runner_dopair_branch_stars_density(struct runner *r, struct cell *ci,
+                                        struct cell *cj);
+void runner_doself_branch_stars_density(struct runner *r, struct cell *ci);
+void runner_dopair_branch_bh_density(struct runner *r, struct cell *ci,
+                                     struct cell *cj);
+void runner_doself_branch_bh_density(struct runner *r, struct cell *ci);
+void runner_doself_grav_pp(struct runner *r, struct cell *c);
+
+/**
+ * @brief Symmetric P-P interaction of two cells without multipoles.
+ */
+void dopair_grav_pp(struct runner *r, struct cell *ci, struct cell *cj) {
+  runner_dopair_grav_pp(r, ci, cj, /*symmetric=*/1, /*allow_mpole=*/0);
+}
+
+void reset_parts(struct cell *c, const struct engine *e) {
+  for (int i = 0; i < c->hydro.count; i++)
+    hydro_init_part(&c->hydro.parts[i], &e->s->hs);
+}
+
+#ifndef STARS_NONE
+void reset_sparts(struct cell *c, const struct engine *e) {
+  for (int i = 0; i < c->stars.count; i++)
+    stars_init_spart(&c->stars.parts[i]);
+}
+#endif
+
+#ifndef BLACK_HOLES_NONE
+void reset_bparts(struct cell *c, const struct engine *e) {
+  for (int i = 0; i < c->black_holes.count; i++)
+    black_holes_init_bpart(&c->black_holes.parts[i]);
+}
+#endif
+
+void reset_gparts(struct cell *c, const struct engine *e) {
+  for (int i = 0; i < c->grav.count; i++)
+    gravity_init_gpart(&c->grav.parts[i]);
+}
+
+/* The kernels, in the order they are run. The hydro loops depend on the
+ * ghosts run after the loops before them. */
+enum kernel_id {
+  kernel_density_self,
+  kernel_density_pair,
+#ifdef EXTRA_HYDRO_LOOP
+  kernel_gradient_self,
+  kernel_gradient_pair,
+#endif
+  kernel_force_self,
+  kernel_force_pair,
+  kernel_limiter_self,
+  kernel_limiter_pair,
+#ifndef STARS_NONE
+  kernel_stars_density_self,
+  kernel_stars_density_pair,
+#endif
+#ifndef BLACK_HOLES_NONE
+  kernel_bh_density_self,
+  kernel_bh_density_pair,
+#endif
+  kernel_grav_pp_self,
+  kernel_grav_pp_pair,
+  kernel_grav_m2l_symmetric,
+  kernel_grav_m2l_nonsym,
+  kernel_grav_m2p,
+  kernel_count
+};
+
+const struct kernel kernels[kernel_count] = {
+    {"density_self", runner_doself1_branch_density, NULL, reset_parts,
+     interaction_density},
+    {"density_pair", NULL, runner_dopair1_branch_density, reset_parts,
+     interaction_density},
+#ifdef EXTRA_HYDRO_LOOP
+    {"gradient_self", runner_doself1_branch_gradient, NULL, NULL,
+     interaction_density},
+    {"gradient_pair", NULL, runner_dopair1_branch_gradient, NULL,
+     interaction_density},
+#endif
+    {"force_self", runner_doself2_branch_force, NULL, NULL, interaction_force},
+    {"force_pair", NULL, runner_dopair2_branch_force, NULL, interaction_force},
+    {"limiter_self", runner_doself1_branch_limiter, NULL, NULL,
+     interaction_density},
+    {"limiter_pair", NULL, runner_dopair1_branch_limiter, NULL,
+     interaction_density},
+#ifndef STARS_NONE
+    {"stars_density_self", runner_doself_branch_stars_density, NULL,
+     reset_sparts, interaction_stars},
+    {"stars_density_pair", NULL, runner_dopair_branch_stars_density,
+     reset_sparts, interaction_stars},
+#endif
+#ifndef BLACK_HOLES_NONE
+    {"bh_density_self", runner_doself_branch_bh_density, NULL, reset_bparts,
+     interaction_bh},
+    {"bh_density_pair", NULL, runner_dopair_branch_bh_density, reset_bparts,
+     interaction_bh},
+#endif
+    {"grav_pp_self", runner_doself_grav_pp, NULL, reset_gparts,
+     interaction_grav},
+    {"grav_pp_pair", NULL, dopair_grav_pp, reset_gparts, interaction_grav},
+    {"grav_m2l_symmetric", NULL, NULL, NULL, interaction_mpole},
+    {"grav_m2l_nonsym", NULL, NULL, NULL, interaction_mpole},
+    {"grav_m2p", NULL, NULL, NULL, interaction_mpole},
+};
+
+/**
+ * @brief Draw a number from a normal distribution (Box-Muller).
+ */
+double random_gaussian(void) {
+  const double u = random_uniform(1e-12, 1.);
+  const double v = random_uniform(0., 2. * M_PI);
+  return sqrt(-2. * log(u)) * cos(v);
+}
+
+/**
+ * @brief Constructs a cell filled with gas, star, black hole and dark matter
+ * particles in a valid state prior to a time-step.
+ *
+ * The positions follow one of three distributions:
+ *  - uniform: uniform random positions (Poisson noise),
+ *  - glass: a lattice with random displacements of a quarter of the spacing,
+ *    whose neighbour statistics are close to those of a relaxed glass,
+ *  - clustered: half of the particles in a Gaussian clump, the rest uniform.
+ * The smoothing lengths follow the local density of the distribution.
+ *
+ * @param n The cube root of the number of gas particles.
+ * @param offset The position of the cell offset from (0,0,0).
+ * @param dist The #distribution of the particles.
+ * @param eta The smoothing length in units of the inter-particle separation.
+ * @param h_pert The maximal random fractional change of h.
+ * @param fraction_active The fraction of particles that are active.
+ * @param partId The running counter of IDs.
+ * @param grav_props The #gravity_props.
+ */
+struct cell *make_cell(size_t n, const double offset[3], enum distribution dist,
+                       double eta, double h_pert, double fraction_active,
+                       long long *partId,
+                       const struct gravity_props *grav_props) {
+
+  const double size = 1.;
+  const size_t count = n * n * n;
+  const double spacing = size / n;
+
+  /* Kernels may not reach beyond the neighbouring cells */
+  const double h_cap = 0.999 * size / kernel_gamma;
+
+  struct cell *cell = NULL;
+  if (posix_memalign((void **)&cell, cell_align, sizeof(struct cell)) != 0)
+    error("Couldn't allocate the cell");
+  bzero(cell, sizeof(struct cell));
+
+  if (posix_memalign((void **)&cell->hydro.parts, part_align,
+                     count * sizeof(struct part)) != 0)
+    error("couldn't allocate particles, no. of particles: %d", (int)count);
+  if (posix_memalign((void **)&cell->hydro.xparts, xpart_align,
+                     count * sizeof(struct xpart)) != 0)
+    error("couldn't allocate particles, no. of x-particles: %d", (int)count);
+  if (posix_memalign((void **)&cell->grav.parts, gpart_align,
+                     count * sizeof(struct gpart)) != 0)
+    error("couldn't allocate particles, no. of g-particles: %d", (int)count);
+  bzero(cell->hydro.parts, count * sizeof(struct part));
+  bzero(cell->hydro.xparts, count * sizeof(struct xpart));
+  bzero(cell->grav.parts, count * sizeof(struct gpart));
+
+  /* Properties of the clump */
+  const size_t clump_count = (size_t)(CLUMP_FRACTION * count);
+  const double sigma = CLUMP_SIGMA * size;
+  const double clump_norm =
+      clump_count / (pow(2. * M_PI, 1.5) * sigma * sigma * sigma);
+  const double background = (count - clump_count) / (size * size * size);
+  double centre[3];
+  for (int k = 0; k < 3; k++)
+    centre[k] = offset[k] + size * random_uniform(0.3, 0.7);
+
+  float h_max = 0.f, h_max_active = 0.f;
+
+  /* Construct the parts */
+  for (size_t i = 0; i < count; ++i) {
+
+    struct part *p = &cell->hydro.parts[i];
+    struct xpart *xp = &cell->hydro.xparts[i];
+
+    double h = eta * spacing;
+    switch (dist) {
+      case dist_uniform:
+        for (int k = 0; k < 3; k++)
+          p->x[k] = offset[k] + size * random_uniform(0., 1.);
+        break;
+
+      case dist_glass: {
+        const size_t lattice[3] = {i / (n * n), (i / n) % n, i % n};
+        for (int k = 0; k < 3; k++)
+          p->x[k] = offset[k] + spacing * (lattice[k] + 0.5 +
+                                           random_uniform(-0.25, 0.25));
+      } break;
+
+      case dist_clustered: {
+        if (i < clump_count) {
+          /* Draw from the clump until we land in the cell */
+          int inside = 0;
+          while (!inside) {
+            inside = 1;
+            for (int k = 0; k < 3; k++) {
+              p->x[k] = centre[k] + sigma * random_gaussian();
+              if (p->x[k] < offset[k] || p->x[k] >= offset[k] + size)
+                inside = 0;
+            }
+          }
+        } else {
+          for (int k = 0; k < 3; k++)
+            p->x[k] = offset[k] + size * random_uniform(0., 1.);
+        }
+
+        /* Local density of the distribution */
+        double r2 = 0.;
+        for (int k = 0; k < 3; k++)
+          r2 += (p->x[k] - centre[k]) * (p->x[k] - centre[k]);
+        const double density =
+            background + clump_norm * exp(-r2 / (2. * sigma * sigma));
+        h = eta * cbrt(1. / density);
+      } break;
+
+      default:
+        error("Unknown distribution");
+    }
+
+    if (h_pert > 0.) h *= random_uniform(1. - h_pert, 1. + h_pert);
+    p->h = min(h, h_cap);
+
+    p->v[0] = random_uniform(-0.05, 0.05);
+    p->v[1] = random_uniform(-0.05, 0.05);
+    p->v[2] = random_uniform(-0.05, 0.05);
+    hydro_set_mass(p, size * size * size / count);
+    hydro_set_init_internal_energy(p, 1.f);
+    hydro_first_init_part(p, xp);
+
+    p->id = ++(*partId);
+    p->time_bin = (random_uniform(0., 1.) < fraction_active)
+                      ? 1
+                      : num_time_bins + 1;
+    h_max = max(h_max, p->h);
+    if (p->time_bin == 1) h_max_active = max(h_max_active, p->h);
+
+#ifdef SWIFT_DEBUG_CHECKS
+    p->ti_drift = 8;
+    p->ti_kick = 8;
+#endif
+
+    /* The dark matter follows the gas */
+    struct gpart *gp = &cell->grav.parts[i];
+    gp->x[0] = p->x[0];
+    gp->x[1] = p->x[1];
+    gp->x[2] = p->x[2];
+    gp->mass = size * size * size / count;
+    gp->epsilon = 0.05 * spacing;
+    gp->type = swift_type_dark_matter;
+    gp->id_or_neg_offset = p->id;
+    gp->time_bin = p->time_bin;
+    gravity_init_gpart(gp);
+
+#ifdef SWIFT_DEBUG_CHECKS
+    gp->ti_drift = 8;
+    gp->ti_kick = 8;
+#endif
+  }
+
+  /* Stars and black holes sit next to random gas particles */
+#ifndef STARS_NONE
+  const size_t scount = max(count / STARS_RATIO, (size_t)1);
+  if (posix_memalign((void **)&cell->stars.parts, spart_align,
+                     scount * sizeof(struct spart)) != 0)
+    error("couldn't allocate particles, no. of s-particles: %d", (int)scount);
+  bzero(cell->stars.parts, scount * sizeof(struct spart));
+
+  float s_h_max = 0.f, s_h_max_active = 0.f;
+  for (size_t i = 0; i < scount; ++i) {
+    struct spart *sp = &cell->stars.parts[i];
+    const struct part *p = &cell->hydro.parts[rand() % count];
+    for (int k = 0; k < 3; k++) {
+      const double x = p->x[k] + 0.01 * spacing * random_uniform(-1., 1.);
+      const double x_min = max(x, offset[k]);
+      sp->x[k] = min(x_min, offset[k] + 0.999 * size);
+    }
+    sp->h = p->h;
+    sp->mass = hydro_get_mass(p);
+    sp->id = ++(*partId);
+    sp->time_bin = (random_uniform(0., 1.) < fraction_active)
+                       ? 1
+                       : num_time_bins + 1;
+    stars_init_spart(sp);
+    s_h_max = max(s_h_max, sp->h);
+    if (sp->time_bin == 1) s_h_max_active = max(s_h_max_active, sp->h);
+
+#ifdef SWIFT_DEBUG_CHECKS
+    sp->ti_drift = 8;
+    sp->ti_kick = 8;
+#endif
+  }
+
+  cell->stars.count = scount;
+  cell->stars.h_max = s_h_max;
+  cell->stars.h_max_active = s_h_max_active;
+  cell->stars.h_max_old = s_h_max;
+  cell->stars.ti_old_part = 8;
+  cell->stars.ti_end_min = 8;
+#endif /* STARS_NONE */
+
+#ifndef BLACK_HOLES_NONE
+  const size_t bcount = max(count / BLACK_HOLES_RATIO, (size_t)1);
+  if (posix_memalign((void **)&cell->black_holes.parts, bpart_align,
+                     bcount * sizeof(struct bpart)) != 0)
+    error("couldn't allocate particles, no. of b-particles: %d", (int)bcount);
+  bzero(cell->black_holes.parts, bcount * sizeof(struct bpart));
+
+  float b_h_max = 0.f, b_h_max_active = 0.f;
+  for (size_t i = 0; i < bcount; ++i) {
+    struct bpart *bp = &cell->black_holes.parts[i];
+    const struct part *p = &cell->hydro.parts[rand() % count];
+    for (int k = 0; k < 3; k++) {
+      const double x = p->x[k] + 0.01 * spacing * random_uniform(-1., 1.);
+      const double x_min = max(x, offset[k]);
+      bp->x[k] = min(x_min, offset[k] + 0.999 * size);
+    }
+    bp->h = p->h;
+    bp->mass = hydro_get_mass(p);
+    bp->id = ++(*partId);
+    bp->time_bin = (random_uniform(0., 1.) < fraction_active)
+                       ? 1
+                       : num_time_bins + 1;
+    black_holes_init_bpart(bp);
+    b_h_max = max(b_h_max, bp->h);
+    if (bp->time_bin == 1) b_h_max_active = max(b_h_max_active, bp->h);
+
+#ifdef SWIFT_DEBUG_CHECKS
+    bp->ti_drift = 8;
+    bp->ti_kick = 8;
+#endif
+  }
+
+  cell->black_holes.count = bcount;
+  cell->black_holes.h_max = b_h_max;
+  cell->black_holes.h_max_active = b_h_max_active;
+  cell->black_holes.h_max_old = b_h_max;
+  cell->black_holes.ti_old_part = 8;
+  cell->black_holes.ti_end_min = 8;
+#endif /* BLACK_HOLES_NONE */
+
+  /* Cell properties */
+  cell->split = 0;
+  cell->width[0] = size;
+  cell->width[1] = size;
+  cell->width[2] = size;
+  cell->dmin = size;
+  cell->loc[0] = offset[0];
+  cell->loc[1] = offset[1];
+  cell->loc[2] = offset[2];
+  cell->nodeID = NODE_ID;
+
+  cell->hydro.count = count;
+  cell->hydro.h_max = h_max;
+  cell->hydro.h_max_active = h_max_active;
+  cell->hydro.h_max_old = h_max;
+  cell->hydro.super = cell;
+  cell->hydro.ti_old_part = 8;
+  cell->hydro.ti_end_min = 8;
+  cell->hydro.ti_beg_max = 8;
+
+  cell->grav.count = count;
+  cell->grav.count_total = count;
+  cell->grav.ti_old_part = 8;
+  cell->grav.ti_old_multipole = 8;
+  cell->grav.ti_end_min = 8;
+  lock_init(&cell->grav.plock);
+  lock_init(&cell->grav.mlock);
+
+  /* Create the multipole */
+  cell->grav.multipole =
+      (struct gravity_tensors *)malloc(sizeof(struct gravity_tensors));
+  gravity_reset(cell->grav.multipole);
+  gravity_P2M(cell->grav.multipole, cell->grav.parts, count, grav_props);
+  gravity_multipole_compute_power(&cell->grav.multipole->m_pole);
+
+  return cell;
+}
+
+void clean_up(struct cell *c) {
+  cell_free_hydro_sorts(c);
+#ifndef STARS_NONE
+  cell_free_stars_sorts(c);
+  free(c->stars.parts);
+#endif
+#ifndef BLACK_HOLES_NONE
+  free(c->black_holes.parts);
+#endif
+  free(c->hydro.parts);
+  free(c->hydro.xparts);
+  free(c->grav.parts);
+  free(c->grav.multipole);
+  free(c);
+}
+
+/**
+ * @brief Count the interactions of each type by brute force.
+ *
+ * @param cells The cells.
+ * @param pairs The pairs of cells.
+ * @param e The #engine.
+ * @param counts (return) The interactions of each type in the self (0) and
+ * pair (1) kernels.
+ */
+void count_interactions(struct cell **cells, struct cell *pairs[][2],
+                        const struct engine *e,
+                        long long counts[interaction_count][2]) {
+
+  const double dim = e->s->dim[0];
+  bzero(counts, interaction_count * 2 * sizeof(long long));
+
+  /* Gas-gas pairs, in the cells and between the cells */
+  for (int n = 0; n < NUM_CELLS + NUM_PAIRS; n++) {
+    const int is_pair = n >= NUM_CELLS;
+    const struct cell *ci = is_pair ? pairs[n - NUM_CELLS][0] : cells[n];
+    const struct cell *cj = is_pair ? pairs[n - NUM_CELLS][1] : cells[n];
+
+    for (int i = 0; i < ci->hydro.count; i++) {
+      const struct part *pi = &ci->hydro.parts[i];
+      const int pi_active = part_is_active(pi, e);
+      const float hig = kernel_gamma * pi->h;
+
+      for (int j = is_pair ? 0 : i + 1; j < cj->hydro.count; j++) {
+        const struct part *pj = &cj->hydro.parts[j];
+        const int pj_active = part_is_active(pj, e);
+        const float hjg = kernel_gamma * pj->h;
+
+        float r2 = 0.f;
+        for (int k = 0; k < 3; k++) {
+          const float dx = nearest(pi->x[k] - pj->x[k], dim);
+          r2 += dx * dx;
+        }
+
+        if (pi_active && r2 < hig * hig) counts[interaction_density][is_pair]++;
+        if (pj_active && r2 < hjg * hjg) counts[interaction_density][is_pair]++;
+        if (r2 < hig * hig || r2 < hjg * hjg)
+          counts[interaction_force][is_pair] += pi_active + pj_active;
+      }
+    }
+
+    /* Gravity: every active particle sees every other particle */
+    int active_i = 0, active_j = 0;
+    for (int i = 0; i < ci->grav.count; i++)
+      active_i += gpart_is_active(&ci->grav.parts[i], e);
+    for (int j = 0; j < cj->grav.count; j++)
+      active_j += gpart_is_active(&cj->grav.parts[j], e);
+    if (is_pair)
+      counts[interaction_grav][1] += (long long)active_i * cj->grav.count +
+                                     (long long)active_j * ci->grav.count;
+    else
+      counts[interaction_grav][0] += (long long)active_i * (ci->grav.count - 1);
+  }
+
+  /* Stars and black holes see the gas of all the cells */
+  for (int ic = 0; ic < NUM_CELLS; ic++) {
+    const struct cell *ci = cells[ic];
+    for (int jc = 0; jc < NUM_CELLS; jc++) {
+      const struct cell *cj = cells[jc];
+      const int is_pair = (ic != jc);
+
+      for (int j = 0; j < cj->hydro.count; j++) {
+        const struct part *pj = &cj->hydro.parts[j];
+
+        for (int i = 0; i < ci->stars.count; i++) {
+          const struct spart *si = &ci->stars.parts[i];
+          if (!spart_is_active(si, e)) continue;
+          const float hig = kernel_gamma * si->h;
+          float r2 = 0.f;
+          for (int k = 0; k < 3; k++) {
+            const float dx = nearest(si->x[k] - pj->x[k], dim);
+            r2 += dx * dx;
+          }
+          if (r2 < hig * hig) counts[interaction_stars][is_pair]++;
+        }
+
+        for (int i = 0; i < ci->black_holes.count; i++) {
+          const struct bpart *bi = &ci->black_holes.parts[i];
+          if (!bpart_is_active(bi, e)) continue;
+          const float hig = kernel_gamma * bi->h;
+          float r2 = 0.f;
+          for (int k = 0; k < 3; k++) {
+            const float dx = nearest(bi->x[k] - pj->x[k], dim);
+            r2 += dx * dx;
+          }
+          if (r2 < hig * hig) counts[interaction_bh][is_pair]++;
+        }
+      }
+    }
+  }
+
+  counts[interaction_mpole][0] = NUM_MPOLE_CALLS;
+  counts[interaction_mpole][1] = NUM_MPOLE_CALLS;
+}
+
+/**
+ * @brief Run a self or pair kernel over all the cells or pairs of cells.
+ *
+ * @param kernel The #kernel.
+ * @param r The #runner.
+ * @param cells The cells.
+ * @param pairs The pairs of cells.
+ * @param repeats The number of times to run the kernel.
+ * @param timing (return) The #kernel_timing (or NULL if not timed).
+ */
+void run_kernel(const struct kernel *kernel, struct runner *r,
+                struct cell **cells, struct cell *pairs[][2], int repeats,
+                struct kernel_timing *timing) {
+
+  for (int n = 0; n < repeats; n++) {
+
+    if (kernel->reset != NULL)
+      for (int i = 0; i < NUM_CELLS; i++) kernel->reset(cells[i], r->e);
+
+    const ticks tic = getticks();
+    if (kernel->self != NULL)
+      for (int i = 0; i < NUM_CELLS; i++) kernel->self(r, cells[i]);
+    else
+      for (int i = 0; i < NUM_PAIRS; i++)
+        kernel->pair(r, pairs[i][0], pairs[i][1]);
+    const ticks toc = getticks();
+
+    if (timing != NULL) {
+      timing->total += toc - tic;
+      if (n == 0 || toc - tic < timing->best) timing->best = toc - tic;
+    }
+  }
+
+  if (timing != NULL)
+    timing->calls = (kernel->self != NULL) ? NUM_CELLS : NUM_PAIRS;
+}
+
+/**
+ * @brief Run one of the multipole kernels on a set of multipoles built from
+ * those of the cells.
+ *
+ * @param id The #kernel_id of the kernel.
+ * @param cells The cells.
+ * @param tensors_i The first set of #gravity_tensors.
+ * @param tensors_j The second set of #gravity_tensors.
+ * @param grav_props The #gravity_props.
+ * @param repeats The number of times to run the kernel.
+ * @param timing (return) The #kernel_timing.
+ */
+void run_mpole_kernel(enum kernel_id id, struct cell **cells,
+                      struct gravity_tensors *tensors_i,
+                      struct gravity_tensors *tensors_j,
+                      const struct gravity_props *grav_props, int repeats,
+                      struct kernel_timing *timing) {
+
+  const double dim[3] = {CELLS_PER_DIM, CELLS_PER_DIM, CELLS_PER_DIM};
+  struct gpart *gparts = cells[0]->grav.parts;
+  const int gcount = cells[0]->grav.count;
+
+  for (int n = 0; n < repeats; n++) {
+
+    const ticks tic = getticks();
+    switch (id) {
+      case kernel_grav_m2l_symmetric:
+        for (int k = 0; k < NUM_MPOLE_CALLS; k++) {
+          const int m = k % NUM_MPOLES;
+          gravity_M2L_symmetric(&tensors_i[m].pot, &tensors_j[m].pot,
+                                &tensors_i[m].m_pole, &tensors_j[m].m_pole,
+                                tensors_i[m].CoM, tensors_j[m].CoM, grav_props,
+                                /*periodic=*/0, dim, /*r_s_inv=*/0.f);
+        }
+        break;
+
+      case kernel_grav_m2l_nonsym:
+        for (int k = 0; k < NUM_MPOLE_CALLS; k++) {
+          const int m = k % NUM_MPOLES;
+          gravity_M2L_nonsym(&tensors_i[m].pot, &tensors_j[m].m_pole,
+                             tensors_i[m].CoM, tensors_j[m].CoM, grav_props,
+                             /*periodic=*/0, dim, /*r_s_inv=*/0.f);
+        }
+        break;
+
+      case kernel_grav_m2p:
+        for (int k = 0; k < NUM_MPOLE_CALLS; k++) {
+          const int m = k % NUM_MPOLES;
+          struct gpart *gp = &gparts[k % gcount];
+          const float r_x = tensors_j[m].CoM[0] - gp->x[0];
+          const float r_y = tensors_j[m].CoM[1] - gp->x[1];
+          const float r_z = tensors_j[m].CoM[2] - gp->x[2];
+          const float r2 = r_x * r_x + r_y * r_y + r_z * r_z;
+          const float eps = gravity_get_softening(gp, grav_props);
+
+          struct reduced_grav_tensor l = {0.f, 0.f, 0.f, 0.f};
+          gravity_M2P(&tensors_j[m].m_pole, r_x, r_y, r_z, r2, eps,
+                      /*periodic=*/0, /*r_s_inv=*/0.f, &l);
+
+          gp->a_grav[0] += l.F_100;
+          gp->a_grav[1] += l.F_010;
+          gp->a_grav[2] += l.F_001;
+        }
+        break;
+
+      default:
+        error("Not a multipole kernel");
+    }
+    const ticks toc = getticks();
+
+    timing->total += toc - tic;
+    if (n == 0 || toc - tic < timing->best) timing->best = toc - tic;
+  }
+
+  timing->calls = NUM_MPOLE_CALLS;
+}
+
+/**
+ * @brief Write a string as a JSON string, escaping what needs to be.
+ */
+void fprint_json_string(FILE *file, const char *s) {
+  fputc('"', file);
+  for (; *s != '\0'; s++) {
+    if (*s == '"' || *s == '\\')
+      fprintf(file, "\\%c", *s);
+    else if ((unsigned char)*s < 0x20)
+      fprintf(file, "\\u%04x", (unsigned char)*s);
+    else
+      fputc(*s, file);
+  }
+  fputc('"', file);
+}
+
+/**
+ * @brief Is a kernel selected by the comma-separated list of name prefixes?
+ */
+int kernel_selected(const char *name, char selection[MAX_LIST][64],
+                    int num_selection) {
+  if (num_selection == 0) return 1;
+  for (int k = 0; k < num_selection; k++)
+    if (strncmp(name, selection[k], strlen(selection[k])) == 0) return 1;
+  return 0;
+}
+
+/**
+ * @brief Split a comma-separated list.
+ *
+ * @return The number of entries.
+ */
+int split_list(const char *list, char entries[MAX_LIST][64]) {
+  char buffer[MAX_LIST * 64];
+  strncpy(buffer, list, sizeof(buffer) - 1);
+  buffer[sizeof(buffer) - 1] = '\0';
+  int count = 0;
+  for (char *tok = strtok(buffer, ","); tok != NULL; tok = strtok(NULL, ",")) {
+    if (count == MAX_LIST) error("Too many entries in '%s'.", list);
+    strncpy(entries[count], tok, 63);
+    entries[count][63] = '\0';
+    count++;
+  }
+  return count;
+}
+
+/* And go... */
+int main(int argc, char *argv[]) {
+
+#ifdef HAVE_SETAFFINITY
+  engine_pin();
+#endif
+
+  char sizes_list[MAX_LIST * 64] = "6,8";
+  char dist_list[MAX_LIST * 64] = "glass";
+  char kernel_list[MAX_LIST * 64] = "";
+  char output_file_name[200] = "";
+  int repeats = 3;
+  double eta = 1.2348, h_pert = 0., fraction_active = 1.;
+  unsigned int seed = 0;
+
+  /* Initialize CPU frequency, this also starts time. */
+  unsigned long long cpufreq = 0;
+  clocks_set_cpufreq(cpufreq);
+
+  int c;
+  while ((c = getopt(argc, argv, "n:d:r:h:p:a:k:s:o:")) != -1) {
+    switch (c) {
+      case 'n':
+        strncpy(sizes_list, optarg, sizeof(sizes_list) - 1);
+        break;
+      case 'd':
+        strncpy(dist_list, optarg, sizeof(dist_list) - 1);
+        break;
+      case 'r':
+        sscanf(optarg, "%d", &repeats);
+        break;
+      case 'h':
+        sscanf(optarg, "%lf", &eta);
+        break;
+      case 'p':
+        sscanf(optarg, "%lf", &h_pert);
+        break;
+      case 'a':
+        sscanf(optarg, "%lf", &fraction_active);
+        break;
+      case 'k':
+        strncpy(kernel_list, optarg, sizeof(kernel_list) - 1);
+        break;
+      case 's':
+        sscanf(optarg, "%u", &seed);
+        break;
+      case 'o':
+        strncpy(output_file_name, optarg, sizeof(output_file_name) - 1);
+        break;
+      case '?':
+        error("Unknown option.");
+        break;
+    }
+  }
+
+  /* Parse the lists */
+  char sizes[MAX_LIST][64], dists[MAX_LIST][64], selection[MAX_LIST][64];
+  const int num_sizes = split_list(sizes_list, sizes);
+  const int num_dists = split_list(dist_list, dists);
+  const int num_selection = split_list(kernel_list, selection);
+
+  int dist_ids[MAX_LIST];
+  for (int k = 0; k < num_dists; k++) {
+    dist_ids[k] = -1;
+    for (int d = 0; d < dist_count; d++)
+      if (strcmp(dists[k], distribution_names[d]) == 0) dist_ids[k] = d;
+  }
+
+  int sizes_ok = (num_sizes > 0);
+  for (int k = 0; k < num_sizes; k++) sizes_ok &= (atoi(sizes[k]) > 0);
+  int dists_ok = (num_dists > 0);
+  for (int k = 0; k < num_dists; k++) dists_ok &= (dist_ids[k] >= 0);
+
+  if (!sizes_ok || !dists_ok || repeats <= 0 || eta <= 0. || h_pert < 0. ||
+      h_pert >= 1. || fraction_active < 0. || fraction_active > 1.) {
+    printf(
+        "\nUsage: %s [OPTIONS...]\n"
+        "\nGenerates a periodic box of %d cells filled with gas, star, black "
+        "\nhole and dark matter particles and times each interaction kernel "
+        "\nrun over all the cells (self) or all the pairs of cells (pair)."
+        "\nThe results can also be written as one JSON object per line."
+        "\n\nOptions:"
+        "\n-n N1,N2,...         - cube root of the nr of gas particles per "
+        "cell (6,8)"
+        "\n-d DIST1,DIST2,...   - distributions: uniform, glass, clustered "
+        "(glass)"
+        "\n-r REPEATS=3         - nr of times each kernel is run"
+        "\n-h DISTANCE=1.2348   - smoothing length in units of the spacing"
+        "\n-p PERT=0            - random fractional change in h, "
+        "h=h*random(1-p,1+p)"
+        "\n-a FRACTION=1        - fraction of active particles"
+        "\n-k NAME1,NAME2,...   - only run the kernels starting with these "
+        "names"
+        "\n-s SEED=0            - seed for RNG"
+        "\n-o FILE              - write the results to this file (none)\n",
+        argv[0], NUM_CELLS);
+    exit(1);
+  }
+
+#if !defined(HYDRO_DIMENSION_3D)
+  message("testInteractionSpeed only useful in 3D. Change parameters in const.h!");
+  return 1;
+#endif
+
+  /* Seed RNG. */
+  message("Seed used for RNG: %d", seed);
+  srand(seed);
+
+  /* Build the infrastructure */
+  struct space space;
+  bzero(&space, sizeof(struct space));
+  space.periodic = 1;
+  space.dim[0] = CELLS_PER_DIM;
+  space.dim[1] = CELLS_PER_DIM;
+  space.dim[2] = CELLS_PER_DIM;
+  hydro_space_init(&space.hs, &space);
+
+  struct phys_const prog_const;
+  prog_const.const_newton_G = 1.f;
+  prog_const.const_vacuum_permeability = 1.0;
+
+  struct hydro_props hp;
+  hydro_props_init_no_hydro(&hp);
+  hp.eta_neighbours = eta;
+  hp.h_tolerance = 1e0;
+  hp.h_max = FLT_MAX;
+  hp.h_min = 0.f;
+  hp.h_min_ratio = 0.f;
+  hp.max_smoothing_iterations = 10;
+  hp.CFL_condition = 0.1;
+
+  struct gravity_props grav_props;
+  bzero(&grav_props, sizeof(struct gravity_props));
+  grav_props.use_advanced_MAC = 1;
+  grav_props.use_adaptive_tolerance = 1;
+  grav_props.adaptive_tolerance = 1e-4;
+  grav_props.theta_crit = 0.5;
+  grav_props.G_Newton = 1.;
+
+  /* P-P without the truncation of the long-range forces */
+  struct pm_mesh mesh;
+  bzero(&mesh, sizeof(struct pm_mesh));
+  mesh.periodic = 0;
+  mesh.dim[0] = CELLS_PER_DIM;
+  mesh.dim[1] = CELLS_PER_DIM;
+  mesh.dim[2] = CELLS_PER_DIM;
+
+  struct cosmology cosmo;
+  cosmology_init_no_cosmo(&cosmo);
+
+  struct lightcone_array_props lightcone_array_properties;
+  lightcone_array_properties.nr_lightcones = 0;
+
+  struct engine engine;
+  bzero(&engine, sizeof(struct engine));
+  engine.hydro_properties = &hp;
+  engine.gravity_properties = &grav_props;
+  engine.physical_constants = &prog_const;
+  engine.mesh = &mesh;
+  engine.s = &space;
+  engine.time = 0.1f;
+  engine.ti_current = 8;
+  engine.max_active_bin = num_time_bins;
+  engine.nodeID = NODE_ID;
+  engine.cosmology = &cosmo;
+  engine.lightcone_array_properties = &lightcone_array_properties;
+
+  struct runner runner;
+  bzero(&runner, sizeof(struct runner));
+  runner.e = &engine;
+
+  /* Initialise the particle caches (they grow as needed). */
+#ifdef WITH_VECTORIZATION
+  cache_init(&runner.ci_cache, 512);
+  cache_init(&runner.cj_cache, 512);
+#endif
+
+  /* Multipoles for the M2L and M2P kernels */
+  struct gravity_tensors *tensors_i = NULL, *tensors_j = NULL;
+  if (posix_memalign((void **)&tensors_i, SWIFT_CACHE_ALIGNMENT,
+                     NUM_MPOLES * sizeof(struct gravity_tensors)) != 0 ||
+      posix_memalign((void **)&tensors_j, SWIFT_CACHE_ALIGNMENT,
+                     NUM_MPOLES * sizeof(struct gravity_tensors)) != 0)
+    error("Error allocating memory for multipoles array.");
+
+  /* Only write the results to a file if asked to. */
+  FILE *file = NULL;
+  if (output_file_name[0] != '\0') {
+    file = fopen(output_file_name, "w");
+    if (file == NULL) error("Could not open file '%s'.", output_file_name);
+  }
+
+  message("Hydro scheme: %s, kernel: %s, multipole order: %d",
+          SPH_IMPLEMENTATION, kernel_name, SELF_GRAVITY_MULTIPOLE_ORDER);
+
+  for (int d = 0; d < num_dists; d++) {
+    for (int s = 0; s < num_sizes; s++) {
+
+      const enum distribution dist = (enum distribution)dist_ids[d];
+      const size_t n = atoi(sizes[s]);
+
+      /* Construct the cells */
+      struct cell *cells[NUM_CELLS];
+      static long long partId = 0;
+      for (int i = 0; i < CELLS_PER_DIM; ++i) {
+        for (int j = 0; j < CELLS_PER_DIM; ++j) {
+          for (int k = 0; k < CELLS_PER_DIM; ++k) {
+            const double offset[3] = {i, j, k};
+            cells[(i * CELLS_PER_DIM + j) * CELLS_PER_DIM + k] =
+                make_cell(n, offset, dist, eta, h_pert, fraction_active,
+                          &partId, &grav_props);
+          }
+        }
+      }
+
+      struct cell *pairs[NUM_PAIRS][2];
+      int num_pairs = 0;
+      for (int i = 0; i < NUM_CELLS; i++) {
+        for (int j = i + 1; j < NUM_CELLS; j++) {
+          pairs[num_pairs][0] = cells[i];
+          pairs[num_pairs][1] = cells[j];
+          num_pairs++;
+        }
+      }
+
+      /* Sort the cells once and for all */
+      for (int i = 0; i < NUM_CELLS; i++) {
+        runner_do_hydro_sort(&runner, cells[i], 0x1FFF, 0, 0, 0);
+#ifndef STARS_NONE
+        runner_do_stars_sort(&runner, cells[i], 0x1FFF, 0, 0);
+#endif
+      }
+
+      /* Gravity caches large enough for any cell */
+      gravity_cache_init(&runner.ci_gravity_cache, n * n * n);
+      gravity_cache_init(&runner.cj_gravity_cache, n * n * n);
+
+      /* Multipoles at varying distances */
+      for (int m = 0; m < NUM_MPOLES; m++) {
+        memcpy(&tensors_i[m], cells[rand() % NUM_CELLS]->grav.multipole,
+               sizeof(struct gravity_tensors));
+        memcpy(&tensors_j[m], cells[rand() % NUM_CELLS]->grav.multipole,
+               sizeof(struct gravity_tensors));
+        for (int k = 0; k < 3; k++)
+          tensors_j[m].CoM[k] += CELLS_PER_DIM * random_uniform(1., 2.);
+      }
+
+      /* What we expect the kernels to do */
+      long long counts[interaction_count][2];
+      count_interactions(cells, pairs, &engine, counts);
+
+      message("%s distribution, %zu gas particles per cell:",
+              distribution_names[dist], n * n * n);
+
+      struct kernel_timing timings[kernel_count];
+      bzero(timings, sizeof(timings));
+
+      for (int k = 0; k < kernel_count; k++) {
+
+        const int selected =
+            kernel_selected(kernels[k].name, selection, num_selection);
+
+        if (kernels[k].interaction == interaction_mpole) {
+          if (selected)
+            run_mpole_kernel((enum kernel_id)k, cells, tensors_i, tensors_j,
+                             &grav_props, repeats, &timings[k]);
+        } else {
+
+          /* The density (and gradient) loops feed the later hydro loops so
+           * they run at least once */
+          int needed = selected;
+#ifdef EXTRA_HYDRO_LOOP
+          needed |= (k == kernel_gradient_self || k == kernel_gradient_pair);
+#endif
+          if (needed)
+            run_kernel(&kernels[k], &runner, cells, pairs,
+                       selected ? repeats : 1, selected ? &timings[k] : NULL);
+
+          /* The timed repeats reset the particles so redo a full density
+           * loop and the ghost to prepare the next loops */
+          if (k == kernel_density_pair) {
+            for (int i = 0; i < NUM_CELLS; i++) {
+              reset_parts(cells[i], &engine);
+              runner_doself1_branch_density(&runner, cells[i]);
+            }
+            for (int i = 0; i < NUM_PAIRS; i++)
+              runner_dopair1_branch_density(&runner, pairs[i][0], pairs[i][1]);
+            for (int i = 0; i < NUM_CELLS; i++)
+              runner_do_ghost(&runner, cells[i], 0);
+          }
+
+#ifdef EXTRA_HYDRO_LOOP
+          if (k == kernel_gradient_pair)
+            for (int i = 0; i < NUM_CELLS; i++)
+              runner_do_extra_ghost(&runner, cells[i], 0);
+#endif
+        }
+
+        if (!selected) continue;
+
+        /* Report */
+        const struct kernel_timing *t = &timings[k];
+        const int is_pair = (kernels[k].self == NULL);
+        const long long interactions = counts[kernels[k].interaction][is_pair];
+        const double time = clocks_from_ticks(t->total) / repeats;
+        const double best = clocks_from_ticks(t->best);
+        const double ns = interactions > 0 ? 1e6 * time / interactions : 0.;
+        const double best_ns =
+            interactions > 0 ? 1e6 * best / interactions : 0.;
+        const double rate = time > 0. ? 1e3 * interactions / time : 0.;
+
+        message("%20s: %6lld calls %12lld interactions %9.3f %s %8.3f "
+                "ns/interaction (best %8.3f) %10.4e interactions/s",
+                kernels[k].name, t->calls, interactions, time,
+                clocks_getunit(), ns, best_ns, rate);
+
+        if (file != NULL) {
+          fprintf(file,
+                  "{\"kernel\":\"%s\",\"distribution\":\"%s\","
+                  "\"parts_per_cell\":%zu,\"cells\":%d,\"active_fraction\":%g,"
+                  "\"eta\":%g,\"h_pert\":%g,\"repeats\":%d,\"calls\":%lld,"
+                  "\"interactions\":%lld,\"time_ms\":%g,\"best_time_ms\":%g,"
+                  "\"ns_per_interaction\":%g,\"best_ns_per_interaction\":%g,"
+                  "\"interactions_per_second\":%g,",
+                  kernels[k].name, distribution_names[dist], n * n * n,
+                  NUM_CELLS, fraction_active, eta, h_pert, repeats, t->calls,
+                  interactions, time, best, ns, best_ns, rate);
+          fprintf(file, "\"build\":{\"compiler\":");
+          fprint_json_string(file, compiler_name());
+          fprintf(file, ",\"compiler_version\":");
+          fprint_json_string(file, compiler_version());
+          fprintf(file, ",\"cflags\":");
+          fprint_json_string(file, compilation_cflags());
+          fprintf(file, ",\"configuration\":");
+          fprint_json_string(file, configuration_options());
+          fprintf(file, ",\"git_revision\":");
+          fprint_json_string(file, git_revision());
+          fprintf(file, ",\"hydro\":");
+          fprint_json_string(file, SPH_IMPLEMENTATION);
+          fprintf(file, ",\"kernel\":");
+          fprint_json_string(file, kernel_name);
+          fprintf(file, ",\"multipole_order\":%d",
+                  SELF_GRAVITY_MULTIPOLE_ORDER);
+#ifdef WITH_VECTORIZATION
+          fprintf(file, ",\"vectorization\":true");
+#else
+          fprintf(file, ",\"vectorization\":false");
+#endif
+          fprintf(file, "}}\n");
+        }
+      }
+
+      /* Be clean */
+      for (int i = 0; i < NUM_CELLS; i++) clean_up(cells[i]);
+    }
+  }
+
+  if (file != NULL) {
+    fclose(file);
+    message("Results written to '%s'.", output_file_name);
+  }
+
+  /* Be clean... */
+  gravity_cache_clean(&runner.ci_gravity_cache);
+  gravity_cache_clean(&runner.cj_gravity_cache);
+#ifdef WITH_VECTORIZATION
+  cache_clean(&runner.ci_cache);
+  cache_clean(&runner.cj_cache);
+#endif
+  free(tensors_i);
+  free(tensors_j);
+
+  return 0;
+}
@@ -125,6 +125,17 @@ int main(int argc, char *argv[]) {
 
   free(histogram1);
 
+  /* The batched transformation must agree with the one-by-one version */
+  const int N_batch = 1000;
+  uint64_t *seeds = (uint64_t *)malloc(N_batch * sizeof(uint64_t));
+  double *batch = (double *)malloc(N_batch * sizeof(double));
+  for (int i = 0; i < N_batch; i++) seeds[i] = seed + i;
+  neutrino_seeds_to_fermi_dirac(seeds, batch, N_batch);
+  for (int i = 0; i < N_batch; i++)
+    assert(batch[i] == neutrino_seed_to_fermi_dirac(seeds[i]));
+  free(seeds);
+  free(batch);
+
   message("Success.");
 
   return 0;
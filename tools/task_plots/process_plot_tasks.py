@@ -18,6 +18,10 @@ output:
    for a specific step. These can be opened by clicking on a task plot on the
    overview page.
 
+The "task_trace-step<n>.dat" files written by SWIFT when a step is slow or when
+a dump is requested (see Scheduler:task_trace_size) use the same format and are
+processed if no thread_info files are present.
+
 By default, all thread_info*.dat files in the current working directory are
 processed. The optional FILES argument allows more fine-grained control over
 which files get included. Note that this script acts as a wrapper for
@@ -100,7 +104,10 @@ def getcount(filename):
 # also do this if a list of files was provided
 files = args.files
 if files is None:
-    files = sorted(glob.glob("thread_info-step*.dat"), key=getcount)
+    files = glob.glob("thread_info-step*.dat")
+    if len(files) == 0:
+        files = glob.glob("task_trace-step*.dat")
+    files = sorted(files, key=getcount)
 else:
     files = sorted(files, key=getcount)
 
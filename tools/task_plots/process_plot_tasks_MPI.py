@@ -21,6 +21,10 @@ script produces the following output:
    tasks for a specific step and a specific rank. These can be opened by
    clicking on a task plot on the step page for the same step.
 
+The "task_trace_MPI-step<n>.dat" files written by SWIFT when a step is slow or
+when a dump is requested (see Scheduler:task_trace_size) use the same format
+and are processed if no thread_info_MPI files are present.
+
 By default, all thread_info_MPI*.dat files in the current working directory are
 processed. The optional FILES argument allows more fine-grained control over
 which files get included. Note that this script acts as a wrapper for
@@ -113,7 +117,10 @@ def get_nrank(filename):
 # also do this if a list of files was provided
 files = args.files
 if files is None:
-    files = sorted(glob.glob("thread_info_MPI-step*.dat"), key=getcount)
+    files = glob.glob("thread_info_MPI-step*.dat")
+    if len(files) == 0:
+        files = glob.glob("task_trace_MPI-step*.dat")
+    files = sorted(files, key=getcount)
 else:
     files = sorted(files, key=getcount)
 
@@ -70,7 +70,6 @@ TASKTYPES = [
     "bh_swallow_ghost3",
     "fof_self",
     "fof_pair",
-    "neutrino_weight",
     "sink_in",
     "sink_ghost1",
     "sink_ghost2",
@@ -97,7 +96,6 @@ SUBTYPES = [
     "xv",
     "rho",
     "part_swallow",
-    "bpart_merger",
     "gpart",
     "multipole",
     "spart_density",
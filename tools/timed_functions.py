@@ -31,7 +31,7 @@ labels = [
     ["space_list_useful_top_level_cells:", 1],
     ["space_rebuild:", 1],
     ["scheduler_report_task_times:", 1],
-    ["engine_drift_all:", 0],
+    ["engine_drift_all_types:", 0],
     ["engine_unskip:", 0],
     ["engine_unskip_timestep_communications:", 0],
     ["engine_collect_end_of_step:", 0],